@@ -80,6 +80,7 @@ int main(int ac, char** av) {
     app.add_options()("prometheus_port", bpo::value<uint16_t>()->default_value(9180), "Prometheus port. Set to zero in order to disable.");
     app.add_options()("prometheus_address", bpo::value<sstring>()->default_value("0.0.0.0"), "Prometheus address");
     app.add_options()("prometheus_prefix", bpo::value<sstring>()->default_value("seastar_httpd"), "Prometheus metrics prefix");
+    app.add_options()("simd-request-parser", bpo::bool_switch(), "Parse requests with the SIMD request parser");
 
     return app.run(ac, av, [&] {
         return seastar::async([&] {
@@ -121,6 +122,11 @@ int main(int ac, char** av) {
             auto server = std::make_unique<http_server_control>();
             auto rb = make_shared<api_registry_builder>("apps/httpd/");
             server->start().get();
+            if (config["simd-request-parser"].as<bool>()) {
+                server->server().invoke_on_all([] (http_server& s) {
+                    s.set_simd_request_parser(true);
+                }).get();
+            }
 
             auto stop_server = defer([&] () noexcept {
                 std::cout << "Stoppping HTTP server" << std::endl; // This can throw, but won't.
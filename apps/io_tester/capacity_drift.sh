@@ -0,0 +1,89 @@
+#!/bin/bash
+#
+# This file is open source software, licensed to you under the terms
+# of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+# distributed with this work for additional information regarding copyright
+# ownership.  You may not use this file except in compliance with the License.
+#
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+
+### Runs io_tester against a loop device that gets throttled halfway through
+### the run, once with the static disk model and once with
+### --io-adaptive-capacity, to compare how the IO scheduler copes with a disk
+### that turns slower than its io-properties say.
+###
+### The device is throttled with the cgroup v2 io.max of the cgroup io_tester
+### runs in, so the script needs sudo, losetup and mkfs.xfs.
+###
+### usage: capacity_drift.sh <io_tester> [nominal MB/s] [throttled MB/s] [seconds]
+
+set -e
+
+io_tester=$(realpath "$1")
+nominal=${2:-400}
+throttled=${3:-100}
+duration=${4:-30}
+conf=$(dirname "$(realpath "$0")")/capacity_drift.yaml
+
+work=$(mktemp -d)
+cg=/sys/fs/cgroup/io_tester_capacity_drift
+dev=
+
+cleanup() {
+    sudo umount "$work/mnt" 2>/dev/null || true
+    [ -n "$dev" ] && sudo losetup -d "$dev"
+    sudo rmdir "$cg" 2>/dev/null || true
+    rm -rf "$work"
+}
+trap cleanup EXIT
+
+truncate -s 4G "$work/disk.img"
+dev=$(sudo losetup --direct-io=on --show -f "$work/disk.img")
+sudo mkfs.xfs -q "$dev"
+mkdir "$work/mnt"
+sudo mount "$dev" "$work/mnt"
+sudo chown "$(id -u):$(id -g)" "$work/mnt"
+majmin=$(lsblk -dno MAJ:MIN "$dev" | tr -d ' ')
+
+echo +io | sudo tee /sys/fs/cgroup/cgroup.subtree_control > /dev/null
+sudo mkdir -p "$cg"
+
+# What iotune would have measured before the throttling
+cat > "$work/io_properties.yaml" <<EOP
+disks:
+  - mountpoint: $work/mnt
+    read_bandwidth: ${nominal}MB
+    read_iops: $((nominal * 256))
+    write_bandwidth: ${nominal}MB
+    write_iops: $((nominal * 256))
+EOP
+
+throttle() {
+    echo "$majmin rbps=$1 wbps=$1" | sudo tee "$cg/io.max" > /dev/null
+}
+
+run() {
+    throttle max
+    sudo sh -c "echo \$\$ > $cg/cgroup.procs && exec $io_tester --storage $work/mnt --conf $conf \
+            --duration $duration --io-properties-file $work/io_properties.yaml $*" > "$work/result.yaml" &
+    local pid=$!
+    sleep $((duration / 2))
+    throttle $((throttled << 20))
+    wait $pid
+    cat "$work/result.yaml"
+}
+
+echo "### static capacity, throttled from ${nominal}MB/s to ${throttled}MB/s after $((duration / 2))s"
+run
+echo "### adaptive capacity, throttled from ${nominal}MB/s to ${throttled}MB/s after $((duration / 2))s"
+run --io-adaptive-capacity=true
@@ -230,11 +230,16 @@ struct shard_info {
     std::chrono::duration<float> think_time = 0ms;
     std::chrono::duration<float> think_after = 0ms;
     std::chrono::duration<float> execution_time = 1ms;
+    // Requests are due that long after they are issued, 0 means no deadline
+    std::chrono::duration<float> deadline = 0ms;
     seastar::scheduling_group scheduling_group = seastar::default_scheduling_group();
 };
 
 struct options {
     bool dsync = false;
+    // io_uring registered resources, see --uring-fixed-files and --uring-fixed-buffers-size
+    bool fixed_file = false;
+    bool fixed_buffers = false;
     ::sleep_fn sleep_fn = timer_sleep<lowres_clock>;
     ::pause_fn pause_fn = make_uniform_pause;
 };
@@ -290,6 +295,7 @@ class class_data {
     std::chrono::steady_clock::time_point _start = {};
     accumulator_type _latencies;
     uint64_t _requests = 0;
+    uint64_t _deadline_misses = 0;
     std::uniform_int_distribution<uint32_t> _pos_distribution;
     file _file;
     bool _think = false;
@@ -318,6 +324,12 @@ class class_data {
     virtual ~class_data() = default;
 
 private:
+    temporary_buffer<char> allocate_request_buffer() {
+        if (_config.options.fixed_buffers) {
+            return allocate_dma_buffer(req_size(), _alignment);
+        }
+        return temporary_buffer<char>::aligned(_alignment, req_size());
+    }
 
     void think_tick() {
         if (_think) {
@@ -330,6 +342,22 @@ class class_data {
     }
 
     future<> issue_request(char* buf, io_intent* intent, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point stop) {
+        if (has_deadline()) {
+            // The deadline is per request, so is the intent that carries it
+            auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(_config.shard_info.deadline);
+            auto own_intent = std::make_unique<io_intent>();
+            own_intent->set_deadline(due);
+            auto f = issue_request(buf, own_intent.get()).then([this, start, stop, due] (auto size) {
+                auto now = std::chrono::steady_clock::now();
+                if (now < stop) {
+                    this->add_result(size, std::chrono::duration_cast<std::chrono::microseconds>(now - start));
+                    if (now > due) {
+                        _deadline_misses++;
+                    }
+                }
+            });
+            return f.finally([own_intent = std::move(own_intent)] {});
+        }
         return issue_request(buf, intent).then([this, start, stop] (auto size) {
             auto now = std::chrono::steady_clock::now();
             if (now < stop) {
@@ -341,8 +369,8 @@ class class_data {
 
     future<> issue_requests_in_parallel(std::chrono::steady_clock::time_point stop) {
         return parallel_for_each(std::views::iota(0u, parallelism()), [this, stop] (auto dummy) mutable {
-            auto bufptr = allocate_aligned_buffer<char>(this->req_size(), _alignment);
-            auto buf = bufptr.get();
+            auto bufptr = allocate_request_buffer();
+            auto buf = bufptr.get_write();
             return do_until([this, stop] { return std::chrono::steady_clock::now() > stop || requests() > limit(); }, [this, buf, stop] () mutable {
                 auto start = std::chrono::steady_clock::now();
                 return issue_request(buf, nullptr, start, stop).then([this] {
@@ -355,8 +383,8 @@ class class_data {
     future<> issue_requests_at_rate(std::chrono::steady_clock::time_point stop) {
         return do_with(io_intent{}, 0u, [this, stop] (io_intent& intent, unsigned& in_flight) {
             return parallel_for_each(std::views::iota(0u, parallelism()), [this, stop, &intent, &in_flight] (auto dummy) mutable {
-                auto bufptr = allocate_aligned_buffer<char>(this->req_size(), _alignment);
-                auto buf = bufptr.get();
+                auto bufptr = allocate_request_buffer();
+                auto buf = bufptr.get_write();
                 auto pause = std::chrono::duration_cast<std::chrono::microseconds>(1s) / rps();
                 auto pause_dist = _config.options.pause_fn(pause);
                 return seastar::sleep((pause / parallelism()) * dummy).then([this, buf, stop, pause = pause_dist.get(), &intent, &in_flight] () mutable {
@@ -487,6 +515,10 @@ class class_data {
         return _config.shard_info.limit;
     }
 
+    bool has_deadline() const {
+        return _config.shard_info.deadline > std::chrono::duration<float>(0);
+    }
+
     unsigned shares() const {
         return _config.shard_info.shares;
     }
@@ -519,6 +551,10 @@ class class_data {
         return _requests;
     }
 
+    uint64_t deadline_misses() const noexcept {
+        return _deadline_misses;
+    }
+
     bool is_sequential() const {
         return (req_type() == request_type::seqread) || (req_type() == request_type::seqwrite);
     }
@@ -596,6 +632,8 @@ class io_class_data : public class_data {
         file_open_options options;
         options.extent_allocation_size_hint = _config.extent_allocation_size_hint.value_or(_config.file_size);
         options.append_is_unlikely = true;
+        options.fixed_file = _config.options.fixed_file;
+        options.fixed_buffers = _config.options.fixed_buffers;
 
         return create_and_fill_file(fname, _config.file_size, flags, options).then([this](std::pair<file, uint64_t> p) {
             _file = std::move(p.first);
@@ -615,7 +653,11 @@ class io_class_data : public class_data {
             flags |= open_flags::dsync;
         }
 
-        return open_file_dma(name, flags).then([this] (auto f) {
+        file_open_options options;
+        options.fixed_file = _config.options.fixed_file;
+        options.fixed_buffers = _config.options.fixed_buffers;
+
+        return open_file_dma(name, flags, std::move(options)).then([this] (auto f) {
             _file = std::move(f);
             return _file.size().then([this] (uint64_t size) {
                 auto shard_area_size = align_down<uint64_t>(size / smp::count, 1 << 20);
@@ -658,6 +700,15 @@ class io_class_data : public class_data {
         emit_one_metrics(out, "io_queue_consumption");
         emit_one_metrics(out, "io_queue_adjusted_consumption");
         emit_one_metrics(out, "io_queue_activations");
+        // Only registered when the queue runs with --io-deadline-dispatch
+        if (seastar::metrics::impl::get_value_map().contains("io_queue_deadline_misses")) {
+            emit_one_metrics(out, "io_queue_deadline_misses");
+        }
+        // Not per-class, only registered with --io-adaptive-capacity
+        const auto& values = seastar::metrics::impl::get_value_map();
+        if (auto mf = values.find("io_queue_capacity_factor"); mf != values.end() && !mf->second.empty()) {
+            out << YAML::Key << "io_queue_capacity_factor" << YAML::Value << mf->second.begin()->second->get_function()().d();
+        }
     }
 
 public:
@@ -674,6 +725,13 @@ class io_class_data : public class_data {
         }
         out << YAML::Key << "max" << YAML::Value << max_latency();
         out << YAML::EndMap;
+        if (has_deadline()) {
+            out << YAML::Key << "deadline" << YAML::BeginMap;
+            out << YAML::Key << "target" << YAML::Value << std::chrono::duration_cast<std::chrono::microseconds>(_config.shard_info.deadline).count() << YAML::Comment("usec");
+            out << YAML::Key << "misses" << YAML::Value << deadline_misses();
+            out << YAML::Key << "miss_ratio" << YAML::Value << (requests() ? double(deadline_misses()) / requests() : 0.0);
+            out << YAML::EndMap;
+        }
         out << YAML::Key << "stats" << YAML::BeginMap;
         out << YAML::Key << "total_requests" << YAML::Value << requests();
         emit_metrics(out);
@@ -956,6 +1014,9 @@ struct convert<shard_info> {
         if (node["execution_time"]) {
             sl.execution_time = node["execution_time"].as<duration_time>().time;
         }
+        if (node["deadline"]) {
+            sl.deadline = node["deadline"].as<duration_time>().time;
+        }
         return true;
     }
 };
@@ -966,6 +1027,12 @@ struct convert<options> {
         if (node["dsync"]) {
             op.dsync = node["dsync"].as<bool>();
         }
+        if (node["fixed_file"]) {
+            op.fixed_file = node["fixed_file"].as<bool>();
+        }
+        if (node["fixed_buffers"]) {
+            op.fixed_buffers = node["fixed_buffers"].as<bool>();
+        }
         if (node["sleep_type"]) {
             auto st = node["sleep_type"].as<std::string>();
             if (st == "busyloop") {
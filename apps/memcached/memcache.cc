@@ -32,6 +32,7 @@
 #include <seastar/core/loop.hh>
 #include <seastar/core/timer-set.hh>
 #include <seastar/core/shared_ptr.hh>
+#include <seastar/core/sharded_cache.hh>
 #include <seastar/core/stream.hh>
 #include <seastar/core/memory.hh>
 #include <seastar/core/units.hh>
@@ -82,11 +83,10 @@ using clock_type = lowres_clock;
 //
 // because lowres_clock now() initialized to zero when the application starts.
 //
-// We will use a timepoint at LLONG_MIN to represent a "never expire" value
-// since it will not collide with the minimum _time value mentioned above for
-// about 290 thousand years to come.
+// We use the "never expires" timepoint of the cache, at LLONG_MAX, which
+// will not collide with any _time value for about 290 thousand years to come.
 //
-static constexpr clock_type::time_point never_expire_timepoint = clock_type::time_point(clock_type::duration::min());
+static constexpr clock_type::time_point never_expire_timepoint = cache_entry<no_eviction, clock_type>::never_expires;
 
 struct expiration {
     using time_point = clock_type::time_point;
@@ -97,6 +97,8 @@ struct expiration {
 
     expiration() {}
 
+    explicit expiration(time_point t) : _time(t) {}
+
     expiration(clock_type::duration wc_to_clock_type_delta, uint32_t s) {
         using namespace std::chrono;
 
@@ -130,21 +132,17 @@ struct expiration {
     }
 };
 
-class item : public slab_item_base {
+// The cache does not evict items itself: the slab allocator evicts the least
+// recently allocated items of a slab class when it runs out of pages.
+class item : public slab_item_base, public cache_entry<no_eviction, clock_type> {
 public:
     using version_type = uint64_t;
-    using time_point = expiration::time_point;
-    using duration = expiration::duration;
     static constexpr uint8_t field_alignment = alignof(void*);
 private:
-    using hook_type = bi::unordered_set_member_hook<>;
     // TODO: align shared data to cache line boundary
-    version_type _version;
-    hook_type _cache_link;
-    bi::list_member_hook<> _timer_link;
-    size_t _key_hash;
-    expiration _expiry;
+    // First, to fill the tail padding of cache_entry
     uint32_t _value_size;
+    version_type _version;
     uint32_t _slab_page_index;
     uint16_t _ref_count;
     uint8_t _key_size;
@@ -154,10 +152,9 @@ class item : public slab_item_base {
 public:
     item(uint32_t slab_page_index, item_key&& key, sstring&& ascii_prefix,
          sstring&& value, expiration expiry, version_type version = 1)
-        : _version(version)
-        , _key_hash(key.hash())
-        , _expiry(expiry)
+        : cache_entry(key.hash())
         , _value_size(value.size())
+        , _version(version)
         , _slab_page_index(slab_page_index)
         , _ref_count(0U)
         , _key_size(key.key().size())
@@ -177,10 +174,6 @@ class item : public slab_item_base {
     item(const item&) = delete;
     item(item&&) = delete;
 
-    clock_type::time_point get_timeout() {
-        return _expiry.to_time_point();
-    }
-
     version_type version() {
         return _version;
     }
@@ -232,11 +225,6 @@ class item : public slab_item_base {
         }
     }
 
-    // needed by timer_set
-    bool cancel() {
-        return false;
-    }
-
     // Methods required by slab allocator.
     uint32_t get_slab_page_index() const {
         return _slab_page_index;
@@ -245,16 +233,6 @@ class item : public slab_item_base {
         return _ref_count == 1;
     }
 
-    friend bool operator==(const item &a, const item &b) {
-         return (a._key_hash == b._key_hash) &&
-            (a._key_size == b._key_size) &&
-            (memcmp(a._data, b._data, a._key_size) == 0);
-    }
-
-    friend std::size_t hash_value(const item &i) {
-        return i._key_hash;
-    }
-
     friend inline void intrusive_ptr_add_ref(item* it) {
         SEASTAR_ASSERT(it->_ref_count >= 0);
         ++it->_ref_count;
@@ -272,26 +250,6 @@ class item : public slab_item_base {
         }
         SEASTAR_ASSERT(it->_ref_count >= 0);
     }
-
-    friend struct item_key_cmp;
-};
-
-struct item_key_cmp
-{
-private:
-    bool compare(const item_key& key, const item& it) const {
-        return (it._key_hash == key.hash()) &&
-            (it._key_size == key.key().size()) &&
-            (memcmp(it._data, key.key().c_str(), it._key_size) == 0);
-    }
-public:
-    bool operator()(const item_key& key, const item& it) const {
-        return compare(key, it);
-    }
-
-    bool operator()(const item& it, const item_key& key) const {
-        return compare(key, it);
-    }
 };
 
 using item_ptr = foreign_ptr<boost::intrusive_ptr<item>>;
@@ -369,31 +327,13 @@ struct item_insertion_data {
 
 class cache {
 private:
-    using cache_type = bi::unordered_set<item,
-        bi::member_hook<item, item::hook_type, &item::_cache_link>,
-        bi::power_2_buckets<true>,
-        bi::constant_time_size<true>>;
-    using cache_iterator = typename cache_type::iterator;
-    static constexpr size_t initial_bucket_count = 1 << 10;
-    static constexpr float load_factor = 0.75f;
-    size_t _resize_up_threshold = load_factor * initial_bucket_count;
-    std::vector<cache_type::bucket_type> _buckets;
-    cache_type _cache;
-    seastar::timer_set<item, &item::_timer_link> _alive;
-    timer<clock_type> _timer;
+    local_cache<item, no_eviction> _cache;
     // delta in seconds between the current values of a wall clock and a clock_type clock
     clock_type::duration _wc_to_clock_type_delta;
+    timer<clock_type> _wc_timer;
     cache_stats _stats;
     timer<clock_type> _flush_timer;
 private:
-    size_t item_size(item& item_ref) {
-        constexpr size_t field_alignment = alignof(void*);
-        return sizeof(item) +
-            align_up(item_ref.key_size(), field_alignment) +
-            align_up(item_ref.ascii_prefix_size(), field_alignment) +
-            item_ref.value_size();
-    }
-
     size_t item_size(item_insertion_data& insertion) {
         constexpr size_t field_alignment = alignof(void*);
         auto size = sizeof(item) +
@@ -414,68 +354,32 @@ class cache {
         return size;
     }
 
-    template <bool IsInCache = true, bool IsInTimerList = true, bool Release = true>
-    void erase(item& item_ref) {
-        if (IsInCache) {
-            _cache.erase(_cache.iterator_to(item_ref));
-        }
-        if (IsInTimerList) {
-            if (item_ref._expiry.ever_expires()) {
-                _alive.remove(item_ref);
-            }
-        }
-        _stats._bytes -= item_size(item_ref);
-        if (Release) {
-            // memory used by item shouldn't be freed when slab is replacing it with another item.
-            intrusive_ptr_release(&item_ref);
-        }
-    }
-
-    void expire() {
+    void update_wc_to_clock_type_delta() {
         using namespace std::chrono;
 
-        //
-        // Adjust the delta on every timer event to minimize an error caused
-        // by a wall clock adjustment.
-        //
         _wc_to_clock_type_delta =
             duration_cast<clock_type::duration>(clock_type::now().time_since_epoch() - system_clock::now().time_since_epoch());
-
-        auto exp = _alive.expire(clock_type::now());
-        while (!exp.empty()) {
-            auto item = &*exp.begin();
-            exp.pop_front();
-            erase<true, false>(*item);
-            _stats._expired++;
-        }
-        _timer.arm(_alive.get_next_timeout());
     }
 
     inline
-    cache_iterator find(const item_key& key) {
-        return _cache.find(key, std::hash<item_key>(), item_key_cmp());
+    item* find(const item_key& key) {
+        return _cache.find(std::string_view(key.key()), key.hash());
     }
 
     template <typename Origin>
     inline
-    cache_iterator add_overriding(cache_iterator i, item_insertion_data& insertion) {
+    item* add_overriding(item* i, item_insertion_data& insertion) {
         auto& old_item = *i;
         uint64_t old_item_version = old_item._version;
 
-        erase(old_item);
+        _cache.erase(old_item);
 
         size_t size = item_size(insertion);
         auto new_item = slab->create(size, Origin::move_if_local(insertion.key), Origin::move_if_local(insertion.ascii_prefix),
             Origin::move_if_local(insertion.data), insertion.expiry, old_item_version + 1);
         intrusive_ptr_add_ref(new_item);
-
-        auto insert_result = _cache.insert(*new_item);
-        SEASTAR_ASSERT(insert_result.second);
-        if (insertion.expiry.ever_expires() && _alive.insert(*new_item)) {
-            _timer.rearm(new_item->get_timeout());
-        }
-        _stats._bytes += size;
-        return insert_result.first;
+        _cache.insert(*new_item, size, insertion.expiry.to_time_point());
+        return new_item;
     }
 
     template <typename Origin>
@@ -485,45 +389,27 @@ class cache {
         auto new_item = slab->create(size, Origin::move_if_local(insertion.key), Origin::move_if_local(insertion.ascii_prefix),
             Origin::move_if_local(insertion.data), insertion.expiry);
         intrusive_ptr_add_ref(new_item);
-        auto& item_ref = *new_item;
-        _cache.insert(item_ref);
-        if (insertion.expiry.ever_expires() && _alive.insert(item_ref)) {
-            _timer.rearm(item_ref.get_timeout());
-        }
-        _stats._bytes += size;
-        maybe_rehash();
-    }
-
-    void maybe_rehash() {
-        if (_cache.size() >= _resize_up_threshold) {
-            auto new_size = _cache.bucket_count() * 2;
-            std::vector<cache_type::bucket_type> old_buckets;
-            try {
-                old_buckets = std::exchange(_buckets, std::vector<cache_type::bucket_type>(new_size));
-            } catch (const std::bad_alloc& e) {
-                _stats._resize_failure++;
-                return;
-            }
-            _cache.rehash(typename cache_type::bucket_traits(_buckets.data(), new_size));
-            _resize_up_threshold = _cache.bucket_count() * load_factor;
-        }
+        _cache.insert(*new_item, size, insertion.expiry.to_time_point());
     }
 public:
     cache(uint64_t per_cpu_slab_size, uint64_t slab_page_size)
-        : _buckets(initial_bucket_count)
-        , _cache(cache_type::bucket_traits(_buckets.data(), initial_bucket_count))
+        : _cache(cache_config{}, [] (item& item_ref, cache_removal_cause) { intrusive_ptr_release(&item_ref); })
     {
         using namespace std::chrono;
 
-        _wc_to_clock_type_delta =
-            duration_cast<clock_type::duration>(clock_type::now().time_since_epoch() - system_clock::now().time_since_epoch());
-
-        _timer.set_callback([this] { expire(); });
+        //
+        // Adjust the delta periodically to minimize an error caused
+        // by a wall clock adjustment.
+        //
+        update_wc_to_clock_type_delta();
+        _wc_timer.set_callback([this] { update_wc_to_clock_type_delta(); });
+        _wc_timer.arm_periodic(1s);
         _flush_timer.set_callback([this] { flush_all(); });
 
         // initialize per-thread slab allocator.
+        // memory used by the evicted item shouldn't be freed, slab is replacing it with another item.
         slab_holder = std::make_unique<slab_allocator<item>>(default_slab_growth_factor, per_cpu_slab_size, slab_page_size,
-                [this](item& item_ref) { erase<true, true, false>(item_ref); _stats._evicted++; });
+                [this](item& item_ref) { _cache.remove(item_ref); _stats._evicted++; });
         slab = slab_holder.get();
 #ifdef __DEBUG__
         static bool print_slab_classes = true;
@@ -540,9 +426,7 @@ class cache {
 
     void flush_all() {
         _flush_timer.cancel();
-        _cache.erase_and_dispose(_cache.begin(), _cache.end(), [this] (item* it) {
-            erase<false, true>(*it);
-        });
+        _cache.clear();
     }
 
     void flush_at(uint32_t time) {
@@ -553,7 +437,7 @@ class cache {
     template <typename Origin = local_origin_tag>
     bool set(item_insertion_data& insertion) {
         auto i = find(insertion.key);
-        if (i != _cache.end()) {
+        if (i) {
             add_overriding<Origin>(i, insertion);
             _stats._set_replaces++;
             return true;
@@ -567,7 +451,7 @@ class cache {
     template <typename Origin = local_origin_tag>
     bool add(item_insertion_data& insertion) {
         auto i = find(insertion.key);
-        if (i != _cache.end()) {
+        if (i) {
             return false;
         }
 
@@ -579,7 +463,7 @@ class cache {
     template <typename Origin = local_origin_tag>
     bool replace(item_insertion_data& insertion) {
         auto i = find(insertion.key);
-        if (i == _cache.end()) {
+        if (!i) {
             return false;
         }
 
@@ -590,19 +474,18 @@ class cache {
 
     bool remove(const item_key& key) {
         auto i = find(key);
-        if (i == _cache.end()) {
+        if (!i) {
             _stats._delete_misses++;
             return false;
         }
         _stats._delete_hits++;
-        auto& item_ref = *i;
-        erase(item_ref);
+        _cache.erase(*i);
         return true;
     }
 
     item_ptr get(const item_key& key) {
         auto i = find(key);
-        if (i == _cache.end()) {
+        if (!i) {
             _stats._get_misses++;
             return nullptr;
         }
@@ -614,7 +497,7 @@ class cache {
     template <typename Origin = local_origin_tag>
     cas_result cas(item_insertion_data& insertion, item::version_type version) {
         auto i = find(insertion.key);
-        if (i == _cache.end()) {
+        if (!i) {
             _stats._cas_misses++;
             return cas_result::not_found;
         }
@@ -637,6 +520,10 @@ class cache {
     }
 
     cache_stats stats() {
+        auto& st = _cache.get_stats();
+        _stats._expired = st.expired;
+        _stats._bytes = _cache.charge();
+        _stats._resize_failure = st.resize_failures;
         _stats._size = size();
         return _stats;
     }
@@ -644,7 +531,7 @@ class cache {
     template <typename Origin = local_origin_tag>
     std::pair<item_ptr, bool> incr(item_key& key, uint64_t delta) {
         auto i = find(key);
-        if (i == _cache.end()) {
+        if (!i) {
             _stats._incr_misses++;
             return {item_ptr{}, false};
         }
@@ -658,16 +545,16 @@ class cache {
             .key = Origin::move_if_local(key),
             .ascii_prefix = sstring(item_ref.ascii_prefix().data(), item_ref.ascii_prefix_size()),
             .data = to_sstring(*value + delta),
-            .expiry = item_ref._expiry
+            .expiry = expiration(item_ref.get_timeout())
         };
         i = add_overriding<local_origin_tag>(i, insertion);
-        return {boost::intrusive_ptr<item>(&*i), true};
+        return {boost::intrusive_ptr<item>(i), true};
     }
 
     template <typename Origin = local_origin_tag>
     std::pair<item_ptr, bool> decr(item_key& key, uint64_t delta) {
         auto i = find(key);
-        if (i == _cache.end()) {
+        if (!i) {
             _stats._decr_misses++;
             return {item_ptr{}, false};
         }
@@ -681,10 +568,10 @@ class cache {
             .key = Origin::move_if_local(key),
             .ascii_prefix = sstring(item_ref.ascii_prefix().data(), item_ref.ascii_prefix_size()),
             .data = to_sstring(*value - std::min(*value, delta)),
-            .expiry = item_ref._expiry
+            .expiry = expiration(item_ref.get_timeout())
         };
         i = add_overriding<local_origin_tag>(i, insertion);
-        return {boost::intrusive_ptr<item>(&*i), true};
+        return {boost::intrusive_ptr<item>(i), true};
     }
 
     std::pair<unsigned, foreign_ptr<lw_shared_ptr<std::string>>> print_hash_stats() {
@@ -734,14 +621,15 @@ class cache {
 
 class sharded_cache {
 private:
+    seastar::sharded_cache<cache> _router;
     distributed<cache>& _peers;
 
     inline
     unsigned get_cpu(const item_key& key) {
-        return std::hash<item_key>()(key) % smp::count;
+        return _router.shard_of(key.hash());
     }
 public:
-    sharded_cache(distributed<cache>& peers) : _peers(peers) {}
+    sharded_cache(distributed<cache>& peers) : _router(peers), _peers(peers) {}
 
     future<> flush_all() {
         return _peers.invoke_on_all(&cache::flush_all);
@@ -782,14 +670,16 @@ class sharded_cache {
 
     // The caller must keep @key live until the resulting future resolves.
     future<bool> remove(const item_key& key) {
-        auto cpu = get_cpu(key);
-        return _peers.invoke_on(cpu, &cache::remove, std::ref(key));
+        return _router.invoke_on_owner(key.hash(), [&key] (cache& c) {
+            return c.remove(key);
+        });
     }
 
     // The caller must keep @key live until the resulting future resolves.
     future<item_ptr> get(const item_key& key) {
-        auto cpu = get_cpu(key);
-        return _peers.invoke_on(cpu, &cache::get, std::ref(key));
+        return _router.invoke_on_owner(key.hash(), [&key] (cache& c) {
+            return c.get(key);
+        });
     }
 
     // The caller must keep @insertion live until the resulting future resolves.
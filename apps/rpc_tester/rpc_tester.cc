@@ -19,7 +19,10 @@
  * Copyright (C) 2022 ScyllaDB
  */
 
+#include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <span>
 #include <vector>
 #include <chrono>
 #include <random>
@@ -42,7 +45,13 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/core/with_scheduling_group.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/thread_cputime_clock.hh>
 #include <seastar/rpc/rpc.hh>
+#include <seastar/rpc/lz4_compressor.hh>
+#include <seastar/rpc/lz4_fragmented_compressor.hh>
+#ifdef SEASTAR_HAVE_ZSTD
+#include <seastar/rpc/zstd_compressor.hh>
+#endif
 #include <seastar/util/assert.hh>
 
 using namespace seastar;
@@ -166,12 +175,23 @@ std::unique_ptr<pause_distribution> make_uniform_pause(duration_range range) {
     return std::make_unique<uniform_process>(range.min, range.max);
 }
 
+struct compression_config {
+    std::string algorithm = "none";
+    // zstd compression level, the compressor default when 0
+    int level = 0;
+    std::string dictionary;
+    // Contents of the dictionary file, loaded once at start
+    std::string dictionary_data;
+};
+
 struct client_config {
     bool nodelay = true;
+    compression_config compression;
 };
 
 struct server_config {
     bool nodelay = true;
+    compression_config compression;
 };
 
 struct job_config {
@@ -186,6 +206,7 @@ struct job_config {
     std::optional<duration_range> sleep_time_range;
     std::optional<std::chrono::duration<double>> timeout;
     size_t payload;
+    std::string payload_content = "zeroes";
 
     bool client = false;
     bool server = false;
@@ -211,12 +232,25 @@ struct byte_size {
 
 namespace YAML {
 
+static void decode_compression(const Node& node, compression_config& cfg) {
+    if (node["compression"]) {
+        cfg.algorithm = node["compression"].as<std::string>();
+    }
+    if (node["compression_level"]) {
+        cfg.level = node["compression_level"].as<int>();
+    }
+    if (node["compression_dictionary"]) {
+        cfg.dictionary = node["compression_dictionary"].as<std::string>();
+    }
+}
+
 template<>
 struct convert<client_config> {
     static bool decode(const Node& node, client_config& cfg) {
         if (node["nodelay"]) {
             cfg.nodelay = node["nodelay"].as<bool>();
         }
+        decode_compression(node, cfg.compression);
         return true;
     }
 };
@@ -227,6 +261,7 @@ struct convert<server_config> {
         if (node["nodelay"]) {
             cfg.nodelay = node["nodelay"].as<bool>();
         }
+        decode_compression(node, cfg.compression);
         return true;
     }
 };
@@ -240,6 +275,9 @@ struct convert<job_config> {
         if (cfg.type == "rpc") {
             cfg.verb = node["verb"].as<std::string>();
             cfg.payload = node["payload"].as<byte_size>().size;
+            if (node["payload_content"]) {
+                cfg.payload_content = node["payload_content"].as<std::string>();
+            }
             cfg.client = true;
             if (node["sleep_time"]) {
                 cfg.sleep_time = node["sleep_time"].as<duration_time>().time;
@@ -357,6 +395,141 @@ enum class rpc_verb : int32_t {
 using rpc_protocol = rpc::protocol<serializer, rpc_verb>;
 static std::array<double, 4> quantiles = { 0.5, 0.95, 0.99, 0.999};
 
+// Accounts the work of all compressors negotiated on one side of the
+// connections of a shard. Sizes are per direction, in bytes, before and
+// after compression.
+struct compression_stats {
+    uint64_t compress_in = 0;
+    uint64_t compress_out = 0;
+    uint64_t decompress_in = 0;
+    uint64_t decompress_out = 0;
+    thread_cputime_clock::duration compress_time{};
+    thread_cputime_clock::duration decompress_time{};
+
+    void emit(YAML::Emitter& out, const std::string& algorithm) const {
+        auto cpu_per_mb = [] (thread_cputime_clock::duration t, uint64_t bytes) -> uint64_t {
+            return bytes ? std::chrono::duration_cast<std::chrono::microseconds>(t).count() * (1 << 20) / bytes : 0;
+        };
+        auto raw = compress_in + decompress_out;
+        auto compressed = compress_out + decompress_in;
+        out << YAML::Key << "algorithm" << YAML::Value << algorithm;
+        out << YAML::Key << "sent" << YAML::Value << compress_in << YAML::Comment("bytes, uncompressed");
+        out << YAML::Key << "received" << YAML::Value << decompress_out << YAML::Comment("bytes, uncompressed");
+        out << YAML::Key << "ratio" << YAML::Value << (compressed ? double(raw) / compressed : 0.0);
+        out << YAML::Key << "compress_cpu" << YAML::Value << cpu_per_mb(compress_time, compress_in) << YAML::Comment("usec/MB");
+        out << YAML::Key << "decompress_cpu" << YAML::Value << cpu_per_mb(decompress_time, decompress_out) << YAML::Comment("usec/MB");
+    }
+};
+
+class measuring_compressor final : public rpc::compressor {
+    std::unique_ptr<rpc::compressor> _compressor;
+    compression_stats& _stats;
+public:
+    measuring_compressor(std::unique_ptr<rpc::compressor> c, compression_stats& stats)
+            : _compressor(std::move(c))
+            , _stats(stats)
+    {}
+
+    virtual rpc::snd_buf compress(size_t head_space, rpc::snd_buf data) override {
+        auto size = data.size;
+        auto start = thread_cputime_clock::now();
+        auto ret = _compressor->compress(head_space, std::move(data));
+        _stats.compress_time += thread_cputime_clock::now() - start;
+        _stats.compress_in += size;
+        _stats.compress_out += ret.size - head_space;
+        return ret;
+    }
+
+    virtual rpc::rcv_buf decompress(rpc::rcv_buf data) override {
+        auto size = data.size;
+        auto start = thread_cputime_clock::now();
+        auto ret = _compressor->decompress(std::move(data));
+        _stats.decompress_time += thread_cputime_clock::now() - start;
+        _stats.decompress_in += size;
+        _stats.decompress_out += ret.size;
+        return ret;
+    }
+
+    virtual sstring name() const override { return _compressor->name(); }
+    virtual future<> close() noexcept override { return _compressor->close(); }
+};
+
+class measuring_compressor_factory final : public rpc::compressor::factory {
+    std::unique_ptr<rpc::compressor::factory> _factory;
+    compression_stats& _stats;
+
+    std::unique_ptr<rpc::compressor> wrap(std::unique_ptr<rpc::compressor> c) const {
+        if (!c) {
+            return nullptr;
+        }
+        return std::make_unique<measuring_compressor>(std::move(c), _stats);
+    }
+
+public:
+    measuring_compressor_factory(std::unique_ptr<rpc::compressor::factory> f, compression_stats& stats)
+            : _factory(std::move(f))
+            , _stats(stats)
+    {}
+
+    virtual const sstring& supported() const override { return _factory->supported(); }
+    virtual std::unique_ptr<rpc::compressor> negotiate(sstring feature, bool is_server, std::function<future<>()> send_empty_frame) const override {
+        return wrap(_factory->negotiate(std::move(feature), is_server, std::move(send_empty_frame)));
+    }
+    virtual std::unique_ptr<rpc::compressor> negotiate(sstring feature, bool is_server) const override {
+        return wrap(_factory->negotiate(std::move(feature), is_server));
+    }
+};
+
+std::unique_ptr<rpc::compressor::factory> make_compressor_factory(const compression_config& cfg) {
+    if (cfg.algorithm == "none") {
+        return nullptr;
+    }
+    if (cfg.algorithm == "lz4") {
+        return std::make_unique<rpc::lz4_compressor::factory>();
+    }
+    if (cfg.algorithm == "lz4_fragmented") {
+        return std::make_unique<rpc::lz4_fragmented_compressor::factory>();
+    }
+#ifdef SEASTAR_HAVE_ZSTD
+    if (cfg.algorithm == "zstd") {
+        auto level = cfg.level ? cfg.level : rpc::zstd_compressor::default_level;
+        if (cfg.dictionary_data.empty()) {
+            return std::make_unique<rpc::zstd_compressor::factory>(level);
+        }
+        return std::make_unique<rpc::zstd_compressor::factory>(
+                std::make_shared<const rpc::zstd_compressor::dictionary>(cfg.dictionary_data, level));
+    }
+#endif
+    throw std::runtime_error(fmt::format("unknown compression algorithm {}", cfg.algorithm));
+}
+
+// Fills the payload with data that compresses about as well as what
+// the job is meant to model
+void fill_payload(payload_t& payload, const std::string& content) {
+    auto bytes = std::span(reinterpret_cast<char*>(payload.data()), payload.size() * sizeof(payload_t::value_type));
+    if (content == "zeroes") {
+        std::ranges::fill(bytes, 0);
+    } else if (content == "random") {
+        std::mt19937_64 rng;
+        std::ranges::generate(payload, rng);
+    } else if (content == "text") {
+        static const char* words[] = { "shard", "reactor", "future", "promise", "queue", "request", "response", "\"key\":", "\"value\":", "{", "}," };
+        std::mt19937 rng;
+        size_t pos = 0;
+        while (pos < bytes.size()) {
+            auto w = std::string_view(words[rng() % std::size(words)]);
+            auto n = std::min(w.size(), bytes.size() - pos);
+            std::copy_n(w.data(), n, bytes.data() + pos);
+            pos += n;
+            if (pos < bytes.size()) {
+                bytes[pos++] = rng() % 4 ? ' ' : '0' + rng() % 10;
+            }
+        }
+    } else {
+        throw std::runtime_error(fmt::format("unknown payload content {}", content));
+    }
+}
+
 class job {
 public:
     virtual std::string name() const = 0;
@@ -371,6 +544,7 @@ class job_rpc : public job {
     job_config _cfg;
     socket_address _caddr;
     client_config _ccfg;
+    rpc::compressor::factory* _compressor_factory;
     rpc_protocol& _rpc;
     std::unique_ptr<rpc_protocol::client> _client;
     std::function<future<>(unsigned)> _call;
@@ -395,10 +569,11 @@ class job_rpc : public job {
     }
 
 public:
-    job_rpc(job_config cfg, rpc_protocol& rpc, client_config ccfg, socket_address caddr)
+    job_rpc(job_config cfg, rpc_protocol& rpc, client_config ccfg, rpc::compressor::factory* compressor_factory, socket_address caddr)
             : _cfg(cfg)
             , _caddr(std::move(caddr))
             , _ccfg(ccfg)
+            , _compressor_factory(compressor_factory)
             , _rpc(rpc)
             , _stop(std::chrono::steady_clock::now() + _cfg.duration)
             , _latencies(extended_p_square_probabilities = quantiles)
@@ -408,6 +583,7 @@ class job_rpc : public job {
         } else if (_cfg.verb == "write") {
             payload_t payload;
             payload.resize(_cfg.payload / sizeof(payload_t::value_type), 0);
+            fill_payload(payload, _cfg.payload_content);
             _call = [this, payload = std::move(payload)] (unsigned x) { return call_write(x, payload); };
         } else if (_cfg.verb == "vecho") {
             _call = [this] (unsigned x) {
@@ -430,6 +606,7 @@ class job_rpc : public job {
         rpc::client_options co;
         co.tcp_nodelay = _ccfg.nodelay;
         co.isolation_cookie = _cfg.sg_name;
+        co.compressor_factory = _compressor_factory;
         _client = std::make_unique<rpc_protocol::client>(_rpc, co, _caddr);
         return parallel_for_each(std::views::iota(0u, _cfg.parallelism), [this] (auto dummy) {
           auto f = make_ready_future<>();
@@ -544,10 +721,22 @@ class context {
     config _cfg;
     std::vector<std::unique_ptr<job>> _jobs;
     std::unordered_map<std::string, scheduling_group> _sched_groups;
+    compression_stats _client_compression;
+    compression_stats _server_compression;
+    std::unique_ptr<rpc::compressor::factory> _client_compressor_factory;
+    std::unique_ptr<rpc::compressor::factory> _server_compressor_factory;
+
+    std::unique_ptr<rpc::compressor::factory> make_measuring_compressor_factory(const compression_config& cfg, compression_stats& stats) {
+        auto f = make_compressor_factory(cfg);
+        if (!f) {
+            return nullptr;
+        }
+        return std::make_unique<measuring_compressor_factory>(std::move(f), stats);
+    }
 
     std::unique_ptr<job> make_job(job_config cfg, std::optional<socket_address> caddr) {
         if (cfg.type == "rpc") {
-            return std::make_unique<job_rpc>(cfg, *_rpc, _cfg.client, *caddr);
+            return std::make_unique<job_rpc>(cfg, *_rpc, _cfg.client, _client_compressor_factory.get(), *caddr);
         }
         if (cfg.type == "cpu") {
             return std::make_unique<job_cpu>(cfg);
@@ -594,6 +783,8 @@ class context {
         if (laddr) {
             rpc::server_options so;
             so.tcp_nodelay = _cfg.server.nodelay;
+            _server_compressor_factory = make_measuring_compressor_factory(_cfg.server.compression, _server_compression);
+            so.compressor_factory = _server_compressor_factory.get();
             rpc::resource_limits limits;
             limits.isolate_connection = [this] (sstring cookie) { return isolate_connection(cookie); };
             _server = std::make_unique<rpc_protocol::server>(*_rpc, so, *laddr, limits);
@@ -608,6 +799,8 @@ class context {
         if (caddr) {
             rpc::client_options co;
             co.tcp_nodelay = _cfg.client.nodelay;
+            _client_compressor_factory = make_measuring_compressor_factory(_cfg.client.compression, _client_compression);
+            co.compressor_factory = _client_compressor_factory.get();
             _client = std::make_unique<rpc_protocol::client>(*_rpc, co, *caddr);
 
             for (auto&& jc : _cfg.jobs) {
@@ -659,6 +852,18 @@ class context {
             job->emit_result(out);
             out << YAML::EndMap;
         }
+        if (_client_compressor_factory) {
+            out << YAML::Key << "client_compression";
+            out << YAML::BeginMap;
+            _client_compression.emit(out, _cfg.client.compression.algorithm);
+            out << YAML::EndMap;
+        }
+        if (_server_compressor_factory) {
+            out << YAML::Key << "server_compression";
+            out << YAML::BeginMap;
+            _server_compression.emit(out, _cfg.server.compression.algorithm);
+            out << YAML::EndMap;
+        }
 
         return make_ready_future<>();
     }
@@ -710,6 +915,15 @@ int main(int ac, char** av) {
 
             YAML::Node doc = YAML::LoadFile(conf);
             auto cfg = doc.as<config>();
+            for (auto* c : { &cfg.client.compression, &cfg.server.compression }) {
+                if (!c->dictionary.empty()) {
+                    std::ifstream f(c->dictionary, std::ios::binary);
+                    if (!f) {
+                        throw std::runtime_error(fmt::format("cannot read compression dictionary {}", c->dictionary));
+                    }
+                    c->dictionary_data.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+                }
+            }
             std::unordered_map<std::string, scheduling_group> groups;
 
             for (auto&& jc : cfg.jobs) {
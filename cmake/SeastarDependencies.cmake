@@ -105,6 +105,11 @@ macro (seastar_find_dependencies)
   seastar_find_dep (ucontext REQUIRED)
   seastar_find_dep (yaml-cpp REQUIRED
     VERSION 0.5.1)
+  if (NOT DEFINED Seastar_ZSTD)
+    seastar_find_dep (zstd 1.4.0)
+  elseif (Seastar_ZSTD)
+    seastar_find_dep (zstd 1.4.0 REQUIRED)
+  endif ()
 
   # workaround for https://gitlab.kitware.com/cmake/cmake/-/issues/25079
   # since protobuf v22.0, it started using abseil, see
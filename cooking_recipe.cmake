@@ -336,3 +336,13 @@ cooking_ingredient (lz4
     CONFIGURE_COMMAND <DISABLE>
     BUILD_COMMAND <DISABLE>
     INSTALL_COMMAND ${make_command} PREFIX=<INSTALL_DIR> install)
+
+cooking_ingredient (zstd
+  EXTERNAL_PROJECT_ARGS
+    URL https://github.com/facebook/zstd/releases/download/v1.5.5/zstd-1.5.5.tar.gz
+    URL_HASH SHA256=9c4396cc829cfae319a6e2615202e82aad41372073482fce286fac78646d3ee4
+    BUILD_IN_SOURCE ON
+    CONFIGURE_COMMAND <DISABLE>
+    BUILD_COMMAND <DISABLE>
+    # Only the library, its headers and its pkg-config file
+    INSTALL_COMMAND ${make_command} -C lib PREFIX=<INSTALL_DIR> install)
@@ -0,0 +1,76 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <seastar/core/future.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/util/modules.hh>
+#include <cstdint>
+#include <unordered_map>
+#endif
+
+namespace seastar {
+
+namespace httpd {
+class http_server;
+}
+
+SEASTAR_MODULE_EXPORT_BEGIN
+
+/// \brief CPU usage samples, aggregated by stack
+///
+/// Stacks are in the folded format of flame graph tools: semicolon
+/// separated frames, outermost first. The first frame is the scheduling
+/// group, the second the type of the task that was running (or "[reactor]"
+/// when the reactor was not running a task, e.g. polling), then come the
+/// code addresses of the backtrace, formatted like the ones of seastar
+/// backtraces so they can be resolved with seastar-addr2line.
+struct cpu_profile {
+    std::unordered_map<sstring, uint64_t> stacks;
+    uint64_t samples = 0;
+    /// Samples lost because they were taken faster than they are aggregated
+    uint64_t dropped = 0;
+
+    void merge(cpu_profile&& o);
+};
+
+/// Sets the rate at which every shard samples its CPU usage, in samples
+/// per second of CPU time the shard consumes. 0 stops sampling.
+///
+/// Sampling at 100Hz costs a signal and a backtrace every 10ms of CPU time.
+future<> set_cpu_profiler_rate(unsigned hz);
+
+/// Returns the samples taken so far on all shards
+///
+/// \param reset discard the returned samples
+future<cpu_profile> collect_cpu_profile(bool reset = false);
+
+/// Adds an endpoint which returns collect_cpu_profile() in the folded
+/// stacks format, one "<stack> <samples>" line per stack. Ready to be
+/// consumed by flamegraph.pl, after resolving the addresses. The
+/// "reset=true" query parameter discards the returned samples.
+future<> add_cpu_profiler_routes(httpd::http_server& server, sstring path = "/profile/cpu");
+
+SEASTAR_MODULE_EXPORT_END
+
+}
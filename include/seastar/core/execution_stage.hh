@@ -27,15 +27,23 @@
 #include <seastar/core/sstring.hh>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/scheduling.hh>
+#include <seastar/core/shard_id.hh>
+#include <seastar/core/cacheline.hh>
 #include <seastar/util/reference_wrapper.hh>
+#include <seastar/util/spinlock.hh>
 #include <seastar/util/noncopyable_function.hh>
 #include <seastar/util/tuple_utils.hh>
 #include <seastar/util/std-compat.hh>
 #include <seastar/util/modules.hh>
 #ifndef SEASTAR_MODULE
 #include <fmt/format.h>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 #include <boost/container/static_vector.hpp>
+#include <boost/intrusive/slist.hpp>
 #endif
 
 namespace seastar {
@@ -68,6 +76,10 @@ namespace seastar {
 /// accepts only lvalue references wrapped in reference_wrapper. It is safe to
 /// pass rvalue references, they are decayed and the objects are moved. See
 /// concrete_execution_stage::operator()() for more details.
+///
+/// A stealable_concrete_execution_stage additionally lets idle shards on the
+/// same NUMA node execute batches of calls queued on a busy one, see
+/// make_stealable_execution_stage().
 
 /// \addtogroup execution-stages
 /// @{
@@ -172,12 +184,15 @@ class execution_stage {
     }
 };
 
+class stealable_execution_stage;
+
 /// \cond internal
 namespace internal {
 
 class execution_stage_manager {
     std::vector<execution_stage*> _execution_stages;
     std::unordered_map<sstring, execution_stage*> _stages_by_name;
+    std::vector<stealable_execution_stage*> _stealable_stages;
 private:
     execution_stage_manager() = default;
     execution_stage_manager(const execution_stage_manager&) = delete;
@@ -186,9 +201,15 @@ class execution_stage_manager {
     void register_execution_stage(execution_stage& stage);
     void unregister_execution_stage(execution_stage& stage) noexcept;
     void update_execution_stage_registration(execution_stage& old_es, execution_stage& new_es) noexcept;
+    void register_stealable_stage(stealable_execution_stage& stage);
+    void unregister_stealable_stage(stealable_execution_stage& stage) noexcept;
     execution_stage* get_stage(const sstring& name);
     bool flush() noexcept;
     bool poll() const noexcept;
+    /// Executes a batch of calls queued on another shard, if there is one
+    bool steal() noexcept;
+    /// Checks whether steal() would find a batch to execute
+    bool can_steal() const noexcept;
 public:
     static execution_stage_manager& get() noexcept;
 };
@@ -299,6 +320,293 @@ class concrete_execution_stage final : public execution_stage {
     }
 };
 
+/// \cond internal
+namespace internal {
+
+// Batches of calls published by the stealable execution stages of a given
+// name, shared by all shards. Every shard has a slot where its stage appends
+// full batches; the stage takes them back from the front as it executes
+// them, and idle shards on the same NUMA node steal them from the front too.
+class steal_board {
+public:
+    struct batch {
+        boost::intrusive::slist_member_hook<> hook;
+        shard_id owner = this_shard_id();
+        virtual ~batch() = default;
+        // Forwards the outcomes of the calls to the callers, runs on the owner
+        virtual void complete() noexcept = 0;
+    };
+private:
+    using batch_list = boost::intrusive::slist<batch,
+            boost::intrusive::member_hook<batch, boost::intrusive::slist_member_hook<>, &batch::hook>,
+            boost::intrusive::cache_last<true>,
+            boost::intrusive::constant_time_size<false>>;
+    struct alignas(cache_line_size) slot {
+        util::spinlock lock;
+        batch_list batches;
+        std::atomic<unsigned> published = { 0 };
+        // Other shards on the same NUMA node
+        std::vector<shard_id> neighbours;
+    };
+    std::unique_ptr<slot[]> _slots;
+
+    static batch* pop(slot& s) noexcept;
+public:
+    explicit steal_board(std::span<const unsigned> shard_to_numa_node);
+
+    // Appends a batch to the slot of the current shard
+    void publish(batch* b) noexcept;
+    // Takes back the oldest batch published by the current shard
+    batch* take() noexcept;
+    // Takes the oldest batch of the most loaded neighbour
+    batch* steal() noexcept;
+    unsigned published() const noexcept;
+    bool stealable() const noexcept;
+
+    // Sends an executed stolen batch back to its owner, which completes and
+    // frees it
+    static void send_back(batch* b) noexcept;
+    // Returns the board shared by the stages of that name on all shards
+    static std::shared_ptr<steal_board> get(const sstring& name);
+};
+
+}
+/// \endcond
+
+/// Base class of execution stages whose queued calls can be executed by
+/// other shards
+SEASTAR_MODULE_EXPORT
+class stealable_execution_stage : public execution_stage {
+protected:
+    std::shared_ptr<internal::steal_board> _board;
+    bool _steal_scheduled = false;
+    uint64_t _function_calls_stolen = 0;
+    metrics::metric_group _steal_metric_group;
+protected:
+    virtual void execute_stolen(internal::steal_board::batch* b) noexcept = 0;
+public:
+    explicit stealable_execution_stage(const sstring& name, scheduling_group sg = {});
+    ~stealable_execution_stage();
+
+    /// Stealable execution stages are shared with other shards and cannot
+    /// be moved, make_stealable_execution_stage() relies on guaranteed copy
+    /// elision instead
+    stealable_execution_stage(stealable_execution_stage&&) = delete;
+
+    /// Returns the number of calls queued on other shards this shard executed
+    uint64_t function_calls_stolen() const noexcept { return _function_calls_stolen; }
+
+    /// Schedules the execution of a batch of calls queued on another shard
+    ///
+    /// Executes at most one stolen batch at a time.
+    ///
+    /// \return true if a batch was stolen
+    bool steal() noexcept;
+
+    /// Checks whether steal() would find a batch to execute
+    bool can_steal() const noexcept {
+        return !_steal_scheduled && _board->stealable();
+    }
+};
+
+/// \brief Execution stage whose batches can be executed by idle shards
+///
+/// Behaves like concrete_execution_stage, except that calls are queued in
+/// batches of batch_size and full batches are made visible to the stages of
+/// the same name on the other shards of the NUMA node. A shard whose reactor
+/// has no tasks to run executes such a batch in the stage's scheduling group
+/// with its own instance of the stage, and sends the outcomes back to the
+/// owner shard over the smp queues, where the returned futures are resolved.
+/// Work the owner shard gets to first is executed locally, as usual.
+///
+/// This is only correct for functions that do not depend on the shard they
+/// run on, and whose arguments and results can be moved to and used from
+/// another shard (e.g. no seastar::shared_ptr). Arguments cannot be
+/// references. Every shard that should help needs an instance of the stage,
+/// typically a thread_local one.
+///
+/// \note The recommended way of creating stealable execution stages is to
+/// use make_stealable_execution_stage().
+///
+/// \tparam ReturnType return type of the function object
+/// \tparam Args  argument pack containing arguments to the function object, needs
+///                   to have move constructor that doesn't throw
+template<typename ReturnType, typename... Args>
+requires std::is_nothrow_move_constructible_v<std::tuple<Args...>>
+class stealable_concrete_execution_stage final : public stealable_execution_stage {
+    using args_tuple = std::tuple<Args...>;
+    static_assert(std::is_nothrow_move_constructible_v<args_tuple>,
+                  "Function arguments need to be nothrow move constructible");
+    static_assert(!(std::is_lvalue_reference_v<Args> || ...),
+                  "Calls to a stealable execution stage may run on another shard, arguments cannot be lvalue references");
+public:
+    static constexpr size_t batch_size = 128;
+private:
+    static constexpr size_t max_published_batches = 1024 / batch_size;
+
+    using return_type = futurize_t<ReturnType>;
+    using promise_type = typename return_type::promise_type;
+    using value_type = typename return_type::value_type;
+    using input_type = typename tuple_map_types<internal::wrap_for_es, args_tuple>::type;
+
+    struct batch final : internal::steal_board::batch {
+        std::vector<input_type> in;
+        std::vector<promise_type> ready;
+        // Outcomes of the calls of a stolen batch, filled on the thief shard
+        std::vector<std::optional<value_type>> values;
+        std::vector<std::exception_ptr> exceptions;
+        size_t executed = 0;
+        size_t pending = 0;
+
+        batch() {
+            in.reserve(batch_size);
+            ready.reserve(batch_size);
+        }
+
+        void store(size_t i, return_type&& f) noexcept {
+            if (f.failed()) {
+                exceptions[i] = f.get_exception();
+            } else {
+                values[i].emplace(f.get());
+            }
+        }
+
+        virtual void complete() noexcept override {
+            for (size_t i = 0; i < ready.size(); i++) {
+                if (exceptions[i]) {
+                    ready[i].set_exception(std::move(exceptions[i]));
+                } else {
+                    ready[i].set_value(std::move(*values[i]));
+                }
+            }
+        }
+    };
+    // Being filled, only visible to this shard
+    std::unique_ptr<batch> _current;
+    // Being executed by this shard
+    std::unique_ptr<batch> _running;
+
+    noncopyable_function<ReturnType (Args...)> _function;
+private:
+    auto unwrap(input_type&& in) {
+        return tuple_map(std::move(in), [] (auto&& obj) {
+            return internal::unwrap_for_es(std::forward<decltype(obj)>(obj));
+        });
+    }
+
+    // Returns true if preempted
+    bool execute(batch& b) noexcept {
+        while (b.executed < b.in.size()) {
+            auto i = b.executed++;
+            futurize<ReturnType>::apply(_function, unwrap(std::move(b.in[i]))).forward_to(std::move(b.ready[i]));
+            _stats.function_calls_executed++;
+
+            if (internal::scheduler_need_preempt()) {
+                _stats.tasks_preempted++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    virtual void do_flush() noexcept override {
+        while (true) {
+            if (!_running) {
+                // Published batches are older than the current one
+                _running.reset(static_cast<batch*>(_board->take()));
+                if (!_running) {
+                    _running = std::move(_current);
+                    if (!_running) {
+                        break;
+                    }
+                }
+            }
+            bool preempted = execute(*_running);
+            if (_running->executed == _running->in.size()) {
+                _running.reset();
+            }
+            if (preempted) {
+                break;
+            }
+        }
+        _empty = !_running && !_current && !_board->published();
+    }
+
+    // Stolen batches are at most batch_size calls long, so they are
+    // executed in one go
+    virtual void execute_stolen(internal::steal_board::batch* base) noexcept override {
+        auto b = static_cast<batch*>(base);
+        auto release = [] (batch* b) noexcept {
+            if (--b->pending == 0) {
+                internal::steal_board::send_back(b);
+            }
+        };
+        b->pending = 1;
+        for (size_t i = 0; i < b->in.size(); i++) {
+            auto f = futurize<ReturnType>::apply(_function, unwrap(std::move(b->in[i])));
+            if (f.available()) {
+                b->store(i, std::move(f));
+            } else {
+                b->pending++;
+                (void)f.then_wrapped([b, i, release] (return_type f) noexcept {
+                    b->store(i, std::move(f));
+                    release(b);
+                });
+            }
+        }
+        _function_calls_stolen += b->in.size();
+        release(b);
+    }
+public:
+    explicit stealable_concrete_execution_stage(const sstring& name, scheduling_group sg, noncopyable_function<ReturnType (Args...)> f)
+        : stealable_execution_stage(name, sg)
+        , _function(std::move(f))
+    {
+    }
+    explicit stealable_concrete_execution_stage(const sstring& name, noncopyable_function<ReturnType (Args...)> f)
+        : stealable_concrete_execution_stage(name, scheduling_group(), std::move(f)) {
+    }
+
+    /// Destroys the stage, the calls that were not executed yet fail with
+    /// broken_promise
+    ~stealable_concrete_execution_stage() {
+        while (auto b = _board->take()) {
+            delete b;
+        }
+    }
+
+    /// Enqueues a call to the stage's function
+    ///
+    /// Adds a function call to the current batch, which is published to the
+    /// other shards once full. Arguments are moved.
+    ///
+    /// \param args arguments passed to the stage's function
+    /// \return future containing the result of the call to the stage's function
+    return_type operator()(typename internal::wrap_for_es<Args>::type... args) {
+        if (_board->published() >= max_published_batches) {
+            do_flush();
+        }
+        if (!_current) {
+            _current = std::make_unique<batch>();
+        }
+        if (_current->in.size() == batch_size - 1) {
+            // Room for the outcomes, in case the batch is stolen
+            _current->values.resize(batch_size);
+            _current->exceptions.resize(batch_size);
+        }
+        _current->in.emplace_back(std::move(args)...);
+        _current->ready.emplace_back();
+        _empty = false;
+        _stats.function_calls_enqueued++;
+        auto f = _current->ready.back().get_future();
+        if (_current->in.size() == batch_size) {
+            _board->publish(_current.release());
+        }
+        flush();
+        return f;
+    }
+};
+
 /// \brief Base class for execution stages with support for automatic \ref scheduling_group inheritance
 class inheriting_execution_stage {
 public:
@@ -540,6 +848,60 @@ make_execution_stage(const sstring& name, Ret (Object::*fn)(Args...) const) {
     return make_execution_stage(name, scheduling_group(), fn);
 }
 
+/// \cond internal
+namespace internal {
+
+template <typename Ret, typename ArgsTuple>
+struct stealable_execution_stage_helper;
+
+template <typename Ret, typename... Args>
+struct stealable_execution_stage_helper<Ret, std::tuple<Args...>> {
+    using type = stealable_concrete_execution_stage<Ret, Args...>;
+};
+
+}
+/// \endcond
+
+/// Creates a new stealable execution stage
+///
+/// Wraps given function object in a stealable_concrete_execution_stage,
+/// whose batches of calls can be executed by idle shards of the same NUMA
+/// node. The stage should be created on every shard under the same name,
+/// and the function must give the same result on any of them.
+///
+/// Usage example:
+/// ```
+/// uint32_t checksum(sstring);
+/// thread_local auto stage = seastar::make_stealable_execution_stage("checksum", checksum);
+///
+/// future<uint32_t> func(sstring data) {
+///     return stage(std::move(data));
+/// }
+/// ```
+///
+/// \param name unique name of the execution stage
+/// \param sg scheduling group to run under, on any shard
+/// \param fn function to be executed by the stage
+/// \return stealable_concrete_execution_stage
+SEASTAR_MODULE_EXPORT
+template<typename Function>
+auto make_stealable_execution_stage(const sstring& name, scheduling_group sg, Function&& fn) {
+    using traits = function_traits<Function>;
+    using ret_type = typename traits::return_type;
+    using args_as_tuple = typename traits::args_as_tuple;
+    using stage_type = typename internal::stealable_execution_stage_helper<ret_type, args_as_tuple>::type;
+    return stage_type(name, sg, std::forward<Function>(fn));
+}
+
+/// Creates a new stealable execution stage (variant not taking \ref scheduling_group)
+///
+/// \see make_stealable_execution_stage(const sstring&, scheduling_group, Function&&)
+SEASTAR_MODULE_EXPORT
+template<typename Function>
+auto make_stealable_execution_stage(const sstring& name, Function&& fn) {
+    return make_stealable_execution_stage(name, scheduling_group(), std::forward<Function>(fn));
+}
+
 /// @}
 
 }
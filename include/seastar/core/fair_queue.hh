@@ -109,23 +109,34 @@ class fair_queue_entry {
     // a 'normalized' form -- converted from floating-point to fixed-point number
     // and scaled accrding to fair-group's token-bucket duration
     using capacity_t = uint64_t;
+    using clock_type = std::chrono::steady_clock;
     friend class fair_queue;
 
+    static constexpr clock_type::time_point no_deadline = clock_type::time_point::max();
+
 private:
     capacity_t _capacity;
     bi::slist_member_hook<> _hook;
+    // Only looked at by queues configured with deadline_dispatch
+    clock_type::time_point _deadline;
 
 public:
-    explicit fair_queue_entry(capacity_t c) noexcept
-        : _capacity(c) {}
+    explicit fair_queue_entry(capacity_t c, clock_type::time_point deadline = no_deadline) noexcept
+        : _capacity(c)
+        , _deadline(deadline) {}
     using container_list_t = bi::slist<fair_queue_entry,
             bi::constant_time_size<false>,
             bi::cache_last<true>,
             bi::member_hook<fair_queue_entry, bi::slist_member_hook<>, &fair_queue_entry::_hook>>;
 
     capacity_t capacity() const noexcept { return _capacity; }
+    clock_type::time_point deadline() const noexcept { return _deadline; }
 };
 
+// Every queued request embeds an entry. The deadline grew it from two words
+// to three, keep it from growing further unnoticed.
+static_assert(sizeof(fair_queue_entry) == 3 * sizeof(uint64_t));
+
 /// \brief Group of queues class
 ///
 /// This is a fair group. It's attached by one or mode fair queues. On machines having the
@@ -267,6 +278,10 @@ class fair_group {
     }
 
     const token_bucket_t& token_bucket() const noexcept { return _token_bucket; }
+
+    // Replenish capacity at the given fraction of the nominal rate, for when
+    // the resource turns out to be faster or slower than configured
+    void update_rate_factor(double factor) noexcept;
 };
 
 /// \brief Fair queuing class
@@ -297,6 +312,16 @@ class fair_queue {
     struct config {
         sstring label = "";
         std::chrono::microseconds tau = std::chrono::milliseconds(5);
+        /// Dispatch the requests of each class in the order of their deadlines
+        /// rather than in the order they were queued. Classes still share the
+        /// capacity according to their shares, the deadlines only reorder the
+        /// requests of a class among themselves.
+        bool deadline_dispatch = false;
+        /// In deadline dispatch mode, entries queued without a deadline get
+        /// one that far in the future, so that a steady flow of requests with
+        /// deadlines cannot starve them forever. Dispatching them after it
+        /// counts as a deadline miss, like for explicit deadlines.
+        std::chrono::microseconds relaxed_deadline = std::chrono::milliseconds(100);
     };
 
     using class_id = unsigned int;
@@ -357,6 +382,7 @@ class fair_queue {
 
     void push_priority_class(priority_class_data& pc) noexcept;
     void push_priority_class_from_idle(priority_class_data& pc) noexcept;
+    void queue_by_deadline(priority_class_data& pc, fair_queue_entry& ent) noexcept;
     void pop_priority_class(priority_class_data& pc) noexcept;
     void plug_priority_class(priority_class_data& pc) noexcept;
     void unplug_priority_class(priority_class_data& pc) noexcept;
@@ -415,6 +441,9 @@ class fair_queue {
     ///
     /// The user of this interface is supposed to call \ref notify_requests_finished when the
     /// request finishes executing - regardless of success or failure.
+    ///
+    /// With \ref config::deadline_dispatch the entry is put in front of the
+    /// class' entries with later deadlines, otherwise it's put at the end.
     void queue(class_id c, fair_queue_entry& ent) noexcept;
 
     void plug_class(class_id c) noexcept;
@@ -100,6 +100,8 @@ struct file_open_options {
     uint64_t sloppy_size_hint = 1 << 20; ///< Hint as to what the eventual file size will be
     file_permissions create_permissions = file_permissions::default_file_permissions; ///< File permissions to use when creating a file
     bool append_is_unlikely = false; ///< Hint that user promises (or at least tries hard) not to write behind file size
+    bool fixed_file = false; ///< Register the file in the reactor's io_uring fixed-file table, if there is one (see --uring-fixed-files)
+    bool fixed_buffers = false; ///< Allocate dma_read_bulk() buffers from the reactor's io_uring registered buffer arena, if there is one (see --uring-fixed-buffers-size)
 
     // The fsxattr.fsx_extsize is 32-bit
     static constexpr uint64_t max_extent_allocation_size_hint = 1 << 31;
@@ -664,6 +666,17 @@ class file_handle {
     friend class file;
 };
 
+/// Allocates a buffer suitable for \ref file DMA reads and writes.
+///
+/// When the reactor runs the \p io_uring backend with a registered buffer
+/// arena (see --uring-fixed-buffers-size), the buffer is carved from that
+/// arena and I/O into it is submitted as fixed-buffer requests. Otherwise,
+/// or when the arena is exhausted, a regular aligned buffer is returned.
+///
+/// \param size size of the buffer, in bytes
+/// \param alignment required memory alignment, see \ref file::memory_dma_alignment()
+temporary_buffer<char> allocate_dma_buffer(size_t size, size_t alignment);
+
 /// @}
 
 /// An exception Cancelled IOs resolve their future into (see \ref io_intent "io_intent")
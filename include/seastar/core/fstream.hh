@@ -61,6 +61,18 @@ struct file_input_stream_options {
     size_t buffer_size = 8192;    ///< I/O buffer size
     unsigned read_ahead = 0;      ///< Maximum number of extra read-ahead operations
     lw_shared_ptr<file_input_stream_history> dynamic_adjustments = { }; ///< Input stream history, if null dynamic adjustments are disabled
+    /// Adapt read-ahead to the access pattern.
+    ///
+    /// The stream starts with \c buffer_size requests and at most one read-ahead,
+    /// as a point read would want. While it is consumed sequentially, the
+    /// request size doubles up to the disk's maximum read length, as configured
+    /// in the I/O queue, and then read-ahead grows up to \c read_ahead as long
+    /// as the consumer has to wait for the disk. Both fall back to the initial
+    /// values after a skip past the data already read, or on the next read
+    /// after the consumer stopped reading for a while. Buffers already read
+    /// ahead are not released while the consumer is idle.
+    /// \c dynamic_adjustments is ignored in this mode.
+    bool adaptive_read_ahead = false;
 };
 
 /// \brief Creates an input_stream to read a portion of a file.
@@ -0,0 +1,99 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <signal.h>
+#include <atomic>
+#include <memory>
+#include <typeinfo>
+#include <unordered_map>
+#include <boost/container/static_vector.hpp>
+#endif
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/timer.hh>
+
+namespace seastar {
+
+struct cpu_profile;
+
+namespace internal {
+
+// Samples the task running on the shard at a fixed rate of thread CPU time,
+// the same way the stall detector measures stalls: a CPU time posix timer
+// delivers a signal to the reactor thread. The signal handler only copies
+// the task type, scheduling group and backtrace into a preallocated ring,
+// which is periodically drained into per-stack counters.
+class cpu_profiler {
+public:
+    static constexpr size_t max_frames = 32;
+    static constexpr size_t ring_size = 512;
+private:
+    struct sample {
+        const std::type_info* task_type;
+        unsigned sg;
+        unsigned nr_frames;
+        uintptr_t frames[max_frames];
+    };
+    struct stack {
+        const std::type_info* task_type;
+        unsigned sg;
+        boost::container::static_vector<uintptr_t, max_frames> frames;
+        bool operator==(const stack&) const noexcept = default;
+    };
+    struct stack_hash {
+        size_t operator()(const stack& s) const noexcept;
+    };
+
+    unsigned _rate = 0;
+    timer_t _timer;
+    bool _timer_created = false;
+    std::unique_ptr<sample[]> _ring;
+    // _head is only written by the signal handler and _tail by drain(), both
+    // on the reactor thread
+    std::atomic<uint64_t> _head = { 0 };
+    std::atomic<uint64_t> _tail = { 0 };
+    std::atomic<uint64_t> _dropped = { 0 };
+    uint64_t _dropped_at_reset = 0;
+    // Aggregated samples, since the last reset and in total
+    uint64_t _samples = 0;
+    uint64_t _total_samples = 0;
+    std::unordered_map<stack, uint64_t, stack_hash> _stacks;
+    timer<lowres_clock> _drain_timer;
+    metrics::metric_groups _metrics;
+private:
+    void drain();
+public:
+    cpu_profiler();
+    ~cpu_profiler();
+    static int signal_number() { return SIGRTMIN + 2; }
+    // Samples per second of CPU time, 0 stops sampling
+    void set_rate(unsigned hz);
+    unsigned rate() const noexcept { return _rate; }
+    // Called from the signal handler, with the interrupted context
+    void on_signal(const std::type_info* task_type, unsigned sg, void* ucontext) noexcept;
+    void collect(cpu_profile& profile, bool reset);
+};
+
+}
+}
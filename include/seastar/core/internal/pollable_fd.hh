@@ -94,6 +94,7 @@ class pollable_fd_state {
     int events_requested = 0; // wanted by pollin/pollout promises
     int events_epoll = 0;     // installed in epoll
     int events_known = 0;     // returned from epoll
+    bool received_ahead = false; // the backend may have read data ahead of recv_some()
 
     friend class reactor;
     friend class pollable_fd;
@@ -107,6 +108,8 @@ class pollable_fd_state {
     future<> write_all(const uint8_t* buffer, size_t size);
     future<size_t> write_some(net::packet& p);
     future<> write_all(net::packet& p);
+    future<size_t> write_some_zerocopy(net::packet& p);
+    future<> write_all_zerocopy(net::packet& p);
     future<> readable();
     future<> writeable();
     future<> readable_or_writeable();
@@ -115,6 +118,8 @@ class pollable_fd_state {
     future<temporary_buffer<char>> recv_some(internal::buffer_allocator* ba);
     future<size_t> sendmsg(struct msghdr *msg);
     future<size_t> recvmsg(struct msghdr *msg);
+    future<size_t> sendmmsg(struct mmsghdr *msgvec, size_t vlen);
+    future<size_t> recvmmsg(struct mmsghdr *msgvec, size_t vlen);
     future<size_t> sendto(socket_address addr, const void* buf, size_t len);
     future<> poll_rdhup();
 
@@ -163,6 +168,14 @@ class pollable_fd {
     future<> write_all(net::packet& p) {
         return _s->write_all(p);
     }
+    /// Like write_all(), but lets the kernel transmit straight from the
+    /// packet's buffers when the reactor backend supports it (io_uring on
+    /// Linux 6.1 or later), copying otherwise. The buffers are kept alive
+    /// until the kernel releases them, which may be after the returned
+    /// future resolves; they must not be modified in the meantime.
+    future<> write_all_zerocopy(net::packet& p) {
+        return _s->write_all_zerocopy(p);
+    }
     future<> readable() {
         return _s->readable();
     }
@@ -187,10 +200,28 @@ class pollable_fd {
     future<size_t> recvmsg(struct msghdr *msg) {
         return _s->recvmsg(msg);
     }
+    /// Sends up to \c vlen messages with a single system call.
+    ///
+    /// \return the number of messages sent, which may be less than \c vlen
+    future<size_t> sendmmsg(struct mmsghdr *msgvec, size_t vlen) {
+        return _s->sendmmsg(msgvec, vlen);
+    }
+    /// Receives up to \c vlen messages with a single system call, waiting
+    /// until at least one message is available.
+    ///
+    /// \return the number of messages received, the length of each is stored
+    ///         in the \c msg_len field of the corresponding \c mmsghdr
+    future<size_t> recvmmsg(struct mmsghdr *msgvec, size_t vlen) {
+        return _s->recvmmsg(msgvec, vlen);
+    }
     future<size_t> sendto(socket_address addr, const void* buf, size_t len) {
         return _s->sendto(addr, buf, len);
     }
     file_desc& get_file_desc() const { return _s->fd; }
+    /// Tells whether the reactor backend may have taken data off the socket
+    /// ahead of recv_some() (io_uring multishot receives), in which case
+    /// reading the socket some other way could miss it
+    bool may_have_received_ahead() const noexcept { return _s->received_ahead; }
     using shutdown_kernel_only = bool_class<struct shutdown_kernel_only_tag>;
     void shutdown(int how, shutdown_kernel_only kernel_only = shutdown_kernel_only::yes);
     void close() { _s.reset(); }
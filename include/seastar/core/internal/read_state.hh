@@ -45,6 +45,13 @@ struct file_read_state {
     , _front(front)
     , _iref(intent) {}
 
+    file_read_state(tmp_buf_type buf, uint64_t offset, uint64_t front, size_t to_read, io_intent* intent)
+    : buf(std::move(buf))
+    , _offset(offset)
+    , _to_read(to_read)
+    , _front(front)
+    , _iref(intent) {}
+
     bool done() const {
         return eof || pos >= _to_read;
     }
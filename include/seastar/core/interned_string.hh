@@ -0,0 +1,210 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <seastar/core/sstring.hh>
+#include <seastar/util/modules.hh>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include <fmt/core.h>
+#endif
+
+namespace seastar {
+
+/// \cond internal
+namespace internal {
+
+// Precedes the characters of every string of a string_pool
+struct interned_string_header {
+    uint32_t size;
+    uint32_t hash;
+};
+
+}
+/// \endcond
+
+SEASTAR_MODULE_EXPORT_BEGIN
+
+class string_pool;
+
+/// \brief Handle to a string stored in a \ref string_pool
+///
+/// A pointer sized, trivially copyable handle, meant as a compact key for
+/// containers with many entries. A pool stores every distinct string once,
+/// so two handles of the same pool are equal if and only if they point to
+/// the same storage: equality and hashing are O(1) whatever the length of
+/// the string (the hash is computed once, when the string is interned).
+/// Handles must not outlive their pool, and comparing handles of different
+/// pools for equality is meaningless.
+///
+/// The default constructed handle is the empty string.
+class interned_string {
+    using header = internal::interned_string_header;
+    const header* _h = nullptr;
+
+    explicit interned_string(const header* h) noexcept : _h(h) {}
+    friend class string_pool;
+public:
+    interned_string() noexcept = default;
+
+    const char* data() const noexcept {
+        return _h ? reinterpret_cast<const char*>(_h + 1) : "";
+    }
+    size_t size() const noexcept {
+        return _h ? _h->size : 0;
+    }
+    bool empty() const noexcept {
+        return !_h;
+    }
+    std::string_view view() const noexcept {
+        return {data(), size()};
+    }
+    operator std::string_view() const noexcept {
+        return view();
+    }
+    /// Returns a copy of the string
+    sstring str() const {
+        return sstring(data(), size());
+    }
+    explicit operator sstring() const {
+        return str();
+    }
+    size_t hash() const noexcept {
+        return _h ? _h->hash : 0;
+    }
+
+    bool operator==(const interned_string& o) const noexcept {
+        return _h == o._h;
+    }
+    /// Orders handles like their strings
+    std::strong_ordering operator<=>(const interned_string& o) const noexcept {
+        return _h == o._h ? std::strong_ordering::equal : view() <=> o.view();
+    }
+};
+
+/// \brief Arena of interned strings
+///
+/// Stores strings back to back in 64KB chunks, each preceded by an 8 byte
+/// header with its size and hash, and indexes them with an open addressing
+/// table of pointers. A string of n characters costs n + 8 bytes, rounded
+/// up to 4, plus 11 to 22 bytes of table, with no per-string allocation;
+/// an sstring costs 16 bytes, plus an allocation for more than 15
+/// characters, before any container overhead.
+///
+/// Strings are only freed all together, by clear() or when the pool is
+/// destroyed, so a pool suits keys from a bounded set (header names, metric
+/// labels) or keys that share a lifetime. Like everything shard local, a
+/// pool must only be used on the shard that created it; local() is a pool
+/// for the current shard.
+class string_pool {
+    using header = internal::interned_string_header;
+
+    static constexpr size_t chunk_size = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> _chunks;
+    char* _pos = nullptr;
+    size_t _left = 0;
+    size_t _chunk_memory = 0;
+    // Power of two sized, empty slots are null
+    std::vector<const header*> _table;
+    size_t _size = 0;
+private:
+    static uint32_t hash_of(std::string_view s) noexcept;
+    const header* store(std::string_view s, uint32_t hash);
+    void grow();
+public:
+    string_pool() = default;
+    string_pool(string_pool&&) noexcept = default;
+    string_pool& operator=(string_pool&&) noexcept = default;
+
+    /// Returns the handle of the string, storing it if it is new
+    interned_string intern(std::string_view s);
+
+    /// Returns the handle of the string if it was interned already
+    std::optional<interned_string> find(std::string_view s) const noexcept;
+
+    /// Returns the number of distinct strings
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    /// Returns the memory held by the pool, in bytes
+    size_t memory_used() const noexcept {
+        return _chunk_memory + _table.capacity() * sizeof(const header*);
+    }
+
+    /// Frees all the strings, invalidating all handles
+    void clear() noexcept;
+
+    /// \brief Returns the pool of the current shard
+    ///
+    /// The pool is shared by every user on the shard and lives as long as
+    /// the shard; it is never cleared, so every string interned in it stays
+    /// until the shard exits. Only intern strings from a bounded set here.
+    /// Keys that keep changing (user supplied names, per request values)
+    /// would grow it without bound and belong in a string_pool owned by the
+    /// code that can clear() it.
+    static string_pool& local() noexcept;
+};
+
+/// \brief Interns a string in the pool of the current shard
+///
+/// The string is never freed, see string_pool::local().
+inline interned_string intern(std::string_view s) {
+    return string_pool::local().intern(s);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const interned_string& s) {
+    return os << s.view();
+}
+
+SEASTAR_MODULE_EXPORT_END
+
+}
+
+namespace std {
+
+SEASTAR_MODULE_EXPORT
+template <>
+struct hash<seastar::interned_string> {
+    size_t operator()(const seastar::interned_string& s) const noexcept {
+        return s.hash();
+    }
+};
+
+}
+
+SEASTAR_MODULE_EXPORT
+template <>
+struct fmt::formatter<seastar::interned_string> : public fmt::formatter<std::string_view> {
+    template <typename FormatContext>
+    auto format(const seastar::interned_string& s, FormatContext& ctx) const {
+        return fmt::formatter<std::string_view>::format(s.view(), ctx);
+    }
+};
@@ -26,6 +26,7 @@
 #include <seastar/util/modules.hh>
 #ifndef SEASTAR_MODULE
 #include <boost/container/small_vector.hpp>
+#include <chrono>
 #endif
 
 namespace seastar {
@@ -40,6 +41,9 @@ namespace seastar {
 ///
 /// If no intent is provided, then the request is processed till its
 /// completion be it success or error
+///
+/// The intent may also carry a deadline for the requests pinned to it,
+/// see set_deadline()
 SEASTAR_MODULE_EXPORT
 class io_intent {
     struct intents_for_queue {
@@ -72,6 +76,7 @@ class io_intent {
 
     boost::container::small_vector<intents_for_queue, 1> _intents;
     references _refs;
+    std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::time_point::max();
     friend internal::intent_reference::intent_reference(io_intent*) noexcept;
 
 public:
@@ -81,7 +86,7 @@ class io_intent {
     io_intent(const io_intent&) = delete;
     io_intent& operator=(const io_intent&) = delete;
     io_intent& operator=(io_intent&&) = delete;
-    io_intent(io_intent&& o) noexcept : _intents(std::move(o._intents)), _refs(std::move(o._refs)) {
+    io_intent(io_intent&& o) noexcept : _intents(std::move(o._intents)), _refs(std::move(o._refs)), _deadline(o._deadline) {
         for (auto&& r : _refs.list) {
             r._intent = this;
         }
@@ -95,6 +100,18 @@ class io_intent {
         _intents.clear();
     }
 
+    /// Sets the time by which the requests issued with this intent from
+    /// now on are expected to complete. IO queues running with deadline
+    /// dispatch (the --io-deadline-dispatch option) dispatch the requests
+    /// of a class earliest deadline first, other queues ignore it.
+    void set_deadline(std::chrono::steady_clock::time_point deadline) noexcept {
+        _deadline = deadline;
+    }
+
+    std::chrono::steady_clock::time_point deadline() const noexcept {
+        return _deadline;
+    }
+
     /// @private
     internal::cancellable_queue& find_or_create_cancellable_queue(unsigned qid, io_priority_class_id cid) {
         for (auto&& i : _intents) {
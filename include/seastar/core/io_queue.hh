@@ -23,6 +23,7 @@
 
 #ifndef SEASTAR_MODULE
 #include <boost/container/static_vector.hpp>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -111,8 +112,14 @@ class io_queue {
     const std::chrono::milliseconds _stall_threshold_min;
     std::chrono::milliseconds _stall_threshold;
 
+    // Capacity estimator window
+    std::chrono::duration<double> _exec_time_sum = std::chrono::duration<double>(0);
+    uint64_t _exec_completions = 0;
+    bool _backlogged = false;
+
     void update_flow_ratio() noexcept;
     void lower_stall_threshold() noexcept;
+    void update_capacity_estimate() noexcept;
 
     metrics::metric_groups _metric_groups;
 public:
@@ -146,6 +153,12 @@ class io_queue {
         double flow_ratio_ema_factor = 0.95;
         double flow_ratio_backpressure_threshold = 1.1;
         std::chrono::milliseconds stall_threshold = std::chrono::milliseconds(100);
+        bool deadline_dispatch = false;
+        // Scale the disk capacity figures above according to the observed
+        // completion latency, within [min, max] of their nominal values
+        bool adaptive_capacity = false;
+        double capacity_factor_min = 0.1;
+        double capacity_factor_max = 2.0;
     };
 
     io_queue(io_group_ptr group, internal::io_sink& sink);
@@ -222,8 +235,23 @@ class io_group {
     util::spinlock _lock;
     const shard_id _allocated_on;
 
+    // Closed-loop estimate of the disk capacity relative to the configured
+    // one. Queues of all shards feed their completion latencies in, see
+    // update_capacity()
+    struct capacity_estimate {
+        std::atomic<double> factor = 1.0;
+        std::chrono::duration<double> target = std::chrono::duration<double>(0);
+        std::chrono::duration<double> exec_time_sum = std::chrono::duration<double>(0);
+        uint64_t completions = 0;
+        bool backlogged = false;
+        io_queue::clock_type::time_point updated = io_queue::clock_type::now();
+    };
+    capacity_estimate _capacity;
+
     static fair_group::config make_fair_group_config(const io_queue::config& qcfg) noexcept;
     priority_class_data& find_or_create_class(internal::priority_class pc);
+    void update_capacity(std::chrono::duration<double> exec_time_sum, uint64_t completions, bool backlogged) noexcept;
+    double capacity_factor() const noexcept { return _capacity.factor.load(std::memory_order_relaxed); }
 };
 
 inline const io_queue::config& io_queue::get_config() const noexcept {
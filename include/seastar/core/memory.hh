@@ -163,7 +163,8 @@ numa_layout merge(numa_layout one, numa_layout two);
 
 internal::numa_layout configure(std::vector<resource::memory> m, bool mbind,
         bool transparent_hugepages,
-        std::optional<std::string> hugetlbfs_path = {});
+        std::optional<std::string> hugetlbfs_path = {},
+        size_t explicit_hugepage_size = 0);
 
 void configure_minimal();
 
@@ -283,11 +284,17 @@ class statistics;
 /// Capture a snapshot of memory allocation statistics for this lcore.
 statistics stats();
 
+/// Number of objects owned by lcore \c cpu that this lcore has freed.
+///
+/// Only frees performed by reactor threads are accounted for.
+uint64_t cross_cpu_frees_to(unsigned cpu);
+
 /// Memory allocation statistics.
 class statistics {
     uint64_t _mallocs;
     uint64_t _frees;
     uint64_t _cross_cpu_frees;
+    uint64_t _cross_cpu_free_batches;
     size_t _total_memory;
     size_t _free_memory;
     uint64_t _reclaims;
@@ -297,16 +304,23 @@ class statistics {
     uint64_t _foreign_mallocs;
     uint64_t _foreign_frees;
     uint64_t _foreign_cross_frees;
+
+    size_t _hugepage_memory;
+    uint64_t _span_refills;
+    uint64_t _span_refills_same_hugepage;
 private:
-    statistics(uint64_t mallocs, uint64_t frees, uint64_t cross_cpu_frees,
+    statistics(uint64_t mallocs, uint64_t frees, uint64_t cross_cpu_frees, uint64_t cross_cpu_free_batches,
             uint64_t total_memory, uint64_t free_memory, uint64_t reclaims,
             uint64_t large_allocs, uint64_t failed_allocs,
-            uint64_t foreign_mallocs, uint64_t foreign_frees, uint64_t foreign_cross_frees)
-        : _mallocs(mallocs), _frees(frees), _cross_cpu_frees(cross_cpu_frees)
+            uint64_t foreign_mallocs, uint64_t foreign_frees, uint64_t foreign_cross_frees,
+            uint64_t hugepage_memory, uint64_t span_refills, uint64_t span_refills_same_hugepage)
+        : _mallocs(mallocs), _frees(frees), _cross_cpu_frees(cross_cpu_frees), _cross_cpu_free_batches(cross_cpu_free_batches)
         , _total_memory(total_memory), _free_memory(free_memory), _reclaims(reclaims)
         , _large_allocs(large_allocs), _failed_allocs(failed_allocs)
         , _foreign_mallocs(foreign_mallocs), _foreign_frees(foreign_frees)
-        , _foreign_cross_frees(foreign_cross_frees) {}
+        , _foreign_cross_frees(foreign_cross_frees)
+        , _hugepage_memory(hugepage_memory), _span_refills(span_refills)
+        , _span_refills_same_hugepage(span_refills_same_hugepage) {}
 public:
     /// Total number of memory allocations calls since the system was started.
     uint64_t mallocs() const { return _mallocs; }
@@ -315,6 +329,10 @@ class statistics {
     /// Total number of memory deallocations that occured on a different lcore
     /// than the one on which they were allocated.
     uint64_t cross_cpu_frees() const { return _cross_cpu_frees; }
+    /// Number of batches in which this lcore handed cross cpu frees over to
+    /// the lcores owning the memory. Compare with cross_cpu_frees() to see
+    /// how well they are batched.
+    uint64_t cross_cpu_free_batches() const { return _cross_cpu_free_batches; }
     /// Total number of objects which were allocated but not freed.
     size_t live_objects() const { return mallocs() - frees(); }
     /// Total free memory (in bytes)
@@ -336,6 +354,14 @@ class statistics {
     uint64_t foreign_frees() const { return _foreign_frees; }
     /// Number of foreign frees on reactor threads
     uint64_t foreign_cross_frees() const { return _foreign_cross_frees; }
+    /// Memory (in bytes) backed by hugetlbfs or explicitly reserved huge pages.
+    /// Transparent huge pages are not accounted for.
+    size_t hugepage_memory() const { return _hugepage_memory; }
+    /// Number of spans taken from the page allocator to refill small object pools
+    uint64_t span_refills() const { return _span_refills; }
+    /// Number of span refills which landed on the same huge page as the
+    /// previous span of the same pool
+    uint64_t span_refills_same_hugepage() const { return _span_refills_same_hugepage; }
     friend statistics stats();
 };
 
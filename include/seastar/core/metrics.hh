@@ -340,10 +340,7 @@ class metric_value {
             : u(d), _type(t) {
     }
 
-    metric_value& operator+=(const metric_value& c) {
-        *this = *this + c;
-        return *this;
-    }
+    metric_value& operator+=(const metric_value& c);
 
     metric_value operator+(const metric_value& c);
     const histogram& get_histogram() const {
@@ -75,7 +75,8 @@ struct histogram {
      * \brief Addition assigning a historgram
      *
      * The histogram must match the buckets upper bounds
-     * or an exception will be thrown
+     * or an exception will be thrown. One of the histograms may have fewer
+     * buckets, when it ends with the last non-empty one.
      */
     histogram& operator+=(const histogram& h);
 
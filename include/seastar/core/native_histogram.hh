@@ -0,0 +1,207 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <seastar/core/bitops.hh>
+#include <seastar/core/metrics_types.hh>
+#include <seastar/util/modules.hh>
+#endif
+
+namespace seastar {
+namespace metrics {
+
+SEASTAR_MODULE_EXPORT_BEGIN
+
+/*!
+ * \brief Per-shard log-linear histogram, cheap enough to record every event
+ *
+ * Covers the whole uint64_t range with a fixed number of buckets, so it
+ * needs no Min/Max tuning and never allocates: each power of two
+ * [2^n, 2^(n+1)) is split linearly into 2^Schema buckets, like an HDR
+ * histogram with Schema bits of precision (the relative error is below
+ * 2^-Schema). Values up to 2^Schema share the first bucket. With the
+ * default schema that is 248 buckets, about 2KB.
+ *
+ * add() is a bucket index computation (one count-leading-zeros and a few
+ * shifts) and three plain increments. There is no locking and there are no
+ * atomics: an instance belongs to a single shard, and the metrics layer
+ * merges the per-shard histograms at scrape time (see
+ * metric_definition_impl::aggregate()).
+ *
+ * The layout is the one of internal::approximate_exponential_histogram
+ * with Min = Precision = 2^Schema, so the exported histogram maps to
+ * Prometheus native histogram buckets of the same schema. Typical use:
+ *
+ *     sm::make_histogram("latency", sm::description("..."), [this] {
+ *         return _latency.to_metrics_histogram();
+ *     }).aggregate({sm::shard_label})
+ *
+ * The same snapshot can back sm::make_summary(); the quantiles are then
+ * computed from the (merged) buckets when the metrics are exported.
+ */
+template <unsigned Schema = 2>
+class native_histogram {
+    static_assert(Schema <= 8, "Prometheus native histograms support schemas up to 8");
+    static constexpr uint64_t sub_buckets = uint64_t(1) << Schema;
+    static constexpr uint64_t sub_bucket_mask = sub_buckets - 1;
+public:
+    static constexpr size_t num_buckets = (64 - Schema) << Schema;
+private:
+    std::array<uint64_t, num_buckets> _buckets = {};
+    uint64_t _count = 0;
+    uint64_t _sum = 0;
+public:
+    /*!
+     * \brief Returns the index of the bucket holding the value
+     */
+    static constexpr size_t bucket_index(uint64_t v) noexcept {
+        v = std::max(v, sub_buckets);
+        unsigned e = log2floor(v);
+        return (size_t(e - Schema) << Schema) + ((v >> (e - Schema)) & sub_bucket_mask);
+    }
+
+    /*!
+     * \brief Returns the smallest value held by the bucket
+     *
+     * The first bucket also holds all the values below it.
+     */
+    static constexpr uint64_t bucket_lower_bound(size_t i) noexcept {
+        unsigned e = i >> Schema;
+        return (sub_buckets << e) + ((i & sub_bucket_mask) << e);
+    }
+
+    /*!
+     * \brief Returns the largest value held by the bucket
+     */
+    static constexpr uint64_t bucket_upper_bound(size_t i) noexcept {
+        return i + 1 == num_buckets ? std::numeric_limits<uint64_t>::max() : bucket_lower_bound(i + 1) - 1;
+    }
+
+    /*!
+     * \brief Records a value
+     */
+    void add(uint64_t v) noexcept {
+        _buckets[bucket_index(v)]++;
+        _count++;
+        _sum += v;
+    }
+
+    /*!
+     * \brief returns the total number of values recorded
+     */
+    uint64_t count() const noexcept {
+        return _count;
+    }
+
+    /*!
+     * \brief returns the sum of the values recorded
+     */
+    uint64_t sum() const noexcept {
+        return _sum;
+    }
+
+    /*!
+     * \brief returns the count in the given bucket
+     */
+    uint64_t get(size_t bucket) const noexcept {
+        return _buckets[bucket];
+    }
+
+    void clear() noexcept {
+        _buckets = {};
+        _count = 0;
+        _sum = 0;
+    }
+
+    /*!
+     * \brief merge a histogram to the current one.
+     */
+    native_histogram& merge(const native_histogram& o) noexcept {
+        for (size_t i = 0; i < num_buckets; i++) {
+            _buckets[i] += o._buckets[i];
+        }
+        _count += o._count;
+        _sum += o._sum;
+        return *this;
+    }
+
+    /*!
+     * \brief get a histogram quantile
+     *
+     * Returns the upper bound of the bucket holding the value at the
+     * given quantile, so the estimate errs on the high side by less than
+     * a bucket width. It will return 0 if the histogram is empty.
+     */
+    uint64_t quantile(double q) const noexcept {
+        if (!_count) {
+            return 0;
+        }
+        auto rank = std::max<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * _count), 1);
+        uint64_t elements = 0;
+        for (size_t i = 0; i < num_buckets; i++) {
+            elements += _buckets[i];
+            if (elements >= rank) {
+                return bucket_upper_bound(i);
+            }
+        }
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    /*!
+     * \brief Snapshot of the histogram for the metrics layer
+     *
+     * Buckets are cumulative and end with the last non-empty one, so the
+     * snapshots of all shards have the same bucket bounds up to their
+     * lengths and can be added to each other.
+     */
+    histogram to_metrics_histogram() const {
+        histogram res;
+        res.sample_count = _count;
+        res.sample_sum = _sum;
+        // Bucket i is exported as the native bucket Schema * 2^Schema + 1 + i,
+        // as approximate_exponential_histogram does
+        res.native_histogram = native_histogram_info{int32_t(Schema), int32_t(Schema * sub_buckets + 1)};
+        size_t used = num_buckets;
+        while (used && !_buckets[used - 1]) {
+            used--;
+        }
+        res.buckets.resize(used);
+        uint64_t cumulative_count = 0;
+        for (size_t i = 0; i < used; i++) {
+            cumulative_count += _buckets[i];
+            res.buckets[i].count = cumulative_count;
+            res.buckets[i].upper_bound = bucket_upper_bound(i);
+        }
+        return res;
+    }
+};
+
+SEASTAR_MODULE_EXPORT_END
+
+}
+}
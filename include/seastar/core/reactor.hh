@@ -69,6 +69,7 @@
 #include <cstring>
 #include <memory>
 #include <string_view>
+#include <typeinfo>
 #include <unordered_map>
 #include <vector>
 #include <unistd.h>
@@ -121,6 +122,7 @@ namespace internal {
 
 class reactor_stall_sampler;
 class cpu_stall_detector;
+class cpu_profiler;
 class buffer_allocator;
 class priority_class;
 class poller;
@@ -139,6 +141,8 @@ void at_exit(noncopyable_function<future<> ()> func);
 class io_queue;
 SEASTAR_MODULE_EXPORT
 class io_intent;
+SEASTAR_MODULE_EXPORT
+struct cpu_profile;
 
 class io_completion : public kernel_completion {
 public:
@@ -201,6 +205,11 @@ class reactor {
         uint64_t fstream_read_bytes_blocked = 0;
         uint64_t fstream_read_aheads_discarded = 0;
         uint64_t fstream_read_ahead_discarded_bytes = 0;
+        uint64_t uring_buffer_ring_recvs = 0;
+        uint64_t uring_buffer_ring_copies = 0;
+        uint64_t uring_buffer_ring_exhausted = 0;
+        uint64_t uring_fixed_file_requests = 0;
+        uint64_t uring_fixed_buffer_requests = 0;
     };
     /// Scheduling statistics.
     struct sched_stats {
@@ -250,6 +259,7 @@ class reactor {
     uint64_t _polls = 0;
     metrics::internal::time_estimated_histogram _stalls_histogram;
     std::unique_ptr<internal::cpu_stall_detector> _cpu_stall_detector;
+    std::unique_ptr<internal::cpu_profiler> _cpu_profiler;
 
     timer<>::set_t _timers;
     timer<>::set_t::timer_list_t _expired_timers;
@@ -297,6 +307,9 @@ class reactor {
     task_queue_list _activating_task_queues;
     task_queue* _at_destroy_tasks;
     task* _current_task = nullptr;
+    // Type of the task run by run_tasks(), for the CPU profiler. Unlike
+    // _current_task, it is safe to look at after the task was disposed.
+    const std::type_info* _current_task_type = nullptr;
     /// Handler that will be called when there is no task to execute on cpu.
     /// It represents a low priority work.
     ///
@@ -341,6 +354,7 @@ class reactor {
 private:
     static std::chrono::nanoseconds calculate_poll_time();
     static void block_notifier(int);
+    static void cpu_profiler_notifier(int, siginfo_t*, void*);
     bool flush_pending_aio();
     steady_clock_type::time_point next_pending_aio() const noexcept;
     bool reap_kernel_completions();
@@ -673,6 +687,7 @@ template <typename Func>
 
     future<struct statfs> fstatfs(int fd) noexcept;
     friend future<shared_ptr<file_impl>> make_file_impl(int fd, file_open_options options, int flags, struct stat st) noexcept;
+    friend temporary_buffer<char> allocate_dma_buffer(size_t size, size_t alignment);
 public:
     future<> readable(pollable_fd_state& fd);
     future<> writeable(pollable_fd_state& fd);
@@ -692,6 +707,12 @@ template <typename Func>
     void set_bypass_fsync(bool value);
     void update_blocked_reactor_notify_ms(std::chrono::milliseconds ms);
     std::chrono::milliseconds get_blocked_reactor_notify_ms() const;
+    /// Sets the rate at which the CPU profiler samples this shard, in
+    /// samples per second of CPU time, 0 stops it. See set_cpu_profiler_rate().
+    void set_cpu_profiler_rate(unsigned hz);
+    unsigned get_cpu_profiler_rate() const noexcept;
+    /// Adds the samples the CPU profiler took on this shard to \c profile
+    void collect_cpu_profile(cpu_profile& profile, bool reset);
 
     class test {
     public:
@@ -42,6 +42,12 @@ struct reactor_config {
     bool strict_o_direct = true;
     bool bypass_fsync = false;
     bool no_poll_aio = false;
+    unsigned uring_buffer_ring_entries = 0;
+    size_t uring_buffer_ring_buffer_size = 16384;
+    unsigned uring_buffer_ring_socket_share = 0;
+    unsigned uring_fixed_files = 0;
+    size_t uring_fixed_buffers_size = 0;
+    bool timer_wheel = false;
 };
 /// \endcond
 
@@ -90,6 +96,22 @@ struct reactor_options : public program_options::option_group {
     ///
     /// Default: infinite (detection is OFF)
     program_options::value<unsigned> io_completion_notify_ms;
+    /// \brief Dispatch the IO requests of each class earliest deadline first
+    ///
+    /// Deadlines are set with \ref io_intent::set_deadline(), requests
+    /// without one are treated as due in 100ms. Shares between classes are
+    /// not affected.
+    ///
+    /// Default: false
+    program_options::value<bool> io_deadline_dispatch;
+    /// \brief Adjust the disk capacity to the observed IO execution time
+    ///
+    /// The rates from the IO properties are scaled down when requests take
+    /// much longer than the IO latency goal to execute, and up when requests
+    /// wait in the queue while the disk executes them well under the goal.
+    ///
+    /// Default: false
+    program_options::value<bool> io_adaptive_capacity;
     /// \brief Maximum number of task backlog to allow.
     ///
     /// When the number of tasks grow above this, we stop polling (e.g. I/O)
@@ -109,6 +131,11 @@ struct reactor_options : public program_options::option_group {
     ///
     /// Default: \p true.
     program_options::value<bool> blocked_reactor_report_format_oneline;
+    /// \brief Sample the CPU usage of every shard this many times per second
+    /// of CPU time, aggregated by scheduling group, task type and backtrace.
+    ///
+    /// See seastar::collect_cpu_profile(). Default: 0 (disabled).
+    program_options::value<unsigned> cpu_profiler_rate;
     /// \brief Allow using buffered I/O if DMA is not available (reduces performance).
     program_options::value<> relaxed_dma;
     /// \brief Use the Linux NOWAIT AIO feature, which reduces reactor stalls due
@@ -180,6 +207,61 @@ struct reactor_options : public program_options::option_group {
     ///
     /// \see max_networking_io_control_blocks
     program_options::value<unsigned> reserve_io_control_blocks;
+    /// \brief Number of buffers in the per-shard io_uring provided buffer ring.
+    ///
+    /// When non-zero, sockets read through the \p io_uring reactor backend
+    /// (see \ref reactor_backend) use multishot receives which take their
+    /// buffers from a shared per-shard ring, rather than each pending read
+    /// holding its own buffer. Rounded up to a power of two. Requires Linux
+    /// 6.0 or later.
+    ///
+    /// Default: 0 (disabled).
+    program_options::value<unsigned> uring_buffer_ring_entries;
+    /// \brief Size of each buffer in the io_uring provided buffer ring.
+    ///
+    /// \see uring_buffer_ring_entries
+    ///
+    /// Default: 16384.
+    program_options::value<unsigned> uring_buffer_ring_buffer_size;
+    /// \brief Number of buffers of the io_uring provided buffer ring a single
+    /// socket may hold.
+    ///
+    /// Buffers stay out of the ring until the application releases them, so
+    /// a slow reader could otherwise drain the ring and make every other
+    /// socket fall back to private buffers. Once a socket holds this many
+    /// buffers, it stops receiving from the ring and reads into private
+    /// buffers, one per read, leaving the rest of its data in the socket
+    /// buffer until it releases some.
+    ///
+    /// \see uring_buffer_ring_entries
+    ///
+    /// Default: 0 (a quarter of the ring).
+    program_options::value<unsigned> uring_buffer_ring_socket_share;
+    /// \brief Number of slots in the per-shard io_uring fixed-file table.
+    ///
+    /// Files opened with \ref file_open_options::fixed_file are registered
+    /// in this table, sparing the kernel a file table lookup and reference
+    /// count update on every request. Only valid for the \p io_uring reactor
+    /// backend; requires Linux 5.19 or later.
+    ///
+    /// Default: 0 (disabled).
+    program_options::value<unsigned> uring_fixed_files;
+    /// \brief Size of the per-shard io_uring registered buffer arena (ex: 64M).
+    ///
+    /// Buffers obtained from \ref allocate_dma_buffer() are carved from
+    /// this arena, which is registered with the kernel once; disk reads and
+    /// writes into it do not need to pin and map the user pages on every
+    /// request. Only valid for the \p io_uring reactor backend.
+    ///
+    /// Default: unset (disabled).
+    program_options::value<std::string> uring_fixed_buffers_size;
+    /// \brief Keep steady_clock and lowres_clock timers in a hierarchical
+    /// timing wheel instead of the default timer_set.
+    ///
+    /// Arming and cancelling stay O(1) and expiry re-inserts fewer
+    /// not-yet-expired timers, which pays off with millions of timers
+    /// per shard. See \ref timer_wheel.
+    program_options::value<> timer_wheel;
     /// \brief Enable seastar heap profiling.
     ///
     /// Allocations will be sampled every N bytes on average. Zero means off.
@@ -0,0 +1,719 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <boost/intrusive/list.hpp>
+#include <boost/intrusive/unordered_set.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include <seastar/core/future.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/memory.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/core/timer-set.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/util/assert.hh>
+#include <seastar/util/modules.hh>
+#include <seastar/util/noncopyable_function.hh>
+#endif
+
+namespace seastar {
+
+/*
+ * A cache of intrusive entries, one instance per shard, and a router that
+ * sends every key to the shard owning it. Shards share nothing, so a shard
+ * accesses its cache without locks or atomics.
+ *
+ * The cache does not allocate entries: the user creates them (with new, a
+ * slab_allocator, ...), inserts them and gets them back through a disposer
+ * when they leave the cache, erased, expired or evicted. Entries derive from
+ * cache_entry<Eviction>, which holds the hooks of the index, of the eviction
+ * policy and of the expiry timers, and provide a key() equality comparable
+ * with the keys they are looked up with.
+ *
+ * Eviction policies:
+ *  - no_eviction: the cache is bounded by other means, e.g. a slab_allocator
+ *    which evicts through local_cache::erase() when it runs out of pages;
+ *  - lru_eviction: least recently used;
+ *  - clock_eviction: second chance FIFO, which unlike LRU does not move
+ *    entries on hits;
+ *  - s3fifo_eviction: S3-FIFO, a small FIFO filtering out the entries which
+ *    are not accessed again before they reach its tail, a CLOCK main queue
+ *    for the others and a ghost of recently filtered keys, which are admitted
+ *    straight to the main queue if they come back.
+ */
+
+SEASTAR_MODULE_EXPORT_BEGIN
+
+/// Why an entry left a \ref local_cache
+enum class cache_removal_cause {
+    erased,     ///< removed by erase(), clear(), or replaced by insert()
+    expired,    ///< its time to live elapsed
+    evicted,    ///< removed to make room, or under memory pressure
+};
+
+/// Does not evict: the cache grows until entries are erased
+class no_eviction {
+public:
+    struct entry_state {};
+
+    void insert(entry_state&, size_t) noexcept {}
+    void touch(entry_state&) noexcept {}
+    void erase(entry_state&) noexcept {}
+    entry_state* evict() noexcept { return nullptr; }
+    void clear() noexcept {}
+};
+
+/// Evicts the least recently inserted or found entry
+class lru_eviction {
+public:
+    struct entry_state {
+        boost::intrusive::list_member_hook<> _lru_link;
+    };
+private:
+    boost::intrusive::list<entry_state,
+        boost::intrusive::member_hook<entry_state, boost::intrusive::list_member_hook<>, &entry_state::_lru_link>,
+        boost::intrusive::constant_time_size<false>> _lru;
+public:
+    void insert(entry_state& e, size_t) noexcept {
+        _lru.push_front(e);
+    }
+    void touch(entry_state& e) noexcept {
+        _lru.erase(_lru.iterator_to(e));
+        _lru.push_front(e);
+    }
+    void erase(entry_state& e) noexcept {
+        _lru.erase(_lru.iterator_to(e));
+    }
+    entry_state* evict() noexcept {
+        if (_lru.empty()) {
+            return nullptr;
+        }
+        auto& e = _lru.back();
+        _lru.pop_back();
+        return &e;
+    }
+    void clear() noexcept {
+        _lru.clear();
+    }
+};
+
+/// Evicts in insertion order, except for the entries found since they were
+/// last considered, which get another round
+class clock_eviction {
+public:
+    struct entry_state {
+        boost::intrusive::list_member_hook<> _clock_link;
+        bool _referenced = false;
+    };
+private:
+    boost::intrusive::list<entry_state,
+        boost::intrusive::member_hook<entry_state, boost::intrusive::list_member_hook<>, &entry_state::_clock_link>,
+        boost::intrusive::constant_time_size<false>> _fifo;
+public:
+    void insert(entry_state& e, size_t) noexcept {
+        e._referenced = false;
+        _fifo.push_front(e);
+    }
+    void touch(entry_state& e) noexcept {
+        e._referenced = true;
+    }
+    void erase(entry_state& e) noexcept {
+        _fifo.erase(_fifo.iterator_to(e));
+    }
+    entry_state* evict() noexcept {
+        while (!_fifo.empty()) {
+            auto& e = _fifo.back();
+            _fifo.pop_back();
+            if (!e._referenced) {
+                return &e;
+            }
+            e._referenced = false;
+            _fifo.push_front(e);
+        }
+        return nullptr;
+    }
+    void clear() noexcept {
+        _fifo.clear();
+    }
+};
+
+/// S3-FIFO (Yang et al., "FIFO queues are all you need for cache eviction",
+/// SOSP '23), with queue sizes in entries
+class s3fifo_eviction {
+public:
+    struct entry_state {
+        boost::intrusive::list_member_hook<> _queue_link;
+        uint32_t _fingerprint = 0;
+        uint8_t _freq = 0;
+        bool _main = false;
+    };
+private:
+    using queue_type = boost::intrusive::list<entry_state,
+        boost::intrusive::member_hook<entry_state, boost::intrusive::list_member_hook<>, &entry_state::_queue_link>,
+        boost::intrusive::constant_time_size<true>>;
+    static constexpr uint8_t max_freq = 3;
+    // Percentage of the entries the small queue may hold before it is
+    // evicted from
+    static constexpr size_t small_percent = 10;
+
+    queue_type _small;
+    queue_type _main;
+    // Fingerprints of the keys recently evicted from the small queue, in a
+    // direct mapped table holding about as many keys as the main queue
+    std::vector<uint32_t> _ghost;
+private:
+    static uint32_t fingerprint(size_t hash) noexcept {
+        // Never 0, the fingerprint of empty slots
+        return uint32_t(hash >> 32) | 1;
+    }
+    size_t ghost_slot(uint32_t fp) const noexcept {
+        return (fp >> 1) & (_ghost.size() - 1);
+    }
+    bool take_ghost(uint32_t fp) noexcept {
+        if (_ghost.empty()) {
+            return false;
+        }
+        auto& slot = _ghost[ghost_slot(fp)];
+        if (slot != fp) {
+            return false;
+        }
+        slot = 0;
+        return true;
+    }
+    void put_ghost(uint32_t fp) noexcept {
+        if (_ghost.size() < _main.size() + _small.size()) {
+            try {
+                _ghost.assign(std::max<size_t>(64, std::bit_ceil(_main.size() + _small.size())), 0);
+            } catch (const std::bad_alloc&) {
+                // The ghost only improves admission, run with the old one
+            }
+        }
+        if (!_ghost.empty()) {
+            _ghost[ghost_slot(fp)] = fp;
+        }
+    }
+    entry_state* evict_small() noexcept {
+        auto& e = _small.back();
+        _small.pop_back();
+        if (e._freq > 1) {
+            e._freq = 0;
+            e._main = true;
+            _main.push_front(e);
+            return nullptr;
+        }
+        put_ghost(e._fingerprint);
+        return &e;
+    }
+    entry_state* evict_main() noexcept {
+        auto& e = _main.back();
+        _main.pop_back();
+        if (e._freq > 0) {
+            e._freq--;
+            _main.push_front(e);
+            return nullptr;
+        }
+        return &e;
+    }
+public:
+    void insert(entry_state& e, size_t hash) noexcept {
+        e._fingerprint = fingerprint(hash);
+        e._freq = 0;
+        e._main = take_ghost(e._fingerprint);
+        (e._main ? _main : _small).push_front(e);
+    }
+    void touch(entry_state& e) noexcept {
+        e._freq = std::min<uint8_t>(e._freq + 1, max_freq);
+    }
+    void erase(entry_state& e) noexcept {
+        auto& q = e._main ? _main : _small;
+        q.erase(q.iterator_to(e));
+    }
+    entry_state* evict() noexcept {
+        // Every round lowers the frequency of an entry or moves it out of
+        // the small queue, so this terminates
+        while (!_small.empty() || !_main.empty()) {
+            auto small_limit = (_small.size() + _main.size()) * small_percent / 100;
+            auto e = !_small.empty() && (_small.size() > small_limit || _main.empty()) ? evict_small() : evict_main();
+            if (e) {
+                return e;
+            }
+        }
+        return nullptr;
+    }
+    void clear() noexcept {
+        _small.clear();
+        _main.clear();
+        std::fill(_ghost.begin(), _ghost.end(), 0);
+    }
+};
+
+/// \brief Base of the entries of a \ref local_cache
+///
+/// Holds the hash of the key of the entry, which the derived class passes
+/// to the constructor, its expiry and its charge, and the hooks linking it
+/// into the cache.
+template <typename Eviction = lru_eviction, typename Clock = lowres_clock>
+class cache_entry : public Eviction::entry_state {
+public:
+    using clock_type = Clock;
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+    static constexpr time_point never_expires = time_point::max();
+private:
+    boost::intrusive::unordered_set_member_hook<> _index_link;
+    boost::intrusive::list_member_hook<> _timer_link;
+    size_t _hash;
+    time_point _expiry = never_expires;
+    size_t _charge = 0;
+
+    template <typename, typename>
+    friend class local_cache;
+public:
+    explicit cache_entry(size_t hash) noexcept : _hash(hash) {}
+    cache_entry(const cache_entry&) = delete;
+    cache_entry& operator=(const cache_entry&) = delete;
+
+    /// Hash of the key
+    size_t hash() const noexcept {
+        return _hash;
+    }
+    /// When the entry expires, never_expires if it does not
+    time_point get_timeout() const noexcept {
+        return _expiry;
+    }
+    /// Charge of the entry against the capacity of its cache
+    size_t charge() const noexcept {
+        return _charge;
+    }
+    // Needed by timer_set
+    bool cancel() noexcept {
+        return false;
+    }
+};
+
+/// Configuration of a \ref local_cache
+struct cache_config {
+    /// Sum of the charges of the entries above which the cache evicts,
+    /// 0 for no limit
+    size_t capacity = 0;
+    /// Largest charge of an entry the cache admits, 0 for no limit
+    size_t max_entry_charge = 0;
+    /// Whether to evict entries when the seastar allocator runs low on
+    /// memory, for caches whose entries are allocated from it
+    bool reclaim_on_memory_pressure = false;
+};
+
+/// \brief Cache of the entries of a shard
+///
+/// Indexes entries by key in a hash table, expires them with a timer_set
+/// and evicts them with the Eviction policy when the sum of their charges
+/// exceeds the capacity, or when memory runs low. Entries are looked up by
+/// any key type K such that entry.key() == K is valid, given the hash of the
+/// key, which must be the same as the one the entry was constructed with.
+///
+/// \tparam Entry derives from cache_entry<Eviction, Clock>
+template <typename Entry, typename Eviction = lru_eviction>
+class local_cache {
+public:
+    using entry_type = Entry;
+    using clock_type = typename Entry::clock_type;
+    using time_point = typename Entry::time_point;
+    using base_type = cache_entry<Eviction, clock_type>;
+    /// Called when an entry leaves the cache, with the entry already
+    /// unlinked from it. Usually frees the entry.
+    using disposer_type = noncopyable_function<void (Entry&, cache_removal_cause)>;
+
+    static constexpr time_point never_expires = base_type::never_expires;
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t rejected = 0;
+        uint64_t expired = 0;
+        uint64_t evicted = 0;
+        uint64_t reclaimed = 0;
+        uint64_t resize_failures = 0;
+    };
+private:
+    static_assert(std::is_base_of_v<base_type, Entry>, "Entry must derive from cache_entry<Eviction, Clock>");
+
+    struct entry_hash {
+        size_t operator()(const base_type& e) const noexcept {
+            return e.hash();
+        }
+    };
+    struct entry_equal {
+        bool operator()(const base_type& a, const base_type& b) const {
+            return static_cast<const Entry&>(a).key() == static_cast<const Entry&>(b).key();
+        }
+    };
+    using index_type = boost::intrusive::unordered_set<base_type,
+        boost::intrusive::member_hook<base_type, boost::intrusive::unordered_set_member_hook<>, &base_type::_index_link>,
+        boost::intrusive::hash<entry_hash>,
+        boost::intrusive::equal<entry_equal>,
+        boost::intrusive::power_2_buckets<true>,
+        boost::intrusive::constant_time_size<true>>;
+
+    static constexpr size_t initial_bucket_count = 1 << 10;
+    static constexpr float load_factor = 0.75f;
+
+    cache_config _cfg;
+    disposer_type _disposer;
+    std::vector<typename index_type::bucket_type> _buckets;
+    index_type _index;
+    size_t _resize_up_threshold = load_factor * initial_bucket_count;
+    Eviction _eviction;
+    timer_set<base_type, &base_type::_timer_link> _alive;
+    timer<clock_type> _expiry_timer;
+    size_t _charge = 0;
+    stats _stats;
+    std::unique_ptr<memory::reclaimer> _reclaimer;
+private:
+    static Entry& to_entry(typename Eviction::entry_state& s) noexcept {
+        return static_cast<Entry&>(static_cast<base_type&>(s));
+    }
+    static base_type& base(Entry& e) noexcept {
+        return e;
+    }
+
+    void unlink(Entry& e) noexcept {
+        auto& b = base(e);
+        _index.erase(_index.iterator_to(b));
+        _eviction.erase(b);
+        if (b._expiry != never_expires) {
+            _alive.remove(b);
+        }
+        _charge -= b._charge;
+    }
+
+    void dispose(Entry& e, cache_removal_cause cause) noexcept {
+        switch (cause) {
+        case cache_removal_cause::erased: break;
+        case cache_removal_cause::expired: _stats.expired++; break;
+        case cache_removal_cause::evicted: _stats.evicted++; break;
+        }
+        _disposer(e, cause);
+    }
+
+    // Unlinks the next victim of the policy from everything else
+    Entry* evict_one() noexcept {
+        auto s = _eviction.evict();
+        if (!s) {
+            return nullptr;
+        }
+        auto& e = to_entry(*s);
+        auto& b = base(e);
+        _index.erase(_index.iterator_to(b));
+        if (b._expiry != never_expires) {
+            _alive.remove(b);
+        }
+        _charge -= b._charge;
+        return &e;
+    }
+
+    void expire() noexcept {
+        auto exp = _alive.expire(clock_type::now());
+        while (!exp.empty()) {
+            auto& b = exp.front();
+            exp.pop_front();
+            auto& e = static_cast<Entry&>(b);
+            _index.erase(_index.iterator_to(b));
+            _eviction.erase(b);
+            _charge -= b._charge;
+            dispose(e, cache_removal_cause::expired);
+        }
+        arm_expiry_timer();
+    }
+
+    void arm_expiry_timer() noexcept {
+        if (!_alive.empty()) {
+            _expiry_timer.rearm(_alive.get_next_timeout());
+        }
+    }
+
+    void maybe_rehash() noexcept {
+        if (_index.size() < _resize_up_threshold) {
+            return;
+        }
+        auto new_size = _index.bucket_count() * 2;
+        std::vector<typename index_type::bucket_type> old_buckets;
+        try {
+            old_buckets = std::exchange(_buckets, std::vector<typename index_type::bucket_type>(new_size));
+        } catch (const std::bad_alloc&) {
+            _stats.resize_failures++;
+            return;
+        }
+        _index.rehash(typename index_type::bucket_traits(_buckets.data(), new_size));
+        _resize_up_threshold = _index.bucket_count() * load_factor;
+    }
+
+    memory::reclaiming_result reclaim(size_t bytes) noexcept {
+        auto reclaimed = evict(bytes);
+        _stats.reclaimed += reclaimed;
+        return reclaimed ? memory::reclaiming_result::reclaimed_something : memory::reclaiming_result::reclaimed_nothing;
+    }
+
+    template <typename K>
+    Entry* lookup(const K& key, size_t hash) noexcept {
+        auto i = _index.find(key, [hash] (const K&) noexcept { return hash; }, [hash] (const K& k, const base_type& e) {
+            return e.hash() == hash && static_cast<const Entry&>(e).key() == k;
+        });
+        return i == _index.end() ? nullptr : &static_cast<Entry&>(*i);
+    }
+public:
+    local_cache(cache_config cfg, disposer_type disposer)
+        : _cfg(cfg)
+        , _disposer(std::move(disposer))
+        , _buckets(initial_bucket_count)
+        , _index(typename index_type::bucket_traits(_buckets.data(), initial_bucket_count))
+        , _expiry_timer([this] { expire(); })
+    {
+        if (_cfg.reclaim_on_memory_pressure) {
+            _reclaimer = std::make_unique<memory::reclaimer>([this] (memory::reclaimer::request r) {
+                return reclaim(r.bytes_to_reclaim);
+            });
+        }
+    }
+
+    local_cache(local_cache&&) = delete;
+
+    ~local_cache() {
+        clear();
+    }
+
+    /// Returns the entry with the given key, or nullptr, and records the
+    /// access with the eviction policy
+    template <typename K>
+    Entry* find(const K& key, size_t hash) noexcept {
+        auto e = lookup(key, hash);
+        if (!e) {
+            _stats.misses++;
+            return nullptr;
+        }
+        auto& b = base(*e);
+        // The expiry timer runs at the resolution of the clock, don't
+        // return entries which expired since it last ran
+        if (b._expiry != never_expires && b._expiry <= clock_type::now()) {
+            unlink(*e);
+            dispose(*e, cache_removal_cause::expired);
+            _stats.misses++;
+            return nullptr;
+        }
+        _stats.hits++;
+        _eviction.touch(b);
+        return e;
+    }
+
+    /// Like find(), without recording the access or counting hits and misses
+    template <typename K>
+    Entry* peek(const K& key, size_t hash) noexcept {
+        auto e = lookup(key, hash);
+        if (e && base(*e)._expiry <= clock_type::now()) {
+            return nullptr;
+        }
+        return e;
+    }
+
+    /// \brief Inserts an entry
+    ///
+    /// An entry with the same key is erased first. The entry is not admitted
+    /// if its charge is over cache_config::max_entry_charge or the capacity;
+    /// then it is not linked and stays owned by the caller. Entries are
+    /// evicted until the charge of the cache leaves room for the new one,
+    /// before it is linked, so that it is never its own victim.
+    ///
+    /// \return whether the entry was admitted
+    bool insert(Entry& e, size_t charge, time_point expiry = never_expires) noexcept {
+        if ((_cfg.max_entry_charge && charge > _cfg.max_entry_charge) || (_cfg.capacity && charge > _cfg.capacity)) {
+            _stats.rejected++;
+            return false;
+        }
+        auto& b = base(e);
+        b._charge = charge;
+        b._expiry = expiry;
+        auto i = _index.find(b);
+        if (i != _index.end()) {
+            auto& old = static_cast<Entry&>(*i);
+            unlink(old);
+            dispose(old, cache_removal_cause::erased);
+        }
+        if (_cfg.capacity) {
+            while (_charge + charge > _cfg.capacity) {
+                auto victim = evict_one();
+                if (!victim) {
+                    break;
+                }
+                dispose(*victim, cache_removal_cause::evicted);
+            }
+        }
+        _index.insert(b);
+        _eviction.insert(b, b._hash);
+        if (expiry != never_expires && _alive.insert(b)) {
+            _expiry_timer.rearm(expiry);
+        }
+        _charge += charge;
+        _stats.inserts++;
+        maybe_rehash();
+        return true;
+    }
+
+    /// Removes an entry and passes it to the disposer
+    void erase(Entry& e, cache_removal_cause cause = cache_removal_cause::erased) noexcept {
+        unlink(e);
+        dispose(e, cause);
+    }
+
+    /// Removes an entry without disposing of it, e.g. when the allocator
+    /// of the entries reuses its memory
+    void remove(Entry& e) noexcept {
+        unlink(e);
+    }
+
+    /// Evicts entries with the eviction policy until their charges add up
+    /// to \c charge
+    ///
+    /// \return the sum of the charges of the evicted entries
+    size_t evict(size_t charge) noexcept {
+        size_t evicted = 0;
+        while (evicted < charge) {
+            auto victim = evict_one();
+            if (!victim) {
+                break;
+            }
+            evicted += base(*victim)._charge;
+            dispose(*victim, cache_removal_cause::evicted);
+        }
+        return evicted;
+    }
+
+    /// Erases all the entries
+    void clear() noexcept {
+        // Unlink everything before disposing of anything, the disposer may
+        // free the entries
+        _eviction.clear();
+        _index.clear_and_dispose([this] (base_type* b) {
+            if (b->_expiry != never_expires) {
+                _alive.remove(*b);
+            }
+            _disposer(static_cast<Entry&>(*b), cache_removal_cause::erased);
+        });
+        _expiry_timer.cancel();
+        _charge = 0;
+    }
+
+    void set_capacity(size_t capacity) noexcept {
+        _cfg.capacity = capacity;
+        if (capacity && _charge > capacity) {
+            evict(_charge - capacity);
+        }
+    }
+
+    size_t capacity() const noexcept {
+        return _cfg.capacity;
+    }
+
+    /// Sum of the charges of the entries
+    size_t charge() const noexcept {
+        return _charge;
+    }
+
+    size_t size() const noexcept {
+        return _index.size();
+    }
+
+    size_t bucket_count() const noexcept {
+        return _index.bucket_count();
+    }
+
+    size_t bucket_size(size_t i) const noexcept {
+        return _index.bucket_size(i);
+    }
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+
+    future<> stop() noexcept {
+        return make_ready_future<>();
+    }
+};
+
+/// \brief Routes keys to the shard owning them
+///
+/// Spreads keys over the shards of a sharded service, typically a service
+/// holding a local_cache, by the high bits of their hash. The low bits are
+/// left to the hash table of each shard: with a plain modulo of the shard
+/// count, all the keys of a shard would fall in the same fraction of its
+/// buckets.
+template <typename Service>
+class sharded_cache {
+    sharded<Service>& _shards;
+public:
+    explicit sharded_cache(sharded<Service>& shards) noexcept : _shards(shards) {}
+
+    /// The shard owning the keys with the given hash
+    static shard_id shard_of(size_t hash) noexcept {
+        return (uint64_t(uint32_t(uint64_t(hash) >> 32)) * smp::count) >> 32;
+    }
+
+    sharded<Service>& container() noexcept {
+        return _shards;
+    }
+
+    Service& local() noexcept {
+        return _shards.local();
+    }
+
+    /// Invokes func(Service&) on the shard owning the keys with the given
+    /// hash, directly when it is the current shard
+    template <typename Func>
+    futurize_t<std::invoke_result_t<Func, Service&>> invoke_on_owner(size_t hash, Func func) {
+        auto shard = shard_of(hash);
+        if (shard == this_shard_id()) {
+            return futurize_invoke(func, _shards.local());
+        }
+        return _shards.invoke_on(shard, std::move(func));
+    }
+
+    /// Invokes func(Service&) on every shard
+    template <typename Func>
+    future<> invoke_on_all(Func func) {
+        return _shards.invoke_on_all(std::move(func));
+    }
+
+    template <typename Mapper, typename Initial, typename Reduce>
+    future<Initial> map_reduce0(Mapper map, Initial initial, Reduce reduce) {
+        return _shards.map_reduce0(std::move(map), std::move(initial), std::move(reduce));
+    }
+};
+
+SEASTAR_MODULE_EXPORT_END
+
+}
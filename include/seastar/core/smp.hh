@@ -62,6 +62,7 @@ namespace internal {
 unsigned smp_service_group_id(smp_service_group ssg) noexcept;
 
 class memory_prefaulter;
+class smp_doorbell;
 
 }
 
@@ -190,12 +191,17 @@ class smp_message_queue {
     struct work_item;
     struct lf_queue_remote {
         reactor* remote;
+        // Doorbell of the shard consuming this queue, rung with the bit of
+        // the peer on the other side; only set with the doorbell transport
+        internal::smp_doorbell* doorbell = nullptr;
+        shard_id doorbell_bit = 0;
     };
     using lf_queue_base = boost::lockfree::spsc_queue<work_item*,
                             boost::lockfree::capacity<queue_length>>;
     // use inheritence to control placement order
     struct lf_queue : lf_queue_remote, lf_queue_base {
         lf_queue(reactor* remote) : lf_queue_remote{remote} {}
+        void ring() noexcept;
         void maybe_wakeup();
         ~lf_queue();
     };
@@ -279,6 +285,9 @@ class smp_message_queue {
 public:
     smp_message_queue(reactor* from, reactor* to);
     ~smp_message_queue();
+    // Switches the queue to the doorbell transport: instead of being polled
+    // unconditionally, the queue is looked at only after its peer rang
+    void use_doorbells(internal::smp_doorbell* doorbells, shard_id from, shard_id to) noexcept;
     template <typename Func>
     futurize_t<std::invoke_result_t<Func>> submit(shard_id t, smp_submit_to_options options, Func&& func) noexcept {
         memory::scoped_critical_alloc_section _;
@@ -322,6 +331,12 @@ class smp : public std::enable_shared_from_this<smp> {
     };
     std::unique_ptr<smp_message_queue*[], qs_deleter> _qs_owner;
     static thread_local smp_message_queue**_qs;
+    struct doorbells_deleter {
+      void operator()(internal::smp_doorbell* doorbells) const;
+    };
+    std::unique_ptr<internal::smp_doorbell[], doorbells_deleter> _doorbells_owner;
+    // This shard's doorbell, or nullptr if queues are polled unconditionally
+    static thread_local internal::smp_doorbell* _doorbell;
     static thread_local std::thread::id _tmain;
     bool _using_dpdk = false;
     std::vector<unsigned> _shard_to_numa_node_mapping;
@@ -56,6 +56,14 @@ struct smp_options : public program_options::option_group {
     program_options::value<std::string> reserve_memory;
     /// Path to accessible hugetlbfs mount (typically /dev/hugepages/something).
     program_options::value<std::string> hugepages;
+    /// Back shard memory with explicitly reserved anonymous huge pages of
+    /// this size (2M or 1G) instead of transparent huge pages.
+    ///
+    /// The pages come from the kernel's huge page pool (see
+    /// `/sys/kernel/mm/hugepages`), no hugetlbfs mount is needed. Memory which
+    /// cannot be reserved falls back to regular pages. Ignored if
+    /// \ref hugepages is set.
+    program_options::value<std::string> explicit_hugepages;
     /// Lock all memory (prevents swapping).
     program_options::value<bool> lock_memory;
     /// Pin threads to their cpus (disable for overprovisioning).
@@ -85,6 +93,14 @@ struct smp_options : public program_options::option_group {
     /// them to remote ones.
     /// \note Unused when seastar is compiled without \p HWLOC support.
     program_options::value<bool> allow_cpus_in_remote_numa_nodes;
+    /// How shards find out about cross-shard messages.
+    ///
+    /// * \p polling: every shard polls the queues of all other shards on each
+    ///   iteration of the event loop (the default).
+    /// * \p doorbell: senders ring a per-shard bitmap of peers with pending
+    ///   messages, and a shard only polls the queues whose bits are set.
+    ///   Reduces the polling cost of idle queues on machines with many shards.
+    program_options::value<std::string> smp_transport;
 
     /// Memory allocator to use.
     ///
@@ -92,6 +108,7 @@ struct smp_options : public program_options::option_group {
     /// * \ref smp_options::memory
     /// * \ref smp_options::reserve_memory
     /// * \ref smp_options::hugepages
+    /// * \ref smp_options::explicit_hugepages
     /// * \ref smp_options::mbind
     /// * \ref reactor_options::heapprof
     /// * \ref reactor_options::abort_on_seastar_bad_alloc
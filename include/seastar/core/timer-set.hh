@@ -233,6 +233,16 @@ class timer_set {
     template <typename EnableFunc>
     void complete(timer_list_t& expired_timers, EnableFunc&& enable_fn) noexcept(noexcept(enable_fn())) {
         expired_timers = expire(this->now());
+        complete_expired(expired_timers, std::forward<EnableFunc>(enable_fn));
+    }
+
+    /**
+     * Runs the callbacks of timers returned by expire().
+     *
+     * Shared with other timer containers holding the same Timer type.
+     */
+    template <typename EnableFunc>
+    static void complete_expired(timer_list_t& expired_timers, EnableFunc&& enable_fn) noexcept(noexcept(enable_fn())) {
         for (auto& t : expired_timers) {
             t._expired = true;
         }
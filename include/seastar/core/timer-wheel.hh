@@ -0,0 +1,385 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <seastar/core/bitset-iter.hh>
+#include <seastar/core/timer-set.hh>
+#include <seastar/util/assert.hh>
+#ifndef SEASTAR_MODULE
+#include <boost/intrusive/list.hpp>
+#include <array>
+#include <bitset>
+#include <limits>
+#endif
+
+namespace seastar {
+
+/**
+ * A hierarchical timing wheel, interchangeable with timer_set.
+ *
+ * Timestamps are split into 6-bit digits. A timer lives on the level of
+ * the most significant digit in which its timeout differs from the last
+ * expiry time, in the slot given by that digit. Arming and cancelling are
+ * O(1). When time advances, the levels below the first changed digit and
+ * the slots of that level preceding the new time have all expired and are
+ * spliced out whole; only the single slot the new time falls into is
+ * cascaded down. Compared to timer_set, where a bucket spans a whole
+ * power-of-two range, every cascade re-inserts 1/64th of a level, which
+ * matters with millions of long-lived timers (e.g. per-connection idle
+ * timeouts) that are mostly cancelled before they expire.
+ *
+ * The template type "Timer" has the same requirements as for timer_set.
+ */
+template<typename Timer, boost::intrusive::list_member_hook<> Timer::*link>
+class timer_wheel {
+public:
+    using time_point = typename Timer::time_point;
+    using timer_list_t = typename timer_set<Timer, link>::timer_list_t;
+private:
+    using duration = typename Timer::duration;
+    using timestamp_t = typename Timer::duration::rep;
+
+    static constexpr timestamp_t max_timestamp = std::numeric_limits<timestamp_t>::max();
+    static constexpr int timestamp_bits = std::numeric_limits<timestamp_t>::digits;
+
+    static constexpr int slot_bits = 6;
+    static constexpr int n_slots = 1 << slot_bits;
+    static constexpr int n_levels = (timestamp_bits + slot_bits - 1) / slot_bits;
+
+    struct level {
+        std::array<timer_list_t, n_slots> slots;
+        std::bitset<n_slots> non_empty_slots;
+    };
+
+    struct position {
+        int level;  // n_levels for _overdue
+        int slot;
+    };
+
+    std::array<level, n_levels> _levels;
+    // Active timers with timeout <= _last
+    timer_list_t _overdue;
+    timestamp_t _last;
+    timestamp_t _next;
+
+    std::bitset<n_levels> _non_empty_levels;
+private:
+    static timestamp_t get_timestamp(time_point _time_point) noexcept
+    {
+        return _time_point.time_since_epoch().count();
+    }
+
+    static timestamp_t get_timestamp(Timer& timer) noexcept
+    {
+        return get_timestamp(timer.get_timeout());
+    }
+
+    position get_position(timestamp_t timestamp) const noexcept
+    {
+        if (timestamp <= _last) {
+            return {n_levels, 0};
+        }
+        int bit = timestamp_bits - 1 - bitsets::count_leading_zeros(timestamp ^ _last);
+        int lvl = bit / slot_bits;
+        return {lvl, int((timestamp >> (lvl * slot_bits)) & (n_slots - 1))};
+    }
+
+    timer_list_t& get_list(position pos) noexcept
+    {
+        return pos.level == n_levels ? _overdue : _levels[pos.level].slots[pos.slot];
+    }
+
+    void link_list(position pos) noexcept
+    {
+        if (pos.level != n_levels) {
+            _levels[pos.level].non_empty_slots[pos.slot] = true;
+            _non_empty_levels[pos.level] = true;
+        }
+    }
+
+    void unlink_slot(int lvl, int slot) noexcept
+    {
+        auto& l = _levels[lvl];
+        l.non_empty_slots[slot] = false;
+        if (l.non_empty_slots.none()) {
+            _non_empty_levels[lvl] = false;
+        }
+    }
+
+    template <typename Func>
+    void for_each_list(Func func) const noexcept
+    {
+        func(_overdue);
+        for (int lvl : bitsets::for_each_set(_non_empty_levels)) {
+            for (int slot : bitsets::for_each_set(_levels[lvl].non_empty_slots)) {
+                func(_levels[lvl].slots[slot]);
+            }
+        }
+    }
+
+public:
+    timer_wheel() noexcept
+        : _last(0)
+        , _next(max_timestamp)
+    {
+    }
+
+    ~timer_wheel() {
+        while (!_overdue.empty()) {
+            _overdue.begin()->cancel();
+        }
+        for (auto&& l : _levels) {
+            for (auto&& list : l.slots) {
+                while (!list.empty()) {
+                    auto& timer = *list.begin();
+                    timer.cancel();
+                }
+            }
+        }
+    }
+
+    /**
+     * Adds timer to the active set.
+     *
+     * Same contract as timer_set::insert().
+     */
+    bool insert(Timer& timer) noexcept
+    {
+        auto timestamp = get_timestamp(timer);
+        auto pos = get_position(timestamp);
+
+        get_list(pos).push_back(timer);
+        link_list(pos);
+
+        if (timestamp < _next) {
+            _next = timestamp;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Removes timer from the active set.
+     *
+     * Same contract as timer_set::remove().
+     */
+    void remove(Timer& timer) noexcept
+    {
+        auto pos = get_position(get_timestamp(timer));
+        auto& list = get_list(pos);
+        list.erase(list.iterator_to(timer));
+        if (pos.level != n_levels && list.empty()) {
+            unlink_slot(pos.level, pos.slot);
+        }
+    }
+
+    /**
+     * Removes timer from the active set or the expired list, if the timer is expired
+     */
+    void remove(Timer& timer, timer_list_t& expired) noexcept
+    {
+        if (timer._expired) {
+            expired.erase(expired.iterator_to(timer));
+            timer._expired = false;
+        } else {
+            remove(timer);
+        }
+    }
+
+    /**
+     * Expires active timers.
+     *
+     * Same contract as timer_set::expire().
+     */
+    timer_list_t expire(time_point now) noexcept
+    {
+        timer_list_t exp;
+        auto timestamp = get_timestamp(now);
+
+        if (timestamp < _last) {
+            abort();
+        }
+
+        exp.splice(exp.end(), _overdue);
+        _next = max_timestamp;
+
+        if (timestamp != _last) {
+            auto top = get_position(timestamp);
+            for (int lvl : bitsets::for_each_set(_non_empty_levels)) {
+                if (lvl >= top.level) {
+                    break;
+                }
+                auto& l = _levels[lvl];
+                for (int slot : bitsets::for_each_set(l.non_empty_slots)) {
+                    exp.splice(exp.end(), l.slots[slot]);
+                }
+                l.non_empty_slots.reset();
+                _non_empty_levels[lvl] = false;
+            }
+
+            auto& l = _levels[top.level];
+            for (int slot : bitsets::for_each_set(l.non_empty_slots)) {
+                if (slot >= top.slot) {
+                    break;
+                }
+                exp.splice(exp.end(), l.slots[slot]);
+                unlink_slot(top.level, slot);
+            }
+
+            _last = timestamp;
+
+            if (l.non_empty_slots[top.slot]) {
+                timer_list_t cascade;
+                cascade.swap(l.slots[top.slot]);
+                unlink_slot(top.level, top.slot);
+                while (!cascade.empty()) {
+                    auto& timer = *cascade.begin();
+                    cascade.pop_front();
+                    if (timer.get_timeout() <= now) {
+                        exp.push_back(timer);
+                    } else {
+                        insert(timer);
+                    }
+                }
+            }
+        }
+
+        // Lower levels and lower slots hold earlier timers, so the next
+        // timeout is in the first non-empty slot
+        if (_next == max_timestamp && _non_empty_levels.any()) {
+            auto& l = _levels[bitsets::get_first_set(_non_empty_levels)];
+            for (auto& timer : l.slots[bitsets::get_first_set(l.non_empty_slots)]) {
+                _next = std::min(_next, get_timestamp(timer));
+            }
+        }
+        return exp;
+    }
+
+    template <typename EnableFunc>
+    void complete(timer_list_t& expired_timers, EnableFunc&& enable_fn) noexcept(noexcept(enable_fn())) {
+        expired_timers = expire(this->now());
+        timer_set<Timer, link>::complete_expired(expired_timers, std::forward<EnableFunc>(enable_fn));
+    }
+
+    /**
+     * Returns a time point at which expire() should be called
+     * in order to ensure timers are expired in a timely manner.
+     *
+     * Returned values are monotonically increasing.
+     */
+    time_point get_next_timeout() const noexcept
+    {
+        return time_point(duration(std::max(_last, _next)));
+    }
+
+    /**
+     * Clears both active and expired timer sets.
+     */
+    void clear() noexcept
+    {
+        _overdue.clear();
+        for (int lvl : bitsets::for_each_set(_non_empty_levels)) {
+            for (int slot : bitsets::for_each_set(_levels[lvl].non_empty_slots)) {
+                _levels[lvl].slots[slot].clear();
+            }
+            _levels[lvl].non_empty_slots.reset();
+        }
+        _non_empty_levels.reset();
+    }
+
+    size_t size() const noexcept
+    {
+        size_t res = 0;
+        for_each_list([&res] (const timer_list_t& list) {
+            res += list.size();
+        });
+        return res;
+    }
+
+    /**
+     * Returns true if and only if there are no timers in the active set.
+     */
+    bool empty() const noexcept
+    {
+        return _overdue.empty() && _non_empty_levels.none();
+    }
+
+    time_point now() noexcept {
+        return Timer::clock::now();
+    }
+};
+
+namespace internal {
+
+/// Timer container of the reactor, which can be switched from timer_set to
+/// timer_wheel while it is still empty.
+template<typename Timer, boost::intrusive::list_member_hook<> Timer::*link>
+class switchable_timer_set {
+public:
+    using time_point = typename Timer::time_point;
+    using timer_list_t = typename timer_set<Timer, link>::timer_list_t;
+private:
+    bool _use_wheel = false;
+    timer_set<Timer, link> _set;
+    timer_wheel<Timer, link> _wheel;
+public:
+    void use_wheel(bool use) noexcept {
+        SEASTAR_ASSERT(empty());
+        _use_wheel = use;
+    }
+    bool insert(Timer& timer) noexcept {
+        return _use_wheel ? _wheel.insert(timer) : _set.insert(timer);
+    }
+    void remove(Timer& timer) noexcept {
+        _use_wheel ? _wheel.remove(timer) : _set.remove(timer);
+    }
+    void remove(Timer& timer, timer_list_t& expired) noexcept {
+        _use_wheel ? _wheel.remove(timer, expired) : _set.remove(timer, expired);
+    }
+    timer_list_t expire(time_point now) noexcept {
+        return _use_wheel ? _wheel.expire(now) : _set.expire(now);
+    }
+    template <typename EnableFunc>
+    void complete(timer_list_t& expired_timers, EnableFunc&& enable_fn) noexcept(noexcept(enable_fn())) {
+        if (_use_wheel) {
+            _wheel.complete(expired_timers, std::forward<EnableFunc>(enable_fn));
+        } else {
+            _set.complete(expired_timers, std::forward<EnableFunc>(enable_fn));
+        }
+    }
+    time_point get_next_timeout() const noexcept {
+        return _use_wheel ? _wheel.get_next_timeout() : _set.get_next_timeout();
+    }
+    void clear() noexcept {
+        _use_wheel ? _wheel.clear() : _set.clear();
+    }
+    size_t size() const noexcept {
+        return _use_wheel ? _wheel.size() : _set.size();
+    }
+    bool empty() const noexcept {
+        return _use_wheel ? _wheel.empty() : _set.empty();
+    }
+};
+
+}
+
+}
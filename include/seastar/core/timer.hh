@@ -23,7 +23,7 @@
 
 #include <seastar/core/future.hh>
 #include <seastar/core/scheduling.hh>
-#include <seastar/core/timer-set.hh>
+#include <seastar/core/timer-wheel.hh>
 #include <seastar/util/assert.hh>
 #include <seastar/util/std-compat.hh>
 #include <seastar/util/modules.hh>
@@ -220,7 +220,8 @@ class timer {
     }
 
     friend class timer_set<timer, &timer::_link>;
-    using set_t = timer_set<timer, &timer::_link>;
+    friend class timer_wheel<timer, &timer::_link>;
+    using set_t = internal::switchable_timer_set<timer, &timer::_link>;
 };
 
 extern template class timer<steady_clock_type>;
@@ -28,6 +28,7 @@
 #include <boost/intrusive/list.hpp>
 #endif
 #include <seastar/http/request_parser.hh>
+#include <seastar/http/simd_request_parser.hh>
 #include <seastar/http/request.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/sstring.hh>
@@ -74,6 +75,7 @@ class connection : public boost::intrusive::list_base_hook<> {
     static constexpr size_t limit = 4096;
     using tmp_buf = temporary_buffer<char>;
     http_request_parser _parser;
+    http_simd_request_parser _simd_parser;
     std::unique_ptr<http::request> _req;
     std::unique_ptr<http::reply> _resp;
     // null element marks eof
@@ -142,6 +144,7 @@ class http_server {
     timer<> _date_format_timer { [this] {_date = http_date();} };
     size_t _content_length_limit = std::numeric_limits<size_t>::max();
     bool _content_streaming = false;
+    bool _simd_request_parser = false;
     gate _task_gate;
 public:
     routes _routes;
@@ -187,6 +190,17 @@ class http_server {
 
     void set_content_streaming(bool b);
 
+    bool get_simd_request_parser() const;
+
+    /*!
+     * \brief parse request heads with http_simd_request_parser
+     *
+     * When set, connections parse the request line and headers with the
+     * SIMD parser instead of the Ragel-generated one. Takes effect from
+     * the next request read on each connection.
+     */
+    void set_simd_request_parser(bool b);
+
     future<> listen(socket_address addr, server_credentials_ptr credentials);
     future<> listen(socket_address addr, listen_options lo, server_credentials_ptr credentials);
     future<> listen(socket_address addr, listen_options lo);
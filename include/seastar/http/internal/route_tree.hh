@@ -0,0 +1,137 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string_view>
+#include <vector>
+#endif
+
+#include <seastar/http/common.hh>
+#include <seastar/http/handlers.hh>
+#include <seastar/http/matchrules.hh>
+#include <seastar/core/sstring.hh>
+
+namespace seastar {
+
+namespace httpd {
+
+namespace internal {
+
+/*
+ * The index routes look handlers up with: a compressed radix tree of the
+ * exact urls and of the match rules of one operation type.
+ *
+ * Rules made of str_matcher and param_matcher, which is what url and
+ * path_description build, are compiled into the tree: literal strings are
+ * edges labelled with their characters, a parameter is an edge that takes
+ * a path segment, and a parameter until the end of the path ends a branch.
+ * A lookup walks the tree once, following all the edges the url matches,
+ * and neither allocates nor compares the url against each rule. The rule
+ * that wins is the one the matchers would have picked: an exact url first,
+ * then the rule added first, so the tree only changes how fast handlers are
+ * found.
+ *
+ * Rules with other matchers are evaluated one after the other, as before,
+ * in their insertion order among the rules of the tree.
+ *
+ * The tree does not own the rules and handlers; routes does.
+ */
+class route_tree {
+public:
+    using rule_cookie = uint64_t;
+    // Rules with more parameters are not compiled
+    static constexpr size_t max_params = 16;
+private:
+    enum class segment_kind { literal, boundary, param, remainder };
+    struct segment {
+        segment_kind kind;
+        std::string_view str;
+    };
+    struct endpoint {
+        rule_cookie cookie;
+        match_rule* rule;
+    };
+    struct node {
+        // The characters of the edge that leads to the node
+        sstring label;
+        std::vector<std::unique_ptr<node>> children;
+        // Urls that go on with a slash, or end
+        std::unique_ptr<node> boundary;
+        // Urls that go on with a path segment, taken by a parameter
+        std::unique_ptr<node> param;
+        // Rules whose last parameter takes the rest of the url, by cookie
+        std::vector<endpoint> remainder;
+        // Rules that end here, by cookie
+        std::vector<endpoint> rules;
+        handler_base* exact = nullptr;
+
+        node* find_child(char c) const noexcept;
+        bool empty() const noexcept;
+    };
+    struct match_state;
+
+    node _root;
+    // The rules the tree cannot hold
+    std::map<rule_cookie, match_rule*> _linear;
+    size_t _compiled = 0;
+private:
+    static bool compile(const match_rule& rule, std::vector<segment>& segments);
+    static node& descend(node& n, std::string_view str);
+    static bool erase(node& n, const segment* s, const segment* end, size_t consumed, rule_cookie cookie, bool exact);
+    static void search(const node& n, size_t pos, match_state& st) noexcept;
+public:
+    route_tree() = default;
+    route_tree(const route_tree&) = delete;
+    route_tree& operator=(const route_tree&) = delete;
+
+    // Adds an exact url, which must not be there yet
+    void put(const sstring& url, handler_base* handler);
+    void drop(const sstring& url);
+
+    // Adds a rule, which must not be modified while in the tree
+    void add(rule_cookie cookie, match_rule* rule);
+    void remove(rule_cookie cookie, match_rule* rule);
+
+    /*
+     * Returns the handler of the url, filling params with its parameters,
+     * or nullptr if no exact url or rule matches
+     */
+    handler_base* find(const sstring& url, parameters& params) const;
+
+    // Number of rules held by the tree and evaluated one by one
+    size_t compiled_rules() const noexcept {
+        return _compiled;
+    }
+    size_t linear_rules() const noexcept {
+        return _linear.size();
+    }
+};
+
+}
+
+}
+
+}
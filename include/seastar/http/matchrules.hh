@@ -112,6 +112,17 @@ class match_rule {
         return *this;
     }
 
+    /**
+     * The matchers of the rule, in the order they are evaluated
+     */
+    const std::vector<matcher*>& matchers() const noexcept {
+        return _match_list;
+    }
+
+    handler_base* handler() const noexcept {
+        return _handler;
+    }
+
 private:
     std::vector<matcher*> _match_list;
     handler_base* _handler;
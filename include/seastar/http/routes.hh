@@ -28,6 +28,7 @@
 
 #include <seastar/http/matchrules.hh>
 #include <seastar/http/handlers.hh>
+#include <seastar/http/internal/route_tree.hh>
 #include <seastar/http/common.hh>
 #include <seastar/http/reply.hh>
 #include <seastar/util/modules.hh>
@@ -77,6 +78,8 @@ struct path_description;
  * (an optional leading slash is permitted) it is chosen
  * If not, the matching rules are used.
  * matching rules are evaluated by their insertion order
+ * Both are indexed by a radix tree, so that finding a handler does not
+ * depend on the number of urls and rules.
  */
 class routes {
 public:
@@ -116,7 +119,7 @@ class routes {
      * routes instance is destroyed.
      */
     routes& add(match_rule* rule, operation_type type = GET) {
-        _rules[type][_rover++] = rule;
+        add_cookie(rule, type);
         return *this;
     }
 
@@ -188,6 +191,8 @@ class routes {
 private:
     rule_cookie _rover = 0;
     std::map<rule_cookie, match_rule*> _rules[NUM_OPERATION];
+    // Indexes _map and _rules
+    internal::route_tree _tree[NUM_OPERATION];
     //default Handler -- for any HTTP Method and Path (/*)
     handler_base* _default_handler = nullptr;
 public:
@@ -230,17 +235,14 @@ class routes {
 
     /**
      * Add a rule to be used.
-     * @param rule a rule to add
+     * @param rule a rule to add, which must not be modified while it is
+     * registered
      * @param type the operation type
      * @return a cookie using which the rule can be removed
      * @attention This method takes ownership of the match_rule pointer. It will be automatically deleted when the
      * routes instance is destroyed.
      */
-    rule_cookie add_cookie(match_rule* rule, operation_type type) {
-        auto pos = _rover++;
-        _rules[type][pos] = rule;
-        return pos;
-    }
+    rule_cookie add_cookie(match_rule* rule, operation_type type);
 
     /**
      * Del a rule by cookie
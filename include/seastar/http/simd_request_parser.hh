@@ -0,0 +1,141 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <list>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+#endif
+#include <seastar/core/future.hh>
+#include <seastar/core/iostream.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/http/request.hh>
+#include <seastar/util/modules.hh>
+
+namespace seastar {
+
+SEASTAR_MODULE_EXPORT_BEGIN
+
+/// \brief HTTP request head parser that scans for delimiters with SIMD.
+///
+/// A drop-in alternative to the Ragel-generated \ref http_request_parser:
+/// it accepts the same request heads and is driven the same way through
+/// input_stream::consume(). Instead of walking a state machine byte by
+/// byte, it first locates the empty line ending the head, then splits the
+/// lines and validates field values 16 bytes at a time.
+///
+/// The method, URL, version and header fields are kept as views into the
+/// input. When the head arrives in a single buffer (the common case) the
+/// views point into a shared reference to that buffer and nothing is
+/// copied; otherwise the fragments are gathered into one contiguous area
+/// first. The views remain valid until the next init(). An http::request
+/// is only built when get_parsed_request() is called.
+///
+/// Unlike http_request_parser, which fails as soon as it sees an invalid
+/// byte, errors are detected once the whole head has been received. The
+/// request line is also stricter: control characters in the URL are
+/// rejected. Since the head is buffered until its end is found, its size
+/// is limited (see set_max_head_size()); a longer head fails the parse
+/// and head_too_large() tells it apart from a malformed one.
+class http_simd_request_parser {
+public:
+    struct header_view {
+        std::string_view name;
+        std::string_view value;
+    };
+    static constexpr size_t default_max_head_size = 64 * 1024;
+private:
+    enum class state {
+        error,
+        too_large,
+        eof,
+        done,
+    };
+    state _state = state::eof;
+    size_t _max_head_size = default_max_head_size;
+    // Shares the head when it arrived in one buffer
+    temporary_buffer<char> _head;
+    // Gathers the head when it is split across buffers
+    std::vector<char> _pending;
+    std::string_view _method;
+    std::string_view _url;
+    std::string_view _version;
+    std::vector<header_view> _headers;
+    // Backing storage for values joined from obs-fold continuation lines
+    std::list<sstring> _folded;
+private:
+    bool parse_head(const char* p, const char* end);
+    bool parse_request_line(const char* p, const char* eol);
+public:
+    void init();
+    future<consumption_result<char>> operator()(temporary_buffer<char> buf);
+
+    /// Materializes the parsed head into an http::request.
+    ///
+    /// Repeated fields are combined into one, separated by commas, as
+    /// http_request_parser does. After a failure, the request holds
+    /// whatever was parsed before the error.
+    std::unique_ptr<http::request> get_parsed_request() const;
+
+    bool eof() const noexcept {
+        return _state == state::eof;
+    }
+    bool failed() const noexcept {
+        return _state == state::error || _state == state::too_large;
+    }
+    /// Whether the parse failed because the head, including the request
+    /// line and the final empty line, exceeded the size limit
+    bool head_too_large() const noexcept {
+        return _state == state::too_large;
+    }
+
+    /// Sets the size limit of the head, default_max_head_size by default
+    void set_max_head_size(size_t size) noexcept {
+        _max_head_size = size;
+    }
+
+    std::string_view method() const noexcept {
+        return _method;
+    }
+    std::string_view url() const noexcept {
+        return _url;
+    }
+    std::string_view version() const noexcept {
+        return _version;
+    }
+    /// Header fields in the order they were received; repeated fields
+    /// are not combined.
+    const std::vector<header_view>& headers() const noexcept {
+        return _headers;
+    }
+    /// Returns the value of the first field named \c name (compared
+    /// case-insensitively), without materializing the request.
+    std::optional<std::string_view> get_header(std::string_view name) const noexcept;
+};
+
+SEASTAR_MODULE_EXPORT_END
+
+}
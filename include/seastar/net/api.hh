@@ -113,6 +113,12 @@ class datagram final {
 
 using udp_datagram = datagram;
 
+/// A datagram queued for transmission with datagram_channel::send_batch().
+struct outgoing_datagram {
+    socket_address dst;
+    packet p;
+};
+
 class datagram_channel {
 private:
     std::unique_ptr<datagram_channel_impl> _impl;
@@ -129,6 +135,20 @@ class datagram_channel {
     future<datagram> receive();
     future<> send(const socket_address& dst, const char* msg);
     future<> send(const socket_address& dst, packet p);
+    /// Receives up to \c max_datagrams datagrams, waiting until at least one
+    /// is available.
+    ///
+    /// Stacks that support it (e.g. the posix stack, via recvmmsg()) collect
+    /// all datagrams already queued on the socket with a single system call,
+    /// amortizing its cost over the whole batch. Other stacks return a single
+    /// datagram per call.
+    future<std::vector<datagram>> receive_batch(size_t max_datagrams);
+    /// Sends a batch of datagrams, possibly to different destinations.
+    ///
+    /// Stacks that support it (e.g. the posix stack, via sendmmsg()) submit
+    /// the whole batch with as few system calls as possible. The returned
+    /// future resolves once all datagrams were handed to the stack.
+    future<> send_batch(std::vector<outgoing_datagram> datagrams);
     bool is_closed() const;
     /// Causes a pending receive() to complete (possibly with an exception)
     void shutdown_input();
@@ -392,8 +412,8 @@ class server_socket {
 /// Options for creating a listening socket.
 ///
 /// WARNING: these options currently only have an effect when using
-/// the POSIX stack: all options are ignored on the native stack as they
-/// are not implemented there.
+/// the POSIX stack: all options but congestion_control are ignored on the
+/// native stack as they are not implemented there.
 struct listen_options {
     bool reuse_address = false;
     server_socket::load_balancing_algorithm lba = server_socket::load_balancing_algorithm::default_;
@@ -414,6 +434,12 @@ struct listen_options {
     /// setting it directly on the already-accepted socket is ineffective (see TCP(7)).
     std::optional<int> so_rcvbuf;
 
+    /// If set, the TCP congestion control algorithm of the sockets returned by
+    /// accept, e.g. "cubic" or "bbr". The POSIX stack sets TCP_CONGESTION on
+    /// the listening socket, and the algorithm must be available in the kernel;
+    /// the native stack knows those of \ref net::tcp_congestion_control.
+    std::optional<sstring> congestion_control;
+
     void set_fixed_cpu(unsigned cpu) {
         lba = server_socket::load_balancing_algorithm::fixed;
         fixed_cpu = cpu;
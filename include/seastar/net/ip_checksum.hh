@@ -31,6 +31,13 @@
 
 namespace seastar {
 
+namespace internal {
+
+// Name of the checksum implementation selected for the running CPU
+const char* checksum_kernel_name() noexcept;
+
+}
+
 namespace net {
 
 uint16_t ip_checksum(const void* data, size_t len);
@@ -40,6 +47,8 @@ struct checksummer {
     bool odd = false;
     void sum(const char* data, size_t len);
     void sum(const packet& p);
+    // Copies len bytes from src to dst and sums them in the same pass
+    void copy_and_sum(char* dst, const char* src, size_t len);
     void sum(uint8_t data) {
         if (!odd) {
             csum += data << 8;
@@ -43,6 +43,8 @@ namespace net {
 
 SEASTAR_MODULE_EXPORT_BEGIN
 
+struct checksummer;
+
 struct fragment {
     char* base;
     size_t size;
@@ -273,6 +275,8 @@ class packet final {
     packet free_on_cpu(unsigned cpu, std::function<void()> cb = []{});
 
     void linearize() { return linearize(0, len()); }
+    // linearize, adding the packet's contents to `csum` while copying them
+    void linearize(checksummer& csum) { return linearize(0, len(), &csum); }
 
     void reset() noexcept { _impl.reset(); }
 
@@ -317,7 +321,7 @@ class packet final {
         return net::packet(nullptr);
     }
 private:
-    void linearize(size_t at_frag, size_t desired_size);
+    void linearize(size_t at_frag, size_t desired_size, checksummer* csum = nullptr);
     bool allocate_headroom(size_t size);
 public:
     struct offload_info get_offload_info() const noexcept { return _impl->_offload_info; }
@@ -126,8 +126,10 @@ class posix_data_source_impl final : public data_source_impl, private internal::
 class posix_data_sink_impl : public data_sink_impl {
     pollable_fd _fd;
     packet _p;
+    size_t _zerocopy_threshold;
 public:
-    explicit posix_data_sink_impl(pollable_fd fd) : _fd(std::move(fd)) {}
+    explicit posix_data_sink_impl(pollable_fd fd, size_t zerocopy_threshold = 0)
+        : _fd(std::move(fd)), _zerocopy_threshold(zerocopy_threshold) {}
     using data_sink_impl::put;
     future<> put(packet p) override;
     future<> put(temporary_buffer<char> buf) override;
@@ -197,6 +199,25 @@ class posix_reuseport_server_socket_impl : public server_socket_impl {
     virtual socket_address local_address() const override;
 };
 
+/// Posix networking stack configuration.
+struct posix_stack_options : public program_options::option_group {
+    /// \brief Send packets of at least this many bytes without copying them.
+    ///
+    /// Packets written to TCP connections are then transmitted by the kernel
+    /// straight from the application's buffers, which are kept alive until
+    /// the kernel releases them. Only the \p io_uring reactor backend on
+    /// Linux 6.1 or later does this, other backends copy as usual. Small
+    /// packets are cheaper to copy than to pin, so keep this at tens of
+    /// kilobytes or more.
+    ///
+    /// Default: 0 (disabled).
+    program_options::value<unsigned> zerocopy_send_threshold;
+
+    /// \cond internal
+    posix_stack_options();
+    /// \endcond
+};
+
 class posix_network_stack : public network_stack {
 private:
     const bool _reuseport;
@@ -231,6 +252,14 @@ class posix_ap_network_stack : public posix_network_stack {
 };
 
 network_stack_entry register_posix_stack();
+
+// The descriptor of a connected socket of the posix stack, or nullptr for
+// sockets of other stacks. For protocols layered over a socket that need
+// more control of it than connected_socket_impl gives, like kernel TLS.
+pollable_fd* get_posix_fd(connected_socket_impl&) noexcept;
+
+// Whether the sinks of a socket of the posix stack send with MSG_ZEROCOPY
+bool posix_zerocopy_send(connected_socket_impl&) noexcept;
 }
 
 }
@@ -79,6 +79,8 @@ class datagram_channel_impl {
     virtual future<datagram> receive() = 0;
     virtual future<> send(const socket_address& dst, const char* msg) = 0;
     virtual future<> send(const socket_address& dst, packet p) = 0;
+    virtual future<std::vector<datagram>> receive_batch(size_t max_datagrams);
+    virtual future<> send_batch(std::vector<outgoing_datagram> datagrams);
     virtual void shutdown_input() = 0;
     virtual void shutdown_output() = 0;
     virtual bool is_closed() const = 0;
@@ -0,0 +1,119 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#endif
+
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/util/modules.hh>
+
+namespace seastar {
+
+namespace net {
+
+SEASTAR_MODULE_EXPORT_BEGIN
+
+/// The window a congestion control algorithm manages, in bytes
+struct tcp_congestion_window {
+    // Congestion window
+    uint32_t cwnd = 0;
+    // Slow start threshold
+    uint32_t ssthresh = 0;
+};
+
+/**
+ * Congestion control of the native TCP stack.
+ *
+ * The connection detects losses, with duplicate acknowledgements or the
+ * retransmission timer, and runs the fast recovery of RFC 5681 and RFC 6582;
+ * the algorithm decides how the window grows as data is acknowledged, and
+ * what it falls back to after a loss.
+ *
+ * The stack comes with "reno", the default, "cubic" (RFC 9438) and "bbr",
+ * a model of the bottleneck bandwidth and round trip time after BBR that
+ * only uses the window, as the stack does not pace. Algorithms are selected
+ * by name, like Linux' TCP_CONGESTION: with listen_options for accepted
+ * connections, and with the TCP_CONGESTION socket option for any connection.
+ * Others can be added with register_algorithm().
+ *
+ * Times come from the clock of the retransmission timers, so round trip
+ * times shorter than its period count as one period.
+ */
+class tcp_congestion_control {
+public:
+    using clock_type = lowres_clock;
+    using factory = std::unique_ptr<tcp_congestion_control> (*)();
+
+    struct ack_sample {
+        // Bytes newly acknowledged
+        uint32_t acked;
+        // Bytes in flight after the acknowledgement
+        uint32_t flight_size;
+        // Round trip time of the acknowledged segment, unless it was
+        // retransmitted
+        std::optional<clock_type::duration> rtt;
+        clock_type::time_point now;
+        // The connection is in fast recovery, which sets the window itself
+        bool recovery;
+    };
+protected:
+    // Sender maximum segment size
+    uint32_t _mss = 0;
+public:
+    virtual ~tcp_congestion_control() = default;
+
+    virtual std::string_view name() const noexcept = 0;
+
+    /// Takes over the window of a connection, which already has its initial
+    /// values, or whatever the previous algorithm left
+    virtual void init(tcp_congestion_window& w, uint32_t mss, clock_type::time_point now);
+    /// Grows the window on new data being acknowledged
+    virtual void on_ack(tcp_congestion_window& w, const ack_sample& s) = 0;
+    /// Returns the slow start threshold after a loss
+    virtual uint32_t on_loss(const tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now) = 0;
+    /// Sets the window to go on with once fast recovery is over
+    virtual void on_recovery_end(tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now);
+    /// The retransmission timer expired, for the first time for the segment
+    /// if first is set
+    virtual void on_timeout(tcp_congestion_window& w, uint32_t flight_size, bool first, clock_type::time_point now);
+
+    /// Makes an algorithm available by name. Register before starting the
+    /// network stack.
+    static void register_algorithm(sstring name, factory f);
+    /// Returns the factory of an algorithm, or nullptr if there is none
+    static factory find(std::string_view name) noexcept;
+    /// Creates an algorithm by name, or throws std::system_error(ENOENT)
+    static std::unique_ptr<tcp_congestion_control> make(std::string_view name);
+    static std::unique_ptr<tcp_congestion_control> make_default();
+};
+
+SEASTAR_MODULE_EXPORT_END
+
+}
+
+}
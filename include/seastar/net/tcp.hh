@@ -22,8 +22,10 @@
 #pragma once
 
 #ifndef SEASTAR_MODULE
+#include <algorithm>
 #include <unordered_map>
 #include <map>
+#include <array>
 #include <functional>
 #include <deque>
 #include <chrono>
@@ -42,6 +44,7 @@
 #include <seastar/net/ip.hh>
 #include <seastar/net/const.hh>
 #include <seastar/net/packet-util.hh>
+#include <seastar/net/tcp-congestion.hh>
 #include <seastar/util/assert.hh>
 #include <seastar/util/std-compat.hh>
 
@@ -94,10 +97,40 @@ void tcp_debug(const char* fmt, Args&&... args) {
 #endif
 }
 
+struct tcp_seq {
+    uint32_t raw;
+};
+
+inline tcp_seq ntoh(tcp_seq s) {
+    return tcp_seq { ntoh(s.raw) };
+}
+
+inline tcp_seq hton(tcp_seq s) {
+    return tcp_seq { hton(s.raw) };
+}
+
+inline
+std::ostream& operator<<(std::ostream& os, tcp_seq s) {
+    return os << s.raw;
+}
+
+inline tcp_seq make_seq(uint32_t raw) { return tcp_seq{raw}; }
+inline tcp_seq& operator+=(tcp_seq& s, int32_t n) { s.raw += n; return s; }
+inline tcp_seq& operator-=(tcp_seq& s, int32_t n) { s.raw -= n; return s; }
+inline tcp_seq operator+(tcp_seq s, int32_t n) { return s += n; }
+inline tcp_seq operator-(tcp_seq s, int32_t n) { return s -= n; }
+inline int32_t operator-(tcp_seq s, tcp_seq q) { return s.raw - q.raw; }
+inline bool operator==(tcp_seq s, tcp_seq q)  { return s.raw == q.raw; }
+inline bool operator!=(tcp_seq s, tcp_seq q) { return !(s == q); }
+inline bool operator<(tcp_seq s, tcp_seq q) { return s - q < 0; }
+inline bool operator>(tcp_seq s, tcp_seq q) { return q < s; }
+inline bool operator<=(tcp_seq s, tcp_seq q) { return !(s > q); }
+inline bool operator>=(tcp_seq s, tcp_seq q) { return !(s < q); }
+
 struct tcp_option {
     // The kind and len field are fixed and defined in TCP protocol
-    enum class option_kind: uint8_t { mss = 2, win_scale = 3, sack = 4, timestamps = 8,  nop = 1, eol = 0 };
-    enum class option_len:  uint8_t { mss = 4, win_scale = 3, sack = 2, timestamps = 10, nop = 1, eol = 1 };
+    enum class option_kind: uint8_t { mss = 2, win_scale = 3, sack_permitted = 4, sack = 5, timestamps = 8,  nop = 1, eol = 0 };
+    enum class option_len:  uint8_t { mss = 4, win_scale = 3, sack_permitted = 2, timestamps = 10, nop = 1, eol = 1 };
     static void write(char* p, option_kind kind, option_len len) {
         p[0] = static_cast<uint8_t>(kind);
         if (static_cast<uint8_t>(len) > 1) {
@@ -132,14 +165,47 @@ struct tcp_option {
             p[2] = shift;
         }
     };
+    struct sack_permitted {
+        static constexpr option_kind kind = option_kind::sack_permitted;
+        static constexpr option_len len = option_len::sack_permitted;
+        static tcp_option::sack_permitted read(const char* p) {
+            return {};
+        }
+        void write(char* p) const {
+            tcp_option::write(p, kind, len);
+        }
+    };
+    // Blocks of data received out of order (RFC 2018), the most recent
+    // first, unless the first one reports a duplicate (RFC 2883)
     struct sack {
         static constexpr option_kind kind = option_kind::sack;
-        static constexpr option_len len = option_len::sack;
+        // As many as fit the option space with no timestamps
+        static constexpr uint8_t max_blocks = 4;
+        struct block {
+            tcp_seq left;
+            tcp_seq right;
+        };
+        std::array<block, max_blocks> blocks;
+        uint8_t nr_blocks = 0;
+        uint8_t len() const {
+            return 2 + nr_blocks * 8;
+        }
         static tcp_option::sack read(const char* p) {
-            return {};
+            tcp_option::sack x;
+            x.nr_blocks = std::min<uint8_t>((uint8_t(p[1]) - 2) / 8, max_blocks);
+            for (uint8_t i = 0; i < x.nr_blocks; i++) {
+                x.blocks[i].left = tcp_seq{read_be<uint32_t>(p + 2 + i * 8)};
+                x.blocks[i].right = tcp_seq{read_be<uint32_t>(p + 6 + i * 8)};
+            }
+            return x;
         }
         void write(char* p) const {
-            tcp_option::write(p, kind, len);
+            p[0] = static_cast<uint8_t>(kind);
+            p[1] = len();
+            for (uint8_t i = 0; i < nr_blocks; i++) {
+                write_be<uint32_t>(p + 2 + i * 8, blocks[i].left.raw);
+                write_be<uint32_t>(p + 6 + i * 8, blocks[i].right.raw);
+            }
         }
     };
     struct timestamps {
@@ -176,6 +242,8 @@ struct tcp_option {
     static const uint8_t align = 4;
 
     void parse(uint8_t* beg, uint8_t* end);
+    // Returns the SACK option of a segment, if any
+    static sack parse_sack(uint8_t* beg, uint8_t* end);
     uint8_t fill(void* h, const tcp_hdr* th, uint8_t option_size);
     uint8_t get_size(bool syn_on, bool ack_on);
 
@@ -190,41 +258,13 @@ struct tcp_option {
     uint16_t _local_mss;
     uint8_t _remote_win_scale = 0;
     uint8_t _local_win_scale = 0;
+    // Sent with acknowledgements, once both ends permitted SACK
+    sack _local_sack;
 };
 inline char*& operator+=(char*& x, tcp_option::option_len len) { x += uint8_t(len); return x; }
 inline const char*& operator+=(const char*& x, tcp_option::option_len len) { x += uint8_t(len); return x; }
 inline uint8_t& operator+=(uint8_t& x, tcp_option::option_len len) { x += uint8_t(len); return x; }
 
-struct tcp_seq {
-    uint32_t raw;
-};
-
-inline tcp_seq ntoh(tcp_seq s) {
-    return tcp_seq { ntoh(s.raw) };
-}
-
-inline tcp_seq hton(tcp_seq s) {
-    return tcp_seq { hton(s.raw) };
-}
-
-inline
-std::ostream& operator<<(std::ostream& os, tcp_seq s) {
-    return os << s.raw;
-}
-
-inline tcp_seq make_seq(uint32_t raw) { return tcp_seq{raw}; }
-inline tcp_seq& operator+=(tcp_seq& s, int32_t n) { s.raw += n; return s; }
-inline tcp_seq& operator-=(tcp_seq& s, int32_t n) { s.raw -= n; return s; }
-inline tcp_seq operator+(tcp_seq s, int32_t n) { return s += n; }
-inline tcp_seq operator-(tcp_seq s, int32_t n) { return s -= n; }
-inline int32_t operator-(tcp_seq s, tcp_seq q) { return s.raw - q.raw; }
-inline bool operator==(tcp_seq s, tcp_seq q)  { return s.raw == q.raw; }
-inline bool operator!=(tcp_seq s, tcp_seq q) { return !(s == q); }
-inline bool operator<(tcp_seq s, tcp_seq q) { return s - q < 0; }
-inline bool operator>(tcp_seq s, tcp_seq q) { return q < s; }
-inline bool operator<=(tcp_seq s, tcp_seq q) { return !(s > q); }
-inline bool operator>=(tcp_seq s, tcp_seq q) { return !(s < q); }
-
 struct tcp_hdr {
     static constexpr size_t len = 20;
     uint16_t src_port;
@@ -327,6 +367,16 @@ class tcp {
             uint16_t data_len;
             unsigned nr_transmits;
             clock_type::time_point tx_time;
+            // Does not move when the segment is partially acknowledged,
+            // unlike its start
+            tcp_seq end;
+            // SACK scoreboard (RFC 6675)
+            // Selectively acknowledged by the receiver
+            bool sacked = false;
+            // Presumed lost, to be retransmitted
+            bool lost = false;
+            // Retransmitted since it was presumed lost
+            bool retransmitted = false;
         };
         struct send {
             tcp_seq unacknowledged;
@@ -356,10 +406,8 @@ class tcp {
             std::chrono::milliseconds srtt;
             bool first_rto_sample = true;
             clock_type::time_point syn_tx_time;
-            // Congestion window
-            uint32_t cwnd;
-            // Slow start threshold
-            uint32_t ssthresh;
+            // Congestion window and slow start threshold
+            tcp_congestion_window cong;
             // Duplicated ACKs
             uint16_t dupacks = 0;
             unsigned syn_retransmit = 0;
@@ -367,6 +415,27 @@ class tcp {
             uint32_t limited_transfer = 0;
             uint32_t partial_ack = 0;
             tcp_seq recover;
+            // In SACK based loss recovery (RFC 6675), until recover is acknowledged
+            bool sack_recovery = false;
+            // Data estimated to be in the network, used during SACK based loss
+            // recovery and kept up to date as segments change
+            uint32_t pipe = 0;
+            // SACK scoreboard hints, as sequence numbers so that they stay
+            // valid as acknowledged segments are dropped. Each acknowledgement
+            // only walks the segments past them.
+            //
+            // End of the highest selectively acknowledged segment
+            tcp_seq highest_sacked;
+            // The segments below it that are not selectively acknowledged
+            // are marked lost
+            tcp_seq lost_below;
+            // The segments below them have been retransmitted or need not
+            // be, as lost or as holes below highest_sacked respectively
+            tcp_seq retransmitted_lost;
+            tcp_seq retransmitted_holes;
+            // Blocks of the previous acknowledgement, whose segments are
+            // already marked
+            tcp_option::sack sack_cache;
             bool window_probe = false;
             uint8_t zero_window_probing_out = 0;
         } _snd;
@@ -381,12 +450,18 @@ class tcp {
             // The total size of data stored in std::deque<packet> data
             size_t data_size = 0;
             tcp_packet_merger out_of_order;
+            // Blocks of out of order data reported to the sender, the most
+            // recent first (RFC 2018)
+            tcp_option::sack sack;
+            // Data received twice, to report once (RFC 2883)
+            std::optional<tcp_option::sack::block> dsack;
             std::optional<promise<>> _data_received_promise;
             // The maximun memory buffer size allowed for receiving
             // Currently, it is the same as default receive window size when window scaling is enabled
             size_t max_receive_buf_size = 3737600;
         } _rcv;
         tcp_option _option;
+        std::unique_ptr<tcp_congestion_control> _cc = tcp_congestion_control::make_default();
         timer<lowres_clock> _delayed_ack;
         // Retransmission timeout
         std::chrono::milliseconds _rto{1000};
@@ -430,7 +505,7 @@ class tcp {
         void input_handle_listen_state(tcp_hdr* th, packet p);
         void input_handle_syn_sent_state(tcp_hdr* th, packet p);
         void input_handle_other_state(tcp_hdr* th, packet p);
-        void output_one(bool data_retransmit = false);
+        void output_one(unacked_segment* retransmit = nullptr, tcp_seq retransmit_seq = {});
         future<> wait_for_data();
         future<> wait_input_shutdown();
         void abort_reader() noexcept;
@@ -472,6 +547,13 @@ class tcp {
         tcp_state& state() {
             return _state;
         }
+        void set_congestion_control(tcp_congestion_control::factory f) {
+            _cc = f();
+            // Past the handshake, take over the window as it is
+            if (ack_needs_on()) {
+                _cc->init(_snd.cong, _snd.mss, clock_type::now());
+            }
+        }
     private:
         void respond_with_reset(tcp_hdr* th);
         bool merge_out_of_order();
@@ -481,8 +563,14 @@ class tcp {
         void clear_delayed_ack() noexcept;
         packet get_transmit_packet();
         void retransmit_one() {
-            bool data_retransmit = true;
-            output_one(data_retransmit);
+            retransmit_one(_snd.data.front(), _snd.unacknowledged);
+        }
+        void retransmit_one(unacked_segment& seg, tcp_seq seq) {
+            if (!seg.retransmitted) {
+                seg.retransmitted = true;
+                _snd.pipe += seg.p.len();
+            }
+            output_one(&seg, seq);
         }
         void start_retransmit_timer() {
             auto now = clock_type::now();
@@ -509,8 +597,31 @@ class tcp {
         void persist();
         void retransmit();
         void fast_retransmit();
+        bool update_scoreboard(tcp_seq seg_ack, const tcp_option::sack& sack);
+        // The first segment ending after seq
+        auto segment_after(tcp_seq seq) {
+            return std::partition_point(_snd.data.begin(), _snd.data.end(),
+                    [seq] (const unacked_segment& seg) { return seg.end <= seq; });
+        }
+        // What the segment adds to the data estimated to be in the network
+        static uint32_t in_pipe(const unacked_segment& seg) {
+            if (seg.sacked) {
+                return 0;
+            }
+            return (seg.lost ? 0 : seg.p.len()) + (seg.retransmitted ? seg.p.len() : 0);
+        }
+        void mark_lost(unacked_segment& seg) {
+            _snd.pipe -= in_pipe(seg);
+            seg.lost = true;
+            _snd.pipe += in_pipe(seg);
+        }
+        void update_lost();
+        void set_pipe();
+        void sack_ack(tcp_seq seg_ack, bool sacked);
+        void sack_retransmit();
+        void add_sack_block(tcp_option::sack::block b);
         void update_rto(clock_type::time_point tx_time);
-        void update_cwnd(uint32_t acked_bytes);
+        void update_cwnd(uint32_t acked_bytes, std::optional<clock_type::duration> rtt);
         void cleanup();
         uint32_t can_send() {
             if (_snd.window_probe) {
@@ -531,16 +642,22 @@ class tcp {
             // Can not send more than advertised window allows or unsent data size
             auto x = std::min(_snd.window - window_used, _snd.unsent_len);
 
-            // Can not send more than congestion window allows
-            x = std::min(_snd.cwnd, x);
-            if (_snd.dupacks == 1 || _snd.dupacks == 2) {
+            if (_snd.sack_recovery) {
+                // RFC6675: Send while the data estimated to be in the network
+                // leaves room for a full segment in the congestion window
+                x = _snd.pipe + _snd.mss <= _snd.cong.cwnd ? std::min(_snd.cong.cwnd - _snd.pipe, x) : 0;
+            } else if (_snd.dupacks == 1 || _snd.dupacks == 2) {
                 // RFC5681 Step 3.1
                 // Send cwnd + 2 * smss per RFC3042
                 auto flight = flight_size();
-                auto max = _snd.cwnd + 2 * _snd.mss;
+                auto max = _snd.cong.cwnd + 2 * _snd.mss;
                 x = flight <= max ? std::min(x, max - flight) : 0;
                 _snd.limited_transfer += x;
-            } else if (_snd.dupacks >= 3) {
+            } else {
+                // Can not send more than congestion window allows
+                x = window_used < _snd.cong.cwnd ? std::min(_snd.cong.cwnd - window_used, x) : 0;
+            }
+            if (_snd.dupacks >= 3 && !_snd.sack_recovery) {
                 // RFC5681 Step 3.5
                 // Sent 1 full-sized segment at most
                 x = std::min(uint32_t(_snd.mss), x);
@@ -623,6 +740,10 @@ class tcp {
             _snd.unacknowledged = _snd.initial;
             _snd.next = _snd.initial + 1;
             _snd.recover = _snd.initial;
+            _snd.highest_sacked = _snd.initial;
+            _snd.lost_below = _snd.initial;
+            _snd.retransmitted_lost = _snd.initial;
+            _snd.retransmitted_holes = _snd.initial;
         }
         void do_local_fin_acked() {
             _snd.unacknowledged += 1;
@@ -645,6 +766,7 @@ class tcp {
             return uint16_t(_state) & uint16_t(state);
         }
         void exit_fast_recovery() {
+            _snd.sack_recovery = false;
             _snd.dupacks = 0;
             _snd.limited_transfer = 0;
             _snd.partial_ack = 0;
@@ -664,11 +786,27 @@ class tcp {
     // queue for packets that do not belong to any tcb
     circular_buffer<ipv4_traits::l4packet> _packetq;
     semaphore _queue_space = {212992};
+public:
+    struct stats {
+        // Data segments sent again, after a timeout or during loss recovery
+        uint64_t retransmissions = 0;
+        // Duplicate segments the receiver reported (D-SACK, RFC 2883).
+        // Mostly retransmissions that turned out to be unnecessary, but
+        // duplicates made by the network are reported the same way.
+        uint64_t spurious_retransmissions = 0;
+        // Loss recoveries driven by selective acknowledgements
+        uint64_t sack_recoveries = 0;
+    };
+private:
+    stats _stats;
     metrics::metric_groups _metrics;
 public:
     const inet_type& inet() const {
         return _inet;
     }
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
     class connection {
         lw_shared_ptr<tcb> _tcb;
     public:
@@ -713,6 +851,13 @@ class tcp {
         uint16_t local_port() {
             return _tcb->_local_port;
         }
+        // Selects the congestion control algorithm of the connection
+        void set_congestion_control(tcp_congestion_control::factory f) {
+            _tcb->set_congestion_control(f);
+        }
+        std::string_view congestion_control() const noexcept {
+            return _tcb->_cc->name();
+        }
         void shutdown_connect();
         void close_read() noexcept;
         void close_write() noexcept;
@@ -722,6 +867,7 @@ class tcp {
         uint16_t _port;
         queue<connection> _q;
         size_t _pending = 0;
+        tcp_congestion_control::factory _congestion_control = nullptr;
     private:
         listener(tcp& t, uint16_t port, size_t queue_length)
             : _tcp(t), _port(port), _q(queue_length) {
@@ -729,7 +875,7 @@ class tcp {
         }
     public:
         listener(listener&& x)
-            : _tcp(x._tcp), _port(x._port), _q(std::move(x._q)) {
+            : _tcp(x._tcp), _port(x._port), _q(std::move(x._q)), _congestion_control(x._congestion_control) {
             _tcp._listening[_port] = this;
             x._port = 0;
         }
@@ -744,6 +890,15 @@ class tcp {
         void abort_accept() {
             _q.abort(std::make_exception_ptr(std::system_error(ECONNABORTED, std::system_category())));
         }
+        // Selects the congestion control algorithm of the connections accepted
+        // from now on, or throws std::system_error(ENOENT) if there is none
+        // with that name
+        void set_congestion_control(std::string_view name) {
+            _congestion_control = tcp_congestion_control::find(name);
+            if (!_congestion_control) {
+                throw std::system_error(ENOENT, std::system_category());
+            }
+        }
         bool full() { return _pending + _q.size() >= _q.max_size(); }
         void inc_pending() { _pending++; }
         void dec_pending() { _pending--; }
@@ -786,7 +941,13 @@ tcp<InetTraits>::tcp(inet_type& inet)
     _metrics.add_group("tcp", {
         sm::make_counter("linearizations", [] { return tcp_packet_merger::linearizations(); },
                         sm::description("Counts a number of times a buffer linearization was invoked during the buffers merge process. "
-                                        "Divide it by a total TCP receive packet rate to get an everage number of lineraizations per TCP packet."))
+                                        "Divide it by a total TCP receive packet rate to get an everage number of lineraizations per TCP packet.")),
+        sm::make_counter("retransmissions", _stats.retransmissions,
+                        sm::description("Counts data segments sent again, after a retransmission timeout or during loss recovery.")),
+        sm::make_counter("spurious_retransmissions", _stats.spurious_retransmissions,
+                        sm::description("Counts duplicate segments the receiver reported with D-SACK: mostly unnecessary retransmissions, but also duplicates made by the network.")),
+        sm::make_counter("sack_recoveries", _stats.sack_recoveries,
+                        sm::description("Counts loss recoveries driven by selective acknowledgements.")),
     });
 
     _inet.register_packet_provider([this, tcb_polled = 0u] () mutable {
@@ -915,6 +1076,9 @@ void tcp<InetTraits>::received(packet p, ipaddr from, ipaddr to) {
                 // check the security
                 // NOTE: Ignored for now
                 tcbp = make_lw_shared<tcb>(*this, id);
+                if (listener->second->_congestion_control) {
+                    tcbp->set_congestion_control(listener->second->_congestion_control);
+                }
                 _tcbs.insert({id, tcbp});
                 // TODO: we need to remove the tcb and decrease the pending if
                 // it stays SYN_RECEIVED state forever.
@@ -1030,14 +1194,17 @@ uint32_t tcp<InetTraits>::tcb::data_segment_acked(tcp_seq seg_ack) {
             && (_snd.unacknowledged + _snd.data.front().p.len() <= seg_ack)) {
         auto acked_bytes = _snd.data.front().p.len();
         _snd.unacknowledged += acked_bytes;
+        std::optional<clock_type::duration> rtt;
         // Ignore retransmitted segments when setting the RTO
         if (_snd.data.front().nr_transmits == 0) {
             update_rto(_snd.data.front().tx_time);
+            rtt = clock_type::now() - _snd.data.front().tx_time;
         }
-        update_cwnd(acked_bytes);
+        update_cwnd(acked_bytes, rtt);
         total_acked_bytes += acked_bytes;
         _snd.current_queue_space -= _snd.data.front().data_len;
         signal_send_available();
+        _snd.pipe -= in_pipe(_snd.data.front());
         _snd.data.pop_front();
     }
     // Partial ACK of segment
@@ -1045,12 +1212,25 @@ uint32_t tcp<InetTraits>::tcb::data_segment_acked(tcp_seq seg_ack) {
         auto acked_bytes = seg_ack - _snd.unacknowledged;
         if (!_snd.data.empty()) {
             auto& unacked_seg = _snd.data.front();
+            _snd.pipe -= in_pipe(unacked_seg);
             unacked_seg.p.trim_front(acked_bytes);
+            _snd.pipe += in_pipe(unacked_seg);
         }
         _snd.unacknowledged = seg_ack;
-        update_cwnd(acked_bytes);
+        update_cwnd(acked_bytes, std::nullopt);
         total_acked_bytes += acked_bytes;
     }
+    // Keep the scoreboard hints within the window, sequence numbers only
+    // compare within 2GB of each other
+    for (auto hint : {&_snd.highest_sacked, &_snd.lost_below, &_snd.retransmitted_lost, &_snd.retransmitted_holes}) {
+        if (*hint < _snd.unacknowledged) {
+            *hint = _snd.unacknowledged;
+        }
+    }
+    auto& cache = _snd.sack_cache;
+    auto stale = std::remove_if(cache.blocks.begin(), cache.blocks.begin() + cache.nr_blocks,
+            [this] (const tcp_option::sack::block& b) { return b.right <= _snd.unacknowledged; });
+    cache.nr_blocks = stale - cache.blocks.begin();
     return total_acked_bytes;
 }
 
@@ -1100,15 +1280,17 @@ void tcp<InetTraits>::tcb::init_from_options(tcp_hdr* th, uint8_t* opt_start, ui
 
     // Setup initial congestion window
     if (2190 < _snd.mss) {
-        _snd.cwnd = 2 * _snd.mss;
+        _snd.cong.cwnd = 2 * _snd.mss;
     } else if (1095 < _snd.mss && _snd.mss <= 2190) {
-        _snd.cwnd = 3 * _snd.mss;
+        _snd.cong.cwnd = 3 * _snd.mss;
     } else {
-        _snd.cwnd = 4 * _snd.mss;
+        _snd.cong.cwnd = 4 * _snd.mss;
     }
 
     // Setup initial slow start threshold
-    _snd.ssthresh = th->window << _snd.window_scale;
+    _snd.cong.ssthresh = th->window << _snd.window_scale;
+
+    _cc->init(_snd.cong, _snd.mss, clock_type::now());
 }
 
 template <typename InetTraits>
@@ -1213,6 +1395,11 @@ void tcp<InetTraits>::tcb::input_handle_syn_sent_state(tcp_hdr* th, packet p) {
 
 template <typename InetTraits>
 void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
+    tcp_option::sack sack;
+    if (_option._sack_received && th->data_offset * 4 > tcp_hdr::len) {
+        auto opt_start = reinterpret_cast<uint8_t*>(p.get_header(0, th->data_offset * 4)) + tcp_hdr::len;
+        sack = tcp_option::parse_sack(opt_start, opt_start + th->data_offset * 4 - tcp_hdr::len);
+    }
     p.trim_front(th->data_offset * 4);
     bool do_output = false;
     bool do_output_data = false;
@@ -1222,6 +1409,10 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
 
     // 4.1 first check sequence number
     if (!segment_acceptable(seg_seq, seg_len)) {
+        if (_option._sack_received && seg_len && seg_seq + seg_len <= _rcv.next) {
+            // RFC2883: Report the duplicate
+            _rcv.dsack = tcp_option::sack::block{seg_seq, seg_seq + seg_len};
+        }
         //<SEQ=SND.NXT><ACK=RCV.NXT><CTL=ACK>
         return output();
     }
@@ -1231,6 +1422,10 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
     if (seg_seq < _rcv.next) {
         // ignore already acknowledged data
         auto dup = std::min(uint32_t(_rcv.next - seg_seq), seg_len);
+        if (_option._sack_received && dup) {
+            // RFC2883: Report the duplicate
+            _rcv.dsack = tcp_option::sack::block{seg_seq, seg_seq + dup};
+        }
         p.trim_front(dup);
         seg_len -= dup;
         seg_seq += dup;
@@ -1332,6 +1527,9 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
         if (in_state(ESTABLISHED | CLOSE_WAIT)){
             // When we are in zero window probing phase and packets_out = 0 we bypass "duplicated ack" check
             auto packets_out = _snd.next - _snd.unacknowledged - _snd.zero_window_probing_out;
+            // Whether the receiver selectively acknowledged data for the first time
+            bool sacked = sack.nr_blocks && _snd.unacknowledged <= seg_ack && seg_ack <= _snd.next
+                    && update_scoreboard(seg_ack, sack);
             // If SND.UNA < SEG.ACK =< SND.NXT then, set SND.UNA <- SEG.ACK.
             if (_snd.unacknowledged < seg_ack && seg_ack <= _snd.next) {
                 // Remote ACKed data we sent
@@ -1357,13 +1555,20 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                     }
                 };
 
-                if (_snd.dupacks >= 3) {
+                if (_option._sack_received) {
+                    if (!_snd.sack_recovery) {
+                        // RFC6675: A cumulative acknowledgement resets the
+                        // duplicate acknowledgements
+                        exit_fast_recovery();
+                    }
+                    sack_ack(seg_ack, sacked);
+                    set_retransmit_timer();
+                } else if (_snd.dupacks >= 3) {
                     // We are in fast retransmit / fast recovery phase
                     uint32_t smss = _snd.mss;
                     if (seg_ack > _snd.recover) {
                         tcp_debug("ack: full_ack\n");
-                        // Set cwnd to min (ssthresh, max(FlightSize, SMSS) + SMSS)
-                        _snd.cwnd = std::min(_snd.ssthresh, std::max(flight_size(), smss) + smss);
+                        _cc->on_recovery_end(_snd.cong, flight_size(), clock_type::now());
                         // Exit the fast recovery procedure
                         exit_fast_recovery();
                         set_retransmit_timer();
@@ -1373,11 +1578,11 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                         fast_retransmit();
                         // Deflate the congestion window by the amount of new data
                         // acknowledged by the Cumulative Acknowledgment field
-                        _snd.cwnd -= acked_bytes;
+                        _snd.cong.cwnd -= acked_bytes;
                         // If the partial ACK acknowledges at least one SMSS of new
                         // data, then add back SMSS bytes to the congestion window
                         if (acked_bytes >= smss) {
-                            _snd.cwnd += smss;
+                            _snd.cong.cwnd += smss;
                         }
                         // Send a new segment if permitted by the new value of
                         // cwnd.  Do not exit the fast recovery procedure For
@@ -1398,7 +1603,12 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                     exit_fast_recovery();
                     set_retransmit_timer();
                 }
-            } else if ((packets_out > 0) && !_snd.data.empty() && seg_len == 0 &&
+            } else if (sacked && seg_ack == _snd.unacknowledged) {
+                // RFC6675: An acknowledgement that selectively acknowledges
+                // new data is a duplicate acknowledgement, whatever it carries
+                sack_ack(seg_ack, sacked);
+                do_output_data = true;
+            } else if (!_option._sack_received && (packets_out > 0) && !_snd.data.empty() && seg_len == 0 &&
                 th->f_fin == 0 && th->f_syn == 0 &&
                 th->ack == _snd.unacknowledged &&
                 uint32_t(th->window << _snd.window_scale) == _snd.window) {
@@ -1421,16 +1631,16 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                     if (seg_ack - 1 > _snd.recover) {
                         _snd.recover = _snd.next - 1;
                         // RFC5681 Step 3.2
-                        _snd.ssthresh = std::max((flight_size() - _snd.limited_transfer) / 2, 2 * smss);
+                        _snd.cong.ssthresh = _cc->on_loss(_snd.cong, flight_size() - _snd.limited_transfer, clock_type::now());
                         fast_retransmit();
                     } else {
                         // Do not enter fast retransmit and do not reset ssthresh
                     }
                     // RFC5681 Step 3.3
-                    _snd.cwnd = _snd.ssthresh + 3 * smss;
+                    _snd.cong.cwnd = _snd.cong.ssthresh + 3 * smss;
                 } else if (_snd.dupacks > 3) {
                     // RFC5681 Step 3.4
-                    _snd.cwnd += smss;
+                    _snd.cong.cwnd += smss;
                     // RFC5681 Step 3.5
                     do_output_data = true;
                 }
@@ -1438,6 +1648,12 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                 // If the ACK acks something not yet sent (SEG.ACK > SND.NXT)
                 // then send an ACK, drop the segment, and return
                 return output();
+            } else if (seg_ack == _snd.unacknowledged && uint32_t(th->window << _snd.window_scale) != _snd.window
+                    && (_snd.wl1 < seg_seq || (_snd.wl1 == seg_seq && _snd.wl2 <= seg_ack))) {
+                // A window update: not a duplicate acknowledgement, but the
+                // ones that follow with the same window are
+                update_window();
+                do_output_data = true;
             } else if (_snd.window == 0 && th->window > 0) {
                 update_window();
                 do_output_data = true;
@@ -1504,6 +1720,14 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
             _rcv.data.push_back(std::move(p));
             _rcv.next += seg_len;
             auto merged = merge_out_of_order();
+            // Stop reporting the blocks that are no longer out of order
+            auto& reported = _rcv.sack;
+            auto nr_blocks = std::exchange(reported.nr_blocks, 0);
+            for (uint8_t i = 0; i < nr_blocks; i++) {
+                if (reported.blocks[i].right > _rcv.next) {
+                    reported.blocks[reported.nr_blocks++] = reported.blocks[i];
+                }
+            }
             _rcv.window = get_modified_receive_window_size();
             signal_data_received();
             // Send an acknowledgment of the form:
@@ -1589,6 +1813,8 @@ packet tcp<InetTraits>::tcb::get_transmit_packet() {
     } else {
         len = std::min(uint16_t(_tcp.hw_features().mtu - net::tcp_hdr_len_min - InetTraits::ip_hdr_len_min), _snd.mss);
     }
+    // SACK blocks take room from the payload (RFC 6691)
+    len -= _option.get_size(false, ack_needs_on());
     can_send = std::min(can_send, len);
     // easy case: one small packet
     if (_snd.unsent.size() == 1 && _snd.unsent.front().len() <= can_send) {
@@ -1624,12 +1850,34 @@ packet tcp<InetTraits>::tcb::get_transmit_packet() {
 }
 
 template <typename InetTraits>
-void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
+void tcp<InetTraits>::tcb::output_one(unacked_segment* retransmit, tcp_seq retransmit_seq) {
     if (in_state(CLOSED)) {
         return;
     }
 
-    packet p = data_retransmit ? _snd.data.front().p.share() : get_transmit_packet();
+    if (_option._sack_received) {
+        // RFC2018: Report the latest blocks of out of order data, after the
+        // latest duplicate, if any (RFC2883)
+        auto& sack = _option._local_sack;
+        sack.nr_blocks = 0;
+        if (_rcv.dsack) {
+            sack.blocks[sack.nr_blocks++] = *_rcv.dsack;
+        }
+        for (uint8_t i = 0; i < _rcv.sack.nr_blocks && sack.nr_blocks < sack.max_blocks; i++) {
+            sack.blocks[sack.nr_blocks++] = _rcv.sack.blocks[i];
+        }
+        if (retransmit && retransmit->p.len() + _option.get_size(false, true) > _snd.mss) {
+            // No room left in a segment sent before them, the duplicate is
+            // reported by the next segment
+            sack.nr_blocks = 0;
+        } else if (_rcv.dsack && !syn_needs_on() && ack_needs_on()) {
+            // Reported once
+            _rcv.dsack.reset();
+        }
+    }
+
+    bool data_retransmit = retransmit;
+    packet p = data_retransmit ? retransmit->p.share() : get_transmit_packet();
     packet clone = p.share();  // early clone to prevent share() from calling packet::unuse_internal_data() on header.
     uint16_t len = p.len();
     bool syn_on = syn_needs_on();
@@ -1652,7 +1900,8 @@ void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
 
     tcp_seq seq;
     if (data_retransmit) {
-        seq = _snd.unacknowledged;
+        seq = retransmit_seq;
+        _tcp._stats.retransmissions++;
     } else {
         seq = syn_on ? _snd.initial : _snd.next;
         _snd.next += len;
@@ -1690,7 +1939,7 @@ void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
         // CSUM offload case.
         //
         if (_tcp.hw_features().tx_tso && len > _snd.mss) {
-            oi.tso_seg_size = _snd.mss;
+            oi.tso_seg_size = _snd.mss - options_size;
         } else {
             pseudo_hdr_seg_len = tcp_hdr::len + options_size + len;
         }
@@ -1720,7 +1969,8 @@ void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
         if (len) {
             unsigned nr_transmits = 0;
             _snd.data.emplace_back(unacked_segment{std::move(clone),
-                                   len, nr_transmits, now});
+                                   len, nr_transmits, now, seq + len});
+            _snd.pipe += len;
         }
         if (!_retransmit.armed()) {
             start_retransmit_timer(now);
@@ -1931,7 +2181,36 @@ bool tcp<InetTraits>::tcb::merge_out_of_order() {
 
 template <typename InetTraits>
 void tcp<InetTraits>::tcb::insert_out_of_order(tcp_seq seg, packet p) {
+    auto len = p.len();
+    if (!_option._sack_received || !len) {
+        _rcv.out_of_order.merge(seg, std::move(p));
+        return;
+    }
+    auto& map = _rcv.out_of_order.map;
+    auto it = map.upper_bound(seg);
+    if (it != map.begin() && seg + len <= std::prev(it)->first + std::prev(it)->second.len()) {
+        // RFC2883: Report the duplicate
+        _rcv.dsack = tcp_option::sack::block{seg, seg + len};
+    }
     _rcv.out_of_order.merge(seg, std::move(p));
+    // RFC2018: Report the block the segment is part of
+    it = std::prev(map.upper_bound(seg));
+    add_sack_block({it->first, it->first + it->second.len()});
+}
+
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::add_sack_block(tcp_option::sack::block b) {
+    // The block first, then those reported before it does not cover
+    auto& reported = _rcv.sack;
+    tcp_option::sack sack;
+    sack.blocks[sack.nr_blocks++] = b;
+    for (uint8_t i = 0; i < reported.nr_blocks && sack.nr_blocks < sack.max_blocks; i++) {
+        auto& x = reported.blocks[i];
+        if (x.right < b.left || b.right < x.left) {
+            sack.blocks[sack.nr_blocks++] = x;
+        }
+    }
+    reported = sack;
 }
 
 template <typename InetTraits>
@@ -1992,16 +2271,27 @@ void tcp<InetTraits>::tcb::retransmit() {
     // If there are unacked data, retransmit the earliest segment
     auto& unacked_seg = _snd.data.front();
 
-    // According to RFC5681
-    // Update ssthresh only for the first retransmit
-    uint32_t smss = _snd.mss;
-    if (unacked_seg.nr_transmits == 0) {
-        _snd.ssthresh = std::max(flight_size() / 2, 2 * smss);
+    if (_option._sack_received) {
+        // RFC6675 5.1: Go on with slow start filling all the holes the
+        // receiver reported, after the earliest segment. Like most stacks,
+        // keep the scoreboard rather than discarding it in case the receiver
+        // reneged, as RFC2018 suggests.
+        for (auto& seg : _snd.data) {
+            seg.lost = !seg.sacked;
+            seg.retransmitted = false;
+        }
+        _snd.lost_below = _snd.next;
+        _snd.retransmitted_lost = _snd.unacknowledged;
+        _snd.retransmitted_holes = _snd.unacknowledged;
+        set_pipe();
     }
+
+    // According to RFC5681
+    // Update ssthresh only for the first retransmit, and start the slow start
+    // process
+    _cc->on_timeout(_snd.cong, flight_size(), unacked_seg.nr_transmits == 0, clock_type::now());
     // RFC6582 Step 4
     _snd.recover = _snd.next - 1;
-    // Start the slow start process
-    _snd.cwnd = smss;
     // End fast recovery
     exit_fast_recovery();
 
@@ -2027,6 +2317,194 @@ void tcp<InetTraits>::tcb::fast_retransmit() {
     }
 }
 
+// Marks the segments the SACK option of an acknowledgement covers, and
+// returns whether it selectively acknowledged new data. Receivers repeat
+// their blocks as they grow, so the segments a block of the previous
+// acknowledgement covered are skipped.
+template <typename InetTraits>
+bool tcp<InetTraits>::tcb::update_scoreboard(tcp_seq seg_ack, const tcp_option::sack& sack) {
+    uint8_t first = 0;
+    auto& d = sack.blocks[0];
+    if (d.right <= seg_ack || (sack.nr_blocks > 1 && sack.blocks[1].left <= d.left && d.right <= sack.blocks[1].right)) {
+        // RFC2883: The first block reports data the receiver got twice,
+        // which can't be told from a network duplicate once acknowledged
+        _tcp._stats.spurious_retransmissions++;
+        first = 1;
+    }
+    auto& cache = _snd.sack_cache;
+    auto marked_by_cache = [&] (tcp_seq seq, tcp_seq end) -> const tcp_option::sack::block* {
+        for (uint8_t i = 0; i < cache.nr_blocks; i++) {
+            if (cache.blocks[i].left <= seq && end <= cache.blocks[i].right) {
+                return &cache.blocks[i];
+            }
+        }
+        return nullptr;
+    };
+    bool sacked = false;
+    tcp_option::sack marked;
+    for (auto i = first; i < sack.nr_blocks; i++) {
+        auto& b = sack.blocks[i];
+        if (_snd.next < b.right) {
+            continue;
+        }
+        auto it = segment_after(b.left < seg_ack ? seg_ack : b.left);
+        while (it != _snd.data.end() && it->end <= b.right) {
+            auto seq = it->end - it->p.len();
+            if (auto c = marked_by_cache(seq, it->end)) {
+                it = segment_after(c->right);
+                continue;
+            }
+            if (b.left <= seq && seq >= seg_ack && !it->sacked) {
+                _snd.pipe -= in_pipe(*it);
+                it->sacked = true;
+                sacked = true;
+                if (_snd.highest_sacked < it->end) {
+                    _snd.highest_sacked = it->end;
+                }
+            }
+            ++it;
+        }
+        // A block reaching below SEG.ACK may leave the segment straddling
+        // it unmarked, so it can't vouch for the segments it covers
+        if (seg_ack <= b.left) {
+            marked.blocks[marked.nr_blocks++] = b;
+        }
+    }
+    cache = marked;
+    return sacked;
+}
+
+// RFC6675 IsLost(): A segment is lost once enough data above it is
+// selectively acknowledged. That only grows as going down the queue, so the
+// lost segments are the ones below a boundary. It is found walking down from
+// the highest selectively acknowledged segment, and only the segments
+// between the previous boundary and the new one are marked.
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::update_lost() {
+    constexpr unsigned dupthresh = 3;
+    // Discontiguous selectively acknowledged sequences above the segment,
+    // and their size
+    unsigned sequences = 0;
+    uint32_t sacked_bytes = 0;
+    bool sacked_above = false;
+    auto lowest = segment_after(_snd.lost_below);
+    auto it = segment_after(_snd.highest_sacked);
+    while (lowest < it) {
+        auto& seg = *--it;
+        if (seg.sacked) {
+            sequences += !sacked_above;
+            sacked_bytes += seg.p.len();
+            sacked_above = true;
+            continue;
+        }
+        sacked_above = false;
+        if (sequences >= dupthresh || sacked_bytes > (dupthresh - 1) * _snd.mss) {
+            _snd.lost_below = seg.end;
+            for (;; --it) {
+                if (!it->sacked && !it->lost) {
+                    mark_lost(*it);
+                }
+                if (it == lowest) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+// RFC6675 SetPipe(), from scratch. Otherwise the pipe is kept up to date
+// as segments are sent, marked and acknowledged.
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::set_pipe() {
+    _snd.pipe = 0;
+    for (auto& seg : _snd.data) {
+        _snd.pipe += in_pipe(seg);
+    }
+}
+
+// RFC6675 loss recovery, on an acknowledgement that moves SND.UNA or
+// selectively acknowledges new data
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::sack_ack(tcp_seq seg_ack, bool sacked) {
+    auto now = clock_type::now();
+    if (_snd.sack_recovery) {
+        if (seg_ack <= _snd.recover) {
+            update_lost();
+            return sack_retransmit();
+        }
+        tcp_debug("ack: sack recovery done\n");
+        _cc->on_recovery_end(_snd.cong, flight_size(), now);
+        exit_fast_recovery();
+    }
+    if (sacked) {
+        _snd.dupacks++;
+    }
+    update_lost();
+    // Enter loss recovery on the third duplicate acknowledgement, or once
+    // the earliest segment is presumed lost. Not before the data sent before
+    // the last recovery or timeout is acknowledged, though.
+    if (sacked && (_snd.dupacks >= 3 || _snd.data.front().lost) && seg_ack - 1 > _snd.recover) {
+        tcp_debug("ack: sack recovery\n");
+        _snd.recover = _snd.next - 1;
+        auto flight = flight_size();
+        // Data sent by limited transmit does not count (RFC3042)
+        _snd.cong.ssthresh = _cc->on_loss(_snd.cong, flight - std::min(flight, _snd.limited_transfer), now);
+        _snd.cong.cwnd = _snd.cong.ssthresh;
+        _snd.sack_recovery = true;
+        _tcp._stats.sack_recoveries++;
+        // Retransmit the earliest segment, whatever the pipe
+        auto& unacked_seg = _snd.data.front();
+        if (!unacked_seg.lost) {
+            mark_lost(unacked_seg);
+        }
+        if (_snd.lost_below < unacked_seg.end) {
+            _snd.lost_below = unacked_seg.end;
+        }
+        unacked_seg.nr_transmits++;
+        retransmit_one();
+        output();
+    }
+    sack_retransmit();
+}
+
+// RFC6675 NextSeg(): Retransmits the segments presumed lost, and during loss
+// recovery when there is no new data to send, those below data the receiver
+// selectively acknowledged, while the data estimated to be in the network
+// leaves room for them in the congestion window. Each kind is retransmitted
+// in order, from where the previous call stopped, like Linux'
+// retransmit_skb_hint.
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::sack_retransmit() {
+    bool retransmitted = false;
+    // Retransmits the segments ending at or below limit, from hint on
+    auto retransmit_below = [&] (tcp_seq& hint, tcp_seq limit) {
+        for (auto it = segment_after(hint); it != _snd.data.end() && it->end <= limit; ++it) {
+            auto seq = it->end - it->p.len();
+            if (_snd.pipe + _snd.mss > _snd.cong.cwnd) {
+                hint = seq;
+                return;
+            }
+            if (!it->sacked && !it->retransmitted) {
+                it->nr_transmits++;
+                retransmit_one(*it, seq);
+                retransmitted = true;
+            }
+        }
+        if (hint < limit) {
+            hint = limit;
+        }
+    };
+    // All the segments below lost_below that are not selectively
+    // acknowledged are lost
+    retransmit_below(_snd.retransmitted_lost, _snd.lost_below);
+    if (_snd.sack_recovery && !_snd.unsent_len) {
+        retransmit_below(_snd.retransmitted_holes, _snd.highest_sacked);
+    }
+    if (retransmitted) {
+        output();
+    }
+}
+
 template <typename InetTraits>
 void tcp<InetTraits>::tcb::update_rto(clock_type::time_point tx_time) {
     // Update RTO according to RFC6298
@@ -2054,16 +2532,14 @@ void tcp<InetTraits>::tcb::update_rto(clock_type::time_point tx_time) {
 }
 
 template <typename InetTraits>
-void tcp<InetTraits>::tcb::update_cwnd(uint32_t acked_bytes) {
-    uint32_t smss = _snd.mss;
-    if (_snd.cwnd < _snd.ssthresh) {
-        // In slow start phase
-        _snd.cwnd += std::min(acked_bytes, smss);
-    } else {
-        // In congestion avoidance phase
-        uint32_t round_up = 1;
-        _snd.cwnd += std::max(round_up, smss * smss / _snd.cwnd);
-    }
+void tcp<InetTraits>::tcb::update_cwnd(uint32_t acked_bytes, std::optional<clock_type::duration> rtt) {
+    _cc->on_ack(_snd.cong, tcp_congestion_control::ack_sample{
+        .acked = acked_bytes,
+        .flight_size = uint32_t(_snd.next - _snd.unacknowledged),
+        .rtt = rtt,
+        .now = clock_type::now(),
+        .recovery = _snd.dupacks >= 3 || _snd.sack_recovery,
+    });
 }
 
 template <typename InetTraits>
@@ -2118,7 +2594,7 @@ std::optional<typename InetTraits::l4packet> tcp<InetTraits>::tcb::get_packet()
 
     auto p = std::move(_packetq.front());
     _packetq.pop_front();
-    if (!_packetq.empty() || (_snd.dupacks < 3 && can_send() > 0 && (_snd.window > 0))) {
+    if (!_packetq.empty() || ((_snd.dupacks < 3 || _snd.sack_recovery) && can_send() > 0 && (_snd.window > 0))) {
         // If there are packets to send in the queue or tcb is allowed to send
         // more add tcp back to polling set to keep sending. In addition, dupacks >= 3
         // is an indication that an segment is lost, stop sending more in this case.
@@ -71,6 +71,8 @@ namespace tls {
     class server_credentials;
     class certificate_credentials;
     class credentials_builder;
+    class client_session_cache;
+    class session_ticket_key_rotation;
 
     /**
      * Diffie-Hellman parameters for
@@ -226,12 +228,33 @@ namespace tls {
          */
         void set_enable_certificate_verification(bool enable);
 
+        /**
+         * Hand the keys of sessions to the kernel once the handshake is done
+         * (Linux kernel TLS), so that records are encrypted and decrypted by
+         * the socket itself and application data takes the same read and write
+         * path as cleartext. Only done for sockets of the posix stack, and for
+         * TLS 1.2 and 1.3 sessions using AES-GCM or ChaCha20-Poly1305. Sessions
+         * fall back to gnutls when the kernel lacks the "tls" module or any of
+         * these does not hold. See get_kernel_offload.
+         */
+        void set_enable_kernel_offload(bool enable);
+
+        /**
+         * Resume client sessions with the session data the cache has for
+         * their server, and store there what servers send for the next
+         * connection. See client_session_cache in seastar/net/tls_resumption.hh.
+         * Sessions given session_resume_data in their tls_options use that
+         * instead. Pass nullptr to stop using a cache.
+         */
+        void set_session_cache(shared_ptr<client_session_cache>);
+
     private:
         class impl;
         friend class session;
         friend class server_session;
         friend class server_credentials;
         friend class credentials_builder;
+        friend class session_ticket_key_rotation;
         template<typename Base>
         friend class reloadable_credentials;
         shared_ptr<impl> _impl;
@@ -323,6 +346,8 @@ namespace tls {
          * simply call this method again to regenerate the key.
          */
         void set_session_resume_mode(session_resume_mode);
+        /// See certificate_credentials::set_enable_kernel_offload
+        void set_enable_kernel_offload(bool);
 
         void apply_to(certificate_credentials&) const;
 
@@ -347,6 +372,7 @@ namespace tls {
         session_resume_mode _session_resume_mode = session_resume_mode::NONE;
         sstring _priority;
         std::vector<uint8_t> _session_resume_key;
+        bool _enable_kernel_offload = false;
     };
 
     using session_data = std::vector<uint8_t>;
@@ -537,6 +563,28 @@ namespace tls {
     */
     future<session_data> get_session_resume_data(connected_socket&);
 
+    /// Which directions of a session are encrypted by the kernel
+    struct kernel_offload {
+        bool tx = false;
+        bool rx = false;
+    };
+
+    /**
+     * Get the directions of a connected socket handed to the kernel, see
+     * certificate_credentials::set_enable_kernel_offload. Will force handshake
+     * if not already done.
+     *
+     * Transmit is offloaded whenever the cipher suite allows. Receive is not
+     * offloaded when the peer already sent records the session had to decrypt,
+     * nor for TLS 1.3 clients, which get session tickets after the handshake,
+     * nor when the reactor receives ahead of the application on the socket
+     * (io_uring with --uring-buffer-ring-entries).
+     *
+     * If the socket is not connected a system_error exception will be thrown.
+     * If the socket is not a TLS socket an exception will be thrown.
+    */
+    future<kernel_offload> get_kernel_offload(connected_socket&);
+
     std::ostream& operator<<(std::ostream&, const subject_alt_name::value_type&);
     std::ostream& operator<<(std::ostream&, const subject_alt_name&);
 
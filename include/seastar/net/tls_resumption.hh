@@ -0,0 +1,140 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#ifndef SEASTAR_MODULE
+#include <chrono>
+#include <optional>
+#include <vector>
+#endif
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/lowres_clock.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/sharded_cache.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/net/tls.hh>
+#include <seastar/util/modules.hh>
+
+namespace seastar {
+
+SEASTAR_MODULE_EXPORT
+namespace tls {
+
+/**
+ * Client side cache of sessions to resume.
+ *
+ * Keeps the session data of the latest session to each server, by server
+ * name, or by address for connections without one, so that reconnecting
+ * clients resume their session instead of going through a full handshake.
+ * Install it with certificate_credentials::set_session_cache(). Sessions
+ * store their data as soon as the server sends it, which for TLS 1.3 is
+ * after the handshake, along with the first records the server sends.
+ *
+ * Like the credentials, a cache belongs to the shard that created it.
+ */
+class client_session_cache {
+    struct entry : public cache_entry<lru_eviction> {
+        sstring _server;
+        session_data data;
+
+        entry(sstring server, session_data d);
+        const sstring& key() const noexcept {
+            return _server;
+        }
+    };
+
+    lowres_clock::duration _ttl;
+    local_cache<entry, lru_eviction> _cache;
+public:
+    using stats = local_cache<entry, lru_eviction>::stats;
+
+    /// \param max_entries number of servers to keep sessions of
+    /// \param ttl how long a session is kept. Servers refuse tickets past
+    ///            their lifetime, 6 hours with gnutls by default.
+    explicit client_session_cache(size_t max_entries = 1024, lowres_clock::duration ttl = std::chrono::hours(1));
+    ~client_session_cache();
+
+    /// Returns the session data stored for the server, if any
+    std::optional<session_data> get(const sstring& server);
+    /// Stores the session data of a server, replacing any previous one
+    void put(const sstring& server, session_data data);
+    /// Forgets the session of a server
+    void erase(const sstring& server);
+    void clear() noexcept;
+
+    size_t size() const noexcept {
+        return _cache.size();
+    }
+    /// Hits and misses of get, sessions expired and evicted
+    const stats& get_stats() const noexcept {
+        return _cache.get_stats();
+    }
+};
+
+/**
+ * Shares the session ticket key of server credentials across shards, and
+ * rotates it.
+ *
+ * Servers encrypt session tickets with a key of their credentials, and can
+ * only resume sessions whose ticket was encrypted with theirs; a client that
+ * reconnects to another shard needs the same key there. Start this as a
+ * sharded<> service, with an initial key from generate_key(), and register
+ * the server credentials of each shard with add() on that shard: all get the
+ * same key, and shard 0 replaces it on all shards every interval.
+ *
+ * Tickets issued before a rotation no longer resume, so the interval trades
+ * how much a leaked key exposes against one full handshake per client and
+ * interval. Within an interval, gnutls already encrypts with keys it derives
+ * from the shared one and changes periodically.
+ *
+ * Credentials added here keep the rotated key when reloaded.
+ */
+class session_ticket_key_rotation : public peering_sharded_service<session_ticket_key_rotation> {
+    lowres_clock::duration _interval;
+    session_data _key;
+    std::vector<shared_ptr<server_credentials>> _creds;
+    timer<lowres_clock> _timer;
+    gate _gate;
+private:
+    void set_key(const session_data& key);
+public:
+    session_ticket_key_rotation(lowres_clock::duration interval, session_data initial_key);
+    ~session_ticket_key_rotation();
+
+    /// Generates a random session ticket key
+    static session_data generate_key();
+
+    /// Turns on TLS 1.3 session tickets for the credentials, encrypted with
+    /// the shared key
+    void add(shared_ptr<server_credentials>);
+
+    /// Replaces the key on all shards with a new one
+    future<> rotate();
+
+    future<> stop();
+};
+
+}
+
+}
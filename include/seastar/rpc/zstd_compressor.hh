@@ -0,0 +1,95 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/rpc/rpc_types.hh>
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace seastar {
+namespace rpc {
+
+/// Zstandard compressor for RPC frames.
+///
+/// Every frame is an independent zstd frame. Fragmented snd_buf/rcv_buf
+/// payloads are fed to the zstd streaming interface fragment by fragment,
+/// and large outputs are produced directly into snd_buf::chunk_size
+/// fragments, so neither side is ever linearized.
+///
+/// Both peers may additionally share a dictionary, which considerably
+/// improves the ratio for the small, similar messages typical of RPC. A
+/// factory with a dictionary advertises "ZSTD_DICT_<id>", where <id> is
+/// the dictionary id, and only agrees to use the dictionary when the peer
+/// offers the same id. Since it also accepts plain "ZSTD", a server with
+/// a dictionary can serve clients without one. To let clients with a
+/// dictionary fall back when the server has a different one (e.g. during
+/// a dictionary rollout), list a plain factory after it in
+/// multi_algo_compressor_factory.
+class zstd_compressor final : public compressor {
+public:
+    static constexpr int default_level = 3;
+
+    /// Immutable, pre-digested compression dictionary, safe to share
+    /// between shards.
+    class dictionary {
+        struct impl;
+        std::unique_ptr<impl> _impl;
+        friend class zstd_compressor;
+    public:
+        /// Loads a dictionary, as produced by train() or `zstd --train`.
+        /// Compression with this dictionary uses the given level.
+        explicit dictionary(std::string_view data, int level = default_level);
+        ~dictionary();
+        uint32_t id() const noexcept;
+        int level() const noexcept;
+
+        /// Trains a dictionary of at most max_size bytes on sample messages.
+        static sstring train(const std::vector<temporary_buffer<char>>& samples, size_t max_size = 112640);
+    };
+
+    class factory final : public rpc::compressor::factory {
+        int _level;
+        std::shared_ptr<const dictionary> _dict;
+        sstring _name;
+    public:
+        explicit factory(int level = default_level);
+        explicit factory(std::shared_ptr<const dictionary> dict);
+        virtual const sstring& supported() const override;
+        virtual std::unique_ptr<rpc::compressor> negotiate(sstring feature, bool is_server) const override;
+    };
+private:
+    int _level;
+    std::shared_ptr<const dictionary> _dict;
+public:
+    explicit zstd_compressor(int level = default_level);
+    explicit zstd_compressor(std::shared_ptr<const dictionary> dict);
+    virtual snd_buf compress(size_t head_space, snd_buf data) override;
+    virtual rcv_buf decompress(rcv_buf data) override;
+    sstring name() const override;
+};
+
+}
+}
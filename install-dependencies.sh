@@ -48,6 +48,7 @@ debian_packages=(
     liburing-dev
     libxml2-dev
     libyaml-cpp-dev
+    libzstd-dev
     make
     meson
     ninja-build
@@ -106,6 +107,7 @@ redhat_packages=(
     valgrind-devel
     xfsprogs-devel
     yaml-cpp-devel
+    libzstd-devel
     "${transitive[@]}"
 )
 
@@ -196,6 +198,7 @@ arch_packages=(
     valgrind
     xfsprogs
     yaml-cpp
+    zstd
 )
 
 opensuse_packages=(
@@ -233,6 +236,7 @@ opensuse_packages=(
     stow
     xfsprogs-devel
     yaml-cpp-devel
+    libzstd-devel
 )
 
 case "$ID" in
@@ -0,0 +1,277 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#ifdef SEASTAR_MODULE
+module;
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <fmt/format.h>
+module seastar;
+#else
+#include <seastar/core/cpu_profiler.hh>
+#include <seastar/core/internal/cpu_profiler.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/posix.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/http/httpd.hh>
+#include <seastar/util/backtrace.hh>
+#include <seastar/util/log.hh>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <fmt/format.h>
+#endif
+
+namespace seastar {
+
+using namespace std::chrono_literals;
+
+namespace internal {
+
+namespace {
+
+// Address of the instruction the signal interrupted, 0 if unknown
+uintptr_t interrupted_pc(void* ucontext) noexcept {
+    auto uc = static_cast<ucontext_t*>(ucontext);
+#if defined(__x86_64__)
+    return uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__aarch64__)
+    return uc->uc_mcontext.pc;
+#else
+    (void)uc;
+    return 0;
+#endif
+}
+
+}
+
+size_t cpu_profiler::stack_hash::operator()(const stack& s) const noexcept {
+    size_t h = std::hash<const std::type_info*>()(s.task_type) ^ s.sg;
+    for (auto f : s.frames) {
+        h = h * 31 + f;
+    }
+    return h;
+}
+
+cpu_profiler::cpu_profiler()
+        : _drain_timer([this] { drain(); }) {
+    // Resolve the unwinder now rather than in the signal handler, see
+    // cpu_stall_detector::cpu_stall_detector()
+    backtrace([] (frame) {});
+
+    namespace sm = seastar::metrics;
+
+    _metrics.add_group("cpu_profiler", {
+            sm::make_counter("samples", _total_samples, sm::description("Total number of CPU profiler samples aggregated")),
+            sm::make_counter("dropped_samples", [this] { return _dropped.load(std::memory_order_relaxed); },
+                    sm::description("Total number of CPU profiler samples lost because they were taken faster than they were aggregated")),
+    });
+}
+
+cpu_profiler::~cpu_profiler() {
+    if (_timer_created) {
+        timer_delete(_timer);
+    }
+}
+
+void cpu_profiler::set_rate(unsigned hz) {
+    if (hz && !_ring) {
+        _ring = std::make_unique<sample[]>(ring_size);
+    }
+    if (hz && !_timer_created) {
+        struct sigevent sev = {};
+        sev.sigev_notify = SIGEV_THREAD_ID;
+        sev.sigev_signo = signal_number();
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+        sev.sigev_notify_thread_id = syscall(SYS_gettid);
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &_timer)) {
+            throw std::system_error(errno, std::system_category(), "failed to create the CPU profiler timer");
+        }
+        _timer_created = true;
+    }
+    _rate = hz;
+    if (_timer_created) {
+        auto period = hz ? std::chrono::nanoseconds(1s) / hz : 0ns;
+        auto its = posix::to_relative_itimerspec(period, period);
+        timer_settime(_timer, 0, &its, nullptr);
+    }
+    if (hz) {
+        // Aggregate well before the ring fills up
+        auto drain_period = std::chrono::nanoseconds(1s) * (ring_size / 4) / hz;
+        _drain_timer.rearm_periodic(std::max<lowres_clock::duration>(std::chrono::duration_cast<lowres_clock::duration>(drain_period), 10ms));
+    } else {
+        _drain_timer.cancel();
+        drain();
+    }
+}
+
+void cpu_profiler::on_signal(const std::type_info* task_type, unsigned sg, void* ucontext) noexcept {
+    auto head = _head.load(std::memory_order_relaxed);
+    if (!_ring || head - _tail.load(std::memory_order_relaxed) == ring_size) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Leave room for the frames of the signal handler
+    void* buffer[max_frames + 8];
+    int n = ::backtrace(buffer, std::size(buffer));
+    int first = 0;
+    if (auto pc = interrupted_pc(ucontext)) {
+        auto it = std::find(buffer, buffer + n, reinterpret_cast<void*>(pc));
+        if (it != buffer + n) {
+            first = it - buffer;
+        }
+    }
+    auto& s = _ring[head % ring_size];
+    s.task_type = task_type;
+    s.sg = sg;
+    s.nr_frames = std::min<unsigned>(n - first, max_frames);
+    for (unsigned i = 0; i < s.nr_frames; i++) {
+        // Like seastar::backtrace(), point into the call instruction
+        s.frames[i] = reinterpret_cast<uintptr_t>(buffer[first + i]) - 1;
+    }
+    std::atomic_signal_fence(std::memory_order_release);
+    _head.store(head + 1, std::memory_order_relaxed);
+}
+
+void cpu_profiler::drain() {
+    auto head = _head.load(std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_acquire);
+    for (auto tail = _tail.load(std::memory_order_relaxed); tail != head; tail++) {
+        auto& s = _ring[tail % ring_size];
+        stack st{s.task_type, s.sg, {s.frames, s.frames + s.nr_frames}};
+        _stacks[std::move(st)]++;
+        _samples++;
+        _total_samples++;
+    }
+    std::atomic_signal_fence(std::memory_order_release);
+    _tail.store(head, std::memory_order_relaxed);
+}
+
+void cpu_profiler::collect(cpu_profile& profile, bool reset) {
+    drain();
+    std::string folded;
+    for (auto& [st, samples] : _stacks) {
+        folded.clear();
+        auto out = std::back_inserter(folded);
+        out = fmt::format_to(out, "{};{}", scheduling_group_from_index(st.sg).name(),
+                st.task_type ? pretty_type_name(*st.task_type) : "[reactor]");
+        for (auto it = st.frames.rbegin(); it != st.frames.rend(); ++it) {
+            out = fmt::format_to(out, ";{}", decorate(*it));
+        }
+        profile.stacks[sstring(folded)] += samples;
+    }
+    auto dropped = _dropped.load(std::memory_order_relaxed);
+    profile.samples += _samples;
+    profile.dropped += dropped - _dropped_at_reset;
+    if (reset) {
+        _stacks.clear();
+        _samples = 0;
+        _dropped_at_reset = dropped;
+    }
+}
+
+}
+
+void cpu_profile::merge(cpu_profile&& o) {
+    for (auto& [stack, samples] : o.stacks) {
+        stacks[stack] += samples;
+    }
+    samples += o.samples;
+    dropped += o.dropped;
+}
+
+future<> set_cpu_profiler_rate(unsigned hz) {
+    return smp::invoke_on_all([hz] {
+        engine().set_cpu_profiler_rate(hz);
+    });
+}
+
+future<cpu_profile> collect_cpu_profile(bool reset) {
+    cpu_profile profile;
+    for (shard_id shard = 0; shard < smp::count; shard++) {
+        profile.merge(co_await smp::submit_to(shard, [reset] {
+            cpu_profile p;
+            engine().collect_cpu_profile(p, reset);
+            return p;
+        }));
+    }
+    co_return profile;
+}
+
+namespace {
+
+future<> write_folded(output_stream<char> out, cpu_profile profile) {
+    std::exception_ptr ex;
+    try {
+        for (auto& [stack, samples] : profile.stacks) {
+            co_await out.write(fmt::format("{} {}\n", stack, samples));
+        }
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+    if (ex) {
+        std::rethrow_exception(std::move(ex));
+    }
+}
+
+class cpu_profile_handler : public httpd::handler_base {
+public:
+    future<std::unique_ptr<http::reply>> handle(const sstring& path,
+            std::unique_ptr<http::request> req, std::unique_ptr<http::reply> rep) override {
+        auto profile = co_await collect_cpu_profile(req->get_query_param("reset") == "true");
+        rep->write_body("txt", [profile = std::move(profile)] (output_stream<char>&& out) mutable {
+            return write_folded(std::move(out), std::move(profile));
+        });
+        co_return rep;
+    }
+};
+
+}
+
+future<> add_cpu_profiler_routes(httpd::http_server& server, sstring path) {
+    server._routes.put(httpd::GET, path, new cpu_profile_handler());
+    return make_ready_future<>();
+}
+
+}
@@ -22,13 +22,19 @@
 #ifdef SEASTAR_MODULE
 module;
 #include <algorithm>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 module seastar;
 #else
 #include <seastar/core/execution_stage.hh>
 #include <seastar/core/print.hh>
 #include <seastar/core/make_task.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/smp.hh>
 #include <seastar/util/defer.hh>
+#include <map>
+#include <mutex>
 #endif
 
 namespace seastar {
@@ -63,6 +69,14 @@ void execution_stage_manager::update_execution_stage_registration(execution_stag
     _stages_by_name.find(new_es.name())->second = &new_es;
 }
 
+void execution_stage_manager::register_stealable_stage(stealable_execution_stage& stage) {
+    _stealable_stages.push_back(&stage);
+}
+
+void execution_stage_manager::unregister_stealable_stage(stealable_execution_stage& stage) noexcept {
+    std::erase(_stealable_stages, &stage);
+}
+
 execution_stage* execution_stage_manager::get_stage(const sstring& name) {
     return _stages_by_name[name];
 }
@@ -84,11 +98,118 @@ bool execution_stage_manager::poll() const noexcept {
     return false;
 }
 
+bool execution_stage_manager::steal() noexcept {
+    for (auto&& stage : _stealable_stages) {
+        if (stage->steal()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool execution_stage_manager::can_steal() const noexcept {
+    for (auto&& stage : _stealable_stages) {
+        if (stage->can_steal()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 execution_stage_manager& execution_stage_manager::get() noexcept {
     static thread_local execution_stage_manager instance;
     return instance;
 }
 
+steal_board::steal_board(std::span<const unsigned> shard_to_numa_node)
+    : _slots(std::make_unique<slot[]>(smp::count))
+{
+    auto node = [&] (shard_id s) {
+        return s < shard_to_numa_node.size() ? shard_to_numa_node[s] : 0;
+    };
+    for (shard_id s = 0; s < smp::count; s++) {
+        // Start right after the shard, so that thieves spread over victims
+        for (shard_id i = 1; i < smp::count; i++) {
+            auto n = (s + i) % smp::count;
+            if (node(n) == node(s)) {
+                _slots[s].neighbours.push_back(n);
+            }
+        }
+    }
+}
+
+steal_board::batch* steal_board::pop(slot& s) noexcept {
+    std::lock_guard<util::spinlock> guard(s.lock);
+    if (s.batches.empty()) {
+        return nullptr;
+    }
+    auto& b = s.batches.front();
+    s.batches.pop_front();
+    s.published.fetch_sub(1, std::memory_order_relaxed);
+    return &b;
+}
+
+void steal_board::publish(batch* b) noexcept {
+    auto& s = _slots[this_shard_id()];
+    std::lock_guard<util::spinlock> guard(s.lock);
+    s.batches.push_back(*b);
+    s.published.fetch_add(1, std::memory_order_relaxed);
+}
+
+steal_board::batch* steal_board::take() noexcept {
+    auto& s = _slots[this_shard_id()];
+    if (!s.published.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return pop(s);
+}
+
+steal_board::batch* steal_board::steal() noexcept {
+    slot* victim = nullptr;
+    unsigned most = 0;
+    for (auto n : _slots[this_shard_id()].neighbours) {
+        auto published = _slots[n].published.load(std::memory_order_relaxed);
+        if (published > most) {
+            most = published;
+            victim = &_slots[n];
+        }
+    }
+    return victim ? pop(*victim) : nullptr;
+}
+
+unsigned steal_board::published() const noexcept {
+    return _slots[this_shard_id()].published.load(std::memory_order_relaxed);
+}
+
+bool steal_board::stealable() const noexcept {
+    for (auto n : _slots[this_shard_id()].neighbours) {
+        if (_slots[n].published.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void steal_board::send_back(batch* b) noexcept {
+    (void)smp::submit_to(b->owner, [b] () noexcept {
+        b->complete();
+        delete b;
+    });
+}
+
+std::shared_ptr<steal_board> steal_board::get(const sstring& name) {
+    static std::mutex lock;
+    static std::map<sstring, std::weak_ptr<steal_board>> boards;
+    std::lock_guard<std::mutex> guard(lock);
+    auto& board = boards[name];
+    auto ret = board.lock();
+    if (!ret) {
+        ret = std::make_shared<steal_board>(engine().smp().shard_to_numa_node_mapping());
+        board = ret;
+    }
+    return ret;
+}
+
 }
 
 execution_stage::~execution_stage()
@@ -153,4 +274,38 @@ bool execution_stage::flush() noexcept {
     return true;
 };
 
+stealable_execution_stage::stealable_execution_stage(const sstring& name, scheduling_group sg)
+    : execution_stage(name, sg)
+    , _board(internal::steal_board::get(name))
+{
+    _steal_metric_group = metrics::metric_group("execution_stages", {
+             metrics::make_counter("function_calls_stolen",
+                                  metrics::description("Counts function calls queued on other shards and executed by this one"),
+                                  { metrics::label_instance("execution_stage", name), },
+                                  [this] { return _function_calls_stolen; }),
+           });
+    internal::execution_stage_manager::get().register_stealable_stage(*this);
+}
+
+stealable_execution_stage::~stealable_execution_stage() {
+    internal::execution_stage_manager::get().unregister_stealable_stage(*this);
+}
+
+bool stealable_execution_stage::steal() noexcept {
+    if (_steal_scheduled) {
+        return false;
+    }
+    auto b = _board->steal();
+    if (!b) {
+        return false;
+    }
+    _stats.tasks_scheduled++;
+    schedule(make_task(_sg, [this, b] {
+        execute_stolen(b);
+        _steal_scheduled = false;
+    }));
+    _steal_scheduled = true;
+    return true;
+}
+
 }
@@ -136,6 +136,10 @@ auto fair_group::capacity_deficiency(capacity_t from) const noexcept -> capacity
     return _token_bucket.deficiency(from);
 }
 
+void fair_group::update_rate_factor(double factor) noexcept {
+    _token_bucket.update_rate(std::max<capacity_t>(fixed_point_factor * factor, 1));
+}
+
 // Priority class, to be used with a given fair_queue
 class fair_queue::priority_class_data {
     friend class fair_queue;
@@ -146,6 +150,7 @@ class fair_queue::priority_class_data {
     bool _queued = false;
     bool _plugged = true;
     uint32_t _activations = 0;
+    uint64_t _deadline_misses = 0;
 
 public:
     explicit priority_class_data(uint32_t shares) noexcept : _shares(std::max(shares, 1u)) {}
@@ -288,10 +293,31 @@ void fair_queue::queue(class_id id, fair_queue_entry& ent) noexcept {
     if (pc._plugged) {
         push_priority_class_from_idle(pc);
     }
-    pc._queue.push_back(ent);
+    if (_config.deadline_dispatch) {
+        queue_by_deadline(pc, ent);
+    } else {
+        pc._queue.push_back(ent);
+    }
     _queued_capacity += ent.capacity();
 }
 
+void fair_queue::queue_by_deadline(priority_class_data& pc, fair_queue_entry& ent) noexcept {
+    if (ent._deadline == fair_queue_entry::no_deadline) {
+        ent._deadline = clock_type::now() + _config.relaxed_deadline;
+    }
+    // Callers mostly use the same timeout for all requests of a class, so
+    // deadlines tend to come in order and the new entry goes to the end
+    auto& q = pc._queue;
+    if (q.empty() || q.back()._deadline <= ent._deadline) {
+        q.push_back(ent);
+        return;
+    }
+    auto prev = q.before_begin();
+    for (auto it = q.begin(); it->_deadline <= ent._deadline; prev = it++) {
+    }
+    q.insert_after(prev, ent);
+}
+
 void fair_queue::notify_request_finished(fair_queue_entry::capacity_t cap) noexcept {
 }
 
@@ -343,6 +369,7 @@ void fair_queue::dispatch_requests(std::function<void(fair_queue_entry&)> cb) {
 
     const uint64_t max_unamortized_reservation = _group.per_tick_grab_threshold();
     auto available = reap_pending_capacity();
+    const auto now = _config.deadline_dispatch ? clock_type::now() : clock_type::time_point::min();
 
     while (!_handles.empty()) {
         priority_class_data& h = *_handles.top();
@@ -423,6 +450,9 @@ void fair_queue::dispatch_requests(std::function<void(fair_queue_entry&)> cb) {
         h._accumulated += req_cost;
         h._pure_accumulated += req_cap;
         _queued_capacity -= req_cap;
+        if (req._deadline < now) {
+            h._deadline_misses++;
+        }
 
         cb(req);
 
@@ -445,7 +475,7 @@ void fair_queue::dispatch_requests(std::function<void(fair_queue_entry&)> cb) {
 std::vector<seastar::metrics::impl::metric_definition_impl> fair_queue::metrics(class_id c) {
     namespace sm = seastar::metrics;
     priority_class_data& pc = *_priority_classes[c];
-    return std::vector<sm::impl::metric_definition_impl>({
+    auto ret = std::vector<sm::impl::metric_definition_impl>({
             sm::make_counter("consumption",
                     [&pc] { return fair_group::capacity_tokens(pc._pure_accumulated); },
                     sm::description("Accumulated disk capacity units consumed by this class; an increment per-second rate indicates full utilization")),
@@ -456,6 +486,12 @@ std::vector<seastar::metrics::impl::metric_definition_impl> fair_queue::metrics(
                     [&pc] { return pc._activations; },
                     sm::description("The number of times the class was woken up from idle")),
     });
+    if (_config.deadline_dispatch) {
+        ret.push_back(sm::make_counter("deadline_misses",
+                [&pc] { return pc._deadline_misses; },
+                sm::description("The number of requests dispatched after their deadline, including the relaxed deadline of requests queued without one")));
+    }
+    return ret;
 }
 
 }
@@ -76,6 +76,9 @@ class posix_file_impl : public file_impl {
     const dev_t _device_id;
     io_queue& _io_queue;
     const open_flags _open_flags;
+    // Registered in this shard's io_uring fixed-file table
+    bool _fixed_file = false;
+    bool _fixed_buffers = false;
 protected:
     int _fd;
 
@@ -118,6 +121,10 @@ class posix_file_impl : public file_impl {
 private:
     void configure_dma_alignment(const internal::fs_info& fsi);
     void configure_io_lengths() noexcept;
+    void unregister_fixed_file() noexcept;
+    // Aligned buffer for dma_read_bulk(), taken from the registered buffer
+    // arena when the file was opened with file_open_options::fixed_buffers
+    temporary_buffer<uint8_t> allocate_read_buffer(size_t len);
 
     /**
      * Try to read from the given position where the previous short read has
@@ -69,6 +69,7 @@ module seastar;
 #include <seastar/core/io_queue.hh>
 #include <seastar/core/queue.hh>
 #include "core/file-impl.hh"
+#include "core/reactor_backend.hh"
 #include "core/syscall_result.hh"
 #include "core/thread_pool.hh"
 #endif
@@ -119,9 +120,13 @@ posix_file_impl::posix_file_impl(int fd, open_flags f, file_open_options options
         , _device_id(device_id)
         , _io_queue(engine().get_io_queue(_device_id))
         , _open_flags(f)
+        , _fixed_buffers(options.fixed_buffers)
         , _fd(fd)
 {
     configure_io_lengths();
+    if (options.fixed_file) {
+        _fixed_file = engine()._backend->register_fixed_file(_fd);
+    }
 }
 
 posix_file_impl::posix_file_impl(int fd, open_flags f, file_open_options options, dev_t device_id, const internal::fs_info& fsi)
@@ -131,6 +136,7 @@ posix_file_impl::posix_file_impl(int fd, open_flags f, file_open_options options
 }
 
 posix_file_impl::~posix_file_impl() {
+    unregister_fixed_file();
     if (_refcount && _refcount->fetch_add(-1, std::memory_order_relaxed) != 1) {
         return;
     }
@@ -155,6 +161,26 @@ posix_file_impl::configure_dma_alignment(const internal::fs_info& fsi) {
     }
 }
 
+void posix_file_impl::unregister_fixed_file() noexcept {
+    // The registration belongs to this object and this shard, so drop it
+    // even if other handles keep the descriptor open.
+    if (std::exchange(_fixed_file, false)) {
+        engine()._backend->unregister_fixed_file(_fd);
+    }
+}
+
+temporary_buffer<uint8_t> posix_file_impl::allocate_read_buffer(size_t len) {
+    len = align_up(len, size_t(_disk_read_dma_alignment));
+    if (_fixed_buffers) {
+        auto buf = engine()._backend->allocate_fixed_buffer(len, _memory_dma_alignment);
+        if (buf) {
+            auto p = reinterpret_cast<uint8_t*>(buf.get_write());
+            return temporary_buffer<uint8_t>(p, len, buf.release());
+        }
+    }
+    return temporary_buffer<uint8_t>::aligned(_memory_dma_alignment, len);
+}
+
 void posix_file_impl::configure_io_lengths() noexcept {
     auto limits = _io_queue.get_request_limits();
     _read_max_length = std::min<size_t>(_read_max_length, limits.max_read);
@@ -309,6 +335,7 @@ posix_file_impl::close() noexcept {
         seastar_logger.warn("double close() detected, contact support");
         return make_ready_future<>();
     }
+    unregister_fixed_file();
     auto fd = _fd;
     _fd = -1;  // Prevent a concurrent close (which is illegal) from closing another file's fd
     if (_refcount && _refcount->fetch_add(-1, std::memory_order_relaxed) != 1) {
@@ -528,10 +555,9 @@ posix_file_impl::do_dma_read_bulk(uint64_t offset, size_t range_size, internal::
     offset -= front;
     range_size += front;
 
-    auto rstate = make_lw_shared<internal::file_read_state<uint8_t>>(offset, front,
+    auto rstate = make_lw_shared<internal::file_read_state<uint8_t>>(allocate_read_buffer(range_size),
+                                                       offset, front,
                                                        range_size,
-                                                       _memory_dma_alignment,
-                                                       _disk_read_dma_alignment,
                                                        intent);
 
     //
@@ -586,8 +612,7 @@ posix_file_impl::read_maybe_eof(uint64_t pos, size_t len, internal::maybe_priori
     // We have to allocate a new aligned buffer to make sure we don't get
     // an EINVAL error due to unaligned destination buffer.
     //
-    temporary_buffer<uint8_t> buf = temporary_buffer<uint8_t>::aligned(
-               _memory_dma_alignment, align_up(len, size_t(_disk_read_dma_alignment)));
+    temporary_buffer<uint8_t> buf = allocate_read_buffer(len);
 
     // try to read a single bulk from the given position
     auto dst = buf.get_write();
@@ -1027,6 +1052,14 @@ posix_file_handle_impl::to_file() && {
     return ret;
 }
 
+temporary_buffer<char> allocate_dma_buffer(size_t size, size_t alignment) {
+    auto buf = engine()._backend->allocate_fixed_buffer(size, alignment);
+    if (buf) {
+        return buf;
+    }
+    return temporary_buffer<char>::aligned(alignment, size);
+}
+
 // Some kernels can append to xfs filesystems, some cannot; determine
 // from kernel version.
 static
@@ -42,6 +42,7 @@ module seastar;
 #include <seastar/core/reactor.hh>
 #include <seastar/core/when_all.hh>
 #include <seastar/core/io_intent.hh>
+#include <seastar/core/lowres_clock.hh>
 #endif
 
 namespace seastar {
@@ -101,6 +102,19 @@ class file_data_source_impl : public data_source_impl {
     bool _in_slow_start = false;
     io_intent _intent;
     using unused_ratio_target = std::ratio<25, 100>;
+    // Adaptive read-ahead state
+    size_t _max_buffer_size;
+    unsigned _sequential_reads = 0;
+    lowres_clock::time_point _last_get;
+    bool _last_get_blocked = false;
+    // Requests are not grown beyond this when the I/O queue does not limit them
+    static constexpr size_t max_adaptive_buffer_size = 1 << 20;
+    // Buffers consumed sequentially between two adjustments
+    static constexpr unsigned sequential_run_length = 2;
+    // A consumer not asking for data for that long does not need it read
+    // ahead. This is only noticed at its next get(), buffers already read
+    // ahead are kept until then.
+    static constexpr auto consumer_stall_threshold = std::chrono::milliseconds(50);
 private:
     size_t minimal_buffer_size() const {
         return std::min(std::max(_options.buffer_size / 4, size_t(8192)), _options.buffer_size);
@@ -119,11 +133,41 @@ class file_data_source_impl : public data_source_impl {
         }
     }
     unsigned get_initial_read_ahead() const {
-        return _options.dynamic_adjustments
+        return _options.dynamic_adjustments && !_options.adaptive_read_ahead
                ? std::min(_options.dynamic_adjustments->read_ahead, _options.read_ahead)
                : !!_options.read_ahead;
     }
 
+    void reset_adaptive_read_ahead() {
+        _sequential_reads = 0;
+        _current_buffer_size = _options.buffer_size;
+        _current_read_ahead = get_initial_read_ahead();
+    }
+    // Called on every get() in adaptive mode. Sequential consumption first
+    // grows the request size, since larger requests are cheaper per byte,
+    // and only then the number of requests in flight, and only while the
+    // consumer is faster than the disk.
+    void adapt_read_ahead() {
+        auto now = lowres_clock::now();
+        auto idle = now - std::exchange(_last_get, now);
+        auto blocked = !_read_buffers.empty() && !_read_buffers.front()._ready.available();
+        // If the previous get() waited for the disk, the time since then
+        // was spent waiting, not stalling
+        auto previous_blocked = std::exchange(_last_get_blocked, blocked);
+        if (_sequential_reads && !previous_blocked && idle > consumer_stall_threshold) {
+            reset_adaptive_read_ahead();
+            return;
+        }
+        if (++_sequential_reads % sequential_run_length) {
+            return;
+        }
+        if (_current_buffer_size < _max_buffer_size) {
+            _current_buffer_size = std::min(_current_buffer_size * 2, _max_buffer_size);
+        } else if (blocked && _current_read_ahead < _options.read_ahead) {
+            _current_read_ahead++;
+        }
+    }
+
     void update_history(uint64_t unused, uint64_t total) {
         // We are maintaining two windows each no larger than window_size.
         // Dynamic adjustment logic uses data from both of them, which
@@ -210,9 +254,14 @@ class file_data_source_impl : public data_source_impl {
 public:
     file_data_source_impl(file f, uint64_t offset, uint64_t len, file_input_stream_options options)
             : _file(std::move(f)), _options(options), _pos(offset), _remain(len), _current_read_ahead(get_initial_read_ahead())
+            , _last_get(lowres_clock::now())
     {
         _options.buffer_size = select_buffer_size(_options.buffer_size, _file.disk_read_max_length());
         _current_buffer_size = _options.buffer_size;
+        _max_buffer_size = std::max(select_buffer_size(max_adaptive_buffer_size, _file.disk_read_max_length()), _options.buffer_size);
+        if (_options.adaptive_read_ahead) {
+            _options.dynamic_adjustments = {};
+        }
         // prevent wraparounds
         set_new_buffer_size(after_skip::no);
         _remain = std::min(std::numeric_limits<uint64_t>::max() - _pos, _remain);
@@ -223,7 +272,9 @@ class file_data_source_impl : public data_source_impl {
         SEASTAR_ASSERT(_reads_in_progress == 0);
     }
     virtual future<temporary_buffer<char>> get() override {
-        if (!_read_buffers.empty() && !_read_buffers.front()._ready.available()) {
+        if (_options.adaptive_read_ahead) {
+            adapt_read_ahead();
+        } else if (!_read_buffers.empty() && !_read_buffers.front()._ready.available()) {
             try_increase_read_ahead();
         }
         issue_read_aheads(1);
@@ -245,6 +296,11 @@ class file_data_source_impl : public data_source_impl {
                 SEASTAR_ASSERT(n <= _remain);
                 _pos += n;
                 _remain -= n;
+                // The skip left the data read so far, the access pattern
+                // is not sequential anymore
+                if (_options.adaptive_read_ahead) {
+                    reset_adaptive_read_ahead();
+                }
                 break;
             }
             auto& front = _read_buffers.front();
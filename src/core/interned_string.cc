@@ -0,0 +1,144 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#ifdef SEASTAR_MODULE
+module;
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+module seastar;
+#else
+#include <seastar/core/interned_string.hh>
+#include <seastar/core/align.hh>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#endif
+
+namespace seastar {
+
+uint32_t string_pool::hash_of(std::string_view s) noexcept {
+    uint64_t h = std::hash<std::string_view>()(s);
+    return h ^ (h >> 32);
+}
+
+const string_pool::header* string_pool::store(std::string_view s, uint32_t hash) {
+    auto bytes = align_up(sizeof(header) + s.size(), alignof(header));
+    _chunks.reserve(_chunks.size() + 1);
+    char* p;
+    if (bytes > chunk_size / 4) {
+        // Would waste too much of a chunk, give it its own
+        _chunks.emplace_back(new char[bytes]);
+        _chunk_memory += bytes;
+        p = _chunks.back().get();
+    } else {
+        if (bytes > _left) {
+            _chunks.emplace_back(new char[chunk_size]);
+            _chunk_memory += chunk_size;
+            _pos = _chunks.back().get();
+            _left = chunk_size;
+        }
+        p = _pos;
+        _pos += bytes;
+        _left -= bytes;
+    }
+    auto h = new (p) header{uint32_t(s.size()), hash};
+    std::memcpy(h + 1, s.data(), s.size());
+    return h;
+}
+
+void string_pool::grow() {
+    std::vector<const header*> table(std::max<size_t>(_table.size() * 2, 64));
+    auto mask = table.size() - 1;
+    for (auto h : _table) {
+        if (h) {
+            auto i = h->hash & mask;
+            while (table[i]) {
+                i = (i + 1) & mask;
+            }
+            table[i] = h;
+        }
+    }
+    _table = std::move(table);
+}
+
+interned_string string_pool::intern(std::string_view s) {
+    if (s.empty()) {
+        return interned_string();
+    }
+    if (s.size() > std::numeric_limits<uint32_t>::max() - sizeof(header)) {
+        throw std::length_error("string too long to be interned");
+    }
+    // Keep the load factor under 3/4
+    if ((_size + 1) * 4 > _table.size() * 3) {
+        grow();
+    }
+    auto hash = hash_of(s);
+    auto mask = _table.size() - 1;
+    for (auto i = hash & mask; ; i = (i + 1) & mask) {
+        auto h = _table[i];
+        if (!h) {
+            _table[i] = store(s, hash);
+            _size++;
+            return interned_string(_table[i]);
+        }
+        if (h->hash == hash && h->size == s.size() && !std::memcmp(h + 1, s.data(), s.size())) {
+            return interned_string(h);
+        }
+    }
+}
+
+std::optional<interned_string> string_pool::find(std::string_view s) const noexcept {
+    if (s.empty()) {
+        return interned_string();
+    }
+    if (_table.empty()) {
+        return std::nullopt;
+    }
+    auto hash = hash_of(s);
+    auto mask = _table.size() - 1;
+    for (auto i = hash & mask; _table[i]; i = (i + 1) & mask) {
+        auto h = _table[i];
+        if (h->hash == hash && h->size == s.size() && !std::memcmp(h + 1, s.data(), s.size())) {
+            return interned_string(h);
+        }
+    }
+    return std::nullopt;
+}
+
+void string_pool::clear() noexcept {
+    _table.clear();
+    _table.shrink_to_fit();
+    _chunks.clear();
+    _pos = nullptr;
+    _left = 0;
+    _chunk_memory = 0;
+    _size = 0;
+}
+
+string_pool& string_pool::local() noexcept {
+    static thread_local string_pool pool;
+    return pool;
+}
+
+}
@@ -44,6 +44,7 @@ module seastar;
 #include <seastar/core/reactor.hh>
 #include <seastar/core/when_all.hh>
 #include <seastar/core/metrics.hh>
+#include <seastar/core/native_histogram.hh>
 #include <seastar/core/internal/io_desc.hh>
 #include <seastar/core/internal/io_sink.hh>
 #include <seastar/core/io_priority_class.hh>
@@ -111,6 +112,8 @@ class io_queue::priority_class_data {
     std::chrono::duration<double> _total_execution_time;
     std::chrono::duration<double> _starvation_time;
     io_queue::clock_type::time_point _activated;
+    // Execution latency of completed requests, in microseconds
+    metrics::native_histogram<> _latency;
 
     io_group::priority_class_data& _group;
     size_t _replenish_head;
@@ -186,6 +189,7 @@ class io_queue::priority_class_data {
 
     void on_complete(std::chrono::duration<double> lat) noexcept {
         _total_execution_time += lat;
+        _latency.add(std::chrono::duration_cast<std::chrono::microseconds>(lat).count());
         _nr_executing--;
         if (_nr_executing == 0 && _nr_queued != 0) {
             _activated = io_queue::clock_type::now();
@@ -284,11 +288,12 @@ class queued_io_request : private internal::io_request {
     bool is_cancelled() const noexcept { return !_desc; }
 
 public:
-    queued_io_request(internal::io_request req, io_queue& q, fair_queue_entry::capacity_t cap, io_queue::priority_class_data& pc, io_direction_and_length dnl, iovec_keeper iovs)
+    queued_io_request(internal::io_request req, io_queue& q, fair_queue_entry::capacity_t cap, fair_queue_entry::clock_type::time_point deadline,
+            io_queue::priority_class_data& pc, io_direction_and_length dnl, iovec_keeper iovs)
         : io_request(std::move(req))
         , _ioq(q)
         , _stream(_ioq.request_stream(dnl))
-        , _fq_entry(cap)
+        , _fq_entry(cap, deadline)
         , _desc(std::make_unique<io_desc_read_write>(_ioq, pc, _stream, dnl, cap, std::move(iovs)))
     {
     }
@@ -540,6 +545,60 @@ void io_queue::update_flow_ratio() noexcept {
     }
 }
 
+void io_queue::update_capacity_estimate() noexcept {
+    if (get_config().adaptive_capacity) {
+        _group->update_capacity(_exec_time_sum, _exec_completions, _backlogged);
+    }
+    _exec_time_sum = std::chrono::duration<double>(0);
+    _exec_completions = 0;
+    _backlogged = false;
+}
+
+// The token bucket lets at most the latency goal worth of work (at the
+// configured rate) be in flight, so on a disk that matches the configuration
+// requests don't take longer than that to execute. Executing for much longer
+// means the disk is slower than configured, while requests waiting for tokens
+// with execution well under the goal means it's faster. The factor is lowered
+// proportionally to the overshoot and raised additively, so it falls fast
+// when the disk gets throttled and recovers carefully.
+void io_group::update_capacity(std::chrono::duration<double> exec_time_sum, uint64_t completions, bool backlogged) noexcept {
+    std::lock_guard _(_lock);
+    auto& c = _capacity;
+    c.exec_time_sum += exec_time_sum;
+    c.completions += completions;
+    c.backlogged |= backlogged;
+
+    auto now = io_queue::clock_type::now();
+    if (now - c.updated < c.target * _config.averaging_decay_ticks) {
+        return;
+    }
+    c.updated = now;
+
+    if (c.completions != 0) {
+        auto latency = c.exec_time_sum / c.completions;
+        auto old_factor = c.factor.load(std::memory_order_relaxed);
+        auto factor = old_factor;
+        if (latency > 2 * c.target) {
+            factor *= std::max(0.5, 2 * c.target / latency);
+        } else if (c.backlogged && latency < c.target) {
+            factor += 0.05;
+        }
+        factor = std::clamp(factor, _config.capacity_factor_min, _config.capacity_factor_max);
+        if (factor != old_factor) {
+            io_log.debug("{}: average execution {:.3f}ms, capacity factor {:.2f} -> {:.2f}", _config.mountpoint,
+                    std::chrono::duration<double, std::milli>(latency).count(), old_factor, factor);
+            c.factor.store(factor, std::memory_order_relaxed);
+            for (auto& fg : _fgs) {
+                fg.update_rate_factor(factor);
+            }
+        }
+    }
+
+    c.exec_time_sum = std::chrono::duration<double>(0);
+    c.completions = 0;
+    c.backlogged = false;
+}
+
 void io_queue::lower_stall_threshold() noexcept {
     auto new_threshold = _stall_threshold - std::chrono::milliseconds(1);
     _stall_threshold = std::max(_stall_threshold_min, new_threshold);
@@ -550,6 +609,10 @@ io_queue::complete_request(io_desc_read_write& desc, std::chrono::duration<doubl
     _requests_executing--;
     _requests_completed++;
     _streams[desc.stream()].notify_request_finished(desc.capacity());
+    if (delay.count() > 0) {
+        _exec_time_sum += delay;
+        _exec_completions++;
+    }
 
     if (delay > _stall_threshold) {
         _stall_threshold *= 2;
@@ -562,6 +625,7 @@ io_queue::complete_request(io_desc_read_write& desc, std::chrono::duration<doubl
 fair_queue::config io_queue::make_fair_queue_config(const config& iocfg, sstring label) {
     fair_queue::config cfg;
     cfg.label = label;
+    cfg.deadline_dispatch = iocfg.deadline_dispatch;
     return cfg;
 }
 
@@ -573,6 +637,7 @@ io_queue::io_queue(io_group_ptr group, internal::io_sink& sink)
     , _averaging_decay_timer([this] {
         update_flow_ratio();
         lower_stall_threshold();
+        update_capacity_estimate();
     })
     , _stall_threshold_min(std::max(get_config().stall_threshold, 1ms))
     , _stall_threshold(_stall_threshold_min)
@@ -597,6 +662,35 @@ io_queue::io_queue(io_group_ptr group, internal::io_sink& sink)
                 sm::description("Ratio of dispatch rate to completion rate. Is expected to be 1.0+ growing larger on reactor stalls or (!) disk problems"),
                 { owner_l, mnt_l, group_l }),
     });
+
+    if (cfg.adaptive_capacity) {
+        auto estimated = [this] (double nominal) {
+            return [this, nominal] { return nominal * _group->capacity_factor(); };
+        };
+        _metric_groups.add_group("io_queue", {
+            sm::make_gauge("capacity_factor", [this] { return _group->capacity_factor(); },
+                    sm::description("Estimated disk capacity relative to the configured one, learned from the requests execution time"),
+                    { owner_l, mnt_l, group_l }),
+        });
+        if (cfg.req_count_rate != io_queue::config().req_count_rate) {
+            double read_iops = double(cfg.req_count_rate) / read_request_base_count;
+            _metric_groups.add_group("io_queue", {
+                sm::make_gauge("estimated_read_iops", estimated(read_iops),
+                        sm::description("Estimated read IOPS the disk can sustain, per IO group"), { owner_l, mnt_l, group_l }),
+                sm::make_gauge("estimated_write_iops", estimated(read_iops * read_request_base_count / cfg.disk_req_write_to_read_multiplier),
+                        sm::description("Estimated write IOPS the disk can sustain, per IO group"), { owner_l, mnt_l, group_l }),
+            });
+        }
+        if (cfg.blocks_count_rate != io_queue::config().blocks_count_rate) {
+            double read_bw = double(cfg.blocks_count_rate << block_size_shift) / read_request_base_count;
+            _metric_groups.add_group("io_queue", {
+                sm::make_gauge("estimated_read_bandwidth", estimated(read_bw),
+                        sm::description("Estimated read bandwidth (bytes per second) the disk can sustain, per IO group"), { owner_l, mnt_l, group_l }),
+                sm::make_gauge("estimated_write_bandwidth", estimated(read_bw * read_request_base_count / cfg.disk_blocks_write_to_read_multiplier),
+                        sm::description("Estimated write bandwidth (bytes per second) the disk can sustain, per IO group"), { owner_l, mnt_l, group_l }),
+            });
+        }
+    }
 }
 
 fair_group::config io_group::make_fair_group_config(const io_queue::config& qcfg) noexcept {
@@ -627,6 +721,7 @@ io_group::io_group(io_queue::config io_cfg, unsigned nr_queues)
     }
 
     auto goal = io_latency_goal();
+    _capacity.target = goal;
     auto lvl = goal > 1.1 * _config.rate_limit_duration ? log_level::warn : log_level::debug;
     seastar_logger.log(lvl, "IO queue uses {:.2f}ms latency goal for {}", goal.count() * 1000, _config.mountpoint);
 
@@ -733,7 +828,10 @@ std::vector<seastar::metrics::impl::metric_definition_impl> io_queue::priority_c
             sm::make_gauge("delay", [this] {
                 return _queue_time.count();
             }, sm::description("random delay time in the queue")),
-            sm::make_gauge("shares", _shares, sm::description("current amount of shares"))
+            sm::make_gauge("shares", _shares, sm::description("current amount of shares")),
+            sm::make_histogram("request_latency", sm::description("Request execution latency in microseconds"), [this] {
+                return _latency.to_metrics_histogram();
+            }).aggregate({sm::shard_label}).set_skip_when_empty()
     });
 }
 
@@ -862,7 +960,8 @@ future<size_t> io_queue::queue_one_request(internal::priority_class pc, io_direc
         // that we create the shared pointer in the same shard it will be used at later.
         auto& pclass = find_or_create_class(pc);
         auto cap = request_capacity(dnl);
-        auto queued_req = std::make_unique<queued_io_request>(std::move(req), *this, cap, pclass, std::move(dnl), std::move(iovs));
+        auto deadline = intent != nullptr ? intent->deadline() : fair_queue_entry::no_deadline;
+        auto queued_req = std::make_unique<queued_io_request>(std::move(req), *this, cap, deadline, pclass, std::move(dnl), std::move(iovs));
         auto fut = queued_req->get_future();
         if (intent != nullptr) {
             auto& cq = intent->find_or_create_cancellable_queue(_id, pc.id());
@@ -956,6 +1055,9 @@ void io_queue::poll_io_queue() {
             queued_io_request::from_fq_entry(fqe).dispatch();
         });
     }
+    if (_queued_requests != 0) {
+        _backlogged = true;
+    }
 }
 
 void io_queue::submit_request(io_desc_read_write* desc, internal::io_request req) noexcept {
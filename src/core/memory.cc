@@ -251,8 +251,8 @@ std::atomic<bool> use_transparent_hugepages = true;
 
 namespace alloc_stats {
 
-enum class types { allocs, frees, cross_cpu_frees, reclaims, large_allocs, failed_allocs,
-    foreign_mallocs, foreign_frees, foreign_cross_frees, enum_size };
+enum class types { allocs, frees, cross_cpu_frees, cross_cpu_free_batches, reclaims, large_allocs, failed_allocs,
+    foreign_mallocs, foreign_frees, foreign_cross_frees, span_refills, span_refills_same_hugepage, enum_size };
 
 using stats_array = std::array<uint64_t, static_cast<std::size_t>(types::enum_size)>;
 using stats_atomic_array = std::array<std::atomic_uint64_t, static_cast<std::size_t>(types::enum_size)>;
@@ -423,6 +423,17 @@ class page_list {
         }
         _front = ary[_front].link._next;
     }
+    // Looks at no more than max_probes spans from the front of the list and
+    // returns the first one whose index satisfies pred, or nullptr
+    template <typename Pred>
+    page* find(page* ary, unsigned max_probes, Pred pred) {
+        for (auto idx = _front; idx && max_probes; idx = ary[idx].link._next, --max_probes) {
+            if (pred(idx)) {
+                return &ary[idx];
+            }
+        }
+        return nullptr;
+    }
     friend seastar::internal::log_buf::inserter_iterator do_dump_memory_diagnostics(seastar::internal::log_buf::inserter_iterator);
 };
 
@@ -438,6 +449,9 @@ class small_pool {
     unsigned _min_free;
     unsigned _max_free;
     unsigned _pages_in_use = 0;
+    // First page of the span most recently added to the pool, used as a hint
+    // to place the next one on the same huge page (0 if none yet)
+    uint32_t _last_span = 0;
     // Flag to indicate whether this pool stores sampled allocations.
     // When freeing small allocations this flag is checked to see whether an
     // allocation site pointer is part of the object and the allocation needs
@@ -548,6 +562,17 @@ struct cross_cpu_free_item {
     cross_cpu_free_item* next;
 };
 
+// Objects freed by a reactor thread on behalf of another shard are collected
+// here, one magazine per owning shard, and handed over with a single atomic
+// operation once the magazine fills up or the reactor polls. This keeps the
+// owner's xcpu_freelist cache line from bouncing on every free.
+struct cross_cpu_magazine {
+    static constexpr unsigned capacity = 64;
+    cross_cpu_free_item* head = nullptr;
+    cross_cpu_free_item* tail = nullptr;
+    unsigned count = 0;
+};
+
 struct cpu_pages {
     small_pool_array<false> small_pools;
     uint32_t min_free_pages = 20000000 / page_size;
@@ -562,6 +587,18 @@ struct cpu_pages {
     std::vector<reclaimer*> reclaimers;
     static constexpr unsigned nr_span_lists = 32;
     page_list free_spans[nr_span_lists];  // contains aligned spans with span_size == 2^idx
+    // log2 of the number of pages in a huge page backing this shard
+    unsigned hugepage_shift = log2ceil(huge_page_size / page_size);
+    // Whether small pool refills should prefer the huge page of their previous span
+    bool hugepage_local_refill = false;
+    // Bytes of this shard's memory known to be backed by huge pages
+    // (hugetlbfs or explicitly reserved anonymous huge pages)
+    size_t hugepage_backed_bytes = 0;
+    cross_cpu_magazine xcpu_magazines[max_cpus];
+    // Shards with a non-empty magazine, in no particular order
+    unsigned xcpu_dirty[max_cpus];
+    unsigned nr_xcpu_dirty = 0;
+    uint64_t xcpu_frees_to[max_cpus] = {};
     alignas(seastar::cache_line_size) std::atomic<cross_cpu_free_item*> xcpu_freelist;
     static std::atomic<unsigned> cpu_id_gen;
     static cpu_pages* all_cpus[max_cpus];
@@ -586,9 +623,12 @@ struct cpu_pages {
     };
     void maybe_reclaim();
     void* allocate_large_and_trim(unsigned nr_pages, bool should_sample);
+    void* take_span(page* span, unsigned nr_pages, bool should_sample);
+    void* allocate_span_near(unsigned nr_pages, pageidx near);
     void* allocate_large(unsigned nr_pages, bool should_sample);
     void* allocate_large_aligned(unsigned align_pages, unsigned nr_pages, bool should_sample);
     page* find_and_unlink_span(unsigned nr_pages);
+    page* find_and_unlink_span_near(unsigned nr_pages, pageidx near);
     page* find_and_unlink_span_reclaiming(unsigned n_pages);
     void free_large(void* ptr);
     bool grow_span(pageidx& start, uint32_t& nr_pages, unsigned idx);
@@ -602,6 +642,10 @@ struct cpu_pages {
     static void do_foreign_free(void* ptr);
     void shrink(void* ptr, size_t new_size);
     static void free_cross_cpu(unsigned cpu_id, void* ptr);
+    static void push_cross_cpu_freelist(unsigned cpu_id, cross_cpu_free_item* head, cross_cpu_free_item* tail);
+    void batch_free_cross_cpu(unsigned cpu_id, cross_cpu_free_item* p);
+    void flush_cross_cpu_magazine(unsigned cpu_id);
+    bool flush_cross_cpu_magazines();
     bool drain_cross_cpu_freelist();
     size_t object_size(void* ptr);
 
@@ -781,6 +825,28 @@ cpu_pages::find_and_unlink_span(unsigned n_pages) {
     return span;
 }
 
+// Like find_and_unlink_span(), but only returns a span lying on the same huge
+// page as page `near`. Just the front of each free list is searched, so this
+// is cheap enough to be tried before every small pool refill.
+page*
+cpu_pages::find_and_unlink_span_near(unsigned n_pages, pageidx near) {
+    static constexpr unsigned max_probes = 8;
+    auto idx = index_of(n_pages);
+    if (n_pages >= (2u << idx)) {
+        return nullptr;
+    }
+    auto hugepage = near >> hugepage_shift;
+    for (; idx < nr_span_lists && idx <= hugepage_shift; ++idx) {
+        auto& list = free_spans[idx];
+        auto span = list.find(pages, max_probes, [&] (pageidx i) { return (i >> hugepage_shift) == hugepage; });
+        if (span) {
+            unlink(list, span);
+            return span;
+        }
+    }
+    return nullptr;
+}
+
 page*
 cpu_pages::find_and_unlink_span_reclaiming(unsigned n_pages) {
     while (true) {
@@ -817,6 +883,13 @@ cpu_pages::allocate_large_and_trim(unsigned n_pages, bool should_sample) {
     if (!span) {
         return nullptr;
     }
+    return take_span(span, n_pages, should_sample);
+}
+
+// Allocates n_pages out of an unlinked free span, returning the excess to
+// the free lists.
+void*
+cpu_pages::take_span(page* span, unsigned n_pages, bool should_sample) {
     auto span_size = span->span_size;
     auto span_idx = span - pages;
     nr_free_pages -= span->span_size;
@@ -842,6 +915,18 @@ cpu_pages::allocate_large_and_trim(unsigned n_pages, bool should_sample) {
     return mem() + span_idx * page_size;
 }
 
+// Allocates a span for a small pool, preferring the huge page holding page
+// `near` so that a pool's objects are covered by as few TLB entries as possible.
+void*
+cpu_pages::allocate_span_near(unsigned n_pages, pageidx near) {
+    if (hugepage_local_refill && near) {
+        if (auto span = find_and_unlink_span_near(n_pages, near)) {
+            return take_span(span, n_pages, false);
+        }
+    }
+    return allocate_large(n_pages, false);
+}
+
 void
 cpu_pages::warn_large_allocation(size_t size) {
     alloc_stats::increment_local(alloc_stats::types::large_allocs);
@@ -1030,17 +1115,71 @@ void cpu_pages::free_cross_cpu(unsigned cpu_id, void* ptr) {
         return;
     }
     auto p = reinterpret_cast<cross_cpu_free_item*>(ptr);
+    // Only reactor threads poll, so only they can be trusted to flush
+    // their magazines.
+    if (is_reactor_thread) {
+        get_cpu_mem().batch_free_cross_cpu(cpu_id, p);
+    } else {
+        push_cross_cpu_freelist(cpu_id, p, p);
+    }
+    alloc_stats::increment(alloc_stats::types::cross_cpu_frees);
+}
+
+void cpu_pages::push_cross_cpu_freelist(unsigned cpu_id, cross_cpu_free_item* head, cross_cpu_free_item* tail) {
     auto& list = all_cpus[cpu_id]->xcpu_freelist;
     auto old = list.load(std::memory_order_relaxed);
     do {
-        p->next = old;
-    } while (!list.compare_exchange_weak(old, p, std::memory_order_release, std::memory_order_relaxed));
-    alloc_stats::increment(alloc_stats::types::cross_cpu_frees);
+        tail->next = old;
+    } while (!list.compare_exchange_weak(old, head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void cpu_pages::batch_free_cross_cpu(unsigned cpu_id, cross_cpu_free_item* p) {
+    auto& mag = xcpu_magazines[cpu_id];
+    p->next = mag.head;
+    mag.head = p;
+    if (!mag.count++) {
+        mag.tail = p;
+        xcpu_dirty[nr_xcpu_dirty++] = cpu_id;
+    }
+    ++xcpu_frees_to[cpu_id];
+    if (mag.count == cross_cpu_magazine::capacity) {
+        flush_cross_cpu_magazine(cpu_id);
+        // Keep the dirty list in sync, the magazine is likely near its end
+        for (unsigned i = nr_xcpu_dirty; i-- > 0;) {
+            if (xcpu_dirty[i] == cpu_id) {
+                xcpu_dirty[i] = xcpu_dirty[--nr_xcpu_dirty];
+                break;
+            }
+        }
+    }
+}
+
+void cpu_pages::flush_cross_cpu_magazine(unsigned cpu_id) {
+    auto& mag = xcpu_magazines[cpu_id];
+    // The owner may have gone away while the objects were waiting here;
+    // leak them, as free_cross_cpu() does.
+    if (live_cpus[cpu_id].load(std::memory_order_relaxed)) {
+        push_cross_cpu_freelist(cpu_id, mag.head, mag.tail);
+        alloc_stats::increment_local(alloc_stats::types::cross_cpu_free_batches);
+    }
+    mag = cross_cpu_magazine{};
+}
+
+bool cpu_pages::flush_cross_cpu_magazines() {
+    if (!nr_xcpu_dirty) {
+        return false;
+    }
+    for (unsigned i = 0; i < nr_xcpu_dirty; ++i) {
+        flush_cross_cpu_magazine(xcpu_dirty[i]);
+    }
+    nr_xcpu_dirty = 0;
+    return true;
 }
 
 bool cpu_pages::drain_cross_cpu_freelist() {
+    bool flushed = flush_cross_cpu_magazines();
     if (!xcpu_freelist.load(std::memory_order_relaxed)) {
-        return false;
+        return flushed;
     }
     auto p = xcpu_freelist.exchange(nullptr, std::memory_order_acquire);
     while (p) {
@@ -1197,6 +1336,7 @@ void cpu_pages::shrink(void* ptr, size_t new_size) {
 }
 
 cpu_pages::~cpu_pages() {
+    flush_cross_cpu_magazines();
     if (is_initialized()) {
         live_cpus[cpu_id].store(false, std::memory_order_relaxed);
     }
@@ -1259,9 +1399,57 @@ allocate_hugetlbfs_memory(file_desc& fd, void* where, size_t how_much) {
             MAP_SHARED | MAP_POPULATE | (where ? MAP_FIXED : 0),
             pos,
             where);
+    cpu_mem.hugepage_backed_bytes += how_much;
     return ret;
 }
 
+// State of the explicitly reserved huge page mapping of this shard
+struct explicit_hugepages {
+    size_t size = 0;
+    // End of the huge page backed part of the shard's memory
+    char* end = nullptr;
+    // Set once the kernel refused a reservation; the rest of the shard's
+    // memory is then backed by ordinary anonymous memory
+    bool exhausted = false;
+};
+
+static thread_local explicit_hugepages explicit_hugepages_state;
+
+// Backs [where, where + how_much) with MAP_HUGETLB pages. The mapping is
+// extended to whole huge pages, so part of the range may already be covered
+// by an earlier call; only what is missing gets mapped. The pages are not
+// populated here. The few holding the shard's memory before configure() are
+// written right away by replace_memory_backing(), the rest are faulted in
+// on first use, after configure() has applied the shard's NUMA policy.
+mmap_area
+allocate_explicit_hugepages_memory(void* where, size_t how_much) {
+    auto& hp = explicit_hugepages_state;
+    auto start = static_cast<char*>(where);
+    auto end = start + how_much;
+    if (hp.end > start) {
+        start = std::min(hp.end, end);
+    }
+    if (start == end) {
+        return mmap_area(nullptr, mmap_deleter{0});
+    }
+    if (!hp.exhausted && align_down(start, hp.size) == start) {
+        auto len = align_up(size_t(end - start), hp.size);
+        auto r = ::mmap(start, len,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB | (log2ceil(hp.size) << MAP_HUGE_SHIFT),
+                -1, 0);
+        if (r != MAP_FAILED) {
+            hp.end = start + len;
+            cpu_mem.hugepage_backed_bytes += len;
+            return mmap_area(static_cast<char*>(r), mmap_deleter{len});
+        }
+        hp.exhausted = true;
+        seastar_memory_logger.warn("cannot reserve {} bytes of {} byte huge pages: {}; falling back to regular pages",
+                len, hp.size, std::strerror(errno));
+    }
+    return allocate_anonymous_memory(start, end - start);
+}
+
 void cpu_pages::replace_memory_backing(allocate_system_memory_fn alloc_sys_mem) {
     // We would like to use ::mremap() to atomically replace the old anonymous
     // memory with hugetlbfs backed memory, but mremap() does not support hugetlbfs
@@ -1470,16 +1658,23 @@ small_pool::add_more_objects() {
         }
     }
     while (_free_count < goal) {
+        auto& cpu_mem = get_cpu_mem();
         auto span_size = _span_sizes.preferred;
-        auto data = reinterpret_cast<char*>(get_cpu_mem().allocate_large(span_size, false));
+        auto data = reinterpret_cast<char*>(cpu_mem.allocate_span_near(span_size, _last_span));
         if (!data) {
             span_size = _span_sizes.fallback;
-            data = reinterpret_cast<char*>(get_cpu_mem().allocate_large(span_size, false));
+            data = reinterpret_cast<char*>(cpu_mem.allocate_span_near(span_size, _last_span));
             if (!data) {
                 break;
             }
         }
-        auto span = get_cpu_mem().to_page(data);
+        auto span = cpu_mem.to_page(data);
+        auto span_idx = pageidx(span - cpu_mem.pages);
+        alloc_stats::increment_local(alloc_stats::types::span_refills);
+        if (_last_span && (span_idx >> cpu_mem.hugepage_shift) == (_last_span >> cpu_mem.hugepage_shift)) {
+            alloc_stats::increment_local(alloc_stats::types::span_refills_same_hugepage);
+        }
+        _last_span = span_idx;
         span_size = span->span_size;
         _pages_in_use += span_size;
         for (unsigned i = 0; i < span_size; ++i) {
@@ -1851,7 +2046,8 @@ static long mbind(void *addr,
 internal::numa_layout
 configure(std::vector<resource::memory> m, bool mbind,
         bool transparent_hugepages,
-        optional<std::string> hugetlbfs_path) {
+        optional<std::string> hugetlbfs_path,
+        size_t explicit_hugepage_size) {
     // we need to make sure cpu_mem is initialize since configure calls cpu_mem.resize
     // and we might reach configure without ever allocating, hence without ever calling
     // cpu_pages::initialize.
@@ -1879,7 +2075,15 @@ configure(std::vector<resource::memory> m, bool mbind,
             return allocate_hugetlbfs_memory(*fdp, where, how_much);
         };
         get_cpu_mem().replace_memory_backing(sys_alloc);
+    } else if (explicit_hugepage_size) {
+        explicit_hugepages_state.size = explicit_hugepage_size;
+        get_cpu_mem().hugepage_shift = log2ceil(explicit_hugepage_size / page_size);
+        sys_alloc = allocate_explicit_hugepages_memory;
+        get_cpu_mem().replace_memory_backing(sys_alloc);
     }
+    // Only when asked for huge pages: with transparent ones, which are the
+    // default, the placement is not worth changing for every application
+    get_cpu_mem().hugepage_local_refill = hugetlbfs_path || explicit_hugepage_size;
     get_cpu_mem().resize(total, sys_alloc);
     size_t pos = 0;
     for (auto&& x : m) {
@@ -1911,9 +2115,16 @@ configure(std::vector<resource::memory> m, bool mbind,
 
 statistics stats() {
     return statistics{alloc_stats::get(alloc_stats::types::allocs), alloc_stats::get(alloc_stats::types::frees), alloc_stats::get(alloc_stats::types::cross_cpu_frees),
+        alloc_stats::get(alloc_stats::types::cross_cpu_free_batches),
         cpu_mem.nr_pages * page_size, cpu_mem.nr_free_pages * page_size, alloc_stats::get(alloc_stats::types::reclaims), alloc_stats::get(alloc_stats::types::large_allocs),
         alloc_stats::get(alloc_stats::types::failed_allocs), alloc_stats::get(alloc_stats::types::foreign_mallocs), alloc_stats::get(alloc_stats::types::foreign_frees),
-        alloc_stats::get(alloc_stats::types::foreign_cross_frees)};
+        alloc_stats::get(alloc_stats::types::foreign_cross_frees),
+        std::min(cpu_mem.hugepage_backed_bytes, size_t(cpu_mem.nr_pages) * page_size),
+        alloc_stats::get(alloc_stats::types::span_refills), alloc_stats::get(alloc_stats::types::span_refills_same_hugepage)};
+}
+
+uint64_t cross_cpu_frees_to(unsigned cpu) {
+    return cpu < max_cpus ? get_cpu_mem().xcpu_frees_to[cpu] : 0;
 }
 
 size_t free_memory() {
@@ -2652,7 +2863,8 @@ void set_reclaim_hook(std::function<void (std::function<void ()>)> hook) {
 internal::numa_layout
 configure(std::vector<resource::memory> m, bool mbind,
         bool transparent_hugepages,
-        std::optional<std::string> hugepages_path) {
+        std::optional<std::string> hugepages_path,
+        size_t explicit_hugepage_size) {
     return {};
 }
 
@@ -2660,7 +2872,11 @@ void configure_minimal()
 {}
 
 statistics stats() {
-    return statistics{0, 0, 0, 1 << 30, 1 << 30, 0, 0, 0, 0, 0, 0};
+    return statistics{0, 0, 0, 0, 1 << 30, 1 << 30, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+}
+
+uint64_t cross_cpu_frees_to(unsigned cpu) {
+    return 0;
 }
 
 size_t free_memory() {
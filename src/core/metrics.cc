@@ -227,17 +227,22 @@ registered_metric::registered_metric(metric_id id, metric_function f, bool enabl
     _info.original_labels = id.internalized_labels();
 }
 
-metric_value metric_value::operator+(const metric_value& c) {
-    metric_value res(*this);
+metric_value& metric_value::operator+=(const metric_value& c) {
     switch (_type) {
     case data_type::HISTOGRAM:
     case data_type::SUMMARY:
-        std::get<histogram>(res.u) += std::get<histogram>(c.u);
+        std::get<histogram>(u) += std::get<histogram>(c.u);
         break;
     default:
-        std::get<double>(res.u) += std::get<double>(c.u);
+        std::get<double>(u) += std::get<double>(c.u);
         break;
     }
+    return *this;
+}
+
+metric_value metric_value::operator+(const metric_value& c) {
+    metric_value res(*this);
+    res += c;
     return res;
 }
 
@@ -607,9 +612,14 @@ histogram& histogram::operator+=(const histogram& c) {
     if (c.sample_count == 0) {
         return *this;
     }
+    // Buckets are cumulative, the ones missing at the end of the shorter
+    // histogram hold its last count
+    uint64_t last_count = buckets.empty() ? 0 : buckets.back().count;
+    uint64_t c_last_count = c.buckets.empty() ? 0 : c.buckets.back().count;
     for (size_t i = 0; i < c.buckets.size(); i++) {
         if (buckets.size() <= i) {
             buckets.push_back(c.buckets[i]);
+            buckets.back().count += last_count;
         } else {
             if (buckets[i].upper_bound != c.buckets[i].upper_bound) {
                 throw std::out_of_range("Trying to add histogram with different bucket limits");
@@ -617,6 +627,9 @@ histogram& histogram::operator+=(const histogram& c) {
             buckets[i].count += c.buckets[i].count;
         }
     }
+    for (size_t i = c.buckets.size(); i < buckets.size(); i++) {
+        buckets[i].count += c_last_count;
+    }
     sample_count += c.sample_count;
     sample_sum += c.sample_sum;
     return *this;
@@ -20,12 +20,12 @@
  */
 
 #include <fmt/core.h>
+#include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <seastar/core/prometheus.hh>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include "proto/metrics2.pb.h"
-#include <sstream>
 
 #include <seastar/core/metrics_api.hh>
 #include <seastar/core/scollectd.hh>
@@ -38,6 +38,9 @@
 #include <seastar/core/thread.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/util/assert.hh>
+#include <array>
+#include <cmath>
+#include <optional>
 #include <ranges>
 #include <regex>
 #include <string_view>
@@ -160,6 +163,26 @@ static void fill_native_type_histogram(const metrics::histogram& h, ::io::promet
     }
 }
 
+/*!
+ * Summaries backed by a native histogram carry the buckets rather than the
+ * quantiles, so that they can be merged across shards. The quantiles are
+ * computed here, from the merged buckets.
+ */
+static constexpr std::array<double, 3> native_summary_quantiles = {0.5, 0.95, 0.99};
+
+static metrics::histogram native_histogram_to_summary(const metrics::histogram& h) {
+    metrics::histogram res;
+    res.sample_count = h.sample_count;
+    res.sample_sum = h.sample_sum;
+    for (auto q : native_summary_quantiles) {
+        auto rank = std::max<uint64_t>(std::ceil(q * h.sample_count), 1);
+        auto b = std::ranges::find_if(h.buckets, [rank] (const metrics::histogram_bucket& b) { return b.count >= rank; });
+        double value = b != h.buckets.end() ? b->upper_bound : (h.buckets.empty() ? 0 : h.buckets.back().upper_bound);
+        res.buckets.push_back({uint64_t(value), q});
+    }
+    return res;
+}
+
 static void fill_metric(pm::MetricFamily& mf, const metrics::impl::metric_value& c,
         const metrics::impl::labels_type & id, const config& ctx) {
     switch (c.type()) {
@@ -168,7 +191,11 @@ static void fill_metric(pm::MetricFamily& mf, const metrics::impl::metric_value&
         mf.set_type(pm::MetricType::GAUGE);
         break;
     case scollectd::data_type::SUMMARY: {
-        auto& h = c.get_histogram();
+        std::optional<metrics::histogram> native;
+        if (c.get_histogram().native_histogram) {
+            native = native_histogram_to_summary(c.get_histogram());
+        }
+        auto& h = native ? *native : c.get_histogram();
         auto mh = add_label(mf.add_metric(), id,ctx)->mutable_summary();
         mh->set_sample_count(h.sample_count);
         mh->set_sample_sum(h.sample_sum);
@@ -203,78 +230,155 @@ static void fill_metric(pm::MetricFamily& mf, const metrics::impl::metric_value&
     }
 }
 
-static std::ostream& operator<<(std::ostream& os, seastar::metrics::impl::data_type dt) {
+static std::string_view type_name(seastar::metrics::impl::data_type dt) {
     switch (dt) {
     case seastar::metrics::impl::data_type::GAUGE:
-        return os << "gauge";
+        return "gauge";
     case seastar::metrics::impl::data_type::COUNTER:
     case seastar::metrics::impl::data_type::REAL_COUNTER:
-        return os << "counter";
+        return "counter";
     case seastar::metrics::impl::data_type::HISTOGRAM:
-        return os << "histogram";
+        return "histogram";
     case seastar::metrics::impl::data_type::SUMMARY:
-        return os << "summary";
+        return "summary";
     }
-    return os << "untyped";
+    return "untyped";
 }
 
-static std::ostream& operator<<(std::ostream& os, const seastar::metrics::impl::metric_value& v) {
-    switch (v.type()) {
-    case seastar::metrics::impl::data_type::GAUGE:
-    case seastar::metrics::impl::data_type::REAL_COUNTER:
-        fmt::print(os, "{:.6f}", v.d());
-        break;
-    case seastar::metrics::impl::data_type::COUNTER:
-        fmt::print(os, "{}", v.i());
-        break;
-    case seastar::metrics::impl::data_type::HISTOGRAM:
-    case seastar::metrics::impl::data_type::SUMMARY:
-        break;
-    }
-    return os;
+/*
+ * The text representation is formatted in place into a buffer, without
+ * intermediate strings, and the buffer is handed to the output stream
+ * whenever it holds text_chunk_size bytes. The buffers are reused across
+ * scrapes, so a scrape does not allocate per series.
+ */
+using text_buffer = fmt::memory_buffer;
+
+static constexpr size_t text_chunk_size = 32 * 1024;
+
+static void append(text_buffer& buf, std::string_view s) {
+    buf.append(s.data(), s.data() + s.size());
 }
 
 /*
- * Sanitizes the prometheus label value as per the line format rules and writes it out to the ostream:
+ * Sanitizes the prometheus label value as per the line format rules and writes it out to the buffer:
  * > label_value can be any sequence of UTF-8 characters, but the backslash (\), double-quote ("), and
  * > line feed (\n) characters have to be escaped as \\, \", and \n, respectively.
  */
-static void escape_and_write_label_value(std::ostream& s, std::string_view label_value) {
+static void escape_and_write_label_value(text_buffer& buf, std::string_view label_value) {
     for (char c : label_value) {
         switch (c) {
-            case '\\': s << R"(\\)"; break;
-            case '\"': s << R"(\")"; break;
-            case '\n': s << R"(\n)"; break;
-            default:   s << c;
+            case '\\': append(buf, R"(\\)"); break;
+            case '\"': append(buf, R"(\")"); break;
+            case '\n': append(buf, R"(\n)"); break;
+            default:   buf.push_back(c);
         }
     }
 }
 
-static void add_name(std::ostream& s, const sstring& name, const std::map<sstring, sstring>& labels, const config& ctx) {
-    s << name << "{";
+static void write_label(text_buffer& buf, const char*& delimiter, std::string_view key, std::string_view value) {
+    append(buf, delimiter);
+    append(buf, key);
+    append(buf, "=\"");
+    escape_and_write_label_value(buf, value);
+    buf.push_back('"');
+    delimiter = ",";
+}
+
+/*
+ * Writes the series name (the family name followed by the suffix) and its
+ * labels. The extra label, if any (le or quantile), is written in its
+ * sorted position, as if it was one of the labels.
+ */
+static void add_name(text_buffer& buf, std::string_view name, std::string_view suffix, const mi::labels_type& labels, const config& ctx,
+        std::string_view extra_key = {}, std::string_view extra_value = {}) {
+    append(buf, name);
+    append(buf, suffix);
+    buf.push_back('{');
     const char* delimiter = "";
     if (ctx.label) {
-        s << ctx.label->key()  << "=\"";
-        escape_and_write_label_value(s, ctx.label->value());
-        s << '"';
-        delimiter = ",";
-    }
-
-    if (!labels.empty()) {
-        for (auto l : labels) {
-            if (!boost::algorithm::starts_with(l.first, "__")) {
-                s << delimiter;
-                s << l.first  << "=\"";
-                escape_and_write_label_value(s, l.second);
-                s << '"';
-                delimiter = ",";
+        write_label(buf, delimiter, ctx.label->key(), ctx.label->value());
+    }
+
+    bool extra_pending = !extra_key.empty();
+    for (auto&& [key, value] : labels) {
+        if (extra_pending && std::string_view(key) >= extra_key) {
+            write_label(buf, delimiter, extra_key, extra_value);
+            extra_pending = false;
+            if (key == extra_key) {
+                continue;
             }
         }
+        if (!boost::algorithm::starts_with(key, "__")) {
+            write_label(buf, delimiter, key, value);
+        }
     }
-    s << "} ";
-
+    if (extra_pending) {
+        write_label(buf, delimiter, extra_key, extra_value);
+    }
+    append(buf, "} ");
 }
 
+/*!
+ * \brief a helper class to aggregate metrics over labels
+ *
+ * This class sum multiple metrics based on a list of labels.
+ * It returns one or more metrics each aggregated by the aggregate_by labels.
+ *
+ * To use it, you define what labels it should aggregate by and then pass to
+ * it metrics with their labels.
+ * For example if a metrics has a 'shard' and 'name' labels and you aggregate by 'shard'
+ * it would return a map of metrics each with only the 'name' label
+ *
+ */
+class metric_aggregate_by_labels {
+    std::vector<std::string> _labels_to_aggregate_by;
+    std::unordered_map<std::map<sstring, sstring>, seastar::metrics::impl::metric_value> _values;
+public:
+    metric_aggregate_by_labels(std::vector<std::string> labels) : _labels_to_aggregate_by(std::move(labels)) {
+    }
+    /*!
+     * \brief add a metric
+     *
+     * This method gets a metric and its labels and adds it to the aggregated metric.
+     * For example, if a metric has the labels {'shard':'0', 'name':'myhist'} and we are aggregating
+     * over 'shard'
+     * The metric would be added to the aggregated metric with labels {'name':'myhist'}.
+     *
+     */
+    void add(const seastar::metrics::impl::metric_value& m, std::map<sstring, sstring> labels) noexcept {
+        for (auto&& l : _labels_to_aggregate_by) {
+            labels.erase(l);
+        }
+        std::unordered_map<std::map<sstring, sstring>, seastar::metrics::impl::metric_value>::iterator i = _values.find(labels);
+        if ( i == _values.end()) {
+            _values.emplace(std::move(labels), m);
+        } else {
+            i->second += m;
+        }
+    }
+    const std::unordered_map<std::map<sstring, sstring>, seastar::metrics::impl::metric_value>& get_values() const noexcept {
+        return _values;
+    }
+    /*!
+     * \brief add the metrics aggregated by another instance
+     *
+     * Used to combine the partial aggregations done by every shard.
+     */
+    void merge(const metric_aggregate_by_labels& o) {
+        for (auto&& [labels, value] : o._values) {
+            auto i = _values.find(labels);
+            if (i == _values.end()) {
+                _values.emplace(labels, value);
+            } else {
+                i->second += value;
+            }
+        }
+    }
+    bool empty() const noexcept {
+        return _values.empty();
+    }
+};
+
 /*!
  * \brief iterator for metric family
  *
@@ -328,9 +432,35 @@ class metric_family_iterator;
 
 class metric_family_range;
 
+/*!
+ * \brief what a scrape asks for
+ */
+struct scrape_request {
+    sstring metric_family_name; // empty for all the families
+    bool prefix = false;
+    bool aggregate = true;
+    std::function<bool(const mi::labels_type&)> filter;
+
+    bool wants(const sstring& family_name) const {
+        if (metric_family_name.empty()) {
+            return true;
+        }
+        return prefix ? boost::algorithm::starts_with(family_name, metric_family_name) : family_name == metric_family_name;
+    }
+};
+
+/*!
+ * \brief the aggregated series of a shard
+ *
+ * Indexed by the family position in the shard metadata, disengaged for the
+ * families that are not aggregated (or not requested).
+ */
+using family_aggregates = std::vector<std::optional<metric_aggregate_by_labels>>;
+
 class metrics_families_per_shard {
     using metrics_family_per_shard_data_container = std::vector<foreign_ptr<mi::values_reference>>;
     metrics_family_per_shard_data_container _data;
+    std::vector<foreign_ptr<std::unique_ptr<family_aggregates>>> _aggregates;
     using comp_function = std::function<bool(const sstring&, const mi::metric_family_metadata&)>;
     /*!
      * \brief find the last item in a range of metric family based on a comparator function
@@ -389,6 +519,7 @@ class metrics_families_per_shard {
 
     void resize(size_t new_size) {
         _data.resize(new_size);
+        _aggregates.resize(new_size);
     }
 
     reference& operator[](size_t n) {
@@ -399,15 +530,78 @@ class metrics_families_per_shard {
         return _data[n];
     }
     /** @} */
+
+    void set_aggregates(size_t shard, foreign_ptr<std::unique_ptr<family_aggregates>> aggregates) {
+        _aggregates[shard] = std::move(aggregates);
+    }
+
+    /*!
+     * \brief the series of a family aggregated by a shard, if any
+     */
+    const metric_aggregate_by_labels* aggregated(size_t shard, size_t pos) const {
+        if (shard >= _aggregates.size() || !_aggregates[shard] || pos >= _aggregates[shard]->size()) {
+            return nullptr;
+        }
+        auto& a = (*_aggregates[shard])[pos];
+        return a ? &*a : nullptr;
+    }
+};
+
+/*!
+ * \brief sum up the series of the requested aggregated families of the local shard
+ *
+ * Runs in a seastar thread, on the shard that owns the values.
+ */
+static std::unique_ptr<family_aggregates> aggregate_locally(const mi::values_copy& values, const scrape_request& req) {
+    auto res = std::make_unique<family_aggregates>();
+    auto& metadata = *values.metadata;
+    res->resize(metadata.size());
+    for (size_t i = 0; i < metadata.size(); i++) {
+        auto& mf = metadata[i].mf;
+        if (mf.aggregate_labels.empty() || !req.wants(mf.name)) {
+            continue;
+        }
+        auto& aggregated = (*res)[i].emplace(mf.aggregate_labels);
+        for (auto&& vm : boost::combine(values.values[i], metadata[i].metrics)) {
+            auto& value = boost::get<0>(vm);
+            auto& value_info = boost::get<1>(vm);
+            if ((value_info.should_skip_when_empty() && value.is_empty()) || !req.filter(value_info.labels())) {
+                continue;
+            }
+            aggregated.add(value, value_info.labels());
+            thread::maybe_yield();
+        }
+    }
+    return res;
+}
+
+struct shard_values {
+    foreign_ptr<mi::values_reference> values;
+    foreign_ptr<std::unique_ptr<family_aggregates>> aggregates;
 };
 
-static future<> get_map_value(metrics_families_per_shard& vec) {
+/*!
+ * \brief collect the values of all the shards
+ *
+ * When aggregating, every shard also sums up its own series of the
+ * aggregated families, so that this shard only merges one partial result
+ * per shard instead of going over all the series of all the shards.
+ */
+static future<> get_map_value(metrics_families_per_shard& vec, const scrape_request& req) {
     vec.resize(smp::count);
-    return parallel_for_each(std::views::iota(0u, smp::count), [&vec] (auto cpu) {
-        return smp::submit_to(cpu, [] {
-            return mi::get_values();
-        }).then([&vec, cpu] (auto res) {
-            vec[cpu] = std::move(res);
+    return parallel_for_each(std::views::iota(0u, smp::count), [&vec, &req] (auto cpu) {
+        return smp::submit_to(cpu, [req] () mutable {
+            auto values = mi::get_values();
+            if (!req.aggregate) {
+                return make_ready_future<shard_values>(shard_values{std::move(values), nullptr});
+            }
+            return seastar::async([values = std::move(values), req = std::move(req)] () mutable {
+                auto aggregates = aggregate_locally(*values, req);
+                return shard_values{std::move(values), make_foreign(std::move(aggregates))};
+            });
+        }).then([&vec, cpu] (shard_values res) {
+            vec[cpu] = std::move(res.values);
+            vec.set_aggregates(cpu, std::move(res.aggregates));
         });
     });
 }
@@ -447,6 +641,11 @@ class metric_family {
 
     void foreach_metric(std::function<void(const mi::metric_value&, const mi::metric_series_metadata&)>&& f);
 
+    /*!
+     * \brief merge the series of the family aggregated by each shard
+     */
+    void merge_aggregated(metric_aggregate_by_labels& res) const;
+
     bool end() const {
         return !_name || !_family_info;
     }
@@ -586,12 +785,29 @@ class metric_family_iterator {
         }
     }
 
+    void merge_aggregated(metric_aggregate_by_labels& res) const {
+        for (size_t shard = 0; shard < _positions.size(); shard++) {
+            auto pos_in_metric_per_shard = _positions[shard];
+            auto& metric_family = _families[shard];
+            if (pos_in_metric_per_shard >= metric_family->metadata->size() ||
+                    metric_family->metadata->at(pos_in_metric_per_shard).mf.name != name()) {
+                continue;
+            }
+            if (auto aggregated = _families.aggregated(shard, pos_in_metric_per_shard)) {
+                res.merge(*aggregated);
+            }
+        }
+    }
 };
 
 void metric_family::foreach_metric(std::function<void(const mi::metric_value&, const mi::metric_series_metadata&)>&& f) {
     _iterator_state.foreach_metric(std::move(f));
 }
 
+void metric_family::merge_aggregated(metric_aggregate_by_labels& res) const {
+    _iterator_state.merge_aggregated(res);
+}
+
 class metric_family_range {
     metric_family_iterator _begin;
     metric_family_iterator _end;
@@ -666,154 +882,149 @@ metric_family_range get_range(const metrics_families_per_shard& mf, const sstrin
 
 }
 
-void write_histogram(std::stringstream& s, const config& ctx, const sstring& name, const seastar::metrics::histogram& h, std::map<sstring, sstring> labels) noexcept {
-    add_name(s, name + "_sum", labels, ctx);
-    s << h.sample_sum << '\n';
+static void write_histogram(text_buffer& buf, const config& ctx, std::string_view name, const seastar::metrics::histogram& h, const mi::labels_type& labels) {
+    add_name(buf, name, "_sum", labels, ctx);
+    fmt::format_to(fmt::appender(buf), "{:g}\n", h.sample_sum);
 
-    add_name(s, name + "_count", labels, ctx);
-    s << h.sample_count  << '\n';
+    add_name(buf, name, "_count", labels, ctx);
+    fmt::format_to(fmt::appender(buf), "{}\n", h.sample_count);
 
-    auto& le = labels["le"];
-    auto bucket = name + "_bucket";
-    for (auto  i : h.buckets) {
-         le = std::to_string(i.upper_bound);
-        add_name(s, bucket, labels, ctx);
-        s << i.count << '\n';
+    fmt::basic_memory_buffer<char, 64> le;
+    for (auto& b : h.buckets) {
+        le.clear();
+        fmt::format_to(fmt::appender(le), "{:f}", b.upper_bound);
+        add_name(buf, name, "_bucket", labels, ctx, "le", std::string_view(le.data(), le.size()));
+        fmt::format_to(fmt::appender(buf), "{}\n", b.count);
     }
-    labels["le"] = "+Inf";
-    add_name(s, bucket, labels, ctx);
-    s << h.sample_count  << '\n';
+    add_name(buf, name, "_bucket", labels, ctx, "le", "+Inf");
+    fmt::format_to(fmt::appender(buf), "{}\n", h.sample_count);
 }
 
-void write_summary(std::stringstream& s, const config& ctx, const sstring& name, const seastar::metrics::histogram& h, std::map<sstring, sstring> labels) noexcept {
+static void write_summary(text_buffer& buf, const config& ctx, std::string_view name, const seastar::metrics::histogram& sh, const mi::labels_type& labels) {
+    std::optional<seastar::metrics::histogram> native;
+    if (sh.native_histogram) {
+        native = native_histogram_to_summary(sh);
+    }
+    auto& h = native ? *native : sh;
     if (h.sample_sum) {
-        add_name(s, name + "_sum", labels, ctx);
-        s << h.sample_sum  << '\n';
+        add_name(buf, name, "_sum", labels, ctx);
+        fmt::format_to(fmt::appender(buf), "{:g}\n", h.sample_sum);
     }
     if (h.sample_count) {
-        add_name(s, name + "_count", labels, ctx);
-        s << h.sample_count  << '\n';
+        add_name(buf, name, "_count", labels, ctx);
+        fmt::format_to(fmt::appender(buf), "{}\n", h.sample_count);
     }
-    auto& le = labels["quantile"];
-    for (auto  i : h.buckets) {
-        le = std::to_string(i.upper_bound);
-        add_name(s, name, labels, ctx);
-        s << i.count  << '\n';
+    fmt::basic_memory_buffer<char, 64> quantile;
+    for (auto& b : h.buckets) {
+        quantile.clear();
+        fmt::format_to(fmt::appender(quantile), "{:f}", b.upper_bound);
+        add_name(buf, name, "", labels, ctx, "quantile", std::string_view(quantile.data(), quantile.size()));
+        fmt::format_to(fmt::appender(buf), "{}\n", b.count);
     }
 }
-/*!
- * \brief a helper class to aggregate metrics over labels
- *
- * This class sum multiple metrics based on a list of labels.
- * It returns one or more metrics each aggregated by the aggregate_by labels.
- *
- * To use it, you define what labels it should aggregate by and then pass to
- * it metrics with their labels.
- * For example if a metrics has a 'shard' and 'name' labels and you aggregate by 'shard'
- * it would return a map of metrics each with only the 'name' label
- *
- */
-class metric_aggregate_by_labels {
-    std::vector<std::string> _labels_to_aggregate_by;
-    std::unordered_map<std::map<sstring, sstring>, seastar::metrics::impl::metric_value> _values;
-public:
-    metric_aggregate_by_labels(std::vector<std::string> labels) : _labels_to_aggregate_by(std::move(labels)) {
-    }
-    /*!
-     * \brief add a metric
-     *
-     * This method gets a metric and its labels and adds it to the aggregated metric.
-     * For example, if a metric has the labels {'shard':'0', 'name':'myhist'} and we are aggregating
-     * over 'shard'
-     * The metric would be added to the aggregated metric with labels {'name':'myhist'}.
-     *
-     */
-    void add(const seastar::metrics::impl::metric_value& m, std::map<sstring, sstring> labels) noexcept {
-        for (auto&& l : _labels_to_aggregate_by) {
-            labels.erase(l);
-        }
-        std::unordered_map<std::map<sstring, sstring>, seastar::metrics::impl::metric_value>::iterator i = _values.find(labels);
-        if ( i == _values.end()) {
-            _values.emplace(std::move(labels), m);
-        } else {
-            i->second += m;
-        }
-    }
-    const std::unordered_map<std::map<sstring, sstring>, seastar::metrics::impl::metric_value>& get_values() const noexcept {
-        return _values;
-    }
-    bool empty() const noexcept {
-        return _values.empty();
-    }
-};
 
-void write_value_as_string(std::stringstream& s, const mi::metric_value& value) noexcept {
-    std::string value_str;
+static void write_value_as_string(text_buffer& buf, size_t line_start, const mi::metric_value& value) {
+    auto line = [&buf, line_start] {
+        return std::string_view(buf.data() + line_start, buf.size() - line_start);
+    };
     try {
-        s << value;
+        switch (value.type()) {
+        case seastar::metrics::impl::data_type::GAUGE:
+        case seastar::metrics::impl::data_type::REAL_COUNTER:
+            fmt::format_to(fmt::appender(buf), "{:.6f}", value.d());
+            break;
+        case seastar::metrics::impl::data_type::COUNTER:
+            fmt::format_to(fmt::appender(buf), "{}", value.i());
+            break;
+        case seastar::metrics::impl::data_type::HISTOGRAM:
+        case seastar::metrics::impl::data_type::SUMMARY:
+            break;
+        }
     } catch (const std::range_error& e) {
-        seastar_logger.debug("prometheus: write_value_as_string: {}: {}", s.str(), e.what());
-        s << "NaN";
+        seastar_logger.debug("prometheus: write_value_as_string: {}: {}", line(), e.what());
+        append(buf, "NaN");
     } catch (...) {
         auto ex = std::current_exception();
         // print this error as it's ignored later on by `connection::start_response`
-        seastar_logger.error("prometheus: write_value_as_string: {}: {}", s.str(), ex);
+        seastar_logger.error("prometheus: write_value_as_string: {}: {}", line(), ex);
         std::rethrow_exception(std::move(ex));
     }
 }
 
-future<> write_text_representation(output_stream<char>& out, const config& ctx, const metric_family_range& m, bool show_help, bool enable_aggregation, std::function<bool(const mi::labels_type&)> filter) {
-    return seastar::async([&ctx, &out, &m, show_help, enable_aggregation, filter] () mutable {
-        bool found = false;
-        std::stringstream s;
+static void write_series(text_buffer& buf, const config& ctx, std::string_view name, const mi::metric_value& value, const mi::labels_type& labels) {
+    if (value.type() == mi::data_type::SUMMARY) {
+        write_summary(buf, ctx, name, value.get_histogram(), labels);
+    } else if (value.type() == mi::data_type::HISTOGRAM) {
+        write_histogram(buf, ctx, name, value.get_histogram(), labels);
+    } else {
+        auto line_start = buf.size();
+        add_name(buf, name, "", labels, ctx);
+        write_value_as_string(buf, line_start, value);
+        buf.push_back('\n');
+    }
+}
+
+/*
+ * Must be called from a seastar thread. The output stream copies the
+ * data, so the buffer can be reused right away.
+ */
+static void flush_text(output_stream<char>& out, text_buffer& buf) {
+    if (buf.size()) {
+        out.write(buf.data(), buf.size()).get();
+        buf.clear();
+    }
+}
+
+static void maybe_flush_text(output_stream<char>& out, text_buffer& buf) {
+    if (buf.size() >= text_chunk_size) {
+        flush_text(out, buf);
+    }
+    thread::maybe_yield();
+}
+
+future<> write_text_representation(output_stream<char>& out, const config& ctx, const metric_family_range& m, bool show_help, bool enable_aggregation, std::function<bool(const mi::labels_type&)> filter, text_buffer& buf) {
+    return seastar::async([&ctx, &out, &m, show_help, enable_aggregation, filter, &buf] () mutable {
+        buf.clear();
+        fmt::memory_buffer name;
         for (metric_family& metric_family : m) {
-            auto name = ctx.prefix + "_" + metric_family.name();
-            found = false;
-            metric_aggregate_by_labels aggregated_values(metric_family.metadata().aggregate_labels);
+            name.clear();
+            fmt::format_to(fmt::appender(name), "{}_{}", ctx.prefix, metric_family.name());
+            auto family_name = std::string_view(name.data(), name.size());
+            auto write_header = [&] {
+                if (show_help && metric_family.metadata().d.str() != "") {
+                    fmt::format_to(fmt::appender(buf), "# HELP {} {}\n", family_name, metric_family.metadata().d.str());
+                }
+                fmt::format_to(fmt::appender(buf), "# TYPE {} {}\n", family_name, type_name(metric_family.metadata().type));
+            };
             bool should_aggregate = enable_aggregation && !metric_family.metadata().aggregate_labels.empty();
-            metric_family.foreach_metric([&s, &out, &ctx, &found, &name, &metric_family, &aggregated_values, should_aggregate, show_help, &filter](const mi::metric_value& value, const mi::metric_series_metadata& value_info) mutable {
-                s.clear();
-                s.str("");
+            if (should_aggregate) {
+                // The series were filtered and summed up by the shards
+                // that own them, only the partial results are left to merge
+                metric_aggregate_by_labels aggregated_values(metric_family.metadata().aggregate_labels);
+                metric_family.merge_aggregated(aggregated_values);
+                if (!aggregated_values.empty()) {
+                    write_header();
+                }
+                for (auto&& h : aggregated_values.get_values()) {
+                    write_series(buf, ctx, family_name, h.second, h.first);
+                    maybe_flush_text(out, buf);
+                }
+                continue;
+            }
+            bool found = false;
+            metric_family.foreach_metric([&] (const mi::metric_value& value, const mi::metric_series_metadata& value_info) {
                 if ((value_info.should_skip_when_empty() && value.is_empty()) || !filter(value_info.labels())) {
                     return;
                 }
                 if (!found) {
-                    if (show_help && metric_family.metadata().d.str() != "") {
-                        s << "# HELP " << name << " " <<  metric_family.metadata().d.str() << '\n';
-                    }
-                    s << "# TYPE " << name << " " << metric_family.metadata().type << '\n';
+                    write_header();
                     found = true;
                 }
-                if (should_aggregate) {
-                    aggregated_values.add(value, value_info.labels());
-                } else if (value.type() == mi::data_type::SUMMARY) {
-                    write_summary(s, ctx, name, value.get_histogram(), value_info.labels());
-                } else if (value.type() == mi::data_type::HISTOGRAM) {
-                    write_histogram(s, ctx, name, value.get_histogram(), value_info.labels());
-                } else {
-                    add_name(s, name, value_info.labels(), ctx);
-                    write_value_as_string(s, value);
-                    s << '\n';
-                }
-                out.write(s.str()).get();
-                thread::maybe_yield();
+                write_series(buf, ctx, family_name, value, value_info.labels());
+                maybe_flush_text(out, buf);
             });
-            if (!aggregated_values.empty()) {
-                for (auto&& h : aggregated_values.get_values()) {
-                    s.clear();
-                    s.str("");
-                    if (h.second.type() == mi::data_type::HISTOGRAM) {
-                        write_histogram(s, ctx, name, h.second.get_histogram(), h.first);
-                    } else {
-                        add_name(s, name, h.first, ctx);
-                        write_value_as_string(s, h.second);
-                        s << '\n';
-                    }
-                    out.write(s.str()).get();
-                    thread::maybe_yield();
-                }
-            }
         }
+        flush_text(out, buf);
     });
 }
 
@@ -827,18 +1038,19 @@ future<> write_protobuf_representation(output_stream<char>& out, const config& c
         pm::MetricFamily mtf;
         bool empty_metric = true;
         mtf.set_name(fmt::format("{}_{}", ctx.prefix, name));
-        mtf.mutable_metric()->Reserve(metric_family.size());
-        metric_family.foreach_metric([&mtf, &ctx, &filter, &aggregated_values, &empty_metric, should_aggregate](const auto& value, const auto& value_info) {
-            if ((value_info.should_skip_when_empty() && value.is_empty()) || !filter(value_info.labels())) {
-                return;
-            }
-            if (should_aggregate) {
-                aggregated_values.add(value, value_info.labels());
-            } else {
+        if (should_aggregate) {
+            // The series were filtered and summed up by the shards that own them
+            metric_family.merge_aggregated(aggregated_values);
+        } else {
+            mtf.mutable_metric()->Reserve(metric_family.size());
+            metric_family.foreach_metric([&mtf, &ctx, &filter, &empty_metric](const auto& value, const auto& value_info) {
+                if ((value_info.should_skip_when_empty() && value.is_empty()) || !filter(value_info.labels())) {
+                    return;
+                }
                 fill_metric(mtf, value, value_info.labels(), ctx);
                 empty_metric = false;
-            }
-        });
+            });
+        }
         for (auto& [labels, value] : aggregated_values.get_values()) {
             fill_metric(mtf, value, labels, ctx);
             empty_metric = false;
@@ -868,6 +1080,8 @@ bool is_accept_protobuf(const std::string& accept) {
 class metrics_handler : public httpd::handler_base  {
     sstring _prefix;
     config _ctx;
+    // Text formatting buffers, reused across scrapes
+    std::vector<text_buffer> _text_buffers;
     static std::function<bool(const mi::labels_type&)> _true_function;
 
     /*!
@@ -922,19 +1136,30 @@ class metrics_handler : public httpd::handler_base  {
     future<std::unique_ptr<http::reply>> handle(const sstring& path,
         std::unique_ptr<http::request> req, std::unique_ptr<http::reply> rep) override {
         auto is_protobuf_format = _ctx.allow_protobuf && is_accept_protobuf(req->get_header("Accept"));
-        sstring metric_family_name = req->get_query_param("__name__");
-        bool prefix = trim_asterisk(metric_family_name);
+        scrape_request sr;
+        sr.metric_family_name = req->get_query_param("__name__");
+        sr.prefix = trim_asterisk(sr.metric_family_name);
+        sr.aggregate = req->get_query_param("__aggregate__") != "false";
+        sr.filter = make_filter(*req);
         bool show_help = req->get_query_param("__help__") != "false";
-        bool enable_aggregation = req->get_query_param("__aggregate__") != "false";
-        std::function<bool(const mi::labels_type&)> filter = make_filter(*req);
-        rep->write_body(is_protobuf_format ? "proto" : "txt", [this, is_protobuf_format, metric_family_name, prefix, show_help, enable_aggregation, filter] (output_stream<char>&& s) {
+        rep->write_body(is_protobuf_format ? "proto" : "txt", [this, is_protobuf_format, sr = std::move(sr), show_help] (output_stream<char>&& s) {
             return do_with(metrics_families_per_shard(), output_stream<char>(std::move(s)),
-                    [this, is_protobuf_format, prefix, &metric_family_name, show_help, enable_aggregation, filter] (metrics_families_per_shard& families, output_stream<char>& s) mutable {
-                return get_map_value(families).then([&s, &families, this, is_protobuf_format, prefix, &metric_family_name, show_help, enable_aggregation, filter]() mutable {
-                    return do_with(get_range(families, metric_family_name, prefix),
-                            [&s, this, is_protobuf_format, show_help, enable_aggregation, filter](metric_family_range& m) {
-                        return (is_protobuf_format) ?  write_protobuf_representation(s, _ctx, m, enable_aggregation, filter) :
-                                write_text_representation(s, _ctx, m, show_help, enable_aggregation, filter);
+                    [this, is_protobuf_format, &sr, show_help] (metrics_families_per_shard& families, output_stream<char>& s) mutable {
+                return get_map_value(families, sr).then([&s, &families, this, is_protobuf_format, &sr, show_help]() mutable {
+                    return do_with(get_range(families, sr.metric_family_name, sr.prefix),
+                            [&s, this, is_protobuf_format, &sr, show_help](metric_family_range& m) {
+                        if (is_protobuf_format) {
+                            return write_protobuf_representation(s, _ctx, m, sr.aggregate, sr.filter);
+                        }
+                        auto buf = std::make_unique<text_buffer>();
+                        if (!_text_buffers.empty()) {
+                            *buf = std::move(_text_buffers.back());
+                            _text_buffers.pop_back();
+                        }
+                        auto& b = *buf;
+                        return write_text_representation(s, _ctx, m, show_help, sr.aggregate, sr.filter, b).finally([this, buf = std::move(buf)] {
+                            _text_buffers.push_back(std::move(*buf));
+                        });
                     });
                 }).finally([&s] () mutable {
                     return s.close();
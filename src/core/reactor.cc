@@ -51,6 +51,7 @@ module;
 #include <sys/eventfd.h>
 #include <poll.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/thread/barrier.hpp>
 #include <boost/algorithm/string/classification.hpp>
@@ -126,6 +127,7 @@ module seastar;
 #else
 #include <seastar/core/abort_on_ebadf.hh>
 #include <seastar/core/alien.hh>
+#include <seastar/core/bitops.hh>
 #include <seastar/core/exception_hacks.hh>
 #include <seastar/core/execution_stage.hh>
 #include <seastar/core/io_queue.hh>
@@ -156,6 +158,8 @@ module seastar;
 #include <seastar/core/internal/io_desc.hh>
 #include <seastar/core/internal/uname.hh>
 #include <seastar/core/internal/stall_detector.hh>
+#include <seastar/core/internal/cpu_profiler.hh>
+#include <seastar/core/cpu_profiler.hh>
 #include <seastar/core/internal/run_in_background.hh>
 #include <seastar/net/native-stack.hh>
 #include <seastar/net/packet.hh>
@@ -460,6 +464,20 @@ future<> pollable_fd_state::write_all(net::packet& p) {
     });
 }
 
+future<size_t> pollable_fd_state::write_some_zerocopy(net::packet& p) {
+    return engine()._backend->sendmsg_zerocopy(*this, p);
+}
+
+future<> pollable_fd_state::write_all_zerocopy(net::packet& p) {
+    return write_some_zerocopy(p).then([this, &p] (size_t size) {
+        if (p.len() == size) {
+            return make_ready_future<>();
+        }
+        p.trim_front(size);
+        return write_all_zerocopy(p);
+    });
+}
+
 future<> pollable_fd_state::readable() {
     return engine().readable(*this);
 }
@@ -501,13 +519,44 @@ future<size_t> pollable_fd_state::recvmsg(struct msghdr *msg) {
         // all messages without resorting to epoll. However this adds extra
         // recvmsg() call when we hit the empty queue condition, so it may
         // hurt request-response workload in which the queue is empty when we
-        // initially enter recvmsg(). If that turns out to be a problem, we can
-        // improve speculation by using recvmmsg().
+        // initially enter recvmsg(). Callers that care should use recvmmsg(),
+        // which only speculates when the batch was filled completely.
         speculate_epoll(EPOLLIN);
         return make_ready_future<size_t>(*r);
     });
 }
 
+future<size_t> pollable_fd_state::recvmmsg(struct mmsghdr* msgvec, size_t vlen) {
+    maybe_no_more_recv();
+    return engine().readable(*this).then([this, msgvec, vlen] {
+        auto r = fd.recvmmsg(msgvec, vlen, 0);
+        if (!r) {
+            return recvmmsg(msgvec, vlen);
+        }
+        // A short batch means the socket queue was drained, so only keep
+        // speculating if we filled all the slots we were given.
+        if (*r == vlen) {
+            speculate_epoll(EPOLLIN);
+        }
+        return make_ready_future<size_t>(*r);
+    });
+}
+
+future<size_t> pollable_fd_state::sendmmsg(struct mmsghdr* msgvec, size_t vlen) {
+    maybe_no_more_send();
+    return engine().writeable(*this).then([this, msgvec, vlen] () mutable {
+        auto r = fd.sendmmsg(msgvec, vlen, 0);
+        if (!r) {
+            return sendmmsg(msgvec, vlen);
+        }
+        // See the comment about speculation in sendmsg().
+        if (*r == vlen) {
+            speculate_epoll(EPOLLOUT);
+        }
+        return make_ready_future<size_t>(*r);
+    });
+}
+
 future<size_t> pollable_fd_state::sendmsg(struct msghdr* msg) {
     maybe_no_more_send();
     return engine().writeable(*this).then([this, msg] () mutable {
@@ -1044,8 +1093,11 @@ reactor::reactor(std::shared_ptr<seastar::smp> smp, alien::instance& alien, unsi
     , _id(id)
     , _cpu_started(0)
     , _cpu_stall_detector(internal::make_cpu_stall_detector())
+    , _cpu_profiler(std::make_unique<internal::cpu_profiler>())
     , _reuseport(posix_reuseport_detect())
     , _thread_pool(std::make_unique<thread_pool>(*this, seastar::format("syscall-{}", id))) {
+    _timers.use_wheel(_cfg.timer_wheel);
+    _lowres_timers.use_wheel(_cfg.timer_wheel);
     /*
      * The _backend assignment is here, not on the initialization list as
      * the chosen backend constructor may want to handle signals and thus
@@ -1063,8 +1115,16 @@ reactor::reactor(std::shared_ptr<seastar::smp> smp, alien::instance& alien, unsi
     sigset_t mask;
     sigemptyset(&mask);
     sigaddset(&mask, internal::cpu_stall_detector::signal_number());
+    sigaddset(&mask, internal::cpu_profiler::signal_number());
     auto r = ::pthread_sigmask(SIG_UNBLOCK, &mask, NULL);
     SEASTAR_ASSERT(r == 0);
+    // Installed here rather than in run(), so that the profiler can be
+    // enabled as soon as the reactor is configured
+    struct sigaction sa_cpu_profiler = {};
+    sa_cpu_profiler.sa_sigaction = &reactor::cpu_profiler_notifier;
+    sa_cpu_profiler.sa_flags = SA_SIGINFO | SA_RESTART;
+    r = sigaction(internal::cpu_profiler::signal_number(), &sa_cpu_profiler, nullptr);
+    SEASTAR_ASSERT(r == 0);
     memory::set_reclaim_hook([this] (std::function<void ()> reclaim_fn) {
         add_high_priority_task(make_task(default_scheduling_group(), [fn = std::move(reclaim_fn)] {
             fn();
@@ -1076,6 +1136,7 @@ reactor::~reactor() {
     sigset_t mask;
     sigemptyset(&mask);
     sigaddset(&mask, internal::cpu_stall_detector::signal_number());
+    sigaddset(&mask, internal::cpu_profiler::signal_number());
     auto r = ::pthread_sigmask(SIG_BLOCK, &mask, NULL);
     SEASTAR_ASSERT(r == 0);
 
@@ -1499,6 +1560,28 @@ reactor::block_notifier(int) {
     engine()._cpu_stall_detector->on_signal();
 }
 
+void
+reactor::cpu_profiler_notifier(int, siginfo_t*, void* ucontext) {
+    auto& r = engine();
+    auto sg = internal::scheduling_group_index(*internal::current_scheduling_group_ptr());
+    r._cpu_profiler->on_signal(r._current_task_type, sg, ucontext);
+}
+
+void
+reactor::set_cpu_profiler_rate(unsigned hz) {
+    _cpu_profiler->set_rate(hz);
+}
+
+unsigned
+reactor::get_cpu_profiler_rate() const noexcept {
+    return _cpu_profiler->rate();
+}
+
+void
+reactor::collect_cpu_profile(cpu_profile& profile, bool reset) {
+    _cpu_profiler->collect(profile, reset);
+}
+
 class network_stack_factory {
     network_stack_entry::factory_func _func;
 
@@ -1517,6 +1600,7 @@ void reactor::configure(const reactor_options& opts) {
     csdc.stall_detector_reports_per_minute = opts.blocked_reactor_reports_per_minute.get_value();
     csdc.oneline = opts.blocked_reactor_report_format_oneline.get_value();
     _cpu_stall_detector->update_config(csdc);
+    set_cpu_profiler_rate(opts.cpu_profiler_rate.get_value());
 
     if (_cfg.no_poll_aio) {
         _aio_eventfd = pollable_fd(file_desc::eventfd(0, 0));
@@ -1560,6 +1644,10 @@ reactor::posix_listen(socket_address sa, listen_options opts) {
         fd.setsockopt(SOL_SOCKET, SO_RCVBUF, *opts.so_rcvbuf);
     }
 
+    if (opts.congestion_control && opts.proto == transport::TCP && !sa.is_af_unix()) {
+        fd.setsockopt(IPPROTO_TCP, TCP_CONGESTION, opts.congestion_control->c_str());
+    }
+
     if (_reuseport && !sa.is_af_unix())
         fd.setsockopt(SOL_SOCKET, SO_REUSEPORT, 1);
 
@@ -2550,6 +2638,16 @@ void reactor::register_metrics() {
             sm::make_total_bytes("aio_bytes_write", _io_stats.aio_write_bytes, sm::description("Total aio-writes bytes")),
             sm::make_counter("aio_outsizes", _io_stats.aio_outsizes, sm::description("Total number of aio operations that exceed IO limit")),
             sm::make_counter("aio_errors", _io_stats.aio_errors, sm::description("Total aio errors")),
+            sm::make_counter("uring_buffer_ring_recvs", _io_stats.uring_buffer_ring_recvs,
+                    sm::description("Total socket receives handed out in a buffer of the io_uring provided buffer ring")),
+            sm::make_counter("uring_buffer_ring_copies", _io_stats.uring_buffer_ring_copies,
+                    sm::description("Total socket receives copied out of the io_uring provided buffer ring or read into a private buffer because the socket held its share of the ring")),
+            sm::make_counter("uring_buffer_ring_exhausted", _io_stats.uring_buffer_ring_exhausted,
+                    sm::description("Total socket receives which found the io_uring provided buffer ring empty and fell back to a private buffer")),
+            sm::make_counter("uring_fixed_file_requests", _io_stats.uring_fixed_file_requests,
+                    sm::description("Total disk requests submitted through the io_uring fixed-file table")),
+            sm::make_counter("uring_fixed_buffer_requests", _io_stats.uring_fixed_buffer_requests,
+                    sm::description("Total disk reads and writes submitted on the io_uring registered buffer arena")),
             sm::make_histogram("stalls", sm::description("A histogram of reactor stall durations"), [this] {return _stalls_histogram.to_metrics_histogram();}).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
             // total_operations value:DERIVE:0:U
             sm::make_counter("fsyncs", _fsyncs, sm::description("Total number of fsync operations")),
@@ -2569,9 +2667,27 @@ void reactor::register_metrics() {
             sm::make_current_bytes("total_memory", [] { return memory::stats().total_memory(); }, sm::description("Total memory size in bytes")),
             sm::make_current_bytes("allocated_memory", [] { return memory::stats().allocated_memory(); }, sm::description("Allocated memory size in bytes")),
             sm::make_counter("reclaims_operations", [] { return memory::stats().reclaims(); }, sm::description("Total reclaims operations")),
-            sm::make_counter("malloc_failed", [] { return memory::stats().failed_allocations(); }, sm::description("Total count of failed memory allocations"))
+            sm::make_counter("malloc_failed", [] { return memory::stats().failed_allocations(); }, sm::description("Total count of failed memory allocations")),
+            sm::make_counter("cross_cpu_free_batches", [] { return memory::stats().cross_cpu_free_batches(); },
+                    sm::description("Total number of batches in which cross cpu frees were handed over to their owning shards")),
+            sm::make_current_bytes("hugepage_memory", [] { return memory::stats().hugepage_memory(); },
+                    sm::description("Memory size in bytes backed by hugetlbfs or explicitly reserved huge pages")),
+            sm::make_counter("span_refills", [] { return memory::stats().span_refills(); },
+                    sm::description("Total number of spans taken from the page allocator by small object pools")),
+            sm::make_counter("span_refills_same_hugepage", [] { return memory::stats().span_refills_same_hugepage(); },
+                    sm::description("Total number of small object pool spans placed on the same huge page as the pool's previous span")),
     });
 
+    std::vector<sm::metric_definition> cross_cpu_frees_to;
+    for (unsigned cpu = 0; cpu < smp::count; ++cpu) {
+        if (cpu != this_shard_id()) {
+            cross_cpu_frees_to.emplace_back(sm::make_counter("cross_cpu_free_operations_to_shard", [cpu] { return memory::cross_cpu_frees_to(cpu); },
+                    sm::description("Total number of objects owned by another shard and freed on this one"),
+                    {sm::label("to_shard")(cpu)}).set_skip_when_empty());
+        }
+    }
+    _metric_groups.add_group("memory", cross_cpu_frees_to);
+
     _metric_groups.add_group("reactor", {
             sm::make_counter("logging_failures", [] { return logging_failures; }, sm::description("Total number of logging failures")),
             // total_operations value:DERIVE:0:U
@@ -2632,8 +2748,10 @@ void reactor::run_tasks(task_queue& tq) {
         STAP_PROBE(seastar, reactor_run_tasks_single_start);
         internal::task_histogram_add_task(*tsk);
         _current_task = tsk;
+        _current_task_type = &typeid(*tsk);
         tsk->run_and_dispose();
         _current_task = nullptr;
+        _current_task_type = nullptr;
         STAP_PROBE(seastar, reactor_run_tasks_single_end);
         ++tq._tasks_processed;
         ++_global_tasks_processed;
@@ -2915,20 +3033,27 @@ class reactor::smp_pollfn final : public reactor::pollfn {
 };
 
 class reactor::execution_stage_pollfn final : public reactor::pollfn {
+    reactor& _r;
     internal::execution_stage_manager& _esm;
 public:
-    execution_stage_pollfn() : _esm(internal::execution_stage_manager::get()) { }
+    execution_stage_pollfn(reactor& r) : _r(r), _esm(internal::execution_stage_manager::get()) { }
 
     virtual bool poll() override {
-        return _esm.flush();
+        if (_esm.flush()) {
+            return true;
+        }
+        // Only help other shards with their stealable stages when there
+        // is nothing else to run here
+        return !_r.have_more_tasks() && _esm.steal();
     }
     virtual bool pure_poll() override {
-        return _esm.poll();
+        return _esm.poll() || _esm.can_steal();
     }
     virtual bool try_enter_interrupt_mode() override {
         // This is a passive poller, so if a previous poll
-        // returned false (idle), there's no more work to do.
-        return true;
+        // returned false (idle), there's no more work to do,
+        // unless another shard published a batch since.
+        return !_esm.can_steal();
     }
     virtual void exit_interrupt_mode() override { }
 };
@@ -3191,7 +3316,7 @@ int reactor::do_run() {
     poller final_real_kernel_completions_poller(std::make_unique<reap_kernel_completions_pollfn>(*this));
 
     poller batch_flush_poller(std::make_unique<batch_flush_pollfn>(*this));
-    poller execution_stage_poller(std::make_unique<execution_stage_pollfn>());
+    poller execution_stage_poller(std::make_unique<execution_stage_pollfn>(*this));
 
     start_aio_eventfd_loop();
 
@@ -3514,12 +3639,75 @@ unsigned syscall_work_queue::complete() {
 }
 
 
+namespace internal {
+
+// Bitmap of peers which pushed requests or completions towards a shard since
+// it last looked, so that the shard can skip the queues of idle peers.
+// Senders set bits after pushing to a queue, the owning shard clears them
+// before draining it; a message is therefore never left behind an unset bit.
+//
+// Every word sits on a cache line of its own, so that the bitmaps of
+// different shards never share a line: a sender only contends with the other
+// senders of the same group of 64 peers, and only while they ring the same
+// shard. A sender rings once per batch it pushes, the same rate at which it
+// already writes the ring's head index, so compared with polling the
+// doorbell adds one atomic on a line the receiver owns per batch, and takes
+// away the receiver's read of every idle peer's ring.
+class smp_doorbell {
+    static constexpr unsigned bits_per_word = std::numeric_limits<uint64_t>::digits;
+    struct alignas(cache_line_size) word {
+        std::atomic<uint64_t> bits{0};
+    };
+    std::unique_ptr<word[]> _words;
+    unsigned _nr_words = 0;
+public:
+    void init(unsigned nr_shards) {
+        _nr_words = (nr_shards + bits_per_word - 1) / bits_per_word;
+        // over-aligned new[], each word gets its own cache line
+        _words = std::make_unique<word[]>(_nr_words);
+    }
+    void ring(shard_id bit) noexcept {
+        _words[bit / bits_per_word].bits.fetch_or(uint64_t(1) << (bit % bits_per_word), std::memory_order_release);
+    }
+    bool rung() const noexcept {
+        for (unsigned w = 0; w < _nr_words; ++w) {
+            if (_words[w].bits.load(std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    // Clears all set bits and calls func for each of them
+    template <typename Func>
+    void answer(Func&& func) {
+        for (unsigned w = 0; w < _nr_words; ++w) {
+            if (!_words[w].bits.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            auto bits = _words[w].bits.exchange(0, std::memory_order_acquire);
+            while (bits) {
+                func(shard_id(w * bits_per_word + count_trailing_zeros(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+};
+
+}
+
 smp_message_queue::smp_message_queue(reactor* from, reactor* to)
     : _pending(to)
     , _completed(from)
 {
 }
 
+void smp_message_queue::use_doorbells(internal::smp_doorbell* doorbells, shard_id from, shard_id to) noexcept {
+    _pending.doorbell = &doorbells[to];
+    _pending.doorbell_bit = from;
+    _completed.doorbell = &doorbells[from];
+    _completed.doorbell_bit = to;
+}
+
 smp_message_queue::~smp_message_queue()
 {
     if (_pending.remote != _completed.remote) {
@@ -3541,6 +3729,10 @@ void smp_message_queue::move_pending() {
     auto nr = end - begin;
     _pending.maybe_wakeup();
     _tx.a.pending_fifo.erase(begin, end);
+    if (!_tx.a.pending_fifo.empty()) {
+        // queue is full, come back to it on the next poll
+        _completed.ring();
+    }
     _current_queue_length += nr;
     _last_snt_batch = nr;
     _sent += nr;
@@ -3570,6 +3762,9 @@ void smp_message_queue::submit_item(shard_id t, smp_timeout_clock::time_point ti
     units_fut.get().release();
     if (_tx.a.pending_fifo.size() >= batch_size) {
         move_pending();
+    } else if (_tx.a.pending_fifo.size() == 1) {
+        // make our own poll flush the batch
+        _completed.ring();
     }
   });
 }
@@ -3578,6 +3773,9 @@ void smp_message_queue::respond(work_item* item) {
     _completed_fifo.push_back(item);
     if (_completed_fifo.size() >= batch_size || engine().stopped()) {
         flush_response_batch();
+    } else if (_completed_fifo.size() == 1) {
+        // make our own poll flush the batch
+        _pending.ring();
     }
 }
 
@@ -3591,6 +3789,10 @@ void smp_message_queue::flush_response_batch() {
         }
         _completed.maybe_wakeup();
         _completed_fifo.erase(begin, end);
+        if (!_completed_fifo.empty()) {
+            // queue is full, come back to it on the next poll
+            _pending.ring();
+        }
     }
 }
 
@@ -3604,10 +3806,17 @@ bool smp_message_queue::pure_poll_rx() const {
     return !const_cast<lf_queue&>(_pending).empty();
 }
 
+void
+smp_message_queue::lf_queue::ring() noexcept {
+    if (doorbell) {
+        doorbell->ring(doorbell_bit);
+    }
+}
+
 void
 smp_message_queue::lf_queue::maybe_wakeup() {
     // Called after lf_queue_base::push().
-    //
+    ring();
     // This is read-after-write, which wants memory_order_seq_cst,
     // but we insert that barrier using systemwide_memory_barrier()
     // because seq_cst is so expensive.
@@ -3828,10 +4037,13 @@ reactor_options::reactor_options(program_options::option_group* parent_group)
     , io_latency_goal_ms(*this, "io-latency-goal-ms", {}, "Max time (ms) io operations must take (1.5 * task-quota-ms if not set)")
     , io_flow_ratio_threshold(*this, "io-flow-rate-threshold", 1.1, "Dispatch rate to completion rate threshold")
     , io_completion_notify_ms(*this, "io-completion-notify-ms", {}, "Threshold in milliseconds over which IO request completion is reported to logs")
+    , io_deadline_dispatch(*this, "io-deadline-dispatch", false, "Dispatch IO requests of each class earliest deadline first (see io_intent::set_deadline())")
+    , io_adaptive_capacity(*this, "io-adaptive-capacity", false, "Adjust the disk capacity from the IO properties to the observed IO execution time")
     , max_task_backlog(*this, "max-task-backlog", 1000, "Maximum number of task backlog to allow; above this we ignore I/O")
     , blocked_reactor_notify_ms(*this, "blocked-reactor-notify-ms", 25, "threshold in miliseconds over which the reactor is considered blocked if no progress is made")
     , blocked_reactor_reports_per_minute(*this, "blocked-reactor-reports-per-minute", 5, "Maximum number of backtraces reported by stall detector per minute")
     , blocked_reactor_report_format_oneline(*this, "blocked-reactor-report-format-oneline", true, "Print a simplified backtrace on a single line")
+    , cpu_profiler_rate(*this, "cpu-profiler-rate", 0, "Sample the CPU usage of every shard this many times per second of CPU time, 0 to disable (see add_cpu_profiler_routes())")
     , relaxed_dma(*this, "relaxed-dma", "allow using buffered I/O if DMA is not available (reduces performance)")
     , linux_aio_nowait(*this, "linux-aio-nowait", aio_nowait_supported,
                 "use the Linux NOWAIT AIO feature, which reduces reactor stalls due to aio (autodetected)")
@@ -3859,6 +4071,21 @@ reactor_options::reactor_options(program_options::option_group* parent_group)
     , reserve_io_control_blocks(*this, "reserve-io-control-blocks", 0,
                 "Reserve this many IOCBs, so it is available to any side application that runs parallel to the seastar appliation."
                 " Takes precedence over --max-networking-io-control-blocks. Only valid for the linux-aio reactor backend (see --reactor-backend).")
+    , uring_buffer_ring_entries(*this, "uring-buffer-ring-entries", 0,
+                "Number of buffers in the per-shard io_uring provided buffer ring used for multishot socket receives (0 disables)."
+                " Rounded up to a power of two. Only valid for the io_uring reactor backend (see --reactor-backend); requires Linux 6.0 or later.")
+    , uring_buffer_ring_buffer_size(*this, "uring-buffer-ring-buffer-size", 16384,
+                "Size of each buffer in the io_uring provided buffer ring (see --uring-buffer-ring-entries)")
+    , uring_buffer_ring_socket_share(*this, "uring-buffer-ring-socket-share", 0,
+                "Number of buffers of the io_uring provided buffer ring a single socket may hold; beyond that it reads into private buffers"
+                " and leaves the rest of its data in the socket buffer (see --uring-buffer-ring-entries). 0 means a quarter of the ring.")
+    , uring_fixed_files(*this, "uring-fixed-files", 0,
+                "Number of slots in the per-shard io_uring fixed-file table used by files opened with file_open_options::fixed_file (0 disables)."
+                " Only valid for the io_uring reactor backend (see --reactor-backend); requires Linux 5.19 or later.")
+    , uring_fixed_buffers_size(*this, "uring-fixed-buffers-size", {},
+                "Size of the per-shard io_uring registered buffer arena backing allocate_dma_buffer() (ex: 64M)."
+                " Only valid for the io_uring reactor backend (see --reactor-backend).")
+    , timer_wheel(*this, "timer-wheel", "keep steady_clock and lowres_clock timers in a hierarchical timing wheel (scales better with millions of timers)")
 #ifdef SEASTAR_HEAPPROF
     , heapprof(*this, "heapprof", 0, "Enable seastar heap profiling. Sample every ARG bytes. 0 means off")
 #else
@@ -3875,6 +4102,7 @@ smp_options::smp_options(program_options::option_group* parent_group)
     , memory(*this, "memory", std::nullopt, "memory to use, in bytes (ex: 4G) (default: all)")
     , reserve_memory(*this, "reserve-memory", {}, "memory reserved to OS (if --memory not specified)")
     , hugepages(*this, "hugepages", {}, "path to accessible hugetlbfs mount (typically /dev/hugepages/something)")
+    , explicit_hugepages(*this, "explicit-hugepages", {}, "back shard memory with reserved anonymous huge pages of this size (2M or 1G) instead of transparent huge pages")
     , lock_memory(*this, "lock-memory", {}, "lock all memory (prevents swapping)")
     , thread_affinity(*this, "thread-affinity", true, "pin threads to their cpus (disable for overprovisioning)")
 #ifdef SEASTAR_HAVE_HWLOC
@@ -3895,6 +4123,7 @@ smp_options::smp_options(program_options::option_group* parent_group)
 #else
     , allow_cpus_in_remote_numa_nodes(*this, "allow-cpus-in-remote-numa-nodes", program_options::unused{})
 #endif
+    , smp_transport(*this, "smp-transport", "polling", "how shards find out about cross-shard messages: polling (poll all queues) or doorbell (poll only queues flagged by their senders)")
 {
 }
 
@@ -3908,6 +4137,7 @@ struct reactor_deleter {
 thread_local std::unique_ptr<reactor, reactor_deleter> reactor_holder;
 
 thread_local smp_message_queue** smp::_qs;
+thread_local internal::smp_doorbell* smp::_doorbell;
 thread_local std::thread::id smp::_tmain;
 unsigned smp::count = 0;
 
@@ -4107,6 +4337,10 @@ void smp::qs_deleter::operator()(smp_message_queue** qs) const {
     delete[](qs);
 }
 
+void smp::doorbells_deleter::operator()(internal::smp_doorbell* doorbells) const {
+    delete[] doorbells;
+}
+
 class disk_config_params {
 private:
     const unsigned _max_queues;
@@ -4115,6 +4349,8 @@ class disk_config_params {
     std::chrono::duration<double> _latency_goal;
     std::chrono::milliseconds _stall_threshold;
     double _flow_ratio_backpressure_threshold;
+    bool _deadline_dispatch = false;
+    bool _adaptive_capacity = false;
 
 public:
     explicit disk_config_params(unsigned max_queues) noexcept
@@ -4148,6 +4384,8 @@ class disk_config_params {
         _flow_ratio_backpressure_threshold = reactor_opts.io_flow_ratio_threshold.get_value();
         seastar_logger.debug("flow-ratio threshold: {}", _flow_ratio_backpressure_threshold);
         _stall_threshold = reactor_opts.io_completion_notify_ms.defaulted() ? std::chrono::milliseconds::max() : reactor_opts.io_completion_notify_ms.get_value() * 1ms;
+        _deadline_dispatch = reactor_opts.io_deadline_dispatch.get_value();
+        _adaptive_capacity = reactor_opts.io_adaptive_capacity.get_value();
 
         if (smp_opts.num_io_groups) {
             _num_io_groups = smp_opts.num_io_groups.get_value();
@@ -4253,6 +4491,10 @@ class disk_config_params {
         // be better to sacrifice some IO latency, but allow for larger concurrency
         cfg.block_count_limit_min = (64 << 10) >> io_queue::block_size_shift;
         cfg.stall_threshold = stall_threshold();
+        cfg.deadline_dispatch = _deadline_dispatch;
+        // There's nothing to adjust on a disk without IO properties
+        cfg.adaptive_capacity = _adaptive_capacity &&
+                (p.read_req_rate != std::numeric_limits<uint64_t>::max() || p.read_bytes_rate != std::numeric_limits<uint64_t>::max());
 
         return cfg;
     }
@@ -4439,6 +4681,25 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     if (smp_opts.hugepages) {
         hugepages_path = smp_opts.hugepages.get_value();
     }
+    bool use_doorbells = false;
+    if (smp_opts.smp_transport) {
+        auto transport = smp_opts.smp_transport.get_value();
+        if (transport == "doorbell") {
+            use_doorbells = true;
+        } else if (transport != "polling") {
+            seastar_logger.error("Bad value for --smp-transport: {}, must be polling or doorbell. Shutting down.", transport);
+            exit(1);
+        }
+    }
+    size_t explicit_hugepage_size = 0;
+    if (smp_opts.explicit_hugepages && !hugepages_path) {
+        explicit_hugepage_size = parse_memory_size(smp_opts.explicit_hugepages.get_value());
+        if (explicit_hugepage_size != memory::huge_page_size && explicit_hugepage_size != (size_t(1) << 30)) {
+            seastar_logger.error("Bad value for --explicit-hugepages: {}, must be {} or 1G. Shutting down.",
+                    smp_opts.explicit_hugepages.get_value(), memory::huge_page_size);
+            exit(1);
+        }
+    }
     auto mlock = false;
     if (smp_opts.lock_memory) {
         mlock = smp_opts.lock_memory.get_value();
@@ -4485,7 +4746,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     }
     std::optional<memory::internal::numa_layout> layout;
     if (smp_opts.memory_allocator == memory_allocator::seastar) {
-        layout = memory::configure(allocations[0].mem, mbind, use_transparent_hugepages, hugepages_path);
+        layout = memory::configure(allocations[0].mem, mbind, use_transparent_hugepages, hugepages_path, explicit_hugepage_size);
     } else {
         // #2148 - if running seastar allocator but options that contradict this, we still need to
         // init memory at least minimally, otherwise a bunch of stuff breaks.
@@ -4493,7 +4754,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
         memory::configure_minimal();
     }
 
-    _shard_to_numa_node_mapping.resize(smp::count);
+    _shard_to_numa_node_mapping.reserve(smp::count);
     for (unsigned i = 0; i < smp::count; i++) {
         _shard_to_numa_node_mapping.push_back(allocations[i].mem.size() > 0 ? allocations[i].mem[0].nodeid : 0);
     }
@@ -4534,6 +4795,12 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
         .strict_o_direct = !reactor_opts.relaxed_dma,
         .bypass_fsync = reactor_opts.unsafe_bypass_fsync.get_value(),
         .no_poll_aio = !reactor_opts.poll_aio.get_value() || (reactor_opts.poll_aio.defaulted() && reactor_opts.overprovisioned),
+        .uring_buffer_ring_entries = reactor_opts.uring_buffer_ring_entries.get_value(),
+        .uring_buffer_ring_buffer_size = reactor_opts.uring_buffer_ring_buffer_size.get_value(),
+        .uring_buffer_ring_socket_share = reactor_opts.uring_buffer_ring_socket_share.get_value(),
+        .uring_fixed_files = reactor_opts.uring_fixed_files.get_value(),
+        .uring_fixed_buffers_size = reactor_opts.uring_fixed_buffers_size ? parse_memory_size(reactor_opts.uring_fixed_buffers_size.get_value()) : 0,
+        .timer_wheel = bool(reactor_opts.timer_wheel),
     };
 
     // Disable hot polling if sched wakeup granularity is too high
@@ -4641,7 +4908,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     auto smp_tmain = smp::_tmain;
     for (i = 1; i < smp::count; i++) {
         auto allocation = allocations[i];
-        create_thread([this, smp_tmain, inited, &reactors_registered, &smp_queues_constructed, &smp_opts, &reactor_opts, &reactors, hugepages_path, i, allocation, assign_io_queues, alloc_io_queues, thread_affinity, heapprof_sampling_rate, mbind, backend_selector, reactor_cfg, &mtx, &layout, use_transparent_hugepages] {
+        create_thread([this, smp_tmain, inited, &reactors_registered, &smp_queues_constructed, &smp_opts, &reactor_opts, &reactors, hugepages_path, explicit_hugepage_size, i, allocation, assign_io_queues, alloc_io_queues, thread_affinity, heapprof_sampling_rate, mbind, backend_selector, reactor_cfg, &mtx, &layout, use_transparent_hugepages] {
           try {
             // initialize thread_locals that are equal across all reacto threads of this smp instance
             smp::_tmain = smp_tmain;
@@ -4651,7 +4918,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
                 smp::pin(allocation.cpu_id);
             }
             if (smp_opts.memory_allocator == memory_allocator::seastar) {
-                auto another_layout = memory::configure(allocation.mem, mbind, use_transparent_hugepages, hugepages_path);
+                auto another_layout = memory::configure(allocation.mem, mbind, use_transparent_hugepages, hugepages_path, explicit_hugepage_size);
                 auto guard = std::lock_guard(mtx);
                 *layout = memory::internal::merge(std::move(*layout), std::move(another_layout));
             } else {
@@ -4677,6 +4944,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
             smp_queues_constructed.wait();
             // _qs_owner is only initialized here
             _qs = _qs_owner.get();
+            _doorbell = _doorbells_owner ? &_doorbells_owner[i] : nullptr;
             start_all_queues();
             assign_io_queues(i);
             inited->wait();
@@ -4711,6 +4979,12 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
 #endif
 
     reactors_registered.wait();
+    if (use_doorbells) {
+        _doorbells_owner = decltype(smp::_doorbells_owner){new internal::smp_doorbell[smp::count], doorbells_deleter{}};
+        for (unsigned i = 0; i < smp::count; i++) {
+            _doorbells_owner[i].init(smp::count);
+        }
+    }
     _qs_owner = decltype(smp::_qs_owner){new smp_message_queue* [smp::count], qs_deleter{}};
     _qs = _qs_owner.get();
     for(unsigned i = 0; i < smp::count; i++) {
@@ -4724,8 +4998,12 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
         ));
         for (unsigned j = 0; j < smp::count; ++j) {
             new (&smp::_qs_owner[i][j]) smp_message_queue(reactors[j], reactors[i]);
+            if (use_doorbells && i != j) {
+                smp::_qs_owner[i][j].use_doorbells(_doorbells_owner.get(), j, i);
+            }
         }
     }
+    _doorbell = _doorbells_owner ? &_doorbells_owner[0] : nullptr;
     _alien._qs = alien::instance::create_qs(reactors);
     smp_queues_constructed.wait();
     start_all_queues();
@@ -4741,6 +5019,18 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
 
 bool smp::poll_queues() {
     size_t got = 0;
+    if (_doorbell) {
+        _doorbell->answer([&got] (shard_id i) {
+            auto& rxq = _qs[this_shard_id()][i];
+            rxq.flush_response_batch();
+            got += rxq.has_unflushed_responses();
+            got += rxq.process_incoming();
+            auto& txq = _qs[i][this_shard_id()];
+            txq.flush_request_batch();
+            got += txq.process_completions(i);
+        });
+        return got != 0;
+    }
     for (unsigned i = 0; i < count; i++) {
         if (this_shard_id() != i) {
             auto& rxq = _qs[this_shard_id()][i];
@@ -4756,6 +5046,10 @@ bool smp::poll_queues() {
 }
 
 bool smp::pure_poll_queues() {
+    if (_doorbell) {
+        // Unflushed batches ring our own doorbell too
+        return _doorbell->rung();
+    }
     for (unsigned i = 0; i < count; i++) {
         if (this_shard_id() != i) {
             auto& rxq = _qs[this_shard_id()][i];
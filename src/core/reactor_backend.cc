@@ -23,6 +23,7 @@ module;
 #endif
 
 #include <atomic>
+#include <bit>
 #include <chrono>
 #include <filesystem>
 #include <thread>
@@ -34,11 +35,24 @@ module;
 #include <sys/syscall.h>
 #include <sys/resource.h>
 #include <boost/container/small_vector.hpp>
+#include <boost/intrusive/list.hpp>
 #include <fmt/core.h>
 #include <seastar/util/assert.hh>
 
 #ifdef SEASTAR_HAVE_URING
 #include <liburing.h>
+// Provided buffer rings and multishot receive need liburing 2.4
+#if defined(IO_URING_VERSION_MAJOR) && (IO_URING_VERSION_MAJOR > 2 || IO_URING_VERSION_MINOR >= 4)
+#define SEASTAR_HAVE_URING_BUF_RING
+#endif
+// Sparse fixed-file tables need liburing 2.2
+#if defined(IO_URING_VERSION_MAJOR) && (IO_URING_VERSION_MAJOR > 2 || IO_URING_VERSION_MINOR >= 2)
+#define SEASTAR_HAVE_URING_FIXED_FILES
+#endif
+// Zero-copy sendmsg needs liburing 2.3
+#if defined(IO_URING_VERSION_MAJOR) && (IO_URING_VERSION_MAJOR > 2 || IO_URING_VERSION_MINOR >= 3)
+#define SEASTAR_HAVE_URING_SEND_ZC
+#endif
 #endif
 
 #ifdef SEASTAR_MODULE
@@ -47,6 +61,7 @@ module seastar;
 #include "core/reactor_backend.hh"
 #include "core/thread_pool.hh"
 #include "core/syscall_result.hh"
+#include <seastar/core/align.hh>
 #include <seastar/core/internal/buffer_allocator.hh>
 #include <seastar/util/internal/iovec_utils.hh>
 #include <seastar/core/internal/uname.hh>
@@ -1199,6 +1214,181 @@ detect_io_uring() {
     return bool(ring_opt);
 }
 
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+
+// A ring of equally-sized receive buffers registered with io_uring as a
+// provided buffer group. The kernel picks a buffer when data arrives, so
+// idle sockets don't pin any memory. Buffers are handed out as
+// temporary_buffers and go back to the ring when those are destroyed.
+//
+// The buffer memory outlives the registration: buffers still held by the
+// application when the ring is unregistered are simply not recycled. As with
+// any buffer carrying a non-trivial deleter, they must be released on the
+// shard that received them.
+//
+// All the sockets of a shard share the ring, so each of them may only hold
+// a share of it (see --uring-buffer-ring-socket-share); the buffers a socket
+// holds are counted in a counter shared with their deleters.
+class uring_provided_buffer_ring {
+    ::io_uring_buf_ring* _br = nullptr;
+    std::unique_ptr<char[], free_deleter> _buffers;
+    unsigned _entries;
+    size_t _buffer_size;
+    int _mask;
+public:
+    static constexpr int group_id = 0;
+
+    uring_provided_buffer_ring(::io_uring& ring, unsigned entries, size_t buffer_size)
+            : _entries(entries)
+            , _buffer_size(buffer_size)
+            , _mask(::io_uring_buf_ring_mask(entries)) {
+        auto p = ::aligned_alloc(4096, size_t(entries) * buffer_size);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        _buffers.reset(static_cast<char*>(p));
+        int err = 0;
+        _br = ::io_uring_setup_buf_ring(&ring, entries, group_id, 0, &err);
+        if (!_br) {
+            throw std::system_error(std::error_code(-err, std::system_category()), "io_uring_setup_buf_ring");
+        }
+        for (unsigned bid = 0; bid < entries; ++bid) {
+            ::io_uring_buf_ring_add(_br, buffer(bid), _buffer_size, bid, _mask, bid);
+        }
+        ::io_uring_buf_ring_advance(_br, entries);
+    }
+
+    void unregister(::io_uring& ring) noexcept {
+        if (_br) {
+            ::io_uring_free_buf_ring(&ring, _br, _entries, group_id);
+            _br = nullptr;
+        }
+    }
+
+    size_t buffer_size() const noexcept {
+        return _buffer_size;
+    }
+
+    char* buffer(unsigned bid) noexcept {
+        return _buffers.get() + size_t(bid) * _buffer_size;
+    }
+
+    void recycle(unsigned bid) noexcept {
+        if (_br) {
+            ::io_uring_buf_ring_add(_br, buffer(bid), _buffer_size, bid, _mask, 0);
+            ::io_uring_buf_ring_advance(_br, 1);
+        }
+    }
+
+    static temporary_buffer<char> make_buffer(lw_shared_ptr<uring_provided_buffer_ring> ring, unsigned bid, size_t size, lw_shared_ptr<unsigned> held) {
+        auto p = ring->buffer(bid);
+        auto d = defer([&] () noexcept { ring->recycle(bid); });
+        auto del = make_deleter([ring, bid, held] () noexcept {
+            --*held;
+            ring->recycle(bid);
+        });
+        d.cancel();
+        ++*held;
+        return temporary_buffer<char>(p, size, std::move(del));
+    }
+};
+
+#endif
+
+// A chunk of memory registered with io_uring as fixed buffer 0, from which
+// DMA buffers are carved. Reads and writes landing entirely inside the arena
+// are submitted as READ_FIXED/WRITE_FIXED, so the kernel does not have to pin
+// and map the user pages on every request.
+//
+// Allocation is deliberately simple: sizes are rounded up to a power of two
+// (at least one page), carved from the arena with a bump pointer, and freed
+// chunks are kept on a per-size free list for reuse. The arena is meant for
+// a steady working set of I/O buffers, not for general purpose allocation.
+// Like the provided buffer ring, the memory outlives the registration.
+class uring_fixed_buffer_arena {
+    static constexpr unsigned min_chunk_shift = 12;
+    std::unique_ptr<char[], free_deleter> _base;
+    size_t _size;
+    size_t _carved = 0;
+    std::vector<std::vector<char*>> _free;
+    bool _registered = false;
+
+    static unsigned size_class(size_t size) noexcept {
+        return std::bit_width(std::max(size, size_t(1) << min_chunk_shift) - 1) - min_chunk_shift;
+    }
+public:
+    static constexpr int buf_index = 0;
+
+    uring_fixed_buffer_arena(::io_uring& ring, size_t size)
+            : _size(align_up(size, size_t(1) << min_chunk_shift))
+            , _free(size_class(_size) + 1) {
+        auto p = ::aligned_alloc(size_t(1) << min_chunk_shift, _size);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        _base.reset(static_cast<char*>(p));
+        ::iovec iov{_base.get(), _size};
+        auto r = ::io_uring_register_buffers(&ring, &iov, 1);
+        if (r < 0) {
+            throw std::system_error(std::error_code(-r, std::system_category()), "io_uring_register_buffers");
+        }
+        _registered = true;
+    }
+
+    void unregister(::io_uring& ring) noexcept {
+        if (std::exchange(_registered, false)) {
+            ::io_uring_unregister_buffers(&ring);
+        }
+    }
+
+    bool contains(const void* p, size_t len) const noexcept {
+        auto c = static_cast<const char*>(p);
+        return _registered && c >= _base.get() && c + len <= _base.get() + _size;
+    }
+
+    // Returns nullptr if the arena is exhausted
+    char* allocate(size_t size, size_t alignment) noexcept {
+        if (alignment > (size_t(1) << min_chunk_shift) || size > _size) {
+            return nullptr;
+        }
+        auto cls = size_class(size);
+        auto& fl = _free[cls];
+        if (!fl.empty()) {
+            auto p = fl.back();
+            fl.pop_back();
+            return p;
+        }
+        auto chunk = size_t(1) << (cls + min_chunk_shift);
+        if (_size - _carved < chunk) {
+            return nullptr;
+        }
+        auto p = _base.get() + _carved;
+        _carved += chunk;
+        return p;
+    }
+
+    void release(char* p, size_t size) noexcept {
+        try {
+            _free[size_class(size)].push_back(p);
+        } catch (...) {
+            // The chunk leaks until the arena is destroyed
+        }
+    }
+
+    static temporary_buffer<char> make_buffer(lw_shared_ptr<uring_fixed_buffer_arena> arena, size_t size, size_t alignment) {
+        auto p = arena->allocate(size, alignment);
+        if (!p) {
+            return {};
+        }
+        auto d = defer([&] () noexcept { arena->release(p, size); });
+        auto del = make_deleter([arena, p, size] () noexcept {
+            arena->release(p, size);
+        });
+        d.cancel();
+        return temporary_buffer<char>(p, size, std::move(del));
+    }
+};
+
 class reactor_backend_uring final : public reactor_backend {
     // s_queue_len is more or less arbitrary. Too low and we'll be
     // issuing too small batches, too high and we require too much locked
@@ -1211,11 +1401,225 @@ class reactor_backend_uring final : public reactor_backend {
     file_desc _hrtimer_timerfd;
     preempt_io_context _preempt_io_context;
 
+    // Completions tagged with this bit in their user_data need the cqe flags
+    // and not only the result: multishot receives and zero-copy sends, which
+    // both get more than one completion per submission.
+    static constexpr uintptr_t flags_tag = 1;
+
+    class flagged_completion {
+    public:
+        virtual ~flagged_completion() = default;
+        virtual void complete_with(ssize_t res, unsigned flags) = 0;
+    };
+
+    void set_flagged_completion(::io_uring_sqe* sqe, flagged_completion* c) noexcept {
+        sqe->user_data = reinterpret_cast<uintptr_t>(c) | flags_tag;
+    }
+
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+
+    // State of a multishot receive armed on a stream socket. A single SQE
+    // keeps producing completions, each carrying a buffer picked from the
+    // provided buffer ring, until the kernel terminates it (no more buffers,
+    // EOF, error or cancellation). Data arriving while nobody is waiting is
+    // queued until the next recv_some().
+    //
+    // Once the socket holds its share of the ring, the receive is cancelled
+    // and not re-armed until the application releases some buffers; until
+    // then recv_some() reads into private buffers, one at a time. This keeps
+    // what is queued here bounded and leaves the rest in the socket buffer,
+    // where TCP flow control sees it.
+    //
+    // It is owned by its uring_pollable_fd_state, unless the fd is forgotten
+    // while the receive is still armed. In that case it is orphaned, the
+    // receive is cancelled and it deletes itself on the final completion, or
+    // is deleted with the backend if that comes first.
+    class multishot_recv final : public flagged_completion {
+        reactor_backend_uring& _be;
+        pollable_fd_state& _fd;
+        internal::buffer_allocator* _ba = nullptr;
+        // Ring buffers of this socket not yet released by the application
+        lw_shared_ptr<unsigned> _held = make_lw_shared<unsigned>(0);
+        circular_buffer<temporary_buffer<char>> _ready;
+        std::optional<promise<temporary_buffer<char>>> _waiter;
+        std::exception_ptr _ex;
+        bool _eof = false;
+        bool _armed = false;
+        bool _cancelling = false;
+        bool _orphaned = false;
+    public:
+        boost::intrusive::list_member_hook<> _orphan_link;
+    private:
+        void deliver(temporary_buffer<char> buf) {
+            if (_waiter) {
+                _waiter->set_value(std::move(buf));
+                _waiter.reset();
+            } else {
+                _ready.push_back(std::move(buf));
+            }
+        }
+        bool holds_share() const noexcept {
+            return *_held >= _be._buffer_ring_socket_share;
+        }
+        void cancel() noexcept {
+            _cancelling = true;
+            auto sqe = _be.get_sqe();
+            ::io_uring_prep_cancel64(sqe, reinterpret_cast<uintptr_t>(static_cast<flagged_completion*>(this)) | flags_tag, 0);
+            ::io_uring_sqe_set_data(sqe, static_cast<kernel_completion*>(&_be._ignore_completion));
+            _be._has_pending_submissions = true;
+        }
+    public:
+        multishot_recv(reactor_backend_uring& be, pollable_fd_state& fd) : _be(be), _fd(fd) {}
+
+        future<temporary_buffer<char>> get(internal::buffer_allocator* ba) {
+            _ba = ba;
+            if (!_ready.empty()) {
+                auto buf = std::move(_ready.front());
+                _ready.pop_front();
+                return make_ready_future<temporary_buffer<char>>(std::move(buf));
+            }
+            if (_ex) {
+                return make_exception_future<temporary_buffer<char>>(_ex);
+            }
+            if (_eof) {
+                return make_ready_future<temporary_buffer<char>>();
+            }
+            if (!_armed && holds_share()) {
+                ++_be._r._io_stats.uring_buffer_ring_copies;
+                return _be.recv_some_oneshot(_fd, ba);
+            }
+            if (!_armed) {
+                auto sqe = _be.get_sqe();
+                ::io_uring_prep_recv_multishot(sqe, _fd.fd.get(), nullptr, 0, 0);
+                ::io_uring_sqe_set_flags(sqe, IOSQE_BUFFER_SELECT);
+                sqe->buf_group = uring_provided_buffer_ring::group_id;
+                _be.set_flagged_completion(sqe, this);
+                _be._has_pending_submissions = true;
+                _armed = true;
+            }
+            _waiter.emplace();
+            return _waiter->get_future();
+        }
+
+        virtual void complete_with(ssize_t res, unsigned flags) override {
+            if (!(flags & IORING_CQE_F_MORE)) {
+                _armed = false;
+                _cancelling = false;
+            }
+            if (_orphaned) {
+                if (flags & IORING_CQE_F_BUFFER) {
+                    _be._buffer_ring->recycle(flags >> IORING_CQE_BUFFER_SHIFT);
+                }
+                if (!_armed) {
+                    _be._orphaned_recvs.erase(_be._orphaned_recvs.iterator_to(*this));
+                    delete this;
+                }
+                return;
+            }
+            if (res > 0) {
+                SEASTAR_ASSERT(flags & IORING_CQE_F_BUFFER);
+                unsigned bid = flags >> IORING_CQE_BUFFER_SHIFT;
+                if (holds_share()) {
+                    // Received before the cancellation took effect, give the
+                    // buffer back so that the other sockets can use it
+                    auto p = _be._buffer_ring->buffer(bid);
+                    auto d = defer([&] () noexcept { _be._buffer_ring->recycle(bid); });
+                    temporary_buffer<char> copy(p, res);
+                    d.cancel();
+                    _be._buffer_ring->recycle(bid);
+                    ++_be._r._io_stats.uring_buffer_ring_copies;
+                    deliver(std::move(copy));
+                } else {
+                    ++_be._r._io_stats.uring_buffer_ring_recvs;
+                    deliver(uring_provided_buffer_ring::make_buffer(_be._buffer_ring, bid, res, _held));
+                }
+                if (_armed && !_cancelling && holds_share()) {
+                    cancel();
+                }
+            } else if (res == 0) {
+                _eof = true;
+                deliver(temporary_buffer<char>());
+            } else if (res == -ENOBUFS) {
+                // The ring ran dry because the application holds on to its
+                // buffers. Serve the waiter from a private buffer, the next
+                // recv_some() will re-arm the multishot receive.
+                ++_be._r._io_stats.uring_buffer_ring_exhausted;
+                if (_waiter) {
+                    auto pr = std::move(*_waiter);
+                    _waiter.reset();
+                    _be.recv_some_oneshot(_fd, _ba).forward_to(std::move(pr));
+                }
+            } else if (res == -ECANCELED) {
+                // Cancelled because the socket holds its share of the ring
+                if (_waiter) {
+                    auto pr = std::move(*_waiter);
+                    _waiter.reset();
+                    get(_ba).forward_to(std::move(pr));
+                }
+            } else {
+                _ex = std::make_exception_ptr(std::system_error(-res, std::system_category(), "recv"));
+                if (_waiter) {
+                    _waiter->set_exception(_ex);
+                    _waiter.reset();
+                }
+            }
+        }
+
+        // Called when the owning fd is forgotten. Returns true if the object
+        // can be deleted right away.
+        bool orphan() noexcept {
+            _ready.clear();
+            if (_waiter) {
+                _waiter->set_exception(std::system_error(EBADF, std::system_category(), "recv"));
+                _waiter.reset();
+            }
+            if (!_armed) {
+                return true;
+            }
+            _orphaned = true;
+            _be._orphaned_recvs.push_back(*this);
+            if (!_cancelling) {
+                cancel();
+            }
+            return false;
+        }
+    };
+
+    // Completion for requests whose result is of no interest, like cancellations
+    class ignore_completion final : public kernel_completion {
+    public:
+        virtual void complete_with(ssize_t res) override {}
+    };
+
+    lw_shared_ptr<uring_provided_buffer_ring> _buffer_ring;
+    unsigned _buffer_ring_socket_share = 0;
+    ignore_completion _ignore_completion;
+    // Receives of forgotten fds waiting for their cancellation to complete
+    boost::intrusive::list<multishot_recv,
+        boost::intrusive::member_hook<multishot_recv, boost::intrusive::list_member_hook<>, &multishot_recv::_orphan_link>,
+        boost::intrusive::constant_time_size<false>> _orphaned_recvs;
+#endif
+
+    // Fixed-file table: slot registered for each file descriptor (-1 if
+    // none), and how many files registered it
+    struct fixed_file {
+        int slot = -1;
+        unsigned refs = 0;
+    };
+    std::vector<fixed_file> _fixed_files;
+    std::vector<unsigned> _free_fixed_file_slots;
+    lw_shared_ptr<uring_fixed_buffer_arena> _fixed_buffers;
+
     class uring_pollable_fd_state : public pollable_fd_state {
         pollable_fd_state_completion _completion_pollin;
         pollable_fd_state_completion _completion_pollout;
         pollable_fd_state_completion _completion_pollrdhup;
     public:
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+        multishot_recv* _multishot = nullptr;
+#endif
+        // Set once the socket rejected a zero-copy send, later sends copy
+        bool _no_zerocopy = false;
         explicit uring_pollable_fd_state(file_desc desc, speculation speculate)
                 : pollable_fd_state(std::move(desc), std::move(speculate)) {
         }
@@ -1233,6 +1637,68 @@ class reactor_backend_uring final : public reactor_backend {
         }
     };
 
+#ifdef SEASTAR_HAVE_URING_SEND_ZC
+    // A zero-copy sendmsg. The kernel posts the result first and, once it
+    // no longer references the user pages, a notification completion. The
+    // caller's packet may be trimmed or destroyed as soon as the result is
+    // delivered, so a shared copy of it pins the buffers until the
+    // notification arrives. The backend tracks it until then, and frees it
+    // if the ring is torn down first.
+    class zerocopy_send final : public flagged_completion {
+        boost::intrusive::list_member_hook<> _link;
+        reactor_backend_uring& _be;
+        uring_pollable_fd_state& _fd;
+        net::packet& _p;
+        net::packet _pinned;
+        ::msghdr _mh = {};
+        promise<size_t> _result;
+
+        void deliver(ssize_t res) {
+            if (res >= 0) {
+                if (size_t(res) == _pinned.len()) {
+                    _fd.speculate_epoll(EPOLLOUT);
+                }
+                _result.set_value(res);
+            } else if (res == -EOPNOTSUPP) {
+                // Not a socket type the kernel can transmit from user pages
+                _fd._no_zerocopy = true;
+                _be.sendmsg(_fd, _p).forward_to(std::move(_result));
+            } else {
+                _result.set_exception(std::make_exception_ptr(std::system_error(-res, std::system_category(), "sendmsg")));
+            }
+        }
+    public:
+        zerocopy_send(reactor_backend_uring& be, uring_pollable_fd_state& fd, net::packet& p)
+                : _be(be), _fd(fd), _p(p), _pinned(p.share()) {
+            _mh.msg_iov = reinterpret_cast<iovec*>(_pinned.fragment_array());
+            _mh.msg_iovlen = std::min<size_t>(_pinned.nr_frags(), IOV_MAX);
+        }
+        virtual void complete_with(ssize_t res, unsigned flags) override {
+            if (!(flags & IORING_CQE_F_NOTIF)) {
+                deliver(res);
+            }
+            if (!(flags & IORING_CQE_F_MORE)) {
+                _be._zerocopy_sends.erase(_be._zerocopy_sends.iterator_to(*this));
+                delete this;
+            }
+        }
+        ::msghdr* msghdr() noexcept {
+            return &_mh;
+        }
+        future<size_t> get_future() {
+            return _result.get_future();
+        }
+
+        friend class reactor_backend_uring;
+    };
+
+    bool _have_send_zc = false;
+    // Zero-copy sends waiting for their final completion
+    boost::intrusive::list<zerocopy_send,
+        boost::intrusive::member_hook<zerocopy_send, boost::intrusive::list_member_hook<>, &zerocopy_send::_link>,
+        boost::intrusive::constant_time_size<false>> _zerocopy_sends;
+#endif
+
     // eventfd and timerfd both need an 8-byte read after completion
     class recurring_eventfd_or_timerfd_completion : public fd_kernel_completion {
         bool _armed = false;
@@ -1317,33 +1783,59 @@ class reactor_backend_uring final : public reactor_backend {
         return ufd->get_completion_future(events);
     }
 
+    // Disk requests carry the plain file descriptor; switch to the fixed-file
+    // slot if the file was registered.
+    void maybe_use_fixed_file(::io_uring_sqe* sqe) noexcept {
+        auto fd = sqe->fd;
+        if (size_t(fd) < _fixed_files.size() && _fixed_files[fd].slot >= 0) {
+            sqe->fd = _fixed_files[fd].slot;
+            sqe->flags |= IOSQE_FIXED_FILE;
+            ++_r._io_stats.uring_fixed_file_requests;
+        }
+    }
+
     void submit_io_request(const internal::io_request& req, io_completion* completion) {
         auto sqe = get_sqe();
         using o = internal::io_request::operation;
         switch (req.opcode()) {
             case o::read: {
                 const auto& op = req.as<io_request::operation::read>();
-                ::io_uring_prep_read(sqe, op.fd, op.addr, op.size, op.pos);
+                if (_fixed_buffers && _fixed_buffers->contains(op.addr, op.size)) {
+                    ::io_uring_prep_read_fixed(sqe, op.fd, op.addr, op.size, op.pos, uring_fixed_buffer_arena::buf_index);
+                    ++_r._io_stats.uring_fixed_buffer_requests;
+                } else {
+                    ::io_uring_prep_read(sqe, op.fd, op.addr, op.size, op.pos);
+                }
+                maybe_use_fixed_file(sqe);
                 break;
             }
             case o::write: {
                 const auto& op = req.as<io_request::operation::write>();
-                ::io_uring_prep_write(sqe, op.fd, op.addr, op.size, op.pos);
+                if (_fixed_buffers && _fixed_buffers->contains(op.addr, op.size)) {
+                    ::io_uring_prep_write_fixed(sqe, op.fd, op.addr, op.size, op.pos, uring_fixed_buffer_arena::buf_index);
+                    ++_r._io_stats.uring_fixed_buffer_requests;
+                } else {
+                    ::io_uring_prep_write(sqe, op.fd, op.addr, op.size, op.pos);
+                }
+                maybe_use_fixed_file(sqe);
                 break;
             }
             case o::readv: {
                 const auto& op = req.as<io_request::operation::readv>();
                 ::io_uring_prep_readv(sqe, op.fd, op.iovec, op.iov_len, op.pos);
+                maybe_use_fixed_file(sqe);
                 break;
             }
             case o::writev: {
                 const auto& op = req.as<io_request::operation::writev>();
                 ::io_uring_prep_writev(sqe, op.fd, op.iovec, op.iov_len, op.pos);
+                maybe_use_fixed_file(sqe);
                 break;
             }
             case o::fdatasync: {
                 const auto& op = req.as<io_request::operation::fdatasync>();
                 ::io_uring_prep_fsync(sqe, op.fd, IORING_FSYNC_DATASYNC);
+                maybe_use_fixed_file(sqe);
                 break;
             }
             case o::recv: {
@@ -1404,6 +1896,11 @@ class reactor_backend_uring final : public reactor_backend {
     void do_process_ready_kernel_completions(::io_uring_cqe** buf, size_t nr) {
         for (auto p = buf; p != buf + nr; ++p) {
             auto cqe = *p;
+            if (cqe->user_data & flags_tag) {
+                auto c = reinterpret_cast<flagged_completion*>(cqe->user_data & ~flags_tag);
+                c->complete_with(cqe->res, cqe->flags);
+                continue;
+            }
             auto completion = reinterpret_cast<kernel_completion*>(cqe->user_data);
             completion->complete_with(cqe->res);
         }
@@ -1445,9 +1942,68 @@ class reactor_backend_uring final : public reactor_backend {
         // expired when it really hasn't, we don't want to block in read(tfd, ...).
         auto tfd = _r._task_quota_timer.get();
         ::fcntl(tfd, F_SETFL, ::fcntl(tfd, F_GETFL) | O_NONBLOCK);
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+        if (auto entries = _r._cfg.uring_buffer_ring_entries) {
+            // Multishot receive needs Linux 6.0
+            if (!kernel_uname().whitelisted({"6.0"})) {
+                seastar_logger.warn("io_uring provided buffer ring requires Linux 6.0 or later, disabled");
+            } else {
+                try {
+                    entries = std::bit_ceil(entries);
+                    _buffer_ring = make_lw_shared<uring_provided_buffer_ring>(_uring, entries, _r._cfg.uring_buffer_ring_buffer_size);
+                    _buffer_ring_socket_share = std::max(_r._cfg.uring_buffer_ring_socket_share ? _r._cfg.uring_buffer_ring_socket_share : entries / 4, 1u);
+                } catch (...) {
+                    seastar_logger.warn("failed to set up io_uring provided buffer ring, disabled: {}", std::current_exception());
+                }
+            }
+        }
+#endif
+#ifdef SEASTAR_HAVE_URING_SEND_ZC
+        _have_send_zc = kernel_uname().whitelisted({"6.1"});
+#endif
+        if (auto slots = _r._cfg.uring_fixed_files) {
+#ifdef SEASTAR_HAVE_URING_FIXED_FILES
+            if (!kernel_uname().whitelisted({"5.19"})) {
+                seastar_logger.warn("io_uring sparse fixed-file table requires Linux 5.19 or later, disabled");
+            } else if (auto r = ::io_uring_register_files_sparse(&_uring, slots); r < 0) {
+                seastar_logger.warn("failed to register io_uring fixed-file table, disabled: {}", std::system_error(-r, std::system_category()));
+            } else {
+                _free_fixed_file_slots.reserve(slots);
+                for (unsigned slot = slots; slot > 0; --slot) {
+                    _free_fixed_file_slots.push_back(slot - 1);
+                }
+            }
+#else
+            seastar_logger.warn("io_uring fixed-file table requires liburing 2.2 or later, disabled");
+#endif
+        }
+        if (auto size = _r._cfg.uring_fixed_buffers_size) {
+            try {
+                _fixed_buffers = make_lw_shared<uring_fixed_buffer_arena>(_uring, size);
+            } catch (...) {
+                seastar_logger.warn("failed to set up io_uring registered buffer arena, disabled: {}", std::current_exception());
+            }
+        }
     }
     ~reactor_backend_uring() {
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+        if (_buffer_ring) {
+            _buffer_ring->unregister(_uring);
+        }
+#endif
+        if (_fixed_buffers) {
+            _fixed_buffers->unregister(_uring);
+        }
         ::io_uring_queue_exit(&_uring);
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+        // Tearing down the ring cancelled the receives whose cancellation
+        // had not completed yet, they will not get their final completion
+        _orphaned_recvs.clear_and_dispose([] (multishot_recv* m) { delete m; });
+#endif
+#ifdef SEASTAR_HAVE_URING_SEND_ZC
+        // Likewise for zero-copy sends still waiting for their notification
+        _zerocopy_sends.clear_and_dispose([] (zerocopy_send* z) { delete z; });
+#endif
     }
     virtual bool reap_kernel_completions() override {
         return do_process_kernel_completions();
@@ -1503,6 +2059,11 @@ class reactor_backend_uring final : public reactor_backend {
     }
     virtual void forget(pollable_fd_state& fd) noexcept override {
         auto* pfd = static_cast<uring_pollable_fd_state*>(&fd);
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+        if (pfd->_multishot && pfd->_multishot->orphan()) {
+            delete pfd->_multishot;
+        }
+#endif
         delete pfd;
     }
     virtual future<std::tuple<pollable_fd, socket_address>> accept(pollable_fd_state& listenfd) override {
@@ -1761,6 +2322,28 @@ class reactor_backend_uring final : public reactor_backend {
         auto req = internal::io_request::make_sendmsg(fd.fd.get(), desc->msghdr(), MSG_NOSIGNAL);
         return submit_request(std::move(desc), std::move(req));
     }
+    virtual future<size_t> sendmsg_zerocopy(pollable_fd_state& fd, net::packet& p) override {
+#ifdef SEASTAR_HAVE_URING_SEND_ZC
+        auto& ufd = static_cast<uring_pollable_fd_state&>(fd);
+        if (_have_send_zc && !ufd._no_zerocopy) {
+            // No speculative attempt: a zero-copy send completes through the
+            // ring, so there is no syscall to save by trying it inline.
+            try {
+                auto desc = std::make_unique<zerocopy_send>(*this, ufd, p);
+                auto fut = desc->get_future();
+                auto sqe = get_sqe();
+                ::io_uring_prep_sendmsg_zc(sqe, fd.fd.get(), desc->msghdr(), MSG_NOSIGNAL);
+                _zerocopy_sends.push_back(*desc);
+                set_flagged_completion(sqe, desc.release());
+                _has_pending_submissions = true;
+                return fut;
+            } catch (...) {
+                return current_exception_as_future<size_t>();
+            }
+        }
+#endif
+        return sendmsg(fd, p);
+    }
     virtual future<size_t> send(pollable_fd_state& fd, const void* buffer, size_t len) override {
         if (fd.take_speculation(EPOLLOUT)) {
             try {
@@ -1803,6 +2386,20 @@ class reactor_backend_uring final : public reactor_backend {
     }
 
     virtual future<temporary_buffer<char>> recv_some(pollable_fd_state& fd, internal::buffer_allocator* ba) override {
+#ifdef SEASTAR_HAVE_URING_BUF_RING
+        if (_buffer_ring) {
+            auto* ufd = static_cast<uring_pollable_fd_state*>(&fd);
+            if (!ufd->_multishot) {
+                ufd->_multishot = new multishot_recv(*this, fd);
+                fd.received_ahead = true;
+            }
+            return ufd->_multishot->get(ba);
+        }
+#endif
+        return recv_some_oneshot(fd, ba);
+    }
+
+    future<temporary_buffer<char>> recv_some_oneshot(pollable_fd_state& fd, internal::buffer_allocator* ba) {
         if (fd.take_speculation(POLLIN)) {
             auto buffer = ba->allocate_buffer();
             try {
@@ -1856,6 +2453,64 @@ class reactor_backend_uring final : public reactor_backend {
         return true;
     }
 
+    virtual bool register_fixed_file(int fd) noexcept override {
+#ifdef SEASTAR_HAVE_URING_FIXED_FILES
+        if (fd < 0) {
+            return false;
+        }
+        if (size_t(fd) < _fixed_files.size() && _fixed_files[fd].slot >= 0) {
+            // Already registered, share the slot instead of taking another
+            // one and losing track of the first
+            ++_fixed_files[fd].refs;
+            return true;
+        }
+        if (_free_fixed_file_slots.empty()) {
+            return false;
+        }
+        try {
+            if (size_t(fd) >= _fixed_files.size()) {
+                _fixed_files.resize(fd + 1);
+            }
+        } catch (...) {
+            return false;
+        }
+        auto slot = _free_fixed_file_slots.back();
+        if (::io_uring_register_files_update(&_uring, slot, &fd, 1) != 1) {
+            return false;
+        }
+        _free_fixed_file_slots.pop_back();
+        _fixed_files[fd] = fixed_file{int(slot), 1};
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    virtual void unregister_fixed_file(int fd) noexcept override {
+#ifdef SEASTAR_HAVE_URING_FIXED_FILES
+        if (size_t(fd) >= _fixed_files.size() || _fixed_files[fd].slot < 0) {
+            return;
+        }
+        if (--_fixed_files[fd].refs) {
+            return;
+        }
+        unsigned slot = std::exchange(_fixed_files[fd].slot, -1);
+        // Requests already submitted hold their own reference to the file,
+        // so the slot can be cleared right away.
+        int none = -1;
+        ::io_uring_register_files_update(&_uring, slot, &none, 1);
+        // Cannot fail, capacity was reserved upfront
+        _free_fixed_file_slots.push_back(slot);
+#endif
+    }
+
+    virtual temporary_buffer<char> allocate_fixed_buffer(size_t size, size_t alignment) override {
+        if (!_fixed_buffers) {
+            return {};
+        }
+        return uring_fixed_buffer_arena::make_buffer(_fixed_buffers, size, alignment);
+    }
+
     virtual void signal_received(int signo, siginfo_t* siginfo, void* ignore) override {
         _r._signals.action(signo, siginfo, ignore);
     }
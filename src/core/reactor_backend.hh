@@ -204,12 +204,30 @@ class reactor_backend {
     virtual future<size_t> recvmsg(pollable_fd_state& fd, const std::vector<iovec>& iov) = 0;
     virtual future<temporary_buffer<char>> read_some(pollable_fd_state& fd, internal::buffer_allocator* ba) = 0;
     virtual future<size_t> sendmsg(pollable_fd_state& fd, net::packet& p) = 0;
+    // Like sendmsg(), but may transmit straight from the packet's buffers,
+    // keeping them alive until the kernel is done with them. Backends that
+    // cannot do that copy.
+    virtual future<size_t> sendmsg_zerocopy(pollable_fd_state& fd, net::packet& p) {
+        return sendmsg(fd, p);
+    }
     virtual future<size_t> send(pollable_fd_state& fd, const void* buffer, size_t len) = 0;
     virtual future<temporary_buffer<char>> recv_some(pollable_fd_state& fd, internal::buffer_allocator* ba) = 0;
 
     virtual bool do_blocking_io() const {
         return false;
     }
+
+    // Resources registered with the kernel ahead of time (io_uring only).
+    // Backends without such a notion refuse them and callers fall back to
+    // plain file descriptors and buffers.
+    virtual bool register_fixed_file(int fd) noexcept {
+        return false;
+    }
+    virtual void unregister_fixed_file(int fd) noexcept {}
+    virtual temporary_buffer<char> allocate_fixed_buffer(size_t size, size_t alignment) {
+        return {};
+    }
+
     virtual void signal_received(int signo, siginfo_t* siginfo, void* ignore) = 0;
     virtual void start_tick() = 0;
     virtual void stop_tick() = 0;
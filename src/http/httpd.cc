@@ -212,14 +212,22 @@ void connection::generate_error_reply_and_close(std::unique_ptr<http::request> r
 }
 
 future<> connection::read_one() {
-    _parser.init();
-    return _read_buf.consume(_parser).then([this] () mutable {
-        if (_parser.eof()) {
+    bool simd = _server.get_simd_request_parser();
+    future<> consumed = make_ready_future<>();
+    if (simd) {
+        _simd_parser.init();
+        consumed = _read_buf.consume(_simd_parser);
+    } else {
+        _parser.init();
+        consumed = _read_buf.consume(_parser);
+    }
+    return consumed.then([this, simd] () mutable {
+        if (simd ? _simd_parser.eof() : _parser.eof()) {
             _done = true;
             return make_ready_future<>();
         }
         ++_server._requests_served;
-        std::unique_ptr<http::request> req = _parser.get_parsed_request();
+        std::unique_ptr<http::request> req = simd ? _simd_parser.get_parsed_request() : _parser.get_parsed_request();
 
         req->_server_address = this->_server_addr;
         req->_client_address = this->_client_addr;
@@ -227,11 +235,15 @@ future<> connection::read_one() {
         if (_tls) {
             req->protocol_name = "https";
         }
-        if (_parser.failed()) {
+        if (simd ? _simd_parser.failed() : _parser.failed()) {
             if (req->_version.empty()) {
                 // we might have failed to parse even the version
                 req->_version = "1.1";
             }
+            if (simd && _simd_parser.head_too_large()) {
+                generate_error_reply_and_close(std::move(req), http::reply::status_type::request_header_fields_too_large, "Request header fields too large");
+                return make_ready_future<>();
+            }
             generate_error_reply_and_close(std::move(req), http::reply::status_type::bad_request, "Can't parse the request");
             return make_ready_future<>();
         }
@@ -389,6 +401,14 @@ void http_server::set_content_streaming(bool b) {
     _content_streaming = b;
 }
 
+bool http_server::get_simd_request_parser() const {
+    return _simd_request_parser;
+}
+
+void http_server::set_simd_request_parser(bool b) {
+    _simd_request_parser = b;
+}
+
 future<> http_server::listen(socket_address addr, listen_options lo,
             server_credentials_ptr listener_credentials) {
     if (listener_credentials) {
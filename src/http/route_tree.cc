@@ -0,0 +1,343 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#ifdef SEASTAR_MODULE
+module;
+#endif
+
+#include <algorithm>
+#include <array>
+#include <typeinfo>
+#include <utility>
+
+#ifdef SEASTAR_MODULE
+module seastar;
+#else
+#include <seastar/http/internal/route_tree.hh>
+#include <seastar/http/matcher.hh>
+#endif
+
+namespace seastar {
+
+namespace httpd {
+
+namespace internal {
+
+route_tree::node* route_tree::node::find_child(char c) const noexcept {
+    for (auto& child : children) {
+        if (child->label[0] == c) {
+            return child.get();
+        }
+    }
+    return nullptr;
+}
+
+bool route_tree::node::empty() const noexcept {
+    return children.empty() && !boundary && !param && remainder.empty() && rules.empty() && !exact;
+}
+
+/*
+ * Turns the matchers of a rule into the edges of its branch, or returns
+ * false if the tree cannot hold it.
+ *
+ * A str_matcher is its string, followed by a boundary: it only matches
+ * where the url ends or goes on with a slash. A literal that starts with a
+ * slash checks that already, and replaces the boundary before it.
+ */
+bool route_tree::compile(const match_rule& rule, std::vector<segment>& segments) {
+    auto& matchers = rule.matchers();
+    if (matchers.empty()) {
+        return false;
+    }
+    segments.clear();
+    size_t params = 0;
+    for (size_t i = 0; i < matchers.size(); i++) {
+        auto m = matchers[i];
+        if (typeid(*m) == typeid(str_matcher)) {
+            std::string_view str = static_cast<const str_matcher*>(m)->str();
+            if (!str.empty()) {
+                if (str[0] == '/' && !segments.empty() && segments.back().kind == segment_kind::boundary) {
+                    segments.pop_back();
+                }
+                segments.push_back({segment_kind::literal, str});
+            }
+            segments.push_back({segment_kind::boundary, {}});
+        } else if (typeid(*m) == typeid(param_matcher)) {
+            if (++params > max_params) {
+                return false;
+            }
+            if (!static_cast<const param_matcher*>(m)->entire_path()) {
+                segments.push_back({segment_kind::param, {}});
+            } else if (i + 1 == matchers.size()) {
+                segments.push_back({segment_kind::remainder, {}});
+            } else {
+                // Whatever follows sees an empty url
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+route_tree::node& route_tree::descend(node& n, std::string_view str) {
+    node* cur = &n;
+    while (!str.empty()) {
+        auto c = cur->find_child(str[0]);
+        if (!c) {
+            auto child = std::make_unique<node>();
+            child->label = sstring(str);
+            cur->children.push_back(std::move(child));
+            return *cur->children.back();
+        }
+        auto common = std::mismatch(str.begin(), str.end(), c->label.begin(), c->label.end()).first - str.begin();
+        if (size_t(common) < c->label.size()) {
+            // Split the edge where the strings part
+            auto mid = std::make_unique<node>();
+            mid->label = c->label.substr(0, common);
+            auto rest = c->label.substr(common);
+            auto& slot = *std::find_if(cur->children.begin(), cur->children.end(), [c] (auto& p) { return p.get() == c; });
+            mid->children.reserve(1);
+            c->label = std::move(rest);
+            mid->children.push_back(std::move(slot));
+            slot = std::move(mid);
+            c = slot.get();
+        }
+        cur = c;
+        str.remove_prefix(common);
+    }
+    return *cur;
+}
+
+static void remove_endpoint(auto& endpoints, uint64_t cookie) noexcept {
+    auto i = std::find_if(endpoints.begin(), endpoints.end(), [cookie] (auto& e) { return e.cookie == cookie; });
+    if (i != endpoints.end()) {
+        endpoints.erase(i);
+    }
+}
+
+// Removes what the segments lead to, and returns whether the node is left empty
+bool route_tree::erase(node& n, const segment* s, const segment* end, size_t consumed, rule_cookie cookie, bool exact) {
+    if (s == end) {
+        if (exact) {
+            n.exact = nullptr;
+        } else {
+            remove_endpoint(n.rules, cookie);
+        }
+        return n.empty();
+    }
+    switch (s->kind) {
+    case segment_kind::literal: {
+        auto str = s->str.substr(consumed);
+        if (str.empty()) {
+            return erase(n, s + 1, end, 0, cookie, exact);
+        }
+        auto c = n.find_child(str[0]);
+        if (c && erase(*c, s, end, consumed + c->label.size(), cookie, exact)) {
+            std::erase_if(n.children, [c] (auto& p) { return p.get() == c; });
+        }
+        break;
+    }
+    case segment_kind::boundary:
+        if (n.boundary && erase(*n.boundary, s + 1, end, 0, cookie, exact)) {
+            n.boundary.reset();
+        }
+        break;
+    case segment_kind::param:
+        if (n.param && erase(*n.param, s + 1, end, 0, cookie, exact)) {
+            n.param.reset();
+        }
+        break;
+    case segment_kind::remainder:
+        remove_endpoint(n.remainder, cookie);
+        break;
+    }
+    return n.empty();
+}
+
+void route_tree::put(const sstring& url, handler_base* handler) {
+    descend(_root, url).exact = handler;
+}
+
+void route_tree::drop(const sstring& url) {
+    segment s{segment_kind::literal, url};
+    erase(_root, &s, &s + 1, 0, 0, true);
+}
+
+void route_tree::add(rule_cookie cookie, match_rule* rule) {
+    std::vector<segment> segments;
+    if (!compile(*rule, segments)) {
+        _linear.emplace(cookie, rule);
+        return;
+    }
+    node* n = &_root;
+    std::vector<endpoint>* endpoints = nullptr;
+    for (auto& s : segments) {
+        switch (s.kind) {
+        case segment_kind::literal:
+            n = &descend(*n, s.str);
+            break;
+        case segment_kind::boundary:
+            if (!n->boundary) {
+                n->boundary = std::make_unique<node>();
+            }
+            n = n->boundary.get();
+            break;
+        case segment_kind::param:
+            if (!n->param) {
+                n->param = std::make_unique<node>();
+            }
+            n = n->param.get();
+            break;
+        case segment_kind::remainder:
+            endpoints = &n->remainder;
+            break;
+        }
+    }
+    if (!endpoints) {
+        endpoints = &n->rules;
+    }
+    // Keep them by cookie, the first one wins
+    auto i = std::upper_bound(endpoints->begin(), endpoints->end(), cookie, [] (rule_cookie c, const endpoint& e) {
+        return c < e.cookie;
+    });
+    endpoints->insert(i, endpoint{cookie, rule});
+    _compiled++;
+}
+
+void route_tree::remove(rule_cookie cookie, match_rule* rule) {
+    if (_linear.erase(cookie)) {
+        return;
+    }
+    std::vector<segment> segments;
+    compile(*rule, segments);
+    erase(_root, segments.data(), segments.data() + segments.size(), 0, cookie, false);
+    _compiled--;
+}
+
+struct route_tree::match_state {
+    using span = std::pair<size_t, size_t>;
+
+    std::string_view url;
+    // The parameters of the branch being walked
+    std::array<span, max_params> spans;
+    size_t nr_spans = 0;
+    // The rule that matched with the lowest cookie so far
+    const endpoint* best = nullptr;
+    std::array<span, max_params> best_spans;
+    size_t nr_best_spans = 0;
+    handler_base* exact = nullptr;
+
+    void consider(const endpoint& e, bool remainder, size_t pos) noexcept {
+        if (best && best->cookie < e.cookie) {
+            return;
+        }
+        best = &e;
+        std::copy_n(spans.begin(), nr_spans, best_spans.begin());
+        nr_best_spans = nr_spans;
+        if (remainder) {
+            best_spans[nr_best_spans++] = {pos, url.size()};
+        }
+    }
+};
+
+/*
+ * Walks all the branches that match the url from pos on, n's label being
+ * matched already.
+ *
+ * Exact urls are only made of literal edges, which are walked first, so an
+ * exact match is found before any rule and ends the walk.
+ */
+void route_tree::search(const node& n, size_t pos, match_state& st) noexcept {
+    auto url = st.url;
+    if (pos == url.size() && n.exact) {
+        st.exact = n.exact;
+        return;
+    }
+    if (pos < url.size()) {
+        auto c = n.find_child(url[pos]);
+        if (c && url.substr(pos).starts_with(std::string_view(c->label))) {
+            search(*c, pos + c->label.size(), st);
+            if (st.exact) {
+                return;
+            }
+        }
+    }
+    // Like match_rule::get, a rule also matches a url with a slash left
+    if (!n.rules.empty() && pos + 1 >= url.size()) {
+        st.consider(n.rules.front(), false, pos);
+    }
+    if (n.boundary && (pos == url.size() || url[pos] == '/')) {
+        search(*n.boundary, pos, st);
+    }
+    if (n.param && pos < url.size() && st.nr_spans < max_params) {
+        auto last = url.find('/', pos + 1);
+        if (last == std::string_view::npos) {
+            last = url.size();
+        }
+        st.spans[st.nr_spans++] = {pos, last};
+        search(*n.param, last, st);
+        st.nr_spans--;
+    }
+    if (!n.remainder.empty()) {
+        st.consider(n.remainder.front(), true, pos);
+    }
+}
+
+handler_base* route_tree::find(const sstring& url, parameters& params) const {
+    match_state st;
+    st.url = url;
+    search(_root, 0, st);
+    if (st.exact) {
+        return st.exact;
+    }
+
+    // Rules the tree cannot hold that were added before the one it found
+    for (auto& [cookie, rule] : _linear) {
+        if (st.best && cookie > st.best->cookie) {
+            break;
+        }
+        auto handler = rule->get(url, params);
+        if (handler != nullptr) {
+            return handler;
+        }
+        params.clear();
+    }
+
+    if (!st.best) {
+        return nullptr;
+    }
+    size_t i = 0;
+    for (auto m : st.best->rule->matchers()) {
+        if (typeid(*m) == typeid(param_matcher)) {
+            auto [begin, end] = st.best_spans[i++];
+            params.set(static_cast<const param_matcher*>(m)->name(), url.substr(begin, end - begin));
+        }
+    }
+    return st.best->rule->handler();
+}
+
+}
+
+}
+
+}
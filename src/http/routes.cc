@@ -115,19 +115,8 @@ sstring routes::normalize_url(const sstring& url) {
 
 handler_base* routes::get_handler(operation_type type, const sstring& url,
         parameters& params) {
-    handler_base* handler = get_exact_match(type, url);
-    if (handler != nullptr) {
-        return handler;
-    }
-
-    for (auto&& rule : _rules[type]) {
-        handler = rule.second->get(url, params);
-        if (handler != nullptr) {
-            return handler;
-        }
-        params.clear();
-    }
-    return _default_handler;
+    handler_base* handler = _tree[type].find(url, params);
+    return handler != nullptr ? handler : _default_handler;
 }
 
 routes& routes::add(operation_type type, const url& url,
@@ -159,7 +148,11 @@ static auto delete_rule_from(operation_type type, Key& key, Map& map) {
 }
 
 handler_base* routes::drop(operation_type type, const sstring& url) {
-    return delete_rule_from(type, url, _map);
+    auto handler = delete_rule_from(type, url, _map);
+    if (handler != nullptr) {
+        _tree[type].drop(url);
+    }
+    return handler;
 }
 
 routes& routes::put(operation_type type, const sstring& url, handler_base* handler) {
@@ -167,11 +160,33 @@ routes& routes::put(operation_type type, const sstring& url, handler_base* handl
     if (it.second == false) {
         throw std::runtime_error(format("Handler for {} already exists.", url));
     }
+    try {
+        _tree[type].put(url, handler);
+    } catch (...) {
+        _map[type].erase(it.first);
+        throw;
+    }
     return *this;
 }
 
+routes::rule_cookie routes::add_cookie(match_rule* rule, operation_type type) {
+    auto pos = _rover++;
+    auto it = _rules[type].emplace(pos, rule).first;
+    try {
+        _tree[type].add(pos, rule);
+    } catch (...) {
+        _rules[type].erase(it);
+        throw;
+    }
+    return pos;
+}
+
 match_rule* routes::del_cookie(rule_cookie cookie, operation_type type) {
-    return delete_rule_from(type, cookie, _rules);
+    auto rule = delete_rule_from(type, cookie, _rules);
+    if (rule != nullptr) {
+        _tree[type].remove(cookie, rule);
+    }
+    return rule;
 }
 
 void routes::add_alias(const path_description& old_path, const path_description& new_path) {
@@ -0,0 +1,340 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#ifdef SEASTAR_MODULE
+module;
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#ifdef SEASTAR_MODULE
+module seastar;
+#else
+#include <seastar/http/simd_request_parser.hh>
+#endif
+
+namespace seastar {
+
+namespace {
+
+constexpr std::array<bool, 256> make_tchar_table() {
+    std::array<bool, 256> t{};
+    for (int c = '0'; c <= '9'; ++c) {
+        t[c] = true;
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        t[c] = true;
+        t[c - 'a' + 'A'] = true;
+    }
+    for (unsigned char c : std::string_view("-!#$%&'*+.^_`|~")) {
+        t[c] = true;
+    }
+    return t;
+}
+
+constexpr auto tchar = make_tchar_table();
+
+// Control characters other than HT are not allowed in field values
+// (RFC 9110, Section 5.5); CR is only allowed as part of a line end.
+inline bool is_ctl(char c) noexcept {
+    auto u = static_cast<unsigned char>(c);
+    return (u < 0x20 && u != '\t') || u == 0x7f;
+}
+
+inline bool is_sp_ht(char c) noexcept {
+    return c == ' ' || c == '\t';
+}
+
+#if defined(__x86_64__)
+
+constexpr size_t vector_size = 16;
+
+inline unsigned ctl_mask(const char* p) noexcept {
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    auto low = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+    low = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), low);
+    auto del = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f));
+    return _mm_movemask_epi8(_mm_or_si128(low, del));
+}
+
+inline unsigned crlfcrlf_mask(const char* p) noexcept {
+    auto cr = _mm_set1_epi8('\r');
+    auto lf = _mm_set1_epi8('\n');
+    auto m = _mm_and_si128(
+            _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), cr),
+                          _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), lf)),
+            _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2)), cr),
+                          _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 3)), lf)));
+    return _mm_movemask_epi8(m);
+}
+
+inline size_t first_match(unsigned mask) noexcept {
+    return __builtin_ctz(mask);
+}
+
+#elif defined(__aarch64__)
+
+constexpr size_t vector_size = 16;
+
+// Narrows a byte mask to 4 bits per byte
+inline uint64_t to_mask(uint8x16_t m) noexcept {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+
+inline uint64_t ctl_mask(const char* p) noexcept {
+    auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    auto low = vbicq_u8(vcltq_u8(v, vdupq_n_u8(0x20)), vceqq_u8(v, vdupq_n_u8('\t')));
+    return to_mask(vorrq_u8(low, vceqq_u8(v, vdupq_n_u8(0x7f))));
+}
+
+inline uint64_t crlfcrlf_mask(const char* p) noexcept {
+    auto u = reinterpret_cast<const uint8_t*>(p);
+    auto cr = vdupq_n_u8('\r');
+    auto lf = vdupq_n_u8('\n');
+    auto m = vandq_u8(vandq_u8(vceqq_u8(vld1q_u8(u), cr), vceqq_u8(vld1q_u8(u + 1), lf)),
+                      vandq_u8(vceqq_u8(vld1q_u8(u + 2), cr), vceqq_u8(vld1q_u8(u + 3), lf)));
+    return to_mask(m);
+}
+
+inline size_t first_match(uint64_t mask) noexcept {
+    return __builtin_ctzll(mask) / 4;
+}
+
+#else
+
+constexpr size_t vector_size = 0;
+
+#endif
+
+// Returns the first control character in [p, end), or end
+const char* find_ctl(const char* p, const char* end) noexcept {
+#if defined(__x86_64__) || defined(__aarch64__)
+    for (; end - p >= ptrdiff_t(vector_size); p += vector_size) {
+        if (auto mask = ctl_mask(p)) {
+            return p + first_match(mask);
+        }
+    }
+#endif
+    return std::find_if(p, end, is_ctl);
+}
+
+// Returns the end of the first "\r\n\r\n" in [p, end), or nullptr
+const char* find_head_end(const char* p, const char* end) noexcept {
+#if defined(__x86_64__) || defined(__aarch64__)
+    for (; end - p >= ptrdiff_t(vector_size + 3); p += vector_size) {
+        if (auto mask = crlfcrlf_mask(p)) {
+            return p + first_match(mask) + 4;
+        }
+    }
+#endif
+    static constexpr std::string_view crlfcrlf = "\r\n\r\n";
+    auto i = std::search(p, end, crlfcrlf.begin(), crlfcrlf.end());
+    return i == end ? nullptr : i + crlfcrlf.size();
+}
+
+std::string_view trim_trailing_spaces_and_tabs(const char* b, const char* e) noexcept {
+    while (e != b && is_sp_ht(e[-1])) {
+        --e;
+    }
+    return std::string_view(b, e - b);
+}
+
+bool iequals(std::string_view a, std::string_view b) noexcept {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+            [] (unsigned char x, unsigned char y) { return ::tolower(x) == ::tolower(y); });
+}
+
+}
+
+void http_simd_request_parser::init() {
+    _state = state::eof;
+    _head = {};
+    _pending.clear();
+    _method = {};
+    _url = {};
+    _version = {};
+    _headers.clear();
+    _folded.clear();
+}
+
+future<consumption_result<char>> http_simd_request_parser::operator()(temporary_buffer<char> buf) {
+    if (buf.empty()) {
+        // Like http_request_parser, a connection closed in the middle
+        // of a request is not an error
+        _state = state::eof;
+        return make_ready_future<consumption_result<char>>(stop_consuming<char>(std::move(buf)));
+    }
+    auto too_large = [this] {
+        _state = state::too_large;
+        _pending.clear();
+        return make_ready_future<consumption_result<char>>(stop_consuming<char>(temporary_buffer<char>()));
+    };
+    const char* head;
+    const char* head_end;
+    if (_pending.empty()) {
+        head_end = find_head_end(buf.get(), buf.end());
+        if (!head_end) {
+            if (buf.size() > _max_head_size) {
+                return too_large();
+            }
+            _pending.assign(buf.begin(), buf.end());
+            _state = state::error;
+            return make_ready_future<consumption_result<char>>(continue_consuming{});
+        }
+        auto len = head_end - buf.get();
+        if (size_t(len) > _max_head_size) {
+            return too_large();
+        }
+        _head = buf.share(0, len);
+        buf.trim_front(len);
+        head = _head.get();
+        head_end = _head.end();
+    } else {
+        // The terminator may straddle the two buffers
+        auto old_size = _pending.size();
+        auto rescan = std::min<size_t>(old_size, 3);
+        // Gather at most one byte past the limit, enough to tell that
+        // the head exceeds it (old_size is within the limit)
+        auto take = std::min(buf.size(), _max_head_size + 1 - old_size);
+        _pending.insert(_pending.end(), buf.begin(), buf.begin() + take);
+        head_end = find_head_end(_pending.data() + old_size - rescan, _pending.data() + _pending.size());
+        if (!head_end) {
+            if (_pending.size() > _max_head_size) {
+                return too_large();
+            }
+            return make_ready_future<consumption_result<char>>(continue_consuming{});
+        }
+        auto len = head_end - _pending.data();
+        if (size_t(len) > _max_head_size) {
+            return too_large();
+        }
+        buf.trim_front(len - old_size);
+        _pending.resize(len);
+        head = _pending.data();
+        head_end = head + len;
+    }
+    _state = parse_head(head, head_end) ? state::done : state::error;
+    return make_ready_future<consumption_result<char>>(stop_consuming<char>(std::move(buf)));
+}
+
+bool http_simd_request_parser::parse_request_line(const char* p, const char* eol) {
+    auto m = p;
+    while (m != eol && *m >= 'A' && *m <= 'Z') {
+        ++m;
+    }
+    if (m == p || m == eol || *m != ' ') {
+        return false;
+    }
+    _method = std::string_view(p, m - p);
+
+    auto u = m + 1;
+    auto sp = static_cast<const char*>(::memchr(u, ' ', eol - u));
+    if (!sp || sp == u) {
+        return false;
+    }
+    _url = std::string_view(u, sp - u);
+
+    auto v = std::string_view(sp + 1, eol - sp - 1);
+    auto is_digit = [] (char c) { return c >= '0' && c <= '9'; };
+    if (v.size() != 8 || !v.starts_with("HTTP/") || !is_digit(v[5]) || v[6] != '.' || !is_digit(v[7])) {
+        return false;
+    }
+    _version = v.substr(5);
+    return true;
+}
+
+bool http_simd_request_parser::parse_head(const char* p, const char* end) {
+    // [p, end) ends with the first "\r\n\r\n", so every line, including
+    // the final empty one, is terminated and find_ctl() stops within it
+    auto eol = find_ctl(p, end);
+    if (*eol != '\r' || eol[1] != '\n' || !parse_request_line(p, eol)) {
+        return false;
+    }
+    for (p = eol + 2; *p != '\r'; p = eol + 2) {
+        eol = find_ctl(p, end);
+        if (*eol != '\r' || eol[1] != '\n') {
+            return false;
+        }
+        if (is_sp_ht(*p)) {
+            // RFC 7230, section 3.2.4.  Field Order:
+            // A server that receives an obs-fold in a request message that is not
+            // within a message/http container MUST either reject the message [...]
+            // or replace each received obs-fold with one or more SP octets [...]
+            if (_headers.empty()) {
+                return false;
+            }
+            while (is_sp_ht(*p)) {
+                ++p;
+            }
+            auto& last = _headers.back();
+            _folded.push_back(sstring(last.value) + " " + sstring(trim_trailing_spaces_and_tabs(p, eol)));
+            last.value = _folded.back();
+            continue;
+        }
+        auto n = p;
+        while (tchar[static_cast<unsigned char>(*n)]) {
+            ++n;
+        }
+        if (n == p || *n != ':') {
+            return false;
+        }
+        auto v = n + 1;
+        while (is_sp_ht(*v)) {
+            ++v;
+        }
+        _headers.push_back({std::string_view(p, n - p), trim_trailing_spaces_and_tabs(v, eol)});
+    }
+    return p[1] == '\n';
+}
+
+std::unique_ptr<http::request> http_simd_request_parser::get_parsed_request() const {
+    auto req = std::make_unique<http::request>();
+    req->_method = sstring(_method);
+    req->_url = sstring(_url);
+    req->_version = sstring(_version);
+    for (auto& h : _headers) {
+        auto [iter, inserted] = req->_headers.try_emplace(sstring(h.name), h.value);
+        if (!inserted) {
+            // RFC 7230, section 3.2.2.  Field Parsing
+            iter->second += sstring(",") + sstring(h.value);
+        }
+    }
+    return req;
+}
+
+std::optional<std::string_view> http_simd_request_parser::get_header(std::string_view name) const noexcept {
+    for (auto& h : _headers) {
+        if (iequals(h.name, name)) {
+            return h.value;
+        }
+    }
+    return std::nullopt;
+}
+
+}
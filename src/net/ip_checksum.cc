@@ -24,6 +24,12 @@ module;
 #endif
 
 #include <arpa/inet.h>
+#include <cstring>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #ifdef SEASTAR_MODULE
 module seastar;
@@ -34,28 +40,225 @@ module seastar;
 
 namespace seastar {
 
+namespace {
+
+// The checksum kernels below sum an even-length buffer as native-endian
+// 32-bit words into 64-bit accumulators and fold the result to 16 bits.
+// Since the one's complement sum is byte order independent (RFC 1071),
+// converting the folded sum to host order yields a value congruent
+// (mod 0xffff) to the sum of the buffer's big-endian 16-bit words, which
+// is what checksummer accumulates.
+
+uint16_t fold(uint64_t sum) {
+    sum = (sum & 0xffff'ffff) + (sum >> 32);
+    sum = (sum & 0xffff'ffff) + (sum >> 32);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return ntohs(uint16_t(sum));
+}
+
+uint64_t sum_tail(uint64_t sum, const char* data, size_t len) {
+    while (len >= 4) {
+        uint32_t v;
+        std::memcpy(&v, data, 4);
+        sum += v;
+        data += 4;
+        len -= 4;
+    }
+    if (len) {
+        uint16_t v;
+        std::memcpy(&v, data, 2);
+        sum += v;
+    }
+    return sum;
+}
+
+uint64_t copy_and_sum_tail(uint64_t sum, char* dst, const char* src, size_t len) {
+    while (len >= 4) {
+        uint32_t v;
+        std::memcpy(&v, src, 4);
+        std::memcpy(dst, &v, 4);
+        sum += v;
+        src += 4;
+        dst += 4;
+        len -= 4;
+    }
+    if (len) {
+        uint16_t v;
+        std::memcpy(&v, src, 2);
+        std::memcpy(dst, &v, 2);
+        sum += v;
+    }
+    return sum;
+}
+
+uint16_t sum_generic(const char* data, size_t len) {
+    return fold(sum_tail(0, data, len));
+}
+
+uint16_t copy_and_sum_generic(char* dst, const char* src, size_t len) {
+    return fold(copy_and_sum_tail(0, dst, src, len));
+}
+
+#if defined(__x86_64__)
+
+[[gnu::target("avx2")]]
+uint64_t hsum(__m256i v) {
+    auto s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return uint64_t(_mm_cvtsi128_si64(s)) + uint64_t(_mm_extract_epi64(s, 1));
+}
+
+[[gnu::target("avx2")]]
+uint16_t sum_avx2(const char* data, size_t len) {
+    const auto zero = _mm256_setzero_si256();
+    auto acc0 = zero;
+    auto acc1 = zero;
+    while (len >= 64) {
+        auto v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        auto v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v0, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v0, zero));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v1, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v1, zero));
+        data += 64;
+        len -= 64;
+    }
+    if (len >= 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v, zero));
+        data += 32;
+        len -= 32;
+    }
+    return fold(sum_tail(hsum(_mm256_add_epi64(acc0, acc1)), data, len));
+}
+
+[[gnu::target("avx2")]]
+uint16_t copy_and_sum_avx2(char* dst, const char* src, size_t len) {
+    const auto zero = _mm256_setzero_si256();
+    auto acc0 = zero;
+    auto acc1 = zero;
+    while (len >= 64) {
+        auto v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        auto v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), v1);
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v0, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v0, zero));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v1, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v1, zero));
+        src += 64;
+        dst += 64;
+        len -= 64;
+    }
+    if (len >= 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v, zero));
+        src += 32;
+        dst += 32;
+        len -= 32;
+    }
+    return fold(copy_and_sum_tail(hsum(_mm256_add_epi64(acc0, acc1)), dst, src, len));
+}
+
+#elif defined(__aarch64__)
+
+// NEON is part of the aarch64 baseline, so no runtime check is needed
+uint16_t sum_neon(const char* data, size_t len) {
+    auto acc0 = vdupq_n_u64(0);
+    auto acc1 = vdupq_n_u64(0);
+    while (len >= 32) {
+        acc0 = vpadalq_u32(acc0, vld1q_u32(reinterpret_cast<const uint32_t*>(data)));
+        acc1 = vpadalq_u32(acc1, vld1q_u32(reinterpret_cast<const uint32_t*>(data + 16)));
+        data += 32;
+        len -= 32;
+    }
+    return fold(sum_tail(vaddvq_u64(vaddq_u64(acc0, acc1)), data, len));
+}
+
+uint16_t copy_and_sum_neon(char* dst, const char* src, size_t len) {
+    auto acc0 = vdupq_n_u64(0);
+    auto acc1 = vdupq_n_u64(0);
+    while (len >= 32) {
+        auto v0 = vld1q_u32(reinterpret_cast<const uint32_t*>(src));
+        auto v1 = vld1q_u32(reinterpret_cast<const uint32_t*>(src + 16));
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst), v0);
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + 16), v1);
+        acc0 = vpadalq_u32(acc0, v0);
+        acc1 = vpadalq_u32(acc1, v1);
+        src += 32;
+        dst += 32;
+        len -= 32;
+    }
+    return fold(copy_and_sum_tail(vaddvq_u64(vaddq_u64(acc0, acc1)), dst, src, len));
+}
+
+#endif
+
+struct checksum_kernel {
+    const char* name;
+    uint16_t (*sum)(const char* data, size_t len);
+    uint16_t (*copy_and_sum)(char* dst, const char* src, size_t len);
+};
+
+checksum_kernel select_checksum_kernel() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return { "avx2", sum_avx2, copy_and_sum_avx2 };
+    }
+#elif defined(__aarch64__)
+    return { "neon", sum_neon, copy_and_sum_neon };
+#endif
+    return { "generic", sum_generic, copy_and_sum_generic };
+}
+
+const checksum_kernel& get_checksum_kernel() {
+    static const checksum_kernel kernel = select_checksum_kernel();
+    return kernel;
+}
+
+}
+
+namespace internal {
+
+const char* checksum_kernel_name() noexcept {
+    return get_checksum_kernel().name;
+}
+
+}
+
 namespace net {
 
 void checksummer::sum(const char* data, size_t len) {
     auto orig_len = len;
-    if (odd) {
+    if (odd && len) {
         csum += uint8_t(*data++);
         --len;
     }
-    auto p64 = reinterpret_cast<const packed<uint64_t>*>(data);
-    while (len >= 8) {
-        csum += ntohq(*p64++);
-        len -= 8;
+    auto even_len = len & ~size_t(1);
+    csum += get_checksum_kernel().sum(data, even_len);
+    if (len & 1) {
+        csum += uint8_t(data[even_len]) << 8;
     }
-    auto p16 = reinterpret_cast<const packed<uint16_t>*>(p64);
-    while (len >= 2) {
-        csum += ntohs(*p16++);
-        len -= 2;
+    odd ^= orig_len & 1;
+}
+
+void checksummer::copy_and_sum(char* dst, const char* src, size_t len) {
+    auto orig_len = len;
+    if (odd && len) {
+        *dst++ = *src;
+        csum += uint8_t(*src++);
+        --len;
     }
-    auto p8 = reinterpret_cast<const uint8_t*>(p16);
-    if (len) {
-        csum += *p8++ << 8;
-        len -= 1;
+    auto even_len = len & ~size_t(1);
+    csum += get_checksum_kernel().copy_and_sum(dst, src, even_len);
+    if (len & 1) {
+        dst[even_len] = src[even_len];
+        csum += uint8_t(src[even_len]) << 8;
     }
     odd ^= orig_len & 1;
 }
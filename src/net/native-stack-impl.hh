@@ -21,8 +21,11 @@
 
 #pragma once
 
+#include <netinet/tcp.h>
+
 #include <seastar/net/stack.hh>
 #include <seastar/net/inet_address.hh>
+#include <seastar/net/tcp-congestion.hh>
 #include <seastar/util/assert.hh>
 #include <seastar/util/log.hh>
 
@@ -67,6 +70,9 @@ class native_server_socket_impl : public server_socket_impl {
 template <typename Protocol>
 native_server_socket_impl<Protocol>::native_server_socket_impl(Protocol& proto, uint16_t port, listen_options opt)
     : _listener(proto.listen(port)) {
+    if (opt.congestion_control) {
+        _listener.set_congestion_control(*opt.congestion_control);
+    }
 }
 
 template <typename Protocol>
@@ -281,11 +287,28 @@ keepalive_params native_connected_socket_impl<Protocol>::get_keepalive_parameter
 
 template<typename Protocol>
 void native_connected_socket_impl<Protocol>::set_sockopt(int level, int optname, const void* data, size_t len) {
+    if (level == IPPROTO_TCP && optname == TCP_CONGESTION) {
+        // Like Linux, the name need not be null terminated
+        std::string_view name(static_cast<const char*>(data), strnlen(static_cast<const char*>(data), len));
+        auto f = tcp_congestion_control::find(name);
+        if (!f) {
+            throw std::system_error(ENOENT, std::system_category(), "setsockopt");
+        }
+        _conn->set_congestion_control(f);
+        return;
+    }
     throw std::runtime_error("Setting custom socket options is not supported for native stack");
 }
 
 template<typename Protocol>
 int native_connected_socket_impl<Protocol>::get_sockopt(int level, int optname, void* data, size_t len) const {
+    if (level == IPPROTO_TCP && optname == TCP_CONGESTION) {
+        auto name = _conn->congestion_control();
+        auto n = std::min(name.size(), len);
+        std::copy_n(name.data(), n, static_cast<char*>(data));
+        std::fill_n(static_cast<char*>(data) + n, len - n, '\0');
+        return 0;
+    }
     throw std::runtime_error("Getting custom socket options is not supported for native stack");
 }
 
@@ -35,6 +35,7 @@ module seastar;
 #else
 #include <seastar/core/print.hh>
 #include <seastar/core/smp.hh>
+#include <seastar/net/ip_checksum.hh>
 #include <seastar/net/packet.hh>
 #endif
 
@@ -47,7 +48,7 @@ namespace net {
 
 static_assert(std::is_nothrow_move_constructible_v<packet>);
 
-void packet::linearize(size_t at_frag, size_t desired_size) {
+void packet::linearize(size_t at_frag, size_t desired_size, checksummer* csum) {
     _impl->unuse_internal_data();
     size_t nr_frags = 0;
     size_t accum_size = 0;
@@ -59,7 +60,12 @@ void packet::linearize(size_t at_frag, size_t desired_size) {
     auto p = new_frag.get();
     for (size_t i = 0; i < nr_frags; ++i) {
         auto& f = _impl->_frags[at_frag + i];
-        p = std::copy(f.base, f.base + f.size, p);
+        if (csum) {
+            csum->copy_and_sum(p, f.base, f.size);
+            p += f.size;
+        } else {
+            p = std::copy(f.base, f.base + f.size, p);
+        }
     }
     // collapse nr_frags into one fragment
     std::copy(_impl->_frags + at_frag + nr_frags, _impl->_frags + _impl->_nr_frags,
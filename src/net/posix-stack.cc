@@ -83,6 +83,8 @@ copy_reinterpret_cast(const void* ptr) {
 
 thread_local std::array<uint64_t, seastar::max_scheduling_groups()> bytes_sent = {};
 thread_local std::array<uint64_t, seastar::max_scheduling_groups()> bytes_received = {};
+// Set from posix_stack_options::zerocopy_send_threshold, 0 disables
+thread_local size_t zerocopy_send_threshold = 0;
 
 }
 
@@ -253,7 +255,9 @@ class posix_connected_socket_impl final : public connected_socket_impl {
         return data_source(std::make_unique<posix_data_source_impl>(_fd, csisc, _allocator));
     }
     virtual data_sink sink() override {
-        return data_sink(std::make_unique< posix_data_sink_impl>(_fd));
+        // The kernel only does zero-copy transmit for inet sockets
+        auto threshold = zerocopy_send() ? zerocopy_send_threshold : 0;
+        return data_sink(std::make_unique< posix_data_sink_impl>(_fd, threshold));
     }
     virtual void shutdown_input() override {
         shutdown_socket_fd(_fd, SHUT_RD);
@@ -294,6 +298,12 @@ class posix_connected_socket_impl final : public connected_socket_impl {
     future<> wait_input_shutdown() override {
         return _fd.poll_rdhup();
     }
+    pollable_fd& fd() noexcept {
+        return _fd;
+    }
+    bool zerocopy_send() const noexcept {
+        return zerocopy_send_threshold && !local_address().is_af_unix();
+    }
 
     friend class posix_server_socket_impl;
     friend class posix_ap_server_socket_impl;
@@ -303,6 +313,16 @@ class posix_connected_socket_impl final : public connected_socket_impl {
     friend class posix_socket_impl;
 };
 
+pollable_fd* get_posix_fd(connected_socket_impl& s) noexcept {
+    auto impl = dynamic_cast<posix_connected_socket_impl*>(&s);
+    return impl ? &impl->fd() : nullptr;
+}
+
+bool posix_zerocopy_send(connected_socket_impl& s) noexcept {
+    auto impl = dynamic_cast<posix_connected_socket_impl*>(&s);
+    return impl && impl->zerocopy_send();
+}
+
 static void resolve_outgoing_address(socket_address& a) {
     if (a.family() != AF_INET6
         || a.as_posix_sockaddr_in6().sin6_scope_id != inet_address::invalid_scope
@@ -686,6 +706,9 @@ posix_data_sink_impl::put(packet p) {
     _p = std::move(p);
     auto sg_id = internal::scheduling_group_index(current_scheduling_group());
     bytes_sent[sg_id] += _p.len();
+    if (_zerocopy_threshold && _p.len() >= _zerocopy_threshold) {
+        return _fd.write_all_zerocopy(_p).then([this] { _p.reset(); });
+    }
     return _fd.write_all(_p).then([this] { _p.reset(); });
 }
 
@@ -699,8 +722,19 @@ void posix_data_sink_impl::on_batch_flush_error() noexcept {
     shutdown_socket_fd(_fd, SHUT_RD);
 }
 
+posix_stack_options::posix_stack_options()
+    : program_options::option_group(nullptr, "Posix")
+    , zerocopy_send_threshold(*this, "zerocopy-send-threshold", 0,
+                "Send packets of at least this many bytes on TCP connections without copying them (0 disables)."
+                " Only effective with the io_uring reactor backend (see --reactor-backend) on Linux 6.1 or later")
+{
+}
+
 posix_network_stack::posix_network_stack(const program_options::option_group& opts, std::pmr::polymorphic_allocator<char>* allocator)
         : _reuseport(engine().posix_reuseport_available()), _allocator(allocator) {
+    if (auto posix_opts = dynamic_cast<const posix_stack_options*>(&opts)) {
+        zerocopy_send_threshold = posix_opts->zerocopy_send_threshold.get_value();
+    }
 }
 
 server_socket
@@ -815,10 +849,120 @@ class posix_datagram_channel : public datagram_channel_impl {
         }
     };
 
+    // Bounds the memory a channel pins for batched receives, together with
+    // the slot size below.
+    static constexpr size_t max_batch_size = 32;
+    // Datagrams are received into slots sized for a jumbo frame, which holds
+    // anything that was not fragmented on the way. The tail of a larger
+    // datagram goes to a spare buffer shared by the batch; once one shows
+    // up, the channel switches to slots of MAX_DATAGRAM_SIZE.
+    static constexpr size_t mtu_slot_size = 9000;
+    struct recv_batch_ctx {
+        std::vector<struct mmsghdr> _hdrs;
+        std::vector<struct iovec> _iovs;
+        std::vector<socket_address> _src_addrs;
+        std::vector<cmsg_with_pktinfo> _cmsgs;
+        std::unique_ptr<char[]> _buffers;
+        std::unique_ptr<char[]> _spare;
+        size_t _slot_size = mtu_slot_size;
+        bool _use_pktinfo;
+
+        recv_batch_ctx(bool use_pktinfo) : _use_pktinfo(use_pktinfo) {}
+
+        recv_batch_ctx(const recv_batch_ctx&) = delete;
+        recv_batch_ctx(recv_batch_ctx&&) = delete;
+
+        // Buffers are allocated on first use, left uninitialized, and reused
+        // afterwards; received datagrams are copied out into right-sized
+        // buffers.
+        void prepare(size_t n) {
+            if (!_buffers) {
+                _buffers = std::make_unique_for_overwrite<char[]>(max_batch_size * _slot_size);
+                if (_slot_size < size_t(MAX_DATAGRAM_SIZE)) {
+                    _spare = std::make_unique_for_overwrite<char[]>(MAX_DATAGRAM_SIZE - _slot_size);
+                }
+                _hdrs.resize(max_batch_size);
+                _iovs.resize(max_batch_size * 2);
+                _src_addrs.resize(max_batch_size);
+                _cmsgs.resize(max_batch_size);
+            }
+            for (size_t i = 0; i < n; i++) {
+                auto& hdr = _hdrs[i].msg_hdr;
+                auto* iov = &_iovs[i * 2];
+                memset(&_hdrs[i], 0, sizeof(_hdrs[i]));
+                iov[0].iov_base = _buffers.get() + i * _slot_size;
+                iov[0].iov_len = _slot_size;
+                iov[1].iov_base = _spare.get();
+                iov[1].iov_len = _spare ? MAX_DATAGRAM_SIZE - _slot_size : 0;
+                hdr.msg_iov = iov;
+                hdr.msg_iovlen = _spare ? 2 : 1;
+                hdr.msg_name = &_src_addrs[i].u.sa;
+                hdr.msg_namelen = sizeof(_src_addrs[i].u.sas);
+                if (_use_pktinfo) {
+                    memset(&_cmsgs[i], 0, sizeof(_cmsgs[i]));
+                    hdr.msg_control = &_cmsgs[i];
+                    hdr.msg_controllen = sizeof(_cmsgs[i]);
+                }
+            }
+        }
+
+        // Copies out datagram i, or returns nothing if its tail was
+        // overwritten by a later datagram of the batch
+        std::optional<temporary_buffer<char>> take(size_t i, size_t nr) {
+            size_t len = _hdrs[i].msg_len;
+            auto* slot = static_cast<const char*>(_iovs[i * 2].iov_base);
+            if (len <= _slot_size) {
+                return temporary_buffer<char>(slot, len);
+            }
+            for (size_t j = i + 1; j < nr; j++) {
+                if (_hdrs[j].msg_len > _slot_size) {
+                    return std::nullopt;
+                }
+            }
+            temporary_buffer<char> buf(len);
+            std::copy_n(slot, _slot_size, buf.get_write());
+            std::copy_n(_spare.get(), len - _slot_size, buf.get_write() + _slot_size);
+            return buf;
+        }
+
+        // Switches to full-size slots after a datagram did not fit
+        void grow() noexcept {
+            _slot_size = MAX_DATAGRAM_SIZE;
+            _buffers.reset();
+            _spare.reset();
+        }
+    };
+    struct send_batch_ctx {
+        std::vector<outgoing_datagram> _datagrams;
+        std::vector<struct mmsghdr> _hdrs;
+        std::vector<std::vector<struct iovec>> _iovecs;
+        size_t _sent = 0;
+
+        send_batch_ctx(std::vector<outgoing_datagram> datagrams)
+            : _datagrams(std::move(datagrams))
+            , _hdrs(_datagrams.size())
+            , _iovecs(_datagrams.size())
+        {
+            for (size_t i = 0; i < _datagrams.size(); i++) {
+                auto& d = _datagrams[i];
+                resolve_outgoing_address(d.dst);
+                _iovecs[i] = to_iovec(d.p);
+                auto& hdr = _hdrs[i].msg_hdr;
+                memset(&_hdrs[i], 0, sizeof(_hdrs[i]));
+                hdr.msg_name = &d.dst.u.sa;
+                hdr.msg_namelen = d.dst.addr_length;
+                hdr.msg_iov = _iovecs[i].data();
+                hdr.msg_iovlen = _iovecs[i].size();
+            }
+        }
+    };
+
     static bool is_inet(sa_family_t family) {
         return family == AF_INET || family == AF_INET6;
     }
 
+    std::optional<socket_address> get_dst(struct msghdr& hdr) const;
+
     static file_desc create_socket(sa_family_t family) {
         file_desc fd = file_desc::socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
 
@@ -836,13 +980,14 @@ class posix_datagram_channel : public datagram_channel_impl {
     socket_address _address;
     recv_ctx _recv;
     send_ctx _send;
+    recv_batch_ctx _recv_batch;
     bool _closed;
 public:
     /// Creates a channel that is not bound to any socket address. The channel
     /// can be used to communicate with adressess that belong to the \param
     /// family.
     posix_datagram_channel(sa_family_t family)
-        : _recv(is_inet(family)), _closed(false) {
+        : _recv(is_inet(family)), _recv_batch(is_inet(family)), _closed(false) {
         auto fd = create_socket(family);
 
         _address = fd.get_address();
@@ -852,7 +997,7 @@ class posix_datagram_channel : public datagram_channel_impl {
     /// Creates a channel that is bound to the specified local address. It can be used to
     /// communicate with addresses that belong to the family of \param local.
     posix_datagram_channel(socket_address local)
-        : _recv(is_inet(local.family())), _closed(false) {
+        : _recv(is_inet(local.family())), _recv_batch(is_inet(local.family())), _closed(false) {
         auto fd = create_socket(local.family());
         fd.bind(local.u.sa, local.addr_length);
 
@@ -864,6 +1009,8 @@ class posix_datagram_channel : public datagram_channel_impl {
     virtual future<datagram> receive() override;
     virtual future<> send(const socket_address& dst, const char *msg) override;
     virtual future<> send(const socket_address& dst, packet p) override;
+    virtual future<std::vector<datagram>> receive_batch(size_t max_datagrams) override;
+    virtual future<> send_batch(std::vector<outgoing_datagram> datagrams) override;
     virtual void shutdown_input() override {
         _fd.shutdown(SHUT_RD, pollable_fd::shutdown_kernel_only::no);
     }
@@ -900,6 +1047,26 @@ future<> posix_datagram_channel::send(const socket_address& dst, packet p) {
             .then([len] (size_t size) { SEASTAR_ASSERT(size == len); });
 }
 
+future<> posix_datagram_channel::send_batch(std::vector<outgoing_datagram> datagrams) {
+    size_t len = 0;
+    for (auto& d : datagrams) {
+        len += d.p.len();
+    }
+    auto sg_id = internal::scheduling_group_index(current_scheduling_group());
+    bytes_sent[sg_id] += len;
+    return do_with(send_batch_ctx(std::move(datagrams)), [this] (send_batch_ctx& ctx) {
+        return do_until([&ctx] { return ctx._sent == ctx._hdrs.size(); }, [this, &ctx] {
+            auto n = std::min(ctx._hdrs.size() - ctx._sent, max_batch_size);
+            return _fd.sendmmsg(ctx._hdrs.data() + ctx._sent, n).then([&ctx] (size_t sent) {
+                for (size_t i = ctx._sent; i < ctx._sent + sent; i++) {
+                    SEASTAR_ASSERT(ctx._hdrs[i].msg_len == ctx._datagrams[i].p.len());
+                }
+                ctx._sent += sent;
+            });
+        });
+    });
+}
+
 udp_channel
 posix_network_stack::make_udp_channel(const socket_address& addr) {
     if (!addr.is_unspecified()) {
@@ -953,20 +1120,23 @@ class posix_datagram : public datagram_impl {
     virtual packet& get_data() override { return _p; }
 };
 
+std::optional<socket_address>
+posix_datagram_channel::get_dst(struct msghdr& hdr) const {
+    for (auto* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
+            return ipv4_addr(copy_reinterpret_cast<in_pktinfo>(CMSG_DATA(cmsg)).ipi_addr, _address.port());
+        } else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+            return ipv6_addr(copy_reinterpret_cast<in6_pktinfo>(CMSG_DATA(cmsg)).ipi6_addr, _address.port());
+        }
+    }
+    return std::nullopt;
+}
+
 future<datagram>
 posix_datagram_channel::receive() {
     _recv.prepare();
     return _fd.recvmsg(&_recv._hdr).then([this] (size_t size) {
-        std::optional<socket_address> dst;
-        for (auto* cmsg = CMSG_FIRSTHDR(&_recv._hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&_recv._hdr, cmsg)) {
-            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
-                dst = ipv4_addr(copy_reinterpret_cast<in_pktinfo>(CMSG_DATA(cmsg)).ipi_addr, _address.port());
-                break;
-            } else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
-                dst = ipv6_addr(copy_reinterpret_cast<in6_pktinfo>(CMSG_DATA(cmsg)).ipi6_addr, _address.port());
-                break;
-            }
-        }
+        std::optional<socket_address> dst = get_dst(_recv._hdr);
         auto sg_id = internal::scheduling_group_index(current_scheduling_group());
         bytes_received[sg_id] += size;
         return make_ready_future<datagram>(datagram(std::make_unique<posix_datagram>(
@@ -977,9 +1147,42 @@ posix_datagram_channel::receive() {
     });
 }
 
+future<std::vector<datagram>>
+posix_datagram_channel::receive_batch(size_t max_datagrams) {
+    auto n = std::clamp<size_t>(max_datagrams, 1, max_batch_size);
+    _recv_batch.prepare(n);
+    return _fd.recvmmsg(_recv_batch._hdrs.data(), n).then([this, max_datagrams] (size_t nr) {
+        std::vector<datagram> ret;
+        ret.reserve(nr);
+        size_t len = 0;
+        bool oversized = false;
+        for (size_t i = 0; i < nr; i++) {
+            auto& mh = _recv_batch._hdrs[i];
+            oversized |= mh.msg_len > _recv_batch._slot_size;
+            auto buf = _recv_batch.take(i, nr);
+            if (!buf) {
+                continue;
+            }
+            auto dst = get_dst(mh.msg_hdr);
+            ret.emplace_back(std::make_unique<posix_datagram>(
+                _recv_batch._src_addrs[i], dst ? *dst : _address, packet(std::move(*buf))));
+            len += mh.msg_len;
+        }
+        if (oversized) {
+            _recv_batch.grow();
+        }
+        auto sg_id = internal::scheduling_group_index(current_scheduling_group());
+        bytes_received[sg_id] += len;
+        if (ret.empty()) {
+            return receive_batch(max_datagrams);
+        }
+        return make_ready_future<std::vector<datagram>>(std::move(ret));
+    });
+}
+
 network_stack_entry register_posix_stack() {
     return network_stack_entry{
-        "posix", std::make_unique<program_options::option_group>(nullptr, "Posix"),
+        "posix", std::make_unique<posix_stack_options>(),
         [](const program_options::option_group& ops) {
             return smp::main_thread() ? posix_network_stack::create(ops)
                                       : posix_ap_network_stack::create(ops);
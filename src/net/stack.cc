@@ -31,6 +31,8 @@ module;
 #ifdef SEASTAR_MODULE
 module seastar;
 #else
+#include <seastar/core/do_with.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/metrics_api.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/net/stack.hh>
@@ -80,6 +82,14 @@ future<> net::datagram_channel::send(const socket_address& dst, packet p) {
     return _impl->send(dst, std::move(p));
 }
 
+future<std::vector<net::datagram>> net::datagram_channel::receive_batch(size_t max_datagrams) {
+    return _impl->receive_batch(max_datagrams);
+}
+
+future<> net::datagram_channel::send_batch(std::vector<outgoing_datagram> datagrams) {
+    return _impl->send_batch(std::move(datagrams));
+}
+
 bool net::datagram_channel::is_closed() const {
     return _impl->is_closed();
 }
@@ -174,6 +184,26 @@ net::connected_socket_impl::source(connected_socket_input_stream_config csisc) {
     return source();
 }
 
+future<std::vector<net::datagram>>
+net::datagram_channel_impl::receive_batch(size_t max_datagrams) {
+    // Default implementation delivers one datagram per call
+    return receive().then([] (datagram d) {
+        std::vector<datagram> ret;
+        ret.push_back(std::move(d));
+        return ret;
+    });
+}
+
+future<>
+net::datagram_channel_impl::send_batch(std::vector<outgoing_datagram> datagrams) {
+    // Default implementation sends the datagrams one by one
+    return do_with(std::move(datagrams), [this] (std::vector<outgoing_datagram>& datagrams) {
+        return do_for_each(datagrams, [this] (outgoing_datagram& d) {
+            return send(d.dst, std::move(d.p));
+        });
+    });
+}
+
 socket::~socket()
 {}
 
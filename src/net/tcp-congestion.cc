@@ -0,0 +1,414 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#ifdef SEASTAR_MODULE
+module;
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <system_error>
+
+#ifdef SEASTAR_MODULE
+module seastar;
+#else
+#include <seastar/net/tcp-congestion.hh>
+#endif
+
+namespace seastar {
+
+namespace net {
+
+using namespace std::chrono_literals;
+
+void tcp_congestion_control::init(tcp_congestion_window& w, uint32_t mss, clock_type::time_point now) {
+    _mss = mss;
+}
+
+void tcp_congestion_control::on_recovery_end(tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now) {
+    // RFC6582: Set cwnd to min (ssthresh, max(FlightSize, SMSS) + SMSS)
+    w.cwnd = std::min(w.ssthresh, std::max(flight_size, _mss) + _mss);
+}
+
+void tcp_congestion_control::on_timeout(tcp_congestion_window& w, uint32_t flight_size, bool first, clock_type::time_point now) {
+    // RFC5681: Update ssthresh only for the first retransmit
+    if (first) {
+        w.ssthresh = on_loss(w, flight_size, now);
+    }
+    // Start the slow start process
+    w.cwnd = _mss;
+}
+
+namespace {
+
+// RFC5681 slow start and congestion avoidance
+class reno final : public tcp_congestion_control {
+public:
+    virtual std::string_view name() const noexcept override {
+        return "reno";
+    }
+    virtual void on_ack(tcp_congestion_window& w, const ack_sample& s) override {
+        if (w.cwnd < w.ssthresh) {
+            // In slow start phase
+            w.cwnd += std::min(s.acked, _mss);
+        } else {
+            // In congestion avoidance phase
+            uint32_t round_up = 1;
+            w.cwnd += std::max(round_up, _mss * _mss / w.cwnd);
+        }
+    }
+    virtual uint32_t on_loss(const tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now) override {
+        return std::max(flight_size / 2, 2 * _mss);
+    }
+};
+
+/*
+ * RFC9438 CUBIC: after a loss the window grows along a cubic function of the
+ * time since, quickly back towards the window the loss happened at, slowly
+ * around it, then faster again to probe for more. The growth does not depend
+ * on the round trip time, which is what makes it fill long fat pipes.
+ *
+ * Windows are in segments, as in the RFC.
+ */
+class cubic final : public tcp_congestion_control {
+    static constexpr double C = 0.4;
+    static constexpr double beta = 0.7;
+    // Reno-friendly additive increase, with the same average window as Reno
+    static constexpr double alpha = 3 * (1 - beta) / (1 + beta);
+
+    // Window before the last reduction
+    double _w_max = 0;
+    // Time it takes to grow back to _w_max
+    double _k = 0;
+    // Window Reno would have
+    double _w_est = 0;
+    // Increase not applied yet as it is less than a byte
+    double _increase = 0;
+    std::optional<clock_type::time_point> _epoch_start;
+    std::optional<clock_type::duration> _min_rtt;
+private:
+    double segments(uint32_t bytes) const noexcept {
+        return double(bytes) / _mss;
+    }
+    void start_epoch(double cwnd, clock_type::time_point now) noexcept {
+        _epoch_start = now;
+        if (cwnd < _w_max) {
+            _k = std::cbrt((_w_max - cwnd) / C);
+        } else {
+            _k = 0;
+            _w_max = cwnd;
+        }
+        _w_est = cwnd;
+        _increase = 0;
+    }
+public:
+    virtual std::string_view name() const noexcept override {
+        return "cubic";
+    }
+    virtual void init(tcp_congestion_window& w, uint32_t mss, clock_type::time_point now) override {
+        tcp_congestion_control::init(w, mss, now);
+        _w_max = 0;
+        _epoch_start.reset();
+        _min_rtt.reset();
+    }
+    virtual void on_ack(tcp_congestion_window& w, const ack_sample& s) override {
+        if (s.rtt && (!_min_rtt || *s.rtt < *_min_rtt)) {
+            _min_rtt = s.rtt;
+        }
+        // Fast recovery owns the window until it is over
+        if (s.recovery) {
+            return;
+        }
+        if (w.cwnd < w.ssthresh) {
+            w.cwnd += std::min(s.acked, _mss);
+            return;
+        }
+        auto cwnd = segments(w.cwnd);
+        if (!_epoch_start) {
+            start_epoch(cwnd, s.now);
+        }
+        // Where the window should be one round trip from now
+        auto t = std::chrono::duration<double>(s.now - *_epoch_start + _min_rtt.value_or(0s)).count();
+        auto target = C * std::pow(t - _k, 3) + _w_max;
+        target = std::clamp(target, cwnd, 1.5 * cwnd);
+
+        _w_est += (_w_est < _w_max ? alpha : 1.0) * segments(s.acked) / cwnd;
+        target = std::max(target, _w_est);
+
+        // Each acknowledged segment brings the window (target - cwnd) / cwnd
+        // segments closer
+        _increase += (target - cwnd) * s.acked / cwnd;
+        auto bytes = uint32_t(_increase);
+        w.cwnd += bytes;
+        _increase -= bytes;
+    }
+    virtual uint32_t on_loss(const tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now) override {
+        auto cwnd = segments(w.cwnd);
+        // Fast convergence: a flow whose window keeps getting smaller releases
+        // bandwidth to the others
+        _w_max = cwnd < _w_max ? cwnd * (1 + beta) / 2 : cwnd;
+        _epoch_start.reset();
+        return std::max(uint32_t(w.cwnd * beta), 2 * _mss);
+    }
+};
+
+/*
+ * A model of the path after BBR: the bottleneck bandwidth is the highest
+ * delivery rate of the last rounds, the propagation delay the lowest round
+ * trip time of the last seconds, and the window their product, the bytes the
+ * path holds without queueing. Losses do not shrink it.
+ *
+ * There is no pacing, so where BBR varies its sending rate this varies the
+ * window: STARTUP grows it as slow start does until the bandwidth stops
+ * growing, DRAIN lets the queue it built drain, PROBE_BW cycles the window
+ * around the product to find more bandwidth and give it back, and PROBE_RTT
+ * keeps it small for a moment to measure the delay again once the lowest
+ * one is too old.
+ *
+ * A round ends when the data in flight at its start is acknowledged; its
+ * delivery rate is the bytes acknowledged during it over its duration.
+ */
+class bbr final : public tcp_congestion_control {
+    enum class mode { startup, drain, probe_bw, probe_rtt };
+    static constexpr unsigned bw_rounds = 10;
+    static constexpr auto min_rtt_window = 10s;
+    static constexpr auto probe_rtt_duration = 200ms;
+    // The clock granularity, which shorter durations are rounded up to
+    static constexpr auto min_interval = 1ms;
+    static constexpr unsigned min_cwnd_segments = 4;
+    static constexpr std::array<double, 8> probe_bw_gains = { 1.25, 0.75, 1, 1, 1, 1, 1, 1 };
+    // STARTUP ends when the bandwidth did not grow by 25% in 3 rounds
+    static constexpr double full_bw_growth = 1.25;
+    static constexpr unsigned full_bw_rounds = 3;
+
+    mode _mode = mode::startup;
+    uint64_t _delivered = 0;
+    uint64_t _round_delivered = 0;
+    uint64_t _next_round_delivered = 0;
+    clock_type::time_point _round_start;
+    uint64_t _round_count = 0;
+    // The sender had less in flight than the window at the start of the round
+    bool _app_limited = false;
+    // Delivery rate of the last rounds, in bytes per second
+    std::array<double, bw_rounds> _bw = {};
+    double _full_bw = 0;
+    unsigned _full_bw_count = 0;
+    std::optional<clock_type::duration> _min_rtt;
+    clock_type::time_point _min_rtt_stamp;
+    clock_type::time_point _probe_rtt_done;
+    bool _filled_pipe = false;
+    unsigned _cycle = 0;
+private:
+    double max_bw() const noexcept {
+        return *std::max_element(_bw.begin(), _bw.end());
+    }
+    uint32_t min_cwnd() const noexcept {
+        return min_cwnd_segments * _mss;
+    }
+    // The bandwidth-delay product, or nothing before the model has samples
+    std::optional<uint32_t> bdp() const noexcept {
+        auto bw = max_bw();
+        if (!_min_rtt || bw == 0) {
+            return std::nullopt;
+        }
+        auto bytes = bw * std::chrono::duration<double>(*_min_rtt).count();
+        return uint32_t(std::min(bytes, double(std::numeric_limits<uint32_t>::max() / 2)));
+    }
+    std::optional<uint32_t> target_cwnd() const noexcept {
+        auto b = bdp();
+        if (!b) {
+            return std::nullopt;
+        }
+        switch (_mode) {
+        case mode::startup:
+            return std::nullopt;
+        case mode::drain:
+            return std::max(*b, min_cwnd());
+        case mode::probe_bw:
+            return std::max(uint32_t(probe_bw_gains[_cycle] * *b) + 3 * _mss, min_cwnd());
+        case mode::probe_rtt:
+            return min_cwnd();
+        }
+        return std::nullopt;
+    }
+    void end_round(const tcp_congestion_window& w, const ack_sample& s) noexcept {
+        // Data takes a round trip to be acknowledged, however short the
+        // round: one ended by a large cumulative acknowledgement, as fast
+        // recovery ends with, can be shorter than a tick of the clock
+        auto duration = std::max<clock_type::duration>(s.now - _round_start, _min_rtt.value_or(min_interval));
+        auto rate = (_delivered - _round_delivered) / std::chrono::duration<double>(duration).count();
+        auto& slot = _bw[_round_count % bw_rounds];
+        // Rounds that did not fill the window say little about the
+        // bandwidth, unless it is more than known
+        slot = _app_limited ? std::max(rate, max_bw()) : rate;
+        _round_count++;
+        _round_delivered = _delivered;
+        _next_round_delivered = _delivered + s.flight_size;
+        _round_start = s.now;
+        _app_limited = s.flight_size + s.acked + _mss < w.cwnd;
+    }
+    void check_full_pipe() noexcept {
+        auto bw = max_bw();
+        if (bw >= _full_bw * full_bw_growth) {
+            _full_bw = bw;
+            _full_bw_count = 0;
+        } else if (++_full_bw_count >= full_bw_rounds) {
+            _filled_pipe = true;
+        }
+    }
+    void update_min_rtt(const ack_sample& s) noexcept {
+        auto expired = s.now > _min_rtt_stamp + min_rtt_window;
+        if (s.rtt) {
+            auto rtt = std::max<clock_type::duration>(*s.rtt, min_interval);
+            if (!_min_rtt || rtt <= *_min_rtt || expired) {
+                _min_rtt = rtt;
+                _min_rtt_stamp = s.now;
+                expired = false;
+            }
+        }
+        if (expired && _mode != mode::probe_rtt) {
+            _mode = mode::probe_rtt;
+            _probe_rtt_done = s.now + probe_rtt_duration;
+        }
+    }
+    void update_mode(const ack_sample& s, bool round_start) noexcept {
+        switch (_mode) {
+        case mode::startup:
+            if (round_start) {
+                check_full_pipe();
+            }
+            if (_filled_pipe) {
+                _mode = mode::drain;
+            }
+            [[fallthrough]];
+        case mode::drain:
+            if (_mode == mode::drain && bdp() && s.flight_size <= *bdp()) {
+                _mode = mode::probe_bw;
+                _cycle = 0;
+            }
+            break;
+        case mode::probe_bw:
+            if (round_start) {
+                _cycle = (_cycle + 1) % probe_bw_gains.size();
+            }
+            break;
+        case mode::probe_rtt:
+            if (s.now >= _probe_rtt_done) {
+                _min_rtt_stamp = s.now;
+                _mode = _filled_pipe ? mode::probe_bw : mode::startup;
+                _cycle = 0;
+            }
+            break;
+        }
+    }
+public:
+    virtual std::string_view name() const noexcept override {
+        return "bbr";
+    }
+    virtual void init(tcp_congestion_window& w, uint32_t mss, clock_type::time_point now) override {
+        tcp_congestion_control::init(w, mss, now);
+        _mode = mode::startup;
+        _delivered = _round_delivered = _next_round_delivered = 0;
+        _round_start = now;
+        _round_count = 0;
+        _app_limited = false;
+        _bw.fill(0);
+        _full_bw = 0;
+        _full_bw_count = 0;
+        _min_rtt.reset();
+        _min_rtt_stamp = now;
+        _filled_pipe = false;
+        _cycle = 0;
+    }
+    virtual void on_ack(tcp_congestion_window& w, const ack_sample& s) override {
+        _delivered += s.acked;
+        bool round_start = _delivered >= _next_round_delivered;
+        if (round_start) {
+            end_round(w, s);
+        }
+        update_min_rtt(s);
+        update_mode(s, round_start);
+        // Fast recovery owns the window until it is over
+        if (s.recovery) {
+            return;
+        }
+        auto target = target_cwnd();
+        if (!target) {
+            w.cwnd += s.acked;
+        } else if (w.cwnd < *target) {
+            w.cwnd = std::min(w.cwnd + s.acked, *target);
+        } else {
+            w.cwnd = *target;
+        }
+    }
+    virtual uint32_t on_loss(const tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now) override {
+        return std::max(w.cwnd, min_cwnd());
+    }
+    virtual void on_recovery_end(tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now) override {
+        w.cwnd = std::max(target_cwnd().value_or(w.ssthresh), min_cwnd());
+    }
+};
+
+template <typename Algorithm>
+std::unique_ptr<tcp_congestion_control> make_algorithm() {
+    return std::make_unique<Algorithm>();
+}
+
+std::map<sstring, tcp_congestion_control::factory, std::less<>>& algorithms() {
+    static std::map<sstring, tcp_congestion_control::factory, std::less<>> algorithms = {
+        { "reno", make_algorithm<reno> },
+        { "cubic", make_algorithm<cubic> },
+        { "bbr", make_algorithm<bbr> },
+    };
+    return algorithms;
+}
+
+}
+
+void tcp_congestion_control::register_algorithm(sstring name, factory f) {
+    algorithms().insert_or_assign(std::move(name), f);
+}
+
+tcp_congestion_control::factory tcp_congestion_control::find(std::string_view name) noexcept {
+    auto& a = algorithms();
+    auto i = a.find(name);
+    return i != a.end() ? i->second : nullptr;
+}
+
+std::unique_ptr<tcp_congestion_control> tcp_congestion_control::make(std::string_view name) {
+    auto f = find(name);
+    if (!f) {
+        throw std::system_error(ENOENT, std::system_category());
+    }
+    return f();
+}
+
+std::unique_ptr<tcp_congestion_control> tcp_congestion_control::make_default() {
+    return std::make_unique<reno>();
+}
+
+}
+
+}
@@ -66,9 +66,9 @@ void tcp_option::parse(uint8_t* beg1, uint8_t* end1) {
             _local_win_scale = 7;
             beg += option_len::win_scale;
             break;
-        case option_kind::sack:
+        case option_kind::sack_permitted:
             _sack_received = true;
-            beg += option_len::sack;
+            beg += option_len::sack_permitted;
             break;
         case option_kind::nop:
             beg += option_len::nop;
@@ -88,6 +88,31 @@ void tcp_option::parse(uint8_t* beg1, uint8_t* end1) {
     }
 }
 
+tcp_option::sack tcp_option::parse_sack(uint8_t* beg1, uint8_t* end1) {
+    const char* beg = reinterpret_cast<const char*>(beg1);
+    const char* end = reinterpret_cast<const char*>(end1);
+    while (beg < end) {
+        auto kind = option_kind(*beg);
+        if (kind == option_kind::eol) {
+            break;
+        } else if (kind == option_kind::nop) {
+            beg += option_len::nop;
+            continue;
+        }
+        auto len = uint8_t(beg[1]);
+        // Make sure there is enough room for this option, and prevent
+        // infinite loop
+        if (len < 2 || beg + len > end) {
+            break;
+        }
+        if (kind == option_kind::sack) {
+            return sack::read(beg);
+        }
+        beg += len;
+    }
+    return sack();
+}
+
 uint8_t tcp_option::fill(void* h, const tcp_hdr* th, uint8_t options_size) {
     auto hdr = reinterpret_cast<char*>(h);
     auto off = hdr + tcp_hdr::len;
@@ -110,6 +135,16 @@ uint8_t tcp_option::fill(void* h, const tcp_hdr* th, uint8_t options_size) {
             off += win_scale.len;
             size += win_scale.len;
         }
+        if (_sack_received || !ack_on) {
+            auto sack_permitted = tcp_option::sack_permitted();
+            sack_permitted.write(off);
+            off += sack_permitted.len;
+            size += sack_permitted.len;
+        }
+    } else if (ack_on && _local_sack.nr_blocks) {
+        _local_sack.write(off);
+        off += _local_sack.len();
+        size += _local_sack.len();
     }
     if (size > 0) {
         // Insert NOP option
@@ -138,6 +173,11 @@ uint8_t tcp_option::get_size(bool syn_on, bool ack_on) {
         if (_win_scale_received || !ack_on) {
             size += option_len::win_scale;
         }
+        if (_sack_received || !ack_on) {
+            size += option_len::sack_permitted;
+        }
+    } else if (ack_on && _local_sack.nr_blocks) {
+        size += _local_sack.len();
     }
     if (size > 0) {
         size += option_len::eol;
@@ -29,13 +29,17 @@ module;
 #include <system_error>
 #include <memory>
 #include <chrono>
+#include <cstring>
 #include <span>
 #include <unordered_set>
 
 #include <seastar/util/assert.hh>
 
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
+#include <linux/tls.h>
 #include <gnutls/gnutls.h>
 #include <gnutls/x509.h>
 
@@ -50,6 +54,7 @@ module;
 module seastar;
 #else
 #include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/file.hh>
@@ -60,6 +65,8 @@ module seastar;
 #include <seastar/core/print.hh>
 #include <seastar/core/with_timeout.hh>
 #include <seastar/net/tls.hh>
+#include <seastar/net/tls_resumption.hh>
+#include <seastar/net/posix-stack.hh>
 #include <seastar/net/stack.hh>
 #include <seastar/util/std-compat.hh>
 #include <seastar/util/variant_utils.hh>
@@ -484,9 +491,18 @@ class tls::certificate_credentials::impl: public gnutlsobj {
         _enable_certificate_verification = enable;
     }
 
+    void set_enable_kernel_offload(bool enable) {
+        _enable_kernel_offload = enable;
+    }
+
+    void set_session_cache(shared_ptr<client_session_cache> cache) {
+        _session_cache = std::move(cache);
+    }
+
 private:
     friend class credentials_builder;
     friend class session;
+    friend class session_ticket_key_rotation;
 
     bool need_load_system_trust() const {
         return _load_system_trust;
@@ -509,6 +525,10 @@ class tls::certificate_credentials::impl: public gnutlsobj {
     semaphore _system_trust_sem {1};
     dn_callback _dn_callback;
     bool _enable_certificate_verification = true;
+    bool _enable_kernel_offload = false;
+    shared_ptr<client_session_cache> _session_cache;
+    // Set when a session_ticket_key_rotation owns the key
+    bool _session_resume_key_rotated = false;
     gnutls_datum _session_resume_key;
 };
 
@@ -591,6 +611,14 @@ void tls::certificate_credentials::set_enable_certificate_verification(bool enab
     _impl->set_enable_certificate_verification(enable);
 }
 
+void tls::certificate_credentials::set_enable_kernel_offload(bool enable) {
+    _impl->set_enable_kernel_offload(enable);
+}
+
+void tls::certificate_credentials::set_session_cache(shared_ptr<client_session_cache> cache) {
+    _impl->set_session_cache(std::move(cache));
+}
+
 tls::server_credentials::server_credentials()
 #if GNUTLS_VERSION_NUMBER < 0x030600
     : server_credentials(dh_params{})
@@ -729,6 +757,10 @@ void tls::credentials_builder::set_session_resume_mode(session_resume_mode m) {
     }
 }
 
+void tls::credentials_builder::set_enable_kernel_offload(bool enable) {
+    _enable_kernel_offload = enable;
+}
+
 template<typename Blobs, typename Visitor>
 static void visit_blobs(Blobs& blobs, Visitor&& visitor) {
     auto visit = [&](const sstring& key, auto* vt) {
@@ -776,8 +808,12 @@ void tls::credentials_builder::apply_to(certificate_credentials& creds) const {
     }
 
     creds._impl->set_client_auth(_client_auth);
-    // Note: this causes server session key rotation on cert reload
-    creds._impl->set_session_resume_mode(_session_resume_mode, std::span{_session_resume_key.begin(), _session_resume_key.end()});
+    creds._impl->set_enable_kernel_offload(_enable_kernel_offload);
+    // Note: this causes server session key rotation on cert reload, unless
+    // the key is rotated by a session_ticket_key_rotation
+    if (!creds._impl->_session_resume_key_rotated) {
+        creds._impl->set_session_resume_mode(_session_resume_mode, std::span{_session_resume_key.begin(), _session_resume_key.end()});
+    }
 }
 
 shared_ptr<tls::certificate_credentials> tls::credentials_builder::build_certificate_credentials() const {
@@ -1097,6 +1133,112 @@ future<shared_ptr<tls::server_credentials>> tls::credentials_builder::build_relo
 
 namespace tls {
 
+// Handshakes of the shard, by role and by whether they resumed a session
+struct handshake_metrics {
+    enum role { client, server };
+    uint64_t full[2] = {};
+    uint64_t resumed[2] = {};
+    metrics::metric_groups groups;
+
+    handshake_metrics() {
+        namespace sm = seastar::metrics;
+        auto role_label = sm::label("role");
+        std::vector<sm::metric_definition> defs;
+        for (auto [r, name] : {std::pair(client, "client"), std::pair(server, "server")}) {
+            defs.push_back(sm::make_counter("full_handshakes", full[r],
+                    sm::description("Handshakes that did not resume a session"), {role_label(name)}));
+            defs.push_back(sm::make_counter("resumed_handshakes", resumed[r],
+                    sm::description("Handshakes that resumed a session"), {role_label(name)}));
+        }
+        groups.add_group("tls", defs);
+    }
+};
+
+// Registers the metrics with the first handshake of the shard
+static handshake_metrics& local_handshake_metrics() {
+    static thread_local handshake_metrics m;
+    return m;
+}
+
+// Record layer state of one direction of a session, as the kernel wants it
+// for TLS_TX or TLS_RX (linux/tls.h). A zero size means the kernel cannot
+// take over the direction.
+struct ktls_crypto_info {
+    union {
+        tls_crypto_info info;
+        tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+        tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+        tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+    };
+    size_t size = 0;
+
+    ktls_crypto_info() noexcept {
+        std::memset(static_cast<void*>(this), 0, sizeof(*this));
+    }
+    ktls_crypto_info(const ktls_crypto_info&) = delete;
+    ~ktls_crypto_info() {
+        // don't leave keys lying around
+        explicit_bzero(this, sizeof(*this));
+    }
+};
+
+static void get_ktls_crypto_info(gnutls_session_t session, bool read, ktls_crypto_info& ci) {
+    uint16_t version;
+    switch (gnutls_protocol_get_version(session)) {
+    case GNUTLS_TLS1_2:
+        version = TLS_1_2_VERSION;
+        break;
+    case GNUTLS_TLS1_3:
+        version = TLS_1_3_VERSION;
+        break;
+    default:
+        return;
+    }
+    gnutls_datum_t mac_key, iv, key;
+    unsigned char seq[8];
+    if (gnutls_record_get_state(session, read, &mac_key, &iv, &key, seq) < 0) {
+        return;
+    }
+    auto fill = [&] <typename Info> (Info& c, uint16_t cipher) {
+        constexpr size_t salt_size = sizeof(c.salt);
+        constexpr size_t iv_size = sizeof(c.iv);
+        if (key.size != sizeof(c.key)) {
+            return;
+        }
+        if (iv.size == salt_size + iv_size) {
+            // TLS 1.3, and ChaCha20 which has no salt: gnutls has the
+            // whole nonce
+            std::memcpy(c.salt, iv.data, salt_size);
+            std::memcpy(c.iv, iv.data + salt_size, iv_size);
+        } else if (iv.size == salt_size && iv_size == sizeof(seq)) {
+            // TLS 1.2 GCM: gnutls has the implicit part of the nonce, and
+            // uses the record sequence number as the explicit one
+            std::memcpy(c.salt, iv.data, salt_size);
+            std::memcpy(c.iv, seq, iv_size);
+        } else {
+            return;
+        }
+        c.info.version = version;
+        c.info.cipher_type = cipher;
+        std::memcpy(c.key, key.data, key.size);
+        std::memcpy(c.rec_seq, seq, sizeof(c.rec_seq));
+        ci.size = sizeof(c);
+    };
+    switch (gnutls_cipher_get(session)) {
+    case GNUTLS_CIPHER_AES_128_GCM:
+        fill(ci.aes_gcm_128, TLS_CIPHER_AES_GCM_128);
+        break;
+    case GNUTLS_CIPHER_AES_256_GCM:
+        fill(ci.aes_gcm_256, TLS_CIPHER_AES_GCM_256);
+        break;
+    case GNUTLS_CIPHER_CHACHA20_POLY1305:
+        fill(ci.chacha20_poly1305, TLS_CIPHER_CHACHA20_POLY1305);
+        break;
+    default:
+        break;
+    }
+}
+
 /**
  * Session wraps gnutls session, and is the
  * actual conduit for an TLS/SSL data flow.
@@ -1170,6 +1312,14 @@ class session : public enable_lw_shared_from_this<session> {
         // if we are a client, check if we have a session ticket to unpack.
         if (_type == type::CLIENT && !_options.session_resume_data.empty()) {
             gtls_chk(gnutls_session_set_data(*this, _options.session_resume_data.data(), _options.session_resume_data.size()));
+        } else if (_type == type::CLIENT && _creds->_session_cache) {
+            // or if the credentials cached one for the server. Stale data
+            // is not worth failing the connection over.
+            _session_cache_key = _options.server_name.empty() ? format("{}", _sock->remote_address()) : _options.server_name;
+            auto data = _creds->_session_cache->get(_session_cache_key);
+            if (data && gnutls_session_set_data(*this, data->data(), data->size()) != GNUTLS_E_SUCCESS) {
+                _creds->_session_cache->erase(_session_cache_key);
+            }
         }
         _options.session_resume_data.clear(); // no need to keep around
     }
@@ -1271,8 +1421,12 @@ class session : public enable_lw_shared_from_this<session> {
                 verify();
             }
             _connected = true;
+            count_handshake();
+            maybe_cache_session();
             // make sure we reset output_pending
-            return wait_for_output();
+            return wait_for_output().then([this] {
+                offload_to_kernel();
+            });
         } catch (...) {
             return make_exception_future<>(std::current_exception());
         }
@@ -1298,6 +1452,168 @@ class session : public enable_lw_shared_from_this<session> {
         });
     }
 
+    void count_handshake() noexcept {
+        auto& m = local_handshake_metrics();
+        auto role = _type == type::CLIENT ? handshake_metrics::client : handshake_metrics::server;
+        if (gnutls_session_is_resumed(*this)) {
+            m.resumed[role]++;
+        } else {
+            m.full[role]++;
+        }
+    }
+
+    // Stores the session data in the cache of the credentials once the
+    // server sent a ticket: with the handshake up to TLS 1.2, in the first
+    // records after it with TLS 1.3
+    void maybe_cache_session() noexcept {
+        if (_session_cache_key.empty() || _session_cached
+                || !(gnutls_session_get_flags(*this) & GNUTLS_SFLAGS_SESSION_TICKET)) {
+            return;
+        }
+        _session_cached = true;
+        try {
+            gnutls_datum tmp;
+            gtls_chk(gnutls_session_get_data2(*this, &tmp));
+            _creds->_session_cache->put(_session_cache_key, session_data(tmp.data, tmp.data + tmp.size));
+        } catch (...) {
+            // the next connection does a full handshake
+        }
+    }
+
+    // Hands the record layer of the session to the kernel, when the
+    // credentials ask for it, so that get and put become plain socket reads
+    // and writes. gnutls keeps any direction the kernel can't take: sockets
+    // of other stacks or sending zero-copy, kernels without the "tls" module,
+    // cipher suites it does not implement.
+    void offload_to_kernel() noexcept {
+        if (std::exchange(_offload_tried, true) || !_creds->_enable_kernel_offload) {
+            return;
+        }
+        _fd = net::get_posix_fd(*_sock);
+        if (!_fd || net::posix_zerocopy_send(*_sock)) {
+            return;
+        }
+        ktls_crypto_info tx, rx;
+        get_ktls_crypto_info(*this, false, tx);
+        if (!tx.size) {
+            return;
+        }
+        // Bytes we, gnutls or a multishot receive of the reactor already
+        // pulled off the socket are past where the kernel would start
+        // decrypting. And a TLS 1.3 client has to read session tickets after
+        // the handshake, which only gnutls can do.
+        if (_input.empty() && gnutls_record_check_pending(*this) == 0 && !_fd->may_have_received_ahead()
+                && !(_type == type::CLIENT && gnutls_protocol_get_version(*this) == GNUTLS_TLS1_3)) {
+            get_ktls_crypto_info(*this, true, rx);
+        }
+        try {
+            _sock->set_sockopt(SOL_TCP, TCP_ULP, "tls", sizeof("tls"));
+            _sock->set_sockopt(SOL_TLS, TLS_TX, &tx.info, tx.size);
+            _tx_offload = true;
+            if (rx.size) {
+                _sock->set_sockopt(SOL_TLS, TLS_RX, &rx.info, rx.size);
+                _rx_offload = true;
+            }
+        } catch (...) {
+            // Whatever the kernel did not take, gnutls still can
+        }
+    }
+
+    // The kernel fails plain reads at a record that is not application data,
+    // and only hands it over to a recvmsg that asks for its type.
+    future<temporary_buffer<char>> read_control_record() {
+        struct control_record {
+            buf_type data{16384};
+            iovec iov;
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))];
+            msghdr hdr = {};
+        };
+        auto rec = std::make_unique<control_record>();
+        rec->iov = {rec->data.get_write(), rec->data.size()};
+        rec->hdr.msg_iov = &rec->iov;
+        rec->hdr.msg_iovlen = 1;
+        rec->hdr.msg_control = rec->control;
+        rec->hdr.msg_controllen = sizeof(rec->control);
+        auto hdr = &rec->hdr;
+        return _fd->recvmsg(hdr).then([this, rec = std::move(rec)] (size_t n) {
+            auto cmsg = CMSG_FIRSTHDR(&rec->hdr);
+            if (!cmsg || cmsg->cmsg_level != SOL_TLS || cmsg->cmsg_type != TLS_GET_RECORD_TYPE) {
+                // application data after all
+                rec->data.trim(n);
+                _eof |= n == 0;
+                return make_ready_future<buf_type>(std::move(rec->data));
+            }
+            auto type = *CMSG_DATA(cmsg);
+            auto alert = reinterpret_cast<const uint8_t*>(rec->data.get());
+            if (type == alert_record_type && n == 2) {
+                if (alert[1] == GNUTLS_A_CLOSE_NOTIFY) {
+                    _eof = true;
+                    return make_ready_future<buf_type>();
+                }
+                if (alert[0] == GNUTLS_AL_WARNING) {
+                    return do_get();
+                }
+                return make_exception_future<buf_type>(std::system_error(GNUTLS_E_FATAL_ALERT_RECEIVED, error_category()));
+            }
+            // Key updates or renegotiation: gnutls, that would know what to
+            // do, no longer has the keys
+            return make_exception_future<buf_type>(std::system_error(
+                    type == handshake_record_type ? GNUTLS_E_UNEXPECTED_HANDSHAKE_PACKET : GNUTLS_E_UNEXPECTED_PACKET, error_category()));
+        });
+    }
+    future<buf_type> do_get_offloaded() {
+        if (eof()) {
+            return make_ready_future<buf_type>();
+        }
+        return _in.get().then_wrapped([this] (future<buf_type> f) {
+            try {
+                auto buf = f.get();
+                _eof |= buf.empty();
+                return make_ready_future<buf_type>(std::move(buf));
+            } catch (const std::system_error& e) {
+                if (e.code() != std::error_code(EIO, std::system_category())) {
+                    throw;
+                }
+            }
+            return read_control_record();
+        }).handle_exception([this] (auto ep) {
+            _error = ep;
+            return make_exception_future<buf_type>(ep);
+        });
+    }
+
+    // gnutls_bye, once the kernel sends the records: the alert is a record
+    // type of its own, which sendmsg sets with a cmsg
+    future<> send_close_notify() {
+        struct alert_record {
+            uint8_t alert[2] = { GNUTLS_AL_WARNING, GNUTLS_A_CLOSE_NOTIFY };
+            iovec iov;
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))] = {};
+            msghdr hdr = {};
+        };
+        auto rec = std::make_unique<alert_record>();
+        rec->iov = {rec->alert, sizeof(rec->alert)};
+        rec->hdr.msg_iov = &rec->iov;
+        rec->hdr.msg_iovlen = 1;
+        rec->hdr.msg_control = rec->control;
+        rec->hdr.msg_controllen = sizeof(rec->control);
+        auto cmsg = CMSG_FIRSTHDR(&rec->hdr);
+        cmsg->cmsg_level = SOL_TLS;
+        cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+        *CMSG_DATA(cmsg) = alert_record_type;
+        auto hdr = &rec->hdr;
+        return _out.flush().then([this, hdr] {
+            return _fd->sendmsg(hdr);
+        }).then_wrapped([this, rec = std::move(rec)] (future<size_t> f) {
+            if (f.failed()) {
+                _error = f.get_exception();
+                return make_exception_future<>(_error);
+            }
+            return make_ready_future<>();
+        });
+    }
+
     size_t in_avail() const {
         return _input.size();
     }
@@ -1421,6 +1737,9 @@ class session : public enable_lw_shared_from_this<session> {
     }
 
     future<temporary_buffer<char>> do_get() {
+        if (_rx_offload) {
+            return do_get_offloaded();
+        }
         // gnutls might have stuff in its buffers.
         auto avail = gnutls_record_check_pending(*this);
         if (avail == 0) {
@@ -1440,6 +1759,11 @@ class session : public enable_lw_shared_from_this<session> {
                     // Our input buffer should be empty now, so just go again
                     return do_get();
                 case GNUTLS_E_REHANDSHAKE:
+                    if (_tx_offload) {
+                        // gnutls can no longer send records
+                        _error = std::make_exception_ptr(std::system_error(n, error_category()));
+                        return make_exception_future<temporary_buffer<char>>(_error);
+                    }
                     // server requests new HS. must release semaphore, so set new state
                     // and return nada.
                     _connected = false;
@@ -1453,6 +1777,7 @@ class session : public enable_lw_shared_from_this<session> {
             if (n == 0) {
                 _eof = true;
             }
+            maybe_cache_session();
             return make_ready_future<temporary_buffer<char>>(std::move(buf));
         }
         if (eof()) {
@@ -1500,6 +1825,14 @@ class session : public enable_lw_shared_from_this<session> {
                return put(std::move(p));
             });
         }
+        if (_tx_offload) {
+            return with_semaphore(_out_sem, 1, [this, p = std::move(p)] () mutable {
+                return _out.put(std::move(p));
+            }).handle_exception([this] (auto ep) {
+                _error = ep;
+                return make_exception_future<>(ep);
+            });
+        }
 
         // We want to make sure that we call gnutls_record_send with as large
         // packets as possible. This is because each call to gnutls_record_send
@@ -1533,6 +1866,12 @@ class session : public enable_lw_shared_from_this<session> {
         return n;
     }
     ssize_t vec_push(const giovec_t * iov, int iovcnt) {
+        if (_tx_offload) {
+            // The kernel has the write state, anything gnutls would send
+            // (a TLS 1.3 key update) would corrupt the stream
+            gnutls_transport_set_errno(*this, EIO);
+            return -1;
+        }
         if (!_output_pending.available()) {
             gnutls_transport_set_errno(*this, EAGAIN);
             return -1;
@@ -1594,6 +1933,9 @@ class session : public enable_lw_shared_from_this<session> {
         if (_error || !_connected) {
             return make_ready_future();
         }
+        if (_tx_offload) {
+            return send_close_notify();
+        }
         auto res = gnutls_bye(*this, GNUTLS_SHUT_WR);
         if (res < 0) {
             switch (res) {
@@ -1711,6 +2053,11 @@ class session : public enable_lw_shared_from_this<session> {
             return gnutls_session_is_resumed(*this) != 0;
         });
     }
+    future<kernel_offload> get_kernel_offload() {
+        return state_checked_access([this] {
+            return kernel_offload{.tx = _tx_offload, .rx = _rx_offload};
+        });
+    }
     future<session_data> get_session_resume_data() {
         return state_checked_access([this] {
             /**
@@ -1881,6 +2228,20 @@ class session : public enable_lw_shared_from_this<session> {
     future<> _output_pending;
     buf_type _input;
 
+    // Server name, or address, of a client session with a session cache
+    sstring _session_cache_key;
+    bool _session_cached = false;
+
+    // Set by offload_to_kernel
+    pollable_fd* _fd = nullptr;
+    bool _offload_tried = false;
+    bool _tx_offload = false;
+    bool _rx_offload = false;
+
+    // TLS record content types (RFC 8446, 5.1)
+    static constexpr uint8_t alert_record_type = 21;
+    static constexpr uint8_t handshake_record_type = 22;
+
     // modify this to a unique_ptr to handle exceptions in our constructor.
     std::unique_ptr<std::remove_pointer_t<gnutls_session_t>, void(*)(gnutls_session_t)> _session;
 };
@@ -1974,6 +2335,9 @@ class tls_connected_socket_impl : public net::connected_socket_impl, public sess
     future<session_data> get_session_resume_data() {
         return _session->get_session_resume_data();
     }
+    future<kernel_offload> get_kernel_offload() {
+        return _session->get_kernel_offload();
+    }
 };
 
 
@@ -2134,6 +2498,93 @@ server_socket tls::listen(shared_ptr<server_credentials> creds, server_socket ss
     return server_socket(std::move(ssls));
 }
 
+tls::client_session_cache::entry::entry(sstring server, session_data d)
+    : cache_entry<lru_eviction>(std::hash<sstring>()(server))
+    , _server(std::move(server))
+    , data(std::move(d))
+{}
+
+tls::client_session_cache::client_session_cache(size_t max_entries, lowres_clock::duration ttl)
+    : _ttl(ttl)
+    , _cache(cache_config{.capacity = max_entries}, [] (entry& e, cache_removal_cause) { delete &e; })
+{}
+
+tls::client_session_cache::~client_session_cache() = default;
+
+std::optional<tls::session_data> tls::client_session_cache::get(const sstring& server) {
+    auto e = _cache.find(server, std::hash<sstring>()(server));
+    if (!e) {
+        return std::nullopt;
+    }
+    return e->data;
+}
+
+void tls::client_session_cache::put(const sstring& server, session_data data) {
+    auto e = std::make_unique<entry>(server, std::move(data));
+    if (_cache.insert(*e, 1, lowres_clock::now() + _ttl)) {
+        e.release();
+    }
+}
+
+void tls::client_session_cache::erase(const sstring& server) {
+    auto e = _cache.peek(server, std::hash<sstring>()(server));
+    if (e) {
+        _cache.erase(*e);
+    }
+}
+
+void tls::client_session_cache::clear() noexcept {
+    _cache.clear();
+}
+
+tls::session_ticket_key_rotation::session_ticket_key_rotation(lowres_clock::duration interval, session_data initial_key)
+    : _interval(interval)
+    , _key(std::move(initial_key))
+    , _timer([this] {
+        (void)with_gate(_gate, [this] {
+            return rotate();
+        }).handle_exception([] (std::exception_ptr) {
+            // keep the current key until the next interval
+        });
+    })
+{
+    if (this_shard_id() == 0) {
+        _timer.arm_periodic(_interval);
+    }
+}
+
+tls::session_ticket_key_rotation::~session_ticket_key_rotation() = default;
+
+tls::session_data tls::session_ticket_key_rotation::generate_key() {
+    gnutls_datum key;
+    gtls_chk(gnutls_session_ticket_key_generate(&key));
+    return session_data(key.data, key.data + key.size);
+}
+
+void tls::session_ticket_key_rotation::set_key(const session_data& key) {
+    _key = key;
+    for (auto& c : _creds) {
+        c->_impl->set_session_resume_mode(session_resume_mode::TLS13_SESSION_TICKET, std::span{_key.begin(), _key.end()});
+    }
+}
+
+void tls::session_ticket_key_rotation::add(shared_ptr<server_credentials> creds) {
+    creds->_impl->_session_resume_key_rotated = true;
+    _creds.push_back(std::move(creds));
+    set_key(_key);
+}
+
+future<> tls::session_ticket_key_rotation::rotate() {
+    return container().invoke_on_all([key = generate_key()] (session_ticket_key_rotation& r) {
+        r.set_key(key);
+    });
+}
+
+future<> tls::session_ticket_key_rotation::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
 static tls::tls_connected_socket_impl* get_tls_socket(connected_socket& socket) {
     auto impl = net::get_impl::maybe_get_ptr(socket);
     if (impl == nullptr) {
@@ -2168,6 +2619,10 @@ future<tls::session_data> tls::get_session_resume_data(connected_socket& socket)
     return get_tls_socket(socket)->get_session_resume_data();
 }
 
+future<tls::kernel_offload> tls::get_kernel_offload(connected_socket& socket) {
+    return get_tls_socket(socket)->get_kernel_offload();
+}
+
 std::string_view tls::format_as(subject_alt_name_type type) {
     switch (type) {
         case subject_alt_name_type::dnsname:
@@ -0,0 +1,338 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/rpc/zstd_compressor.hh>
+#include <seastar/core/format.hh>
+
+#include <span>
+#include <stdexcept>
+
+#include <zstd.h>
+#include <zdict.h>
+
+namespace seastar {
+namespace rpc {
+
+namespace {
+
+struct cctx_deleter {
+    void operator()(ZSTD_CCtx* ctx) const noexcept {
+        ZSTD_freeCCtx(ctx);
+    }
+};
+
+struct dctx_deleter {
+    void operator()(ZSTD_DCtx* ctx) const noexcept {
+        ZSTD_freeDCtx(ctx);
+    }
+};
+
+struct cdict_deleter {
+    void operator()(ZSTD_CDict* dict) const noexcept {
+        ZSTD_freeCDict(dict);
+    }
+};
+
+struct ddict_deleter {
+    void operator()(ZSTD_DDict* dict) const noexcept {
+        ZSTD_freeDDict(dict);
+    }
+};
+
+size_t check(size_t ret, const char* what) {
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(format("RPC frame ZSTD {} failure: {}", what, ZSTD_getErrorName(ret)));
+    }
+    return ret;
+}
+
+// Contexts are reset before every frame, so one of each per shard is
+// enough; they are expensive to create and hold large work areas.
+ZSTD_CCtx* compression_context() {
+    static thread_local auto ctx = std::unique_ptr<ZSTD_CCtx, cctx_deleter>(ZSTD_createCCtx());
+    if (!ctx) {
+        throw std::bad_alloc();
+    }
+    return ctx.get();
+}
+
+ZSTD_DCtx* decompression_context() {
+    static thread_local auto ctx = std::unique_ptr<ZSTD_DCtx, dctx_deleter>(ZSTD_createDCtx());
+    if (!ctx) {
+        throw std::bad_alloc();
+    }
+    return ctx.get();
+}
+
+using buffers = std::variant<std::vector<temporary_buffer<char>>, temporary_buffer<char>>;
+
+std::span<temporary_buffer<char>> fragments(buffers& bufs) {
+    if (auto b = std::get_if<temporary_buffer<char>>(&bufs)) {
+        return {b, 1};
+    }
+    auto& v = std::get<std::vector<temporary_buffer<char>>>(bufs);
+    return {v.data(), v.size()};
+}
+
+sstring dictionary_feature(const zstd_compressor::dictionary& dict) {
+    return format("ZSTD_DICT_{}", dict.id());
+}
+
+const sstring plain_feature = "ZSTD";
+
+}
+
+struct zstd_compressor::dictionary::impl {
+    uint32_t id;
+    int level;
+    std::unique_ptr<ZSTD_CDict, cdict_deleter> cdict;
+    std::unique_ptr<ZSTD_DDict, ddict_deleter> ddict;
+};
+
+zstd_compressor::dictionary::dictionary(std::string_view data, int level)
+        : _impl(std::make_unique<impl>()) {
+    _impl->id = ZSTD_getDictID_fromDict(data.data(), data.size());
+    if (!_impl->id) {
+        // Raw content dictionaries carry no id, derive one (FNV-1a) so
+        // that peers can still tell whether they have the same one
+        uint32_t h = 2166136261u;
+        for (unsigned char c : data) {
+            h = (h ^ c) * 16777619u;
+        }
+        _impl->id = h;
+    }
+    _impl->level = level;
+    _impl->cdict.reset(ZSTD_createCDict(data.data(), data.size(), level));
+    _impl->ddict.reset(ZSTD_createDDict(data.data(), data.size()));
+    if (!_impl->cdict || !_impl->ddict) {
+        throw std::runtime_error("Failed to load ZSTD dictionary");
+    }
+}
+
+zstd_compressor::dictionary::~dictionary() = default;
+
+uint32_t zstd_compressor::dictionary::id() const noexcept {
+    return _impl->id;
+}
+
+int zstd_compressor::dictionary::level() const noexcept {
+    return _impl->level;
+}
+
+sstring zstd_compressor::dictionary::train(const std::vector<temporary_buffer<char>>& samples, size_t max_size) {
+    std::vector<char> concatenated;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (auto& s : samples) {
+        concatenated.insert(concatenated.end(), s.begin(), s.end());
+        sizes.push_back(s.size());
+    }
+    auto dict = uninitialized_string(max_size);
+    auto ret = ZDICT_trainFromBuffer(dict.data(), dict.size(), concatenated.data(), sizes.data(), sizes.size());
+    if (ZDICT_isError(ret)) {
+        throw std::runtime_error(format("Failed to train ZSTD dictionary: {}", ZDICT_getErrorName(ret)));
+    }
+    dict.resize(ret);
+    return dict;
+}
+
+zstd_compressor::factory::factory(int level)
+        : _level(level)
+        , _name(plain_feature) {
+}
+
+zstd_compressor::factory::factory(std::shared_ptr<const dictionary> dict)
+        : _level(dict->level())
+        , _dict(std::move(dict))
+        , _name(dictionary_feature(*_dict)) {
+}
+
+const sstring& zstd_compressor::factory::supported() const {
+    return _name;
+}
+
+std::unique_ptr<rpc::compressor> zstd_compressor::factory::negotiate(sstring feature, bool is_server) const {
+    if (feature == _name) {
+        return _dict ? std::make_unique<zstd_compressor>(_dict) : std::make_unique<zstd_compressor>(_level);
+    }
+    if (_dict && feature == plain_feature) {
+        return std::make_unique<zstd_compressor>(_level);
+    }
+    return nullptr;
+}
+
+zstd_compressor::zstd_compressor(int level)
+        : _level(level) {
+}
+
+zstd_compressor::zstd_compressor(std::shared_ptr<const dictionary> dict)
+        : _level(dict->level())
+        , _dict(std::move(dict)) {
+}
+
+sstring zstd_compressor::name() const {
+    return _dict ? dictionary_feature(*_dict) : plain_feature;
+}
+
+snd_buf zstd_compressor::compress(size_t head_space, snd_buf data) {
+    auto cctx = compression_context();
+    check(ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters), "reset");
+    if (_dict) {
+        check(ZSTD_CCtx_refCDict(cctx, _dict->_impl->cdict.get()), "dictionary");
+    } else {
+        check(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, _level), "level");
+    }
+
+    auto src = fragments(data.bufs);
+    size_t size = data.size;
+    auto bound = ZSTD_compressBound(size);
+
+    if (src.size() <= 1 && head_space + bound <= snd_buf::chunk_size) {
+        // faster path for small messages
+        auto dst = temporary_buffer<char>(head_space + bound);
+        auto compressed_size = check(ZSTD_compress2(cctx, dst.get_write() + head_space, bound,
+                src.empty() ? nullptr : src.front().get(), size), "compression");
+        dst.trim(head_space + compressed_size);
+        return snd_buf(std::move(dst));
+    }
+
+    // Feed the source fragments to the streaming interface as they are,
+    // and let it fill snd_buf::chunk_size destination fragments.
+    check(ZSTD_CCtx_setPledgedSrcSize(cctx, size), "compression");
+    std::vector<temporary_buffer<char>> dst_buffers;
+    dst_buffers.emplace_back(std::max(std::min(head_space + bound, snd_buf::chunk_size), head_space + 1));
+    ZSTD_outBuffer out{dst_buffers.back().get_write(), dst_buffers.back().size(), head_space};
+    size_t total_compressed_size = 0;
+
+    auto next_dst = [&] {
+        total_compressed_size += out.pos;
+        dst_buffers.emplace_back(snd_buf::chunk_size);
+        out = {dst_buffers.back().get_write(), dst_buffers.back().size(), 0};
+    };
+
+    size_t src_left = size;
+    for (auto& frag : src) {
+        ZSTD_inBuffer in{frag.get(), std::min(frag.size(), src_left), 0};
+        src_left -= in.size;
+        auto mode = src_left ? ZSTD_e_continue : ZSTD_e_end;
+        size_t remaining;
+        do {
+            if (out.pos == out.size) {
+                next_dst();
+            }
+            remaining = check(ZSTD_compressStream2(cctx, &out, &in, mode), "compression");
+        } while (mode == ZSTD_e_end ? remaining != 0 : in.pos != in.size);
+        if (!src_left) {
+            break;
+        }
+    }
+
+    dst_buffers.back().trim(out.pos);
+    total_compressed_size += out.pos;
+
+    if (dst_buffers.size() == 1) {
+        return snd_buf(std::move(dst_buffers.front()));
+    }
+    return snd_buf(std::move(dst_buffers), total_compressed_size);
+}
+
+rcv_buf zstd_compressor::decompress(rcv_buf data) {
+    if (data.size == 0) {
+        return rcv_buf();
+    }
+
+    auto dctx = decompression_context();
+    check(ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters), "reset");
+    if (_dict) {
+        check(ZSTD_DCtx_refDDict(dctx, _dict->_impl->ddict.get()), "dictionary");
+    }
+
+    auto src = fragments(data.bufs);
+
+    if (src.size() == 1) {
+        // faster path for small messages: the content size is in the
+        // frame header, decompress straight into a buffer of that size
+        auto content_size = ZSTD_getFrameContentSize(src.front().get(), data.size);
+        if (content_size <= snd_buf::chunk_size) {
+            auto dst = temporary_buffer<char>(content_size);
+            auto size = check(ZSTD_decompressDCtx(dctx, dst.get_write(), dst.size(), src.front().get(), data.size), "decompression");
+            if (size != content_size) {
+                throw std::runtime_error("RPC frame ZSTD decompression failure: size mismatch");
+            }
+            return rcv_buf(std::move(dst));
+        }
+    }
+
+    std::vector<temporary_buffer<char>> dst_buffers;
+    ZSTD_outBuffer out{nullptr, 0, 0};
+    size_t total_size = 0;
+
+    auto next_dst = [&] {
+        total_size += out.pos;
+        dst_buffers.emplace_back(snd_buf::chunk_size);
+        out = {dst_buffers.back().get_write(), dst_buffers.back().size(), 0};
+    };
+
+    size_t src_left = data.size;
+    size_t remaining = 1;
+    for (auto& frag : src) {
+        ZSTD_inBuffer in{frag.get(), std::min(frag.size(), src_left), 0};
+        src_left -= in.size;
+        while (in.pos != in.size) {
+            if (remaining == 0) {
+                throw std::runtime_error("RPC frame ZSTD decompression failure: trailing data");
+            }
+            if (out.pos == out.size) {
+                next_dst();
+            }
+            remaining = check(ZSTD_decompressStream(dctx, &out, &in), "decompression");
+        }
+        if (!src_left) {
+            break;
+        }
+    }
+    // All input is consumed, flush what the context still holds
+    while (remaining != 0) {
+        if (out.pos == out.size) {
+            next_dst();
+        }
+        auto pos = out.pos;
+        ZSTD_inBuffer in{nullptr, 0, 0};
+        remaining = check(ZSTD_decompressStream(dctx, &out, &in), "decompression");
+        if (remaining != 0 && out.pos == pos) {
+            throw std::runtime_error("RPC frame ZSTD decompression failure: truncated frame");
+        }
+    }
+
+    dst_buffers.back().trim(out.pos);
+    total_size += out.pos;
+    if (dst_buffers.back().empty() && dst_buffers.size() > 1) {
+        dst_buffers.pop_back();
+    }
+
+    if (dst_buffers.size() == 1) {
+        return rcv_buf(std::move(dst_buffers.front()));
+    }
+    return rcv_buf(std::move(dst_buffers), total_size);
+}
+
+}
+}
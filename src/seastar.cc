@@ -130,6 +130,7 @@ module;
 #include <linux/fs.h>
 #include <linux/perf_event.h>
 #include <arpa/inet.h>
+#include <netinet/tcp.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <sys/inotify.h>
@@ -176,6 +177,7 @@ export module seastar;
 #include <seastar/core/circular_buffer_fixed_capacity.hh>
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/cpu_profiler.hh>
 #include <seastar/core/deleter.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/do_with.hh>
@@ -192,6 +194,7 @@ export module seastar;
 #include <seastar/core/future-util.hh>
 #include <seastar/core/gate.hh>
 #include <seastar/core/idle_cpu_handler.hh>
+#include <seastar/core/interned_string.hh>
 #include <seastar/core/iostream.hh>
 #include <seastar/core/iostream-impl.hh>
 #include <seastar/core/io_intent.hh>
@@ -208,6 +211,7 @@ export module seastar;
 #include <seastar/core/metrics_api.hh>
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/metrics_types.hh>
+#include <seastar/core/native_histogram.hh>
 #include <seastar/core/pipe.hh>
 #include <seastar/core/polymorphic_temporary_buffer.hh>
 #include <seastar/core/posix.hh>
@@ -231,6 +235,7 @@ export module seastar;
 #include <seastar/core/seastar.hh>
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/sharded_cache.hh>
 #include <seastar/core/shared_future.hh>
 #include <seastar/core/shared_mutex.hh>
 #include <seastar/core/shared_ptr.hh>
@@ -285,8 +290,10 @@ export module seastar;
 #include <seastar/net/posix-stack.hh>
 #include <seastar/net/socket_defs.hh>
 #include <seastar/net/tcp.hh>
+#include <seastar/net/tcp-congestion.hh>
 #include <seastar/net/udp.hh>
 #include <seastar/net/tls.hh>
+#include <seastar/net/tls_resumption.hh>
 
 #include <seastar/http/common.hh>
 #include <seastar/http/client.hh>
@@ -298,6 +305,7 @@ export module seastar;
 #include <seastar/http/response_parser.hh>
 #include <seastar/http/request.hh>
 #include <seastar/http/routes.hh>
+#include <seastar/http/simd_request_parser.hh>
 #include <seastar/http/transformers.hh>
 
 #include <seastar/json/formatter.hh>
@@ -309,6 +317,7 @@ module : private;
 #include <seastar/core/internal/buffer_allocator.hh>
 #include <seastar/core/internal/io_intent.hh>
 #include <seastar/core/internal/stall_detector.hh>
+#include <seastar/core/internal/cpu_profiler.hh>
 #include <seastar/core/internal/uname.hh>
 
 #include "core/cgroup.hh"
@@ -338,3 +347,4 @@ module : private;
 
 #include <seastar/http/url.hh>
 #include <seastar/http/internal/content_source.hh>
+#include <seastar/http/internal/route_tree.hh>
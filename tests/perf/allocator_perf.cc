@@ -22,6 +22,7 @@
 #include <seastar/testing/perf_tests.hh>
 
 #include <seastar/core/memory.hh>
+#include <seastar/core/smp.hh>
 #include <sys/mman.h>
 
 struct alloc_bench {
@@ -153,6 +154,29 @@ PERF_TEST_F(alloc_bench, single_alloc_and_free_small_many_cross_page_alloc_more)
     }
 }
 
+// Free objects allocated on another shard. Each free is routed back to the
+// owning shard, so this measures the cross-shard free path (batched into the
+// per-destination magazines) plus the cost of flushing them to the owner.
+PERF_TEST_F(alloc_bench, cross_shard_free)
+{
+    if (seastar::smp::count < 2) {
+        return seastar::make_ready_future<size_t>(0);
+    }
+    return seastar::smp::submit_to(1, [this] {
+        for (auto& p : _pointers) {
+            p = malloc(small_alloc_size);
+        }
+    }).then([this] {
+        perf_tests::start_measuring_time();
+        for (auto& p : _pointers) {
+            free(p);
+        }
+        seastar::memory::drain_cross_cpu_freelist();
+        perf_tests::stop_measuring_time();
+        return _pointers.size();
+    });
+}
+
 template <typename DistType>
 static size_t dist_bench() {
     std::random_device rd_device;
@@ -0,0 +1,98 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/net/ip_checksum.hh>
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/testing/random.hh>
+
+#include <fmt/core.h>
+
+using namespace seastar;
+
+// Each test checksums a batch of fragments of a given size and returns
+// the number of bytes processed, so the reported time is per byte and
+// its inverse is the throughput in GB/s.
+struct checksum {
+    static constexpr size_t buffer_size = 1 << 20;
+
+    std::vector<char> _src;
+    std::vector<char> _dst;
+
+    checksum() : _src(buffer_size), _dst(buffer_size) {
+        std::uniform_int_distribution<int> dist(0, 255);
+        for (auto& c : _src) {
+            c = dist(testing::local_random_engine);
+        }
+        fmt::print("checksum kernel: {}\n", internal::checksum_kernel_name());
+    }
+
+    template <size_t FragmentSize>
+    size_t sum() {
+        size_t n = 0;
+        for (size_t off = 0; off + FragmentSize <= buffer_size; off += FragmentSize) {
+            net::checksummer csum;
+            csum.sum(_src.data() + off, FragmentSize);
+            perf_tests::do_not_optimize(csum.get());
+            n += FragmentSize;
+        }
+        return n;
+    }
+
+    template <size_t FragmentSize>
+    size_t copy_and_sum() {
+        size_t n = 0;
+        for (size_t off = 0; off + FragmentSize <= buffer_size; off += FragmentSize) {
+            net::checksummer csum;
+            csum.copy_and_sum(_dst.data() + off, _src.data() + off, FragmentSize);
+            perf_tests::do_not_optimize(csum.get());
+            n += FragmentSize;
+        }
+        return n;
+    }
+
+    // The unfused baseline for copy_and_sum()
+    template <size_t FragmentSize>
+    size_t copy_then_sum() {
+        size_t n = 0;
+        for (size_t off = 0; off + FragmentSize <= buffer_size; off += FragmentSize) {
+            net::checksummer csum;
+            std::copy_n(_src.data() + off, FragmentSize, _dst.data() + off);
+            csum.sum(_dst.data() + off, FragmentSize);
+            perf_tests::do_not_optimize(csum.get());
+            n += FragmentSize;
+        }
+        return n;
+    }
+};
+
+PERF_TEST_F(checksum, sum_64) { return sum<64>(); }
+PERF_TEST_F(checksum, sum_576) { return sum<576>(); }
+PERF_TEST_F(checksum, sum_1460) { return sum<1460>(); }
+PERF_TEST_F(checksum, sum_9000) { return sum<9000>(); }
+PERF_TEST_F(checksum, sum_65536) { return sum<65536>(); }
+
+PERF_TEST_F(checksum, copy_and_sum_64) { return copy_and_sum<64>(); }
+PERF_TEST_F(checksum, copy_and_sum_1460) { return copy_and_sum<1460>(); }
+PERF_TEST_F(checksum, copy_and_sum_65536) { return copy_and_sum<65536>(); }
+
+PERF_TEST_F(checksum, copy_then_sum_64) { return copy_then_sum<64>(); }
+PERF_TEST_F(checksum, copy_then_sum_1460) { return copy_then_sum<1460>(); }
+PERF_TEST_F(checksum, copy_then_sum_65536) { return copy_then_sum<65536>(); }
@@ -25,6 +25,12 @@
 #include <seastar/testing/perf_tests.hh>
 #include <seastar/core/chunked_fifo.hh>
 #include <seastar/core/circular_buffer.hh>
+#include <seastar/core/interned_string.hh>
+#include <seastar/core/memory.hh>
+#include <seastar/core/sstring.hh>
+#include <fmt/core.h>
+#include <unordered_set>
+#include <utility>
 
 using trivial_elem = int;
 
@@ -233,3 +239,80 @@ PERF_TEST_F(container_perf, iter_small_boost_deque) {
     return iteration_bench<boost_deque_traits>(small_size);
 }
 
+static constexpr size_t nr_string_keys = 10000;
+
+// String keys too long for the internal buffer of sstring, like the keys
+// of a cache or the names of a metric registry
+struct string_keys {
+    std::vector<sstring> keys;
+    std::unordered_set<sstring> sstring_set;
+    string_pool pool;
+    std::vector<interned_string> interned;
+    std::unordered_set<interned_string> interned_set;
+
+    string_keys() {
+        keys.reserve(nr_string_keys);
+        for (size_t i = 0; i < nr_string_keys; i++) {
+            keys.push_back(format("user:{:08}:session:{:08x}", i, uint32_t(i * 2654435761u)));
+        }
+        // Only meaningful with the seastar allocator
+        auto before = memory::stats().allocated_memory();
+        sstring_set = {keys.begin(), keys.end()};
+        auto sstring_bytes = memory::stats().allocated_memory() - before;
+        before = memory::stats().allocated_memory();
+        for (auto& k : keys) {
+            interned_set.insert(pool.intern(k));
+        }
+        auto interned_bytes = memory::stats().allocated_memory() - before;
+        // The fixture is constructed for every test using it, print once
+        static bool printed = false;
+        if (!std::exchange(printed, true)) {
+            fmt::print("memory per key: unordered_set<sstring> {:.1f} bytes, unordered_set<interned_string> {:.1f} bytes (string_pool {:.1f})\n",
+                    double(sstring_bytes) / nr_string_keys, double(interned_bytes) / nr_string_keys,
+                    double(pool.memory_used()) / nr_string_keys);
+        }
+        interned.assign(interned_set.begin(), interned_set.end());
+    }
+};
+
+PERF_TEST_F(string_keys, insert_sstring_set) {
+    std::unordered_set<sstring> set;
+    perf_tests::start_measuring_time();
+    for (auto& k : keys) {
+        set.insert(k);
+    }
+    perf_tests::stop_measuring_time();
+    return keys.size();
+}
+
+PERF_TEST_F(string_keys, insert_interned_set) {
+    string_pool p;
+    std::unordered_set<interned_string> set;
+    perf_tests::start_measuring_time();
+    for (auto& k : keys) {
+        set.insert(p.intern(k));
+    }
+    perf_tests::stop_measuring_time();
+    return keys.size();
+}
+
+PERF_TEST_F(string_keys, find_sstring_set) {
+    for (auto& k : keys) {
+        perf_tests::do_not_optimize(sstring_set.find(k));
+    }
+    return keys.size();
+}
+
+PERF_TEST_F(string_keys, find_interned_set) {
+    for (auto& k : interned) {
+        perf_tests::do_not_optimize(interned_set.find(k));
+    }
+    return interned.size();
+}
+
+PERF_TEST_F(string_keys, intern_existing) {
+    for (auto& k : keys) {
+        perf_tests::do_not_optimize(pool.intern(k));
+    }
+    return keys.size();
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/net/api.hh>
+#include <seastar/net/inet_address.hh>
+
+using namespace seastar;
+
+// Each iteration sends a burst of small datagrams over loopback and receives
+// them back, the reported time per iteration is thus the cost of a single
+// datagram round through the stack and the result can be read as packets/s.
+struct datagram_perf {
+    // Small enough to fit in the default socket receive buffer, so that
+    // loopback never drops datagrams
+    static constexpr size_t burst = 64;
+    static constexpr size_t datagram_size = 64;
+
+    net::datagram_channel _server;
+    net::datagram_channel _client;
+    char _payload[datagram_size] = {};
+
+    datagram_perf()
+        : _server(make_bound_datagram_channel(ipv4_addr("127.0.0.1", 0)))
+        , _client(make_bound_datagram_channel(ipv4_addr("127.0.0.1", 0)))
+    { }
+
+    ~datagram_perf() {
+        _client.close();
+        _server.close();
+    }
+
+    net::packet payload() const {
+        return net::packet::from_static_data(_payload, datagram_size);
+    }
+
+    future<> receive_single(size_t n) {
+        while (n--) {
+            auto d = co_await _server.receive();
+            perf_tests::do_not_optimize(d.get_data().len());
+        }
+    }
+
+    future<> receive_batched(size_t n) {
+        while (n) {
+            auto batch = co_await _server.receive_batch(n);
+            perf_tests::do_not_optimize(batch.front().get_data().len());
+            n -= batch.size();
+        }
+    }
+};
+
+PERF_TEST_CN(datagram_perf, single) {
+    for (size_t i = 0; i < burst; i++) {
+        co_await _client.send(_server.local_address(), payload());
+    }
+    co_await receive_single(burst);
+    co_return burst;
+}
+
+PERF_TEST_CN(datagram_perf, batched) {
+    std::vector<net::outgoing_datagram> out;
+    out.reserve(burst);
+    for (size_t i = 0; i < burst; i++) {
+        out.push_back({_server.local_address(), payload()});
+    }
+    co_await _client.send_batch(std::move(out));
+    co_await receive_batched(burst);
+    co_return burst;
+}
+
+PERF_TEST_CN(datagram_perf, batched_receive_only) {
+    for (size_t i = 0; i < burst; i++) {
+        co_await _client.send(_server.local_address(), payload());
+    }
+    co_await receive_batched(burst);
+    co_return burst;
+}
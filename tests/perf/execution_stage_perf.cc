@@ -0,0 +1,139 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+/*
+ * Runs a skewed load through an execution stage: shard 0 has --concurrency
+ * fibers calling a CPU bound function through the stage, the other shards
+ * only --background ones. Reports the latency of the calls made on shard 0
+ * with a plain execution stage and with a stealable one, which lets the
+ * mostly idle shards execute batches queued on shard 0.
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/execution_stage.hh>
+#include <seastar/core/native_histogram.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/coroutine/parallel_for_each.hh>
+#include <seastar/util/closeable.hh>
+#include <fmt/core.h>
+#include <chrono>
+#include <ranges>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+using clock_type = std::chrono::steady_clock;
+
+// Spins for the given number of nanoseconds
+uint64_t work(uint64_t ns) {
+    auto end = clock_type::now() + std::chrono::nanoseconds(ns);
+    uint64_t iterations = 0;
+    while (clock_type::now() < end) {
+        iterations++;
+    }
+    return iterations;
+}
+
+class skewed_load {
+    concrete_execution_stage<uint64_t, uint64_t> _plain{"plain", work};
+    stealable_concrete_execution_stage<uint64_t, uint64_t> _stealable{"stealable", work};
+    metrics::native_histogram<4> _latencies;
+    uint64_t _calls = 0;
+
+    template <typename Stage>
+    future<> client(Stage& stage, clock_type::time_point end, uint64_t ns) {
+        while (clock_type::now() < end) {
+            auto start = clock_type::now();
+            co_await stage(ns);
+            _latencies.add((clock_type::now() - start) / 1ns);
+            _calls++;
+        }
+    }
+public:
+    struct result {
+        metrics::native_histogram<4> latencies;
+        uint64_t calls;
+        uint64_t stolen;
+    };
+
+    future<result> run(bool stealable, unsigned fibers, clock_type::duration duration, uint64_t ns) {
+        _latencies.clear();
+        _calls = 0;
+        auto stolen = _stealable.function_calls_stolen();
+        auto end = clock_type::now() + duration;
+        co_await coroutine::parallel_for_each(std::views::iota(0u, fibers), [&] (unsigned) {
+            return stealable ? client(_stealable, end, ns) : client(_plain, end, ns);
+        });
+        co_return result{_latencies, _calls, _stealable.function_calls_stolen() - stolen};
+    }
+
+    future<> stop() {
+        return make_ready_future<>();
+    }
+};
+
+int main(int ac, char** av) {
+    app_template at;
+    namespace bpo = boost::program_options;
+    at.add_options()
+            ("concurrency", bpo::value<unsigned>()->default_value(1024), "Number of fibers calling the stage on shard 0")
+            ("background", bpo::value<unsigned>()->default_value(1), "Number of fibers calling the stage on the other shards")
+            ("work-us", bpo::value<unsigned>()->default_value(5), "CPU time taken by a call, in microseconds")
+            ("duration", bpo::value<unsigned>()->default_value(5), "Duration of each run, in seconds")
+            ;
+    return at.run(ac, av, [&at] {
+        return seastar::async([&at] {
+            auto& opts = at.configuration();
+            auto concurrency = opts["concurrency"].as<unsigned>();
+            auto background = opts["background"].as<unsigned>();
+            auto ns = uint64_t(opts["work-us"].as<unsigned>()) * 1000;
+            auto duration = std::chrono::seconds(opts["duration"].as<unsigned>());
+
+            sharded<skewed_load> loads;
+            loads.start().get();
+            auto stop_loads = deferred_stop(loads);
+
+            fmt::print("{} shards, {} fibers on shard 0, {} on the others, {}us per call\n",
+                    smp::count, concurrency, background, ns / 1000);
+            fmt::print("{:>10} {:>12} {:>10} {:>10} {:>10} {:>12}\n", "stage", "calls/s", "p50 us", "p99 us", "max us", "stolen calls");
+            for (bool stealable : {false, true}) {
+                std::vector<skewed_load::result> results(smp::count);
+                loads.invoke_on_all([&] (skewed_load& l) -> future<> {
+                    auto fibers = this_shard_id() == 0 ? concurrency : background;
+                    results[this_shard_id()] = co_await l.run(stealable, fibers, duration, ns);
+                }).get();
+                auto& r = results[0];
+                uint64_t stolen = 0;
+                for (auto& o : results) {
+                    stolen += o.stolen;
+                }
+                auto us = [] (uint64_t ns) {
+                    return ns / 1000.0;
+                };
+                fmt::print("{:>10} {:>12.0f} {:>10.1f} {:>10.1f} {:>10.1f} {:>12}\n", stealable ? "stealable" : "plain",
+                        r.calls / std::chrono::duration<double>(duration).count(),
+                        us(r.latencies.quantile(0.5)), us(r.latencies.quantile(0.99)), us(r.latencies.quantile(1.0)), stolen);
+            }
+        });
+    });
+}
@@ -27,6 +27,11 @@
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/core/when_all.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/util/later.hh>
+#include <fmt/core.h>
+#include <algorithm>
+#include <optional>
 #include <ranges>
 
 static constexpr fair_queue::class_id cid = 0;
@@ -141,3 +146,131 @@ PERF_TEST_F(perf_fair_queue, contended_shared)
 {
     return test(false);
 }
+
+// Two classes with equal shares share a simulated disk that serves requests
+// one by one. The "mixed" class queues three compaction-sized writes followed
+// by a read due shortly, the "batch" class queues writes only. Time is
+// virtual and counted in read service times, so the results don't depend on
+// the machine. On destruction the fixture reports how late the reads were
+// with and without deadline dispatch, and which part of the disk the mixed
+// class got by the time half of the requests were served.
+struct perf_fair_queue_deadlines {
+    static constexpr unsigned rounds = 250;
+    static constexpr unsigned writes_per_round = 3;
+    static constexpr unsigned write_to_read_ratio = 8;
+    // Time to serve one round of both classes
+    static constexpr unsigned round_time = 2 * (writes_per_round * write_to_read_ratio + 1);
+    static constexpr unsigned read_slack = 10;
+
+    static constexpr fair_queue::class_id mixed = 0;
+    static constexpr fair_queue::class_id batch = 1;
+
+    struct sim_entry {
+        fair_queue_entry ent;
+        fair_queue::class_id cls;
+        std::optional<unsigned> read;
+
+        sim_entry(fair_queue_entry::capacity_t cap, fair_queue_entry::clock_type::time_point deadline, fair_queue::class_id c, std::optional<unsigned> r)
+            : ent(cap, deadline), cls(c), read(r) {}
+    };
+
+    struct results {
+        std::vector<double> lateness;
+        double mixed_share = 0;
+    };
+
+    seastar::fair_group fg;
+    results fifo;
+    results edf;
+
+    static fair_group::config fg_config() {
+        fair_group::config cfg;
+        return cfg;
+    }
+
+    perf_fair_queue_deadlines()
+        : fg(fg_config(), 1)
+    {}
+
+    ~perf_fair_queue_deadlines() {
+        report("fifo", fifo);
+        report("deadline", edf);
+    }
+
+    static void report(const char* name, results& res) {
+        if (res.lateness.empty()) {
+            return;
+        }
+        auto& l = res.lateness;
+        std::sort(l.begin(), l.end());
+        auto q = [&l] (double q) { return l[std::min<size_t>(q * l.size(), l.size() - 1)]; };
+        auto misses = std::count_if(l.begin(), l.end(), [] (double v) { return v > 0; });
+        fmt::print("{:>8}: read lateness p50 {:.1f} p99 {:.1f} max {:.1f}, {:.1f}% missed, mixed class share {:.2f}\n",
+                name, q(0.5), q(0.99), l.back(), 100.0 * misses / l.size(), res.mixed_share);
+        l.clear();
+    }
+
+    future<> test(bool deadline_dispatch);
+};
+
+future<> perf_fair_queue_deadlines::test(bool deadline_dispatch) {
+    fair_queue::config cfg;
+    cfg.deadline_dispatch = deadline_dispatch;
+    fair_queue fq(fg, cfg);
+    fq.register_priority_class(mixed, 100);
+    fq.register_priority_class(batch, 100);
+
+    auto read_cap = fq.tokens_capacity(double(1) / std::numeric_limits<int>::max());
+    auto write_cap = read_cap * write_to_read_ratio;
+    auto base = fair_queue_entry::clock_type::now();
+    unsigned total = 0;
+
+    for (unsigned r = 0; r < rounds; r++) {
+        for (unsigned w = 0; w < writes_per_round; w++) {
+            fq.queue(mixed, (new sim_entry(write_cap, fair_queue_entry::no_deadline, mixed, std::nullopt))->ent);
+            fq.queue(batch, (new sim_entry(write_cap, fair_queue_entry::no_deadline, batch, std::nullopt))->ent);
+        }
+        // One virtual time unit is mapped on a microsecond
+        auto due = base + std::chrono::microseconds(r * round_time + read_slack);
+        fq.queue(mixed, (new sim_entry(read_cap, due, mixed, r))->ent);
+        fq.queue(batch, (new sim_entry(read_cap, fair_queue_entry::no_deadline, batch, std::nullopt))->ent);
+        total += 2 * (writes_per_round + 1);
+    }
+
+    auto& res = deadline_dispatch ? edf : fifo;
+    fair_queue_entry::capacity_t served = 0;
+    fair_queue_entry::capacity_t mixed_served = 0;
+    const fair_queue_entry::capacity_t half = fair_queue_entry::capacity_t(rounds) * round_time * read_cap / 2;
+    unsigned dispatched = 0;
+
+    while (dispatched < total) {
+        fq.dispatch_requests([&] (fair_queue_entry& ent) {
+            auto se = boost::intrusive::get_parent_from_member(&ent, &sim_entry::ent);
+            served += ent.capacity();
+            if (se->cls == mixed && served <= half) {
+                mixed_served += ent.capacity();
+            }
+            if (se->read) {
+                double now = double(served) / read_cap;
+                res.lateness.push_back(now - (*se->read * round_time + read_slack));
+            }
+            fq.notify_request_finished(ent.capacity());
+            dispatched++;
+            delete se;
+        });
+        co_await yield();
+    }
+    res.mixed_share = double(mixed_served) / half;
+
+    fq.unregister_priority_class(mixed);
+    fq.unregister_priority_class(batch);
+}
+
+PERF_TEST_F(perf_fair_queue_deadlines, fifo_reads)
+{
+    return test(false);
+}
+PERF_TEST_F(perf_fair_queue_deadlines, deadline_reads)
+{
+    return test(true);
+}
@@ -25,22 +25,169 @@
 #include <seastar/core/app-template.hh>
 #include <seastar/core/do_with.hh>
 #include <seastar/core/loop.hh>
+#include <seastar/core/memory.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/when_all.hh>
+#include <seastar/util/closeable.hh>
 #include <fmt/printf.h>
+#include <random>
 #include <string>
 
 using namespace seastar;
 using namespace std::chrono_literals;
 
+struct mixed_read_config {
+    uint64_t file_size;
+    unsigned scanners;
+    uint64_t scan_size;
+    unsigned point_readers;
+    size_t point_read_size;
+    unsigned read_ahead;
+    std::chrono::seconds duration;
+};
+
+struct mixed_read_result {
+    uint64_t scanned_bytes = 0;
+    uint64_t point_reads = 0;
+    std::chrono::steady_clock::duration point_read_time{};
+    size_t peak_memory = 0;
+};
+
+// Scanners read long sequential ranges, like compaction does, while point
+// readers open a stream at a random position of the same file and only
+// consume a small piece of it, without knowing in advance how much.
+static mixed_read_result run_mixed_read(file f, const mixed_read_config& cfg, file_input_stream_options scan_opts, file_input_stream_options point_opts) {
+    mixed_read_result res;
+    auto stop = std::chrono::steady_clock::now() + cfg.duration;
+    auto baseline = memory::stats().allocated_memory();
+    auto sampler = timer<>([&] {
+        res.peak_memory = std::max(res.peak_memory, memory::stats().allocated_memory() - std::min(baseline, memory::stats().allocated_memory()));
+    });
+    sampler.arm_periodic(1ms);
+
+    auto scanner = [&] (unsigned id) {
+        return seastar::async([&, id] {
+            std::mt19937_64 rng(id);
+            while (std::chrono::steady_clock::now() < stop) {
+                auto pos = align_down<uint64_t>(rng() % (cfg.file_size - cfg.scan_size), 4096);
+                auto in = make_file_input_stream(f, pos, cfg.scan_size, scan_opts);
+                auto close_in = deferred_close(in);
+                while (auto buf = in.read().get()) {
+                    res.scanned_bytes += buf.size();
+                }
+            }
+        });
+    };
+    auto point_reader = [&] (unsigned id) {
+        return seastar::async([&, id] {
+            std::mt19937_64 rng(cfg.scanners + id);
+            while (std::chrono::steady_clock::now() < stop) {
+                auto pos = rng() % (cfg.file_size - cfg.point_read_size);
+                auto start = std::chrono::steady_clock::now();
+                auto in = make_file_input_stream(f, pos, point_opts);
+                auto close_in = deferred_close(in);
+                in.read_exactly(cfg.point_read_size).get();
+                res.point_reads++;
+                res.point_read_time += std::chrono::steady_clock::now() - start;
+            }
+        });
+    };
+
+    std::vector<future<>> fibers;
+    for (unsigned i = 0; i < cfg.scanners; i++) {
+        fibers.push_back(scanner(i));
+    }
+    for (unsigned i = 0; i < cfg.point_readers; i++) {
+        fibers.push_back(point_reader(i));
+    }
+    when_all_succeed(fibers.begin(), fibers.end()).get();
+    return res;
+}
+
+static future<> mixed_read(const mixed_read_config& cfg, size_t buffer_size, size_t large_buffer_size) {
+    return seastar::async([=] {
+        auto name = "testfile.tmp";
+        auto f = open_file_dma(name, open_flags::rw | open_flags::create | open_flags::exclusive).get();
+        {
+            static constexpr size_t chunk = 1 << 20;
+            auto buf = temporary_buffer<char>::aligned(f.memory_dma_alignment(), chunk);
+            std::fill_n(buf.get_write(), chunk, 'x');
+            for (uint64_t pos = 0; pos < cfg.file_size; pos += chunk) {
+                f.dma_write(pos, buf.get(), chunk).get();
+            }
+            f.flush().get();
+        }
+
+        struct setup {
+            std::string name;
+            file_input_stream_options scan;
+            file_input_stream_options point;
+        };
+        auto fixed = [] (size_t buffer_size, unsigned read_ahead) {
+            file_input_stream_options o;
+            o.buffer_size = buffer_size;
+            o.read_ahead = read_ahead;
+            return o;
+        };
+        auto adaptive = fixed(buffer_size, cfg.read_ahead);
+        adaptive.adaptive_read_ahead = true;
+        // The same options are used for both kinds of readers, as when the
+        // code opening the stream cannot tell what it is going to be used for
+        auto setups = std::vector<setup>{
+            { "fixed-large", fixed(large_buffer_size, cfg.read_ahead), fixed(large_buffer_size, cfg.read_ahead) },
+            { "fixed-small", fixed(buffer_size, cfg.read_ahead), fixed(buffer_size, cfg.read_ahead) },
+            { "adaptive", adaptive, adaptive },
+        };
+
+        fmt::print("{:12} {:>12} {:>14} {:>16} {:>14}\n", "setup", "scan MB/s", "point reads/s", "point read usec", "peak mem MB");
+        for (auto& s : setups) {
+            auto res = run_mixed_read(f, cfg, s.scan, s.point);
+            using fseconds = std::chrono::duration<double>;
+            auto secs = std::chrono::duration_cast<fseconds>(cfg.duration).count();
+            fmt::print("{:12} {:12.1f} {:14.0f} {:16.1f} {:14.1f}\n", s.name,
+                    res.scanned_bytes / secs / (1 << 20),
+                    res.point_reads / secs,
+                    res.point_reads ? std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(res.point_read_time).count() / res.point_reads : 0.0,
+                    double(res.peak_memory) / (1 << 20));
+        }
+        f.close().get();
+        remove_file(name).get();
+    });
+}
+
 int main(int ac, char** av) {
     app_template at;
     namespace bpo = boost::program_options;
     at.add_options()
             ("concurrency", bpo::value<unsigned>()->default_value(1), "Write operations to issue in parallel")
-            ("buffer-size", bpo::value<size_t>()->default_value(4096), "Write buffer size")
+            ("buffer-size", bpo::value<size_t>()->default_value(4096), "Write buffer size, or read buffer size for mixed-read")
             ("total-ops", bpo::value<unsigned>()->default_value(100000), "Total write operations to issue")
             ("sloppy-size", bpo::value<bool>()->default_value(false), "Enable the sloppy-size optimization")
+            ("mode", bpo::value<std::string>()->default_value("write"), "Scenario to run: write or mixed-read")
+            ("large-buffer-size", bpo::value<size_t>()->default_value(128 << 10), "mixed-read: buffer size for streams set up for scanning")
+            ("read-ahead", bpo::value<unsigned>()->default_value(4), "mixed-read: read-ahead")
+            ("file-size", bpo::value<uint64_t>()->default_value(1024), "mixed-read: file size in MB")
+            ("scanners", bpo::value<unsigned>()->default_value(2), "mixed-read: number of sequential readers")
+            ("scan-size", bpo::value<uint64_t>()->default_value(64), "mixed-read: MB read by a sequential reader at a time")
+            ("point-readers", bpo::value<unsigned>()->default_value(16), "mixed-read: number of point readers")
+            ("point-read-size", bpo::value<size_t>()->default_value(4096), "mixed-read: bytes read by a point reader at a time")
+            ("duration", bpo::value<unsigned>()->default_value(10), "mixed-read: seconds to run each setup for")
             ;
     return at.run(ac, av, [&at] {
+        if (at.configuration()["mode"].as<std::string>() == "mixed-read") {
+            auto& opts = at.configuration();
+            auto cfg = mixed_read_config{
+                .file_size = opts["file-size"].as<uint64_t>() << 20,
+                .scanners = opts["scanners"].as<unsigned>(),
+                .scan_size = opts["scan-size"].as<uint64_t>() << 20,
+                .point_readers = opts["point-readers"].as<unsigned>(),
+                .point_read_size = opts["point-read-size"].as<size_t>(),
+                .read_ahead = opts["read-ahead"].as<unsigned>(),
+                .duration = std::chrono::seconds(opts["duration"].as<unsigned>()),
+            };
+            return mixed_read(cfg, opts["buffer-size"].as<size_t>(), opts["large-buffer-size"].as<size_t>());
+        }
         auto concurrency = at.configuration()["concurrency"].as<unsigned>();
         auto buffer_size = at.configuration()["buffer-size"].as<size_t>();
         auto total_ops = at.configuration()["total-ops"].as<unsigned>();
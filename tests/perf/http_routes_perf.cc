@@ -0,0 +1,176 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/http/routes.hh>
+#include <seastar/http/matchrules.hh>
+#include <seastar/testing/perf_tests.hh>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace seastar;
+using namespace httpd;
+
+namespace {
+
+constexpr size_t lookups_per_run = 1000;
+
+class dummy_handler : public handler_base {
+public:
+    virtual future<std::unique_ptr<http::reply>> handle(const sstring& path,
+            std::unique_ptr<http::request> req, std::unique_ptr<http::reply> rep) override {
+        return make_ready_future<std::unique_ptr<http::reply>>(std::move(rep));
+    }
+};
+
+/*
+ * A REST API with a quarter of each: exact urls, one parameter, two
+ * parameters with a string between them, and a parameter until the end of
+ * the path, looked up with urls that hit each kind and some that miss.
+ */
+template <size_t NrRoutes>
+struct routes_perf {
+    routes tree;
+    // How routes::get_handler found handlers before the tree: an exact
+    // match, then each rule in turn. The baseline of the tree.
+    std::unordered_map<sstring, handler_base*> exact;
+    std::map<uint64_t, match_rule*> rules;
+    std::vector<std::unique_ptr<handler_base>> handlers;
+    std::vector<sstring> urls;
+
+    routes_perf() {
+        uint64_t cookie = 0;
+        auto add_rule = [&] (auto build) {
+            auto r1 = new match_rule(new dummy_handler());
+            auto r2 = new match_rule(new dummy_handler());
+            build(*r1);
+            build(*r2);
+            tree.add(r1, GET);
+            rules.emplace(cookie++, r2);
+        };
+        for (size_t i = 0; i < NrRoutes; i++) {
+            auto base = format("/api/v1/resource{}", i / 4);
+            switch (i % 4) {
+            case 0:
+                tree.put(GET, base, new dummy_handler());
+                handlers.push_back(std::make_unique<dummy_handler>());
+                exact.emplace(base, handlers.back().get());
+                break;
+            case 1:
+                add_rule([&] (match_rule& r) { r.add_str(base).add_param("id"); });
+                break;
+            case 2:
+                add_rule([&] (match_rule& r) { r.add_str(base).add_param("id").add_str("/items").add_param("item"); });
+                break;
+            case 3:
+                add_rule([&] (match_rule& r) { r.add_str(format("/static{}", i / 4)).add_param("path", true); });
+                break;
+            }
+        }
+
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<size_t> route(0, NrRoutes - 1);
+        for (size_t i = 0; i < lookups_per_run; i++) {
+            auto r = route(rng);
+            switch (r % 4) {
+            case 0:
+                urls.push_back(format("/api/v1/resource{}", r / 4));
+                break;
+            case 1:
+                urls.push_back(format("/api/v1/resource{}/{}", r / 4, i));
+                break;
+            case 2:
+                urls.push_back(format("/api/v1/resource{}/{}/items/{}", r / 4, i, i * 7));
+                break;
+            case 3:
+                urls.push_back(i % 8 ? format("/static{}/css/site{}.css", r / 4, i) : format("/missing{}", i));
+                break;
+            }
+        }
+    }
+    ~routes_perf() {
+        for (auto& r : rules) {
+            delete r.second;
+        }
+    }
+
+    handler_base* linear_get_handler(const sstring& url, parameters& params) {
+        auto i = exact.find(url);
+        if (i != exact.end()) {
+            return i->second;
+        }
+        for (auto&& rule : rules) {
+            auto handler = rule.second->get(url, params);
+            if (handler != nullptr) {
+                return handler;
+            }
+            params.clear();
+        }
+        return nullptr;
+    }
+
+    size_t linear() {
+        for (auto& url : urls) {
+            parameters params;
+            perf_tests::do_not_optimize(linear_get_handler(url, params));
+        }
+        return urls.size();
+    }
+
+    size_t radix_tree() {
+        for (auto& url : urls) {
+            parameters params;
+            perf_tests::do_not_optimize(tree.get_handler(GET, url, params));
+        }
+        return urls.size();
+    }
+};
+
+}
+
+using routes_10 = routes_perf<10>;
+using routes_100 = routes_perf<100>;
+using routes_1000 = routes_perf<1000>;
+
+PERF_TEST_F(routes_10, linear) {
+    return linear();
+}
+
+PERF_TEST_F(routes_10, radix_tree) {
+    return radix_tree();
+}
+
+PERF_TEST_F(routes_100, linear) {
+    return linear();
+}
+
+PERF_TEST_F(routes_100, radix_tree) {
+    return radix_tree();
+}
+
+PERF_TEST_F(routes_1000, linear) {
+    return linear();
+}
+
+PERF_TEST_F(routes_1000, radix_tree) {
+    return radix_tree();
+}
@@ -0,0 +1,201 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+/*
+ * Scrapes the prometheus endpoint of a server that exports many series
+ * and reports how long a scrape takes and the longest stretch of time the
+ * reactor of each shard spent without getting back to a probe fiber, which
+ * is an upper bound on the longest task the scrape ran.
+ *
+ * The series are spread evenly over the shards and over --families
+ * families, half of which are aggregated over the shard label. The HTTP
+ * connection is a loopback one, the server runs on shard 0.
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/prometheus.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/http/httpd.hh>
+#include <seastar/util/closeable.hh>
+#include <seastar/util/later.hh>
+#include <../../tests/unit/loopback_socket.hh>
+#include <fmt/core.h>
+#include <chrono>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+namespace sm = seastar::metrics;
+
+using clock_type = std::chrono::steady_clock;
+
+class series_set {
+    sm::metric_groups _metrics;
+    uint64_t _value = 0;
+public:
+    void setup(unsigned series, unsigned families) {
+        auto id = sm::label("id");
+        std::vector<sm::metric_definition> defs;
+        defs.reserve(series);
+        for (unsigned i = 0; i < series; i++) {
+            auto family = i % families;
+            auto def = sm::make_counter(fmt::format("series_{}", family), _value, sm::description("benchmark series"), {id(i / families)});
+            if (family % 2) {
+                def.aggregate({sm::shard_label});
+            }
+            defs.emplace_back(std::move(def));
+        }
+        _metrics.add_group("bench", defs);
+    }
+
+    future<> stop() {
+        _metrics.clear();
+        return make_ready_future<>();
+    }
+};
+
+// Yields in a loop and records the longest gap between two of its runs
+class stall_probe {
+    bool _stop = false;
+    clock_type::duration _max = {};
+    future<> _done = make_ready_future<>();
+
+    future<> run() {
+        auto last = clock_type::now();
+        while (!_stop) {
+            co_await yield();
+            auto now = clock_type::now();
+            _max = std::max(_max, now - last);
+            last = now;
+        }
+    }
+public:
+    void start() {
+        _stop = false;
+        _max = {};
+        _done = run();
+    }
+
+    future<clock_type::duration> finish() {
+        _stop = true;
+        co_await std::exchange(_done, make_ready_future<>());
+        co_return _max;
+    }
+
+    future<> stop() {
+        _stop = true;
+        return std::exchange(_done, make_ready_future<>());
+    }
+};
+
+// Reads a chunked response up to its last chunk, returns its size
+size_t read_response(input_stream<char>& in) {
+    static constexpr std::string_view last_chunk = "\r\n0\r\n\r\n";
+    std::string tail;
+    size_t size = 0;
+    while (true) {
+        auto buf = in.read().get();
+        if (buf.empty()) {
+            throw std::runtime_error("connection closed before the end of the response");
+        }
+        size += buf.size();
+        tail.append(buf.get(), buf.size());
+        if (tail.ends_with(last_chunk)) {
+            return size;
+        }
+        tail.erase(0, tail.size() - std::min(tail.size(), last_chunk.size()));
+    }
+}
+
+int main(int ac, char** av) {
+    app_template at;
+    namespace bpo = boost::program_options;
+    at.add_options()
+            ("series", bpo::value<unsigned>()->default_value(100000), "Total number of series, spread over the shards")
+            ("families", bpo::value<unsigned>()->default_value(100), "Number of metric families")
+            ("scrapes", bpo::value<unsigned>()->default_value(5), "Number of scrapes")
+            ("aggregate", bpo::value<bool>()->default_value(true), "Let the server aggregate the families that ask for it")
+            ;
+    return at.run(ac, av, [&at] {
+        return seastar::async([&at] {
+            auto& opts = at.configuration();
+            auto series = opts["series"].as<unsigned>();
+            auto families = std::max(opts["families"].as<unsigned>(), 1u);
+            auto scrapes = opts["scrapes"].as<unsigned>();
+            auto aggregate = opts["aggregate"].as<bool>();
+
+            sharded<series_set> sets;
+            sets.start().get();
+            auto stop_sets = deferred_stop(sets);
+            sets.invoke_on_all([series, families] (series_set& s) {
+                s.setup(series / smp::count, families);
+            }).get();
+
+            sharded<stall_probe> probes;
+            probes.start().get();
+            auto stop_probes = deferred_stop(probes);
+
+            loopback_connection_factory lcf(1);
+            httpd::http_server server("prometheus_perf");
+            loopback_socket_impl lsi(lcf);
+            httpd::http_server_tester::listeners(server).emplace_back(lcf.get_server_socket());
+            prometheus::config ctx;
+            prometheus::add_prometheus_routes(server, ctx).get();
+            auto accept = server.do_accepts(0);
+
+            auto c_socket = lsi.connect(socket_address(ipv4_addr()), socket_address(ipv4_addr())).get();
+            input_stream<char> input(c_socket.input());
+            output_stream<char> output(c_socket.output());
+            auto request = fmt::format("GET /metrics{} HTTP/1.1\r\nHost: test\r\n\r\n", aggregate ? "" : "?__aggregate__=false");
+
+            fmt::print("{} series, {} families, {} shards\n", series, families, smp::count);
+            fmt::print("{:>8} {:>12} {:>10} {:>16} {:>16}\n", "scrape", "duration ms", "MB", "max task ms", "shard 0 task ms");
+            for (unsigned i = 0; i < scrapes; i++) {
+                probes.invoke_on_all([] (stall_probe& p) {
+                    p.start();
+                }).get();
+                auto start = clock_type::now();
+                output.write(request).get();
+                output.flush().get();
+                auto size = read_response(input);
+                auto duration = clock_type::now() - start;
+                std::vector<clock_type::duration> gaps(smp::count);
+                probes.invoke_on_all([&gaps] (stall_probe& p) {
+                    return p.finish().then([&gaps] (clock_type::duration gap) {
+                        gaps[this_shard_id()] = gap;
+                    });
+                }).get();
+                auto ms = [] (clock_type::duration d) {
+                    return std::chrono::duration<double, std::milli>(d).count();
+                };
+                fmt::print("{:>8} {:>12.1f} {:>10.1f} {:>16.2f} {:>16.2f}\n", i, ms(duration), size / double(1 << 20),
+                        ms(*std::max_element(gaps.begin(), gaps.end())), ms(gaps[0]));
+            }
+
+            output.close().get();
+            input.close().get();
+            server.stop().get();
+            accept.get();
+        });
+    });
+}
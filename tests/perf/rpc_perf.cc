@@ -21,13 +21,68 @@
 
 #include <random>
 
+#include <fmt/format.h>
+
 #include <seastar/rpc/lz4_compressor.hh>
 #include <seastar/rpc/lz4_fragmented_compressor.hh>
+#ifdef SEASTAR_HAVE_ZSTD
+#include <seastar/rpc/zstd_compressor.hh>
+#endif
 
 #include <seastar/testing/perf_tests.hh>
 #include <seastar/testing/random.hh>
 
+namespace {
+
+// Roughly what a key-value store sends around: small, similar records
+std::string text_record(std::default_random_engine& eng) {
+    static const char* names[] = { "alice", "bob", "carol", "dave", "erin", "frank" };
+    static const char* states[] = { "active", "suspended", "pending" };
+    auto dist = std::uniform_int_distribution<unsigned>(0, 1000000);
+    return fmt::format("{{\"id\":{},\"user\":\"{}\",\"state\":\"{}\",\"balance\":{},\"updated_at\":\"2026-{:02}-{:02}T{:02}:{:02}:00Z\"}}",
+            dist(eng), names[dist(eng) % 6], states[dist(eng) % 3], dist(eng), 1 + dist(eng) % 12, 1 + dist(eng) % 28, dist(eng) % 24, dist(eng) % 60);
+}
+
+void fill_text(char* p, size_t size, std::default_random_engine& eng) {
+    while (size) {
+        auto r = text_record(eng);
+        auto n = std::min(size, r.size());
+        std::copy_n(r.data(), n, p);
+        p += n;
+        size -= n;
+    }
+}
+
 template<typename Compressor>
+struct make_compressor {
+    static Compressor make() { return Compressor(); }
+};
+
+#ifdef SEASTAR_HAVE_ZSTD
+
+std::shared_ptr<const seastar::rpc::zstd_compressor::dictionary> text_dictionary() {
+    static auto dict = [] {
+        auto eng = std::default_random_engine(0);
+        auto samples = std::vector<seastar::temporary_buffer<char>>();
+        for (auto i = 0; i < 10000; i++) {
+            auto r = text_record(eng);
+            samples.emplace_back(r.data(), r.size());
+        }
+        return std::make_shared<const seastar::rpc::zstd_compressor::dictionary>(
+                std::string_view(seastar::rpc::zstd_compressor::dictionary::train(samples, 16 * 1024)));
+    }();
+    return dict;
+}
+
+struct make_zstd_dict_compressor {
+    static seastar::rpc::zstd_compressor make() { return seastar::rpc::zstd_compressor(text_dictionary()); }
+};
+
+#endif
+
+}
+
+template<typename Compressor, typename Make = make_compressor<Compressor>>
 struct compression {
     static constexpr size_t small_buffer_size = 128;
     static constexpr size_t large_buffer_size = 16 * 1024 * 1024;
@@ -37,15 +92,19 @@ struct compression {
 
     seastar::temporary_buffer<char> _small_buffer_random;
     seastar::temporary_buffer<char> _small_buffer_zeroes;
+    seastar::temporary_buffer<char> _small_buffer_text;
 
     std::vector<seastar::temporary_buffer<char>> _large_buffer_random;
     std::vector<seastar::temporary_buffer<char>> _large_buffer_zeroes;
+    std::vector<seastar::temporary_buffer<char>> _large_buffer_text;
 
     std::vector<seastar::temporary_buffer<char>> _small_compressed_buffer_random;
     std::vector<seastar::temporary_buffer<char>> _small_compressed_buffer_zeroes;
+    std::vector<seastar::temporary_buffer<char>> _small_compressed_buffer_text;
 
     std::vector<seastar::temporary_buffer<char>> _large_compressed_buffer_random;
     std::vector<seastar::temporary_buffer<char>> _large_compressed_buffer_zeroes;
+    std::vector<seastar::temporary_buffer<char>> _large_compressed_buffer_text;
 
 private:
     static seastar::rpc::rcv_buf get_rcv_buf(std::vector<temporary_buffer<char>>& input) {
@@ -74,61 +133,76 @@ struct compression {
         return seastar::rpc::snd_buf(input.share());
     }
 
+    std::vector<seastar::temporary_buffer<char>> compress(seastar::rpc::snd_buf input) {
+        auto rcv = _compressor.compress(0, std::move(input));
+        if (auto buffer = std::get_if<seastar::temporary_buffer<char>>(&rcv.bufs)) {
+            auto ret = std::vector<seastar::temporary_buffer<char>>{};
+            ret.emplace_back(std::move(*buffer));
+            return ret;
+        }
+        return std::move(std::get<std::vector<seastar::temporary_buffer<char>>>(rcv.bufs));
+    }
+
+    std::vector<seastar::temporary_buffer<char>> compress(std::vector<seastar::temporary_buffer<char>>& input) {
+        auto bufs = std::vector<temporary_buffer<char>>{};
+        for (auto&& b : input) {
+            bufs.emplace_back(b.clone());
+        }
+        return compress(seastar::rpc::snd_buf(std::move(bufs), large_buffer_size));
+    }
+
+    static double ratio(size_t size, const std::vector<seastar::temporary_buffer<char>>& compressed) {
+        auto compressed_size = std::accumulate(compressed.begin(), compressed.end(), size_t(0),
+            [] (size_t n, const temporary_buffer<char>& buf) { return n + buf.size(); });
+        return double(size) / compressed_size;
+    }
+
+    // Every test constructs its own fixture, report once per algorithm
+    void print_ratios() {
+        static bool printed = false;
+        if (std::exchange(printed, true)) {
+            return;
+        }
+        fmt::print("{} compression ratio: small random {:.2f}, zeroed {:.2f}, text {:.2f}; large random {:.2f}, zeroed {:.2f}, text {:.2f}\n",
+            _compressor.name(),
+            ratio(small_buffer_size, _small_compressed_buffer_random),
+            ratio(small_buffer_size, _small_compressed_buffer_zeroes),
+            ratio(small_buffer_size, _small_compressed_buffer_text),
+            ratio(large_buffer_size, _large_compressed_buffer_random),
+            ratio(large_buffer_size, _large_compressed_buffer_zeroes),
+            ratio(large_buffer_size, _large_compressed_buffer_text));
+    }
+
 public:
     compression()
-        : _small_buffer_random(seastar::temporary_buffer<char>(small_buffer_size))
+        : _compressor(Make::make())
+        , _small_buffer_random(seastar::temporary_buffer<char>(small_buffer_size))
         , _small_buffer_zeroes(seastar::temporary_buffer<char>(small_buffer_size))
+        , _small_buffer_text(seastar::temporary_buffer<char>(small_buffer_size))
     {
         auto& eng = testing::local_random_engine;
         auto dist = std::uniform_int_distribution<int>(0, std::numeric_limits<char>::max());
 
         std::generate_n(_small_buffer_random.get_write(), small_buffer_size, [&] { return dist(eng); });
+        std::fill_n(_small_buffer_zeroes.get_write(), small_buffer_size, 0);
+        fill_text(_small_buffer_text.get_write(), small_buffer_size, eng);
         for (auto i = 0u; i < large_buffer_size / seastar::rpc::snd_buf::chunk_size; i++) {
             _large_buffer_random.emplace_back(seastar::rpc::snd_buf::chunk_size);
             std::generate_n(_large_buffer_random.back().get_write(), seastar::rpc::snd_buf::chunk_size, [&] { return dist(eng); });
             _large_buffer_zeroes.emplace_back(seastar::rpc::snd_buf::chunk_size);
             std::fill_n(_large_buffer_zeroes.back().get_write(), seastar::rpc::snd_buf::chunk_size, 0);
+            _large_buffer_text.emplace_back(seastar::rpc::snd_buf::chunk_size);
+            fill_text(_large_buffer_text.back().get_write(), seastar::rpc::snd_buf::chunk_size, eng);
         }
 
-        auto rcv = _compressor.compress(0, seastar::rpc::snd_buf(_small_buffer_random.share()));
-        if (auto buffer = std::get_if<seastar::temporary_buffer<char>>(&rcv.bufs)) {
-            _small_compressed_buffer_random.emplace_back(std::move(*buffer));
-        } else {
-            _small_compressed_buffer_random
-                = std::move(std::get<std::vector<seastar::temporary_buffer<char>>>(rcv.bufs));
-        }
-
-        rcv = _compressor.compress(0, seastar::rpc::snd_buf(_small_buffer_zeroes.share()));
-        if (auto buffer = std::get_if<seastar::temporary_buffer<char>>(&rcv.bufs)) {
-            _small_compressed_buffer_zeroes.emplace_back(std::move(*buffer));
-        } else {
-            _small_compressed_buffer_zeroes
-                = std::move(std::get<std::vector<seastar::temporary_buffer<char>>>(rcv.bufs));
-        }
-
-        auto bufs = std::vector<temporary_buffer<char>>{};
-        for (auto&& b : _large_buffer_random) {
-            bufs.emplace_back(b.clone());
-        }
-        rcv = _compressor.compress(0, seastar::rpc::snd_buf(std::move(bufs), large_buffer_size));
-        if (auto buffer = std::get_if<seastar::temporary_buffer<char>>(&rcv.bufs)) {
-            _large_compressed_buffer_random.emplace_back(std::move(*buffer));
-        } else {
-            _large_compressed_buffer_random
-                = std::move(std::get<std::vector<seastar::temporary_buffer<char>>>(rcv.bufs));
-        }
+        _small_compressed_buffer_random = compress(seastar::rpc::snd_buf(_small_buffer_random.share()));
+        _small_compressed_buffer_zeroes = compress(seastar::rpc::snd_buf(_small_buffer_zeroes.share()));
+        _small_compressed_buffer_text = compress(seastar::rpc::snd_buf(_small_buffer_text.share()));
+        _large_compressed_buffer_random = compress(_large_buffer_random);
+        _large_compressed_buffer_zeroes = compress(_large_buffer_zeroes);
+        _large_compressed_buffer_text = compress(_large_buffer_text);
 
-        bufs = std::vector<temporary_buffer<char>>{};
-        for (auto&& b : _large_buffer_zeroes) {
-            bufs.emplace_back(b.clone());
-        }
-        rcv = _compressor.compress(0, seastar::rpc::snd_buf(std::move(bufs), large_buffer_size));
-        if (auto buffer = std::get_if<seastar::temporary_buffer<char>>(&rcv.bufs)) {
-            _large_compressed_buffer_zeroes.emplace_back(std::move(*buffer));
-        } else {
-            _large_compressed_buffer_zeroes
-                = std::move(std::get<std::vector<seastar::temporary_buffer<char>>>(rcv.bufs));
-        }
+        print_ratios();
     }
 
     Compressor& compressor() { return _compressor; }
@@ -139,6 +213,9 @@ struct compression {
     seastar::rpc::snd_buf small_buffer_zeroes() {
         return get_snd_buf(_small_buffer_zeroes);
     }
+    seastar::rpc::snd_buf small_buffer_text() {
+        return get_snd_buf(_small_buffer_text);
+    }
 
     seastar::rpc::snd_buf large_buffer_random() {
         return get_snd_buf(_large_buffer_random);
@@ -146,6 +223,9 @@ struct compression {
     seastar::rpc::snd_buf large_buffer_zeroes() {
         return get_snd_buf(_large_buffer_zeroes);
     }
+    seastar::rpc::snd_buf large_buffer_text() {
+        return get_snd_buf(_large_buffer_text);
+    }
 
     seastar::rpc::rcv_buf small_compressed_buffer_random() {
         return get_rcv_buf(_small_compressed_buffer_random);
@@ -153,6 +233,9 @@ struct compression {
     seastar::rpc::rcv_buf small_compressed_buffer_zeroes() {
         return get_rcv_buf(_small_compressed_buffer_zeroes);
     }
+    seastar::rpc::rcv_buf small_compressed_buffer_text() {
+        return get_rcv_buf(_small_compressed_buffer_text);
+    }
 
     seastar::rpc::rcv_buf large_compressed_buffer_random() {
         return get_rcv_buf(_large_compressed_buffer_random);
@@ -160,6 +243,9 @@ struct compression {
     seastar::rpc::rcv_buf large_compressed_buffer_zeroes() {
         return get_rcv_buf(_large_compressed_buffer_zeroes);
     }
+    seastar::rpc::rcv_buf large_compressed_buffer_text() {
+        return get_rcv_buf(_large_compressed_buffer_text);
+    }
 };
 
 using lz4 = compression<seastar::rpc::lz4_compressor>;
@@ -261,3 +347,155 @@ PERF_TEST_F(lz4_fragmented, large_zeroed_buffer_decompress) {
         compressor().decompress(large_compressed_buffer_zeroes())
     );
 }
+
+#ifdef SEASTAR_HAVE_ZSTD
+
+using zstd = compression<seastar::rpc::zstd_compressor>;
+
+PERF_TEST_F(zstd, small_random_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, small_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd, small_zeroed_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, small_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd, small_text_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, small_buffer_text())
+    );
+}
+
+PERF_TEST_F(zstd, large_random_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, large_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd, large_zeroed_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, large_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd, large_text_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, large_buffer_text())
+    );
+}
+
+PERF_TEST_F(zstd, small_random_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(small_compressed_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd, small_zeroed_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(small_compressed_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd, small_text_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(small_compressed_buffer_text())
+    );
+}
+
+PERF_TEST_F(zstd, large_random_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(large_compressed_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd, large_zeroed_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(large_compressed_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd, large_text_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(large_compressed_buffer_text())
+    );
+}
+
+using zstd_dict = compression<seastar::rpc::zstd_compressor, make_zstd_dict_compressor>;
+
+PERF_TEST_F(zstd_dict, small_random_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, small_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd_dict, small_zeroed_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, small_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd_dict, small_text_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, small_buffer_text())
+    );
+}
+
+PERF_TEST_F(zstd_dict, large_random_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, large_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd_dict, large_zeroed_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, large_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd_dict, large_text_buffer_compress) {
+    perf_tests::do_not_optimize(
+        compressor().compress(0, large_buffer_text())
+    );
+}
+
+PERF_TEST_F(zstd_dict, small_random_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(small_compressed_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd_dict, small_zeroed_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(small_compressed_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd_dict, small_text_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(small_compressed_buffer_text())
+    );
+}
+
+PERF_TEST_F(zstd_dict, large_random_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(large_compressed_buffer_random())
+    );
+}
+
+PERF_TEST_F(zstd_dict, large_zeroed_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(large_compressed_buffer_zeroes())
+    );
+}
+
+PERF_TEST_F(zstd_dict, large_text_buffer_decompress) {
+    perf_tests::do_not_optimize(
+        compressor().decompress(large_compressed_buffer_text())
+    );
+}
+
+#endif
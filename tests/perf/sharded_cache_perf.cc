@@ -0,0 +1,157 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <boost/intrusive/unordered_set.hpp>
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/core/sharded_cache.hh>
+#include <bit>
+#include <random>
+#include <vector>
+
+static constexpr size_t nr_keys = 100000;
+static constexpr size_t ops_per_run = 10000;
+
+static size_t hash_of(uint64_t key) {
+    return key * 0x9e3779b97f4a7c15ull;
+}
+
+static std::vector<uint64_t> random_keys(size_t n, uint64_t range) {
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<uint64_t> dist(0, range - 1);
+    std::vector<uint64_t> keys(n);
+    for (auto& k : keys) {
+        k = dist(rng);
+    }
+    return keys;
+}
+
+template <typename Eviction>
+struct cache_perf {
+    struct entry : public cache_entry<Eviction> {
+        uint64_t _key;
+        explicit entry(uint64_t key) : cache_entry<Eviction>(hash_of(key)), _key(key) {}
+        uint64_t key() const { return _key; }
+    };
+
+    local_cache<entry, Eviction> cache;
+    std::vector<uint64_t> lookups = random_keys(ops_per_run, nr_keys);
+    // Twice as many keys as the capacity, so that about half of the inserts
+    // evict
+    std::vector<uint64_t> inserts = random_keys(ops_per_run, 2 * nr_keys);
+
+    cache_perf()
+        : cache(cache_config{.capacity = nr_keys}, [] (entry& e, cache_removal_cause) { delete &e; })
+    {
+        for (uint64_t k = 0; k < nr_keys; k++) {
+            cache.insert(*new entry(k), 1);
+        }
+    }
+
+    size_t find() {
+        for (auto k : lookups) {
+            perf_tests::do_not_optimize(cache.find(k, hash_of(k)));
+        }
+        return lookups.size();
+    }
+
+    size_t insert() {
+        for (auto k : inserts) {
+            cache.insert(*new entry(k), 1);
+        }
+        return inserts.size();
+    }
+};
+
+using no_eviction_cache = cache_perf<no_eviction>;
+using lru_cache = cache_perf<lru_eviction>;
+using clock_cache = cache_perf<clock_eviction>;
+using s3fifo_cache = cache_perf<s3fifo_eviction>;
+
+// What memcached indexed its items with before it used local_cache: the
+// baseline of no_eviction_cache
+struct intrusive_set {
+    struct entry {
+        boost::intrusive::unordered_set_member_hook<> _link;
+        uint64_t _key;
+        size_t _hash;
+        explicit entry(uint64_t key) : _key(key), _hash(hash_of(key)) {}
+        friend bool operator==(const entry& a, const entry& b) { return a._key == b._key; }
+        friend size_t hash_value(const entry& e) { return e._hash; }
+    };
+    using set_type = boost::intrusive::unordered_set<entry,
+        boost::intrusive::member_hook<entry, boost::intrusive::unordered_set_member_hook<>, &entry::_link>,
+        boost::intrusive::power_2_buckets<true>,
+        boost::intrusive::constant_time_size<true>>;
+
+    std::vector<set_type::bucket_type> buckets;
+    set_type set;
+    std::vector<uint64_t> lookups = random_keys(ops_per_run, nr_keys);
+
+    intrusive_set()
+        : buckets(std::bit_ceil(nr_keys * 4 / 3))
+        , set(set_type::bucket_traits(buckets.data(), buckets.size()))
+    {
+        for (uint64_t k = 0; k < nr_keys; k++) {
+            set.insert(*new entry(k));
+        }
+    }
+    ~intrusive_set() {
+        set.clear_and_dispose([] (entry* e) { delete e; });
+    }
+};
+
+PERF_TEST_F(intrusive_set, find) {
+    for (auto k : lookups) {
+        auto h = hash_of(k);
+        perf_tests::do_not_optimize(set.find(k, [h] (uint64_t) { return h; }, [h] (uint64_t k, const entry& e) {
+            return e._hash == h && e._key == k;
+        }));
+    }
+    return lookups.size();
+}
+
+PERF_TEST_F(no_eviction_cache, find) {
+    return find();
+}
+
+PERF_TEST_F(lru_cache, find) {
+    return find();
+}
+
+PERF_TEST_F(clock_cache, find) {
+    return find();
+}
+
+PERF_TEST_F(s3fifo_cache, find) {
+    return find();
+}
+
+PERF_TEST_F(lru_cache, insert) {
+    return insert();
+}
+
+PERF_TEST_F(clock_cache, insert) {
+    return insert();
+}
+
+PERF_TEST_F(s3fifo_cache, insert) {
+    return insert();
+}
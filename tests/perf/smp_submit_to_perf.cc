@@ -29,6 +29,12 @@
 #include <seastar/core/sleep.hh>
 #include <seastar/util/later.hh>
 
+// Measures smp::submit_to() throughput and round-trip latency. To compare the
+// cross-shard transports, run the same configuration with
+// --smp-transport=polling and --smp-transport=doorbell, e.g. at --smp 16, 64
+// and 128 with --targets 1 (many-to-one) and --targets equal to --smp
+// (every shard talks to itself, all other queues stay idle).
+
 using namespace seastar;
 using namespace std::chrono;
 
@@ -106,6 +112,8 @@ class worker {
     std::unique_ptr<thinker> _think;
 
     uint64_t _total;
+    steady_clock::duration _latency_sum;
+    steady_clock::duration _latency_max;
     bool _stop;
     future<> _done;
 
@@ -118,6 +126,7 @@ class worker {
     future<> start_working(unsigned concurrency, respond_type resp, microseconds tmo) {
         return parallel_for_each(std::views::iota(0u, concurrency), [this, resp, tmo] (unsigned f) {
             return do_until([this] { return _stop; }, [this, resp, tmo] {
+                auto start = steady_clock::now();
                 return smp::submit_to(_to, [resp, tmo] {
                     switch (resp) {
                     case respond_type::ready:
@@ -131,7 +140,10 @@ class worker {
                     }
 
                     __builtin_unreachable();
-                }).then([this] {
+                }).then([this, start] {
+                    auto latency = steady_clock::now() - start;
+                    _latency_sum += latency;
+                    _latency_max = std::max(_latency_max, latency);
                     _total++;
                     return make_ready_future<>();
                 });
@@ -153,6 +165,8 @@ class worker {
         : _to(my_target(cfg.targets))
         , _think(is_target() && (cfg.thinkers > 0) ? std::make_unique<thinker>(cfg.thinkers, cfg.think) : nullptr)
         , _total(0)
+        , _latency_sum(0)
+        , _latency_max(0)
         , _stop(false)
         , _done(start_working(cfg.concurrency, cfg.respond, cfg.respond_tmo))
     {
@@ -171,6 +185,12 @@ class worker {
 
     bool is_target() const noexcept { return _to == this_shard_id(); }
     uint64_t total() const noexcept { return _total; }
+    double avg_latency_us() const noexcept {
+        return _total ? duration_cast<duration<double, std::micro>>(_latency_sum).count() / _total : 0.0;
+    }
+    double max_latency_us() const noexcept {
+        return duration_cast<duration<double, std::micro>>(_latency_max).count();
+    }
 };
 
 class stats {
@@ -231,17 +251,25 @@ int main(int ac, char** av) {
             auto real_duration = duration_cast<seconds>(steady_clock::now() - start);
             fmt::print("took {}s (expected {}s)\n", real_duration.count(), duration.count());
             stats st(real_duration.count()), st_targets(real_duration.count());
+            double latency_sum = 0, latency_max = 0;
+            unsigned latency_nr = 0;
             for (unsigned i = 0; i < smp::count; i++) {
-                workers.invoke_on(i, [&st, &st_targets] (worker& w) {
+                workers.invoke_on(i, [&] (worker& w) {
                     if (w.is_target()) {
                         st_targets.append(w.total());
                     } else {
                         st.append(w.total());
                     }
+                    if (w.total() > 0) {
+                        latency_sum += w.avg_latency_us();
+                        latency_max = std::max(latency_max, w.max_latency_us());
+                        latency_nr++;
+                    }
                 }).get();
             }
             fmt::print("workers({:2}): min {:.1f} avg {:.1f} max {:.1f} op/s\n", st.nr(), st.min(), st.avg(), st.max());
             fmt::print("targets({:2}): min {:.1f} avg {:.1f} max {:.1f} op/s\n", st_targets.nr(), st_targets.min(), st_targets.avg(), st_targets.max());
+            fmt::print("latency: avg {:.1f} max {:.1f} us\n", latency_nr ? latency_sum / latency_nr : 0.0, latency_max);
 
             workers.stop().get();
         });
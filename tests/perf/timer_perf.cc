@@ -0,0 +1,122 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/core/timer-wheel.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/testing/random.hh>
+
+#include <vector>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+// A bare timer, so that only the cost of the containers is measured
+struct bench_timer {
+    using clock = steady_clock_type;
+    using time_point = clock::time_point;
+    using duration = clock::duration;
+
+    boost::intrusive::list_member_hook<> link;
+    time_point timeout;
+    bool _expired = false;
+
+    time_point get_timeout() const noexcept { return timeout; }
+    void cancel() noexcept {}
+};
+
+// Each fixture keeps N timers armed with timeouts spread over the next
+// minute, like per-connection idle timers. arm_cancel arms and cancels a
+// batch of extra timers among them and reports the cost per timer; expire
+// advances time by one lowres_clock tick, re-arms whatever expired a
+// minute ahead and reports the cost per tick.
+template <typename Set, size_t N>
+class timers_bench {
+    static constexpr auto horizon = std::chrono::duration_cast<bench_timer::duration>(60s);
+    static constexpr auto tick = std::chrono::duration_cast<bench_timer::duration>(10ms);
+    static constexpr size_t batch = 1000;
+
+    std::vector<bench_timer> _timers;
+    std::vector<bench_timer> _extra;
+    std::vector<bench_timer::duration> _offsets;
+    Set _set;
+    bench_timer::time_point _now;
+
+public:
+    timers_bench() : _timers(N), _extra(batch), _now(bench_timer::clock::now()) {
+        std::uniform_int_distribution<bench_timer::duration::rep> dist(1, horizon.count());
+        _set.expire(_now);
+        for (auto& t : _timers) {
+            t.timeout = _now + bench_timer::duration(dist(testing::local_random_engine));
+            _set.insert(t);
+        }
+        _offsets.reserve(batch);
+        for (size_t i = 0; i < batch; ++i) {
+            _offsets.push_back(bench_timer::duration(dist(testing::local_random_engine)));
+        }
+    }
+
+    ~timers_bench() {
+        _set.clear();
+    }
+
+    size_t arm_cancel() {
+        for (size_t i = 0; i < batch; ++i) {
+            _extra[i].timeout = _now + _offsets[i];
+            _set.insert(_extra[i]);
+        }
+        for (auto& t : _extra) {
+            _set.remove(t);
+        }
+        return batch;
+    }
+
+    size_t expire() {
+        _now += tick;
+        auto expired = _set.expire(_now);
+        while (!expired.empty()) {
+            auto& t = expired.front();
+            expired.pop_front();
+            t.timeout = _now + horizon;
+            _set.insert(t);
+        }
+        return 1;
+    }
+};
+
+using bench_timer_set = timer_set<bench_timer, &bench_timer::link>;
+using bench_timer_wheel = timer_wheel<bench_timer, &bench_timer::link>;
+
+#define TIMER_PERF_TESTS(name, set, n) \
+    struct name : timers_bench<set, n> {}; \
+    PERF_TEST_F(name, arm_cancel) { return arm_cancel(); } \
+    PERF_TEST_F(name, expire) { return expire(); }
+
+TIMER_PERF_TESTS(timer_set_1k, bench_timer_set, 1'000)
+TIMER_PERF_TESTS(timer_wheel_1k, bench_timer_wheel, 1'000)
+TIMER_PERF_TESTS(timer_set_10k, bench_timer_set, 10'000)
+TIMER_PERF_TESTS(timer_wheel_10k, bench_timer_wheel, 10'000)
+TIMER_PERF_TESTS(timer_set_100k, bench_timer_set, 100'000)
+TIMER_PERF_TESTS(timer_wheel_100k, bench_timer_wheel, 100'000)
+TIMER_PERF_TESTS(timer_set_1m, bench_timer_set, 1'000'000)
+TIMER_PERF_TESTS(timer_wheel_1m, bench_timer_wheel, 1'000'000)
+TIMER_PERF_TESTS(timer_set_10m, bench_timer_set, 10'000'000)
+TIMER_PERF_TESTS(timer_wheel_10m, bench_timer_wheel, 10'000'000)
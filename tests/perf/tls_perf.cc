@@ -0,0 +1,272 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+/*
+ * Two A/B benchmarks of TLS over loopback, with the client and the server
+ * both on shard 0. The CPU is the busy time of the reactor, which includes
+ * the time spent in the kernel by socket calls.
+ *
+ * --bench stream streams data over a connection, once with the records
+ * encrypted by gnutls and once with kernel TLS offload enabled, and reports
+ * the throughput and the CPU each spends per GB, that of encrypting and
+ * decrypting every byte once. Offloaded records get encrypted in socket
+ * calls. When the kernel lacks the "tls" module sessions fall back to
+ * gnutls, and both runs measure the same thing: the offload columns say
+ * which one ran.
+ *
+ * --bench reconnect is a reconnect storm: clients connect, exchange a byte
+ * and disconnect over and over, once with full handshakes only and once
+ * with TLS 1.3 session tickets, a client session cache and a ticket key
+ * shared through session_ticket_key_rotation. It reports connections per
+ * second, how many resumed, and the CPU per thousand connections.
+ *
+ * Certificates from the unit tests will do, e.g.
+ *   tls_perf --cert tests/unit/test.crt --key tests/unit/test.key
+ */
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/net/api.hh>
+#include <seastar/net/inet_address.hh>
+#include <seastar/net/tls.hh>
+#include <seastar/net/tls_resumption.hh>
+#include <seastar/util/closeable.hh>
+#include <fmt/core.h>
+#include <chrono>
+#include <ranges>
+
+using namespace seastar;
+
+using clock_type = std::chrono::steady_clock;
+
+struct run_result {
+    double seconds;
+    double busy_seconds;
+    tls::kernel_offload client;
+    tls::kernel_offload server;
+};
+
+static run_result run_stream(const sstring& cert, const sstring& key, const sstring& priority, bool offload,
+        size_t total, size_t chunk, uint16_t port) {
+    tls::credentials_builder b;
+    b.set_x509_key_file(cert, key, tls::x509_crt_format::PEM).get();
+    if (!priority.empty()) {
+        b.set_priority_string(priority);
+    }
+    b.set_enable_kernel_offload(offload);
+    auto creds = b.build_certificate_credentials();
+    // The certificate is not signed for 127.0.0.1
+    creds->set_enable_certificate_verification(false);
+    auto serv = b.build_server_credentials();
+
+    listen_options opts;
+    opts.reuse_address = true;
+    opts.set_fixed_cpu(this_shard_id());
+    auto addr = make_ipv4_address({0x7f000001, port});
+    auto server = tls::listen(serv, addr, opts);
+
+    auto sa = server.accept();
+    auto c = tls::connect(creds, addr).get();
+    auto s = std::move(sa.get().connection);
+
+    auto out = c.output();
+    auto in = s.input();
+    // Handshake, and see what the sessions ended up with
+    out.write("x").get();
+    out.flush().get();
+    in.read_exactly(1).get();
+    auto client = tls::get_kernel_offload(c).get();
+    auto srv = tls::get_kernel_offload(s).get();
+
+    temporary_buffer<char> payload(chunk);
+    std::fill_n(payload.get_write(), chunk, 'x');
+
+    auto busy = engine().total_busy_time();
+    auto start = clock_type::now();
+    auto reader = seastar::async([&in, total] {
+        size_t received = 0;
+        while (received < total) {
+            auto buf = in.read().get();
+            if (buf.empty()) {
+                throw std::runtime_error("unexpected end of stream");
+            }
+            received += buf.size();
+        }
+    });
+    for (size_t sent = 0; sent < total; sent += chunk) {
+        out.write(payload.share()).get();
+    }
+    out.flush().get();
+    reader.get();
+    auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    auto busy_seconds = std::chrono::duration<double>(engine().total_busy_time() - busy).count();
+
+    out.close().get();
+    in.close().get();
+    return run_result{seconds, busy_seconds, client, srv};
+}
+
+struct reconnect_result {
+    double seconds;
+    double busy_seconds;
+    size_t resumed;
+};
+
+static reconnect_result run_reconnect(const sstring& cert, const sstring& key, const sstring& priority, bool resume,
+        size_t connections, unsigned clients, uint16_t port) {
+    tls::credentials_builder b;
+    b.set_x509_key_file(cert, key, tls::x509_crt_format::PEM).get();
+    b.set_priority_string(priority.empty() ? "SECURE128:+SECURE192:-VERS-TLS-ALL:+VERS-TLS1.3" : priority);
+    auto creds = b.build_certificate_credentials();
+    creds->set_enable_certificate_verification(false);
+    auto serv = b.build_server_credentials();
+
+    sharded<tls::session_ticket_key_rotation> rotation;
+    rotation.start(std::chrono::hours(1), tls::session_ticket_key_rotation::generate_key()).get();
+    auto stop_rotation = deferred_stop(rotation);
+    if (resume) {
+        rotation.local().add(serv);
+        creds->set_session_cache(make_shared<tls::client_session_cache>());
+    }
+
+    listen_options opts;
+    opts.reuse_address = true;
+    opts.set_fixed_cpu(this_shard_id());
+    auto addr = make_ipv4_address({0x7f000001, port});
+    auto server = tls::listen(serv, addr, opts);
+
+    // Echoes a byte on each connection
+    gate connections_gate;
+    auto accepts = seastar::async([&] {
+        while (true) {
+            accept_result ar;
+            try {
+                ar = server.accept().get();
+            } catch (...) {
+                break;
+            }
+            (void)with_gate(connections_gate, [s = std::move(ar.connection)] () mutable {
+                return do_with(std::move(s), [] (connected_socket& s) {
+                    return do_with(s.input(), s.output(), [] (input_stream<char>& in, output_stream<char>& out) {
+                        return in.read_exactly(1).then([&out] (temporary_buffer<char> buf) {
+                            return out.write(std::move(buf));
+                        }).then([&out] {
+                            return out.flush();
+                        }).finally([&in, &out] {
+                            return out.close().finally([&in] {
+                                return in.close();
+                            });
+                        });
+                    });
+                });
+            }).handle_exception([] (std::exception_ptr) {});
+        }
+    });
+
+    size_t started = 0;
+    size_t resumed = 0;
+    auto busy = engine().total_busy_time();
+    auto start = clock_type::now();
+    parallel_for_each(std::views::iota(0u, clients), [&] (unsigned) {
+        return seastar::async([&] {
+            while (started < connections) {
+                started++;
+                auto c = tls::connect(creds, addr).get();
+                auto out = c.output();
+                auto in = c.input();
+                out.write("x").get();
+                out.flush().get();
+                // With TLS 1.3 the ticket comes along with the reply
+                in.read_exactly(1).get();
+                resumed += tls::check_session_is_resumed(c).get();
+                out.close().get();
+                in.close().get();
+            }
+        });
+    }).get();
+    auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    auto busy_seconds = std::chrono::duration<double>(engine().total_busy_time() - busy).count();
+
+    server.abort_accept();
+    accepts.get();
+    connections_gate.close().get();
+    return reconnect_result{seconds, busy_seconds, resumed};
+}
+
+int main(int ac, char** av) {
+    app_template at;
+    namespace bpo = boost::program_options;
+    at.add_options()
+            ("bench", bpo::value<sstring>()->default_value("stream"), "stream or reconnect")
+            ("cert", bpo::value<sstring>()->required(), "PEM certificate of the server")
+            ("key", bpo::value<sstring>()->required(), "PEM key of the server")
+            ("priority", bpo::value<sstring>()->default_value(""), "gnutls priority string, to pick the protocol version and cipher suite")
+            ("gb", bpo::value<double>()->default_value(4), "GB to stream per run")
+            ("chunk", bpo::value<size_t>()->default_value(128 * 1024), "Size of the writes")
+            ("connections", bpo::value<size_t>()->default_value(10000), "Connections per reconnect run")
+            ("clients", bpo::value<unsigned>()->default_value(64), "Concurrent clients of a reconnect run")
+            ("runs", bpo::value<unsigned>()->default_value(3), "Number of runs of each mode")
+            ("port", bpo::value<uint16_t>()->default_value(4713), "Loopback port")
+            ;
+    return at.run(ac, av, [&at] {
+        return seastar::async([&at] {
+            auto& opts = at.configuration();
+            auto cert = opts["cert"].as<sstring>();
+            auto key = opts["key"].as<sstring>();
+            auto priority = opts["priority"].as<sstring>();
+            auto runs = opts["runs"].as<unsigned>();
+            auto port = opts["port"].as<uint16_t>();
+
+            if (opts["bench"].as<sstring>() == "reconnect") {
+                auto connections = opts["connections"].as<size_t>();
+                auto clients = opts["clients"].as<unsigned>();
+                fmt::print("{:>10} {:>14} {:>10} {:>22}\n", "handshake", "connections/s", "resumed", "CPU ms per 1000 conn");
+                for (unsigned i = 0; i < runs; i++) {
+                    for (bool resume : {false, true}) {
+                        auto r = run_reconnect(cert, key, priority, resume, connections, clients, port);
+                        fmt::print("{:>10} {:>14.0f} {:>10} {:>22.1f}\n", resume ? "resumed" : "full",
+                                connections / r.seconds, r.resumed, r.busy_seconds * 1e6 / connections);
+                    }
+                }
+                return;
+            }
+
+            auto gb = opts["gb"].as<double>();
+            auto chunk = opts["chunk"].as<size_t>();
+            auto total = size_t(gb * (1ull << 30));
+
+            auto directions = [] (tls::kernel_offload o) {
+                return o.tx && o.rx ? "tx+rx" : o.tx ? "tx" : o.rx ? "rx" : "-";
+            };
+            fmt::print("{:>10} {:>16} {:>16} {:>10} {:>14}\n", "mode", "client offload", "server offload", "GB/s", "CPU s per GB");
+            for (unsigned i = 0; i < runs; i++) {
+                for (bool offload : {false, true}) {
+                    auto r = run_stream(cert, key, priority, offload, total, chunk, port);
+                    fmt::print("{:>10} {:>16} {:>16} {:>10.2f} {:>14.3f}\n", offload ? "kernel" : "gnutls",
+                            directions(r.client), directions(r.server), gb / r.seconds, r.busy_seconds / gb);
+                }
+            }
+        });
+    });
+}
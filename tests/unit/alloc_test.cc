@@ -100,6 +100,63 @@ SEASTAR_TEST_CASE(test_live_objects_counter_with_cross_cpu_free) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_cross_cpu_free_batching) {
+#ifndef SEASTAR_DEFAULT_ALLOCATOR
+    if (smp::count < 2) {
+        return;
+    }
+    constexpr size_t nr_objects = 1000;
+    auto frees_to_before = memory::cross_cpu_frees_to(1);
+    auto batches_before = memory::stats().cross_cpu_free_batches();
+    auto owner_frees_before = smp::submit_to(1, [] { return memory::stats().frees(); }).get();
+
+    auto vec = smp::submit_to(1, [] {
+        std::vector<std::unique_ptr<int>> ret(nr_objects);
+        for (auto& o : ret) {
+            o = std::make_unique<int>(0);
+        }
+        return ret;
+    }).get();
+    vec = decltype(vec)(); // cross-cpu frees, including the vector's own storage
+    memory::drain_cross_cpu_freelist(); // flush partially filled magazines
+
+    auto frees_to = memory::cross_cpu_frees_to(1) - frees_to_before;
+    auto batches = memory::stats().cross_cpu_free_batches() - batches_before;
+    BOOST_REQUIRE_GE(frees_to, nr_objects + 1);
+    BOOST_REQUIRE_GE(batches, 1u);
+    BOOST_REQUIRE_LT(batches, frees_to);
+
+    auto owner_frees = smp::submit_to(1, [] {
+        memory::drain_cross_cpu_freelist();
+        return memory::stats().frees();
+    }).get() - owner_frees_before;
+    BOOST_REQUIRE_GE(owner_frees, nr_objects + 1);
+#endif
+}
+
+SEASTAR_THREAD_TEST_CASE(test_span_refills_same_hugepage) {
+#ifndef SEASTAR_DEFAULT_ALLOCATOR
+    constexpr size_t nr_objects = 100000;
+    auto before = memory::stats();
+    std::vector<void*> objects;
+    objects.reserve(nr_objects);
+    for (size_t i = 0; i < nr_objects; ++i) {
+        objects.push_back(std::malloc(1000));
+    }
+    auto after = memory::stats();
+    for (auto p : objects) {
+        std::free(p);
+    }
+
+    auto refills = after.span_refills() - before.span_refills();
+    auto same_hugepage = after.span_refills_same_hugepage() - before.span_refills_same_hugepage();
+    BOOST_REQUIRE_GT(refills, 0u);
+    BOOST_REQUIRE_GT(same_hugepage, 0u);
+    BOOST_REQUIRE_LE(same_hugepage, refills);
+    BOOST_REQUIRE_LE(after.hugepage_memory(), after.total_memory());
+#endif
+}
+
 SEASTAR_TEST_CASE(test_aligned_alloc) {
     for (size_t align = sizeof(void*); align <= 65536; align <<= 1) {
         for (size_t size = align; size <= align * 2; size <<= 1) {
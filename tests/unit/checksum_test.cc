@@ -0,0 +1,103 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/net/ip_checksum.hh>
+#include <random>
+#include <vector>
+
+using namespace seastar;
+using namespace net;
+
+// Straightforward RFC 1071 implementation to check the optimized ones against
+static uint16_t reference_checksum(const uint8_t* data, size_t len) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        sum += (data[i] << 8) | data[i + 1];
+    }
+    if (len & 1) {
+        sum += data[len - 1] << 8;
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return htons(~sum);
+}
+
+static std::vector<uint8_t> random_data(size_t len) {
+    std::mt19937 rng(len);
+    std::vector<uint8_t> data(len);
+    for (auto& c : data) {
+        c = rng();
+    }
+    return data;
+}
+
+BOOST_AUTO_TEST_CASE(test_checksum_matches_reference) {
+    BOOST_TEST_MESSAGE("checksum kernel: " << internal::checksum_kernel_name());
+    auto data = random_data(66000);
+    auto src = reinterpret_cast<const char*>(data.data());
+    std::mt19937 rng(0);
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t len : {0, 1, 2, 3, 31, 32, 33, 63, 64, 65, 127, 1459, 1460, 9000, 65535}) {
+            auto expected = reference_checksum(data.data() + offset, len);
+            BOOST_REQUIRE_EQUAL(ip_checksum(src + offset, len), expected);
+
+            // split at an arbitrary, possibly odd, point
+            auto split = len ? rng() % len : 0;
+            checksummer csum;
+            csum.sum(src + offset, split);
+            csum.sum(src + offset + split, len - split);
+            BOOST_REQUIRE_EQUAL(csum.get(), expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_copy_and_sum) {
+    auto data = random_data(10000);
+    auto src = reinterpret_cast<const char*>(data.data());
+    std::vector<char> dst(data.size());
+    for (size_t split : {0, 1, 17, 64, 4097}) {
+        checksummer csum;
+        csum.copy_and_sum(dst.data(), src + 1, split);
+        csum.copy_and_sum(dst.data() + split, src + 1 + split, data.size() - 1 - split);
+        BOOST_REQUIRE_EQUAL(csum.get(), reference_checksum(data.data() + 1, data.size() - 1));
+        BOOST_REQUIRE(std::equal(src + 1, src + data.size(), dst.begin()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_linearize_with_checksum) {
+    auto data = random_data(5000);
+    auto src = reinterpret_cast<const char*>(data.data());
+    packet p;
+    for (size_t off = 0, len = 1; off < data.size(); off += len, len = len * 3 + 1) {
+        len = std::min(len, data.size() - off);
+        p = packet(std::move(p), temporary_buffer<char>(src + off, len));
+    }
+    BOOST_REQUIRE_GT(p.nr_frags(), 1);
+    checksummer csum;
+    p.linearize(csum);
+    BOOST_REQUIRE_EQUAL(p.nr_frags(), 1);
+    BOOST_REQUIRE_EQUAL(csum.get(), reference_checksum(data.data(), data.size()));
+    BOOST_REQUIRE(std::equal(src, src + data.size(), p.frag(0).base));
+}
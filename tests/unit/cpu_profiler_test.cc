@@ -0,0 +1,104 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/core/cpu_profiler.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/core/thread_cputime_clock.hh>
+#include <seastar/core/with_scheduling_group.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/defer.hh>
+#include <seastar/util/later.hh>
+#include <algorithm>
+#include <chrono>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+static void spin(std::chrono::duration<double> how_much) {
+    auto end = thread_cputime_clock::now() + how_much;
+    while (thread_cputime_clock::now() < end) {
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cpu_profiler_attribution) {
+    auto sg = create_scheduling_group("profiled", 100).get();
+    auto destroy_sg = defer([&] () noexcept { destroy_scheduling_group(sg).get(); });
+
+    cpu_profile discarded;
+    engine().collect_cpu_profile(discarded, true);
+    engine().set_cpu_profiler_rate(1000);
+    auto stop = defer([] () noexcept { engine().set_cpu_profiler_rate(0); });
+
+    // 200ms of CPU time in continuations of the profiled group
+    with_scheduling_group(sg, [] {
+        return do_with(0, [] (int& i) {
+            return repeat([&i] {
+                return yield().then([&i] {
+                    spin(1ms);
+                    return stop_iteration(++i == 200);
+                });
+            });
+        });
+    }).get();
+    engine().set_cpu_profiler_rate(0);
+
+    cpu_profile profile;
+    engine().collect_cpu_profile(profile, true);
+    BOOST_REQUIRE_GT(profile.samples, 50);
+
+    uint64_t total = 0;
+    uint64_t in_continuations = 0;
+    for (auto& [stack, samples] : profile.stacks) {
+        total += samples;
+        // scheduling group, task type and at least one frame
+        BOOST_REQUIRE_GE(std::ranges::count(stack, ';'), 2);
+        if (stack.starts_with("profiled;seastar::continuation<")) {
+            in_continuations += samples;
+        }
+    }
+    BOOST_REQUIRE_EQUAL(total, profile.samples);
+    BOOST_REQUIRE_GT(in_continuations, profile.samples / 2);
+
+    // Collecting with reset leaves nothing behind
+    cpu_profile after;
+    engine().collect_cpu_profile(after, false);
+    BOOST_REQUIRE_EQUAL(after.samples, 0);
+    BOOST_REQUIRE(after.stacks.empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cpu_profile_of_all_shards) {
+    set_cpu_profiler_rate(1000).get();
+    auto stop = defer([] () noexcept { set_cpu_profiler_rate(0).get(); });
+    smp::invoke_on_all([] {
+        spin(50ms);
+    }).get();
+    set_cpu_profiler_rate(0).get();
+
+    auto profile = collect_cpu_profile(true).get();
+    BOOST_REQUIRE_GT(profile.samples, 0);
+    uint64_t total = 0;
+    for (auto& [stack, samples] : profile.stacks) {
+        total += samples;
+    }
+    BOOST_REQUIRE_EQUAL(total, profile.samples);
+}
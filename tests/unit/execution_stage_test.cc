@@ -29,8 +29,11 @@
 #include <seastar/testing/thread_test_case.hh>
 #include <seastar/testing/test_runner.hh>
 #include <seastar/core/execution_stage.hh>
+#include <seastar/core/sharded.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/util/closeable.hh>
 #include <seastar/util/defer.hh>
+#include <seastar/util/later.hh>
 
 using namespace std::chrono_literals;
 
@@ -334,3 +337,56 @@ SEASTAR_THREAD_TEST_CASE(test_inheriting_concrete_execution_stage_reference_para
     a_struct obj;
     es(seastar::ref(obj), &obj).get();
 }
+
+struct stealable_doubler {
+    seastar::stealable_concrete_execution_stage<future<int>, int> stage{"stealable", [] (int x) {
+        if (x % 7 == 0) {
+            return make_exception_future<int>(std::runtime_error("seven"));
+        }
+        return yield().then([x] { return x * 2; });
+    }};
+
+    future<> stop() {
+        return make_ready_future<>();
+    }
+};
+
+SEASTAR_THREAD_TEST_CASE(test_stealable_execution_stage) {
+    sharded<stealable_doubler> doublers;
+    doublers.start().get();
+    auto stop = deferred_stop(doublers);
+
+    auto& stage = doublers.local().stage;
+    const int calls = 16 * stage.batch_size + 3;
+    auto stolen_calls = [&] {
+        return doublers.map_reduce0([] (stealable_doubler& d) {
+            return d.stage.function_calls_stolen();
+        }, uint64_t(0), std::plus<uint64_t>()).get();
+    };
+    // The other shards only steal while they poll, which they do for a
+    // while after having run something
+    int rounds = 0;
+    do {
+        smp::invoke_on_others([] {}).get();
+        std::vector<future<int>> fs;
+        for (int i = 0; i < calls; i++) {
+            fs.emplace_back(stage(i));
+        }
+        for (int i = 0; i < calls; i++) {
+            if (i % 7 == 0) {
+                BOOST_REQUIRE_THROW(fs[i].get(), std::runtime_error);
+            } else {
+                BOOST_REQUIRE_EQUAL(fs[i].get(), i * 2);
+            }
+        }
+        rounds++;
+    } while (smp::count > 1 && !stolen_calls() && rounds < 10);
+
+    // Every call was executed exactly once, here or on another shard
+    auto stolen = stolen_calls();
+    BOOST_REQUIRE_EQUAL(stage.get_stats().function_calls_enqueued, uint64_t(calls) * rounds);
+    BOOST_REQUIRE_EQUAL(stage.get_stats().function_calls_executed + stolen, uint64_t(calls) * rounds);
+    if (smp::count > 1) {
+        BOOST_REQUIRE_GT(stolen, 0);
+    }
+}
@@ -33,6 +33,7 @@
 #include <seastar/core/sleep.hh>
 #include <seastar/core/print.hh>
 #include <boost/range/irange.hpp>
+#include <algorithm>
 #include <chrono>
 
 using namespace seastar;
@@ -44,8 +45,8 @@ struct request {
     unsigned index;
 
     template <typename Func>
-    request(fair_queue_entry::capacity_t cap, unsigned index, Func&& h)
-        : fqent(cap)
+    request(fair_queue_entry::capacity_t cap, fair_queue_entry::clock_type::time_point deadline, unsigned index, Func&& h)
+        : fqent(cap, deadline)
         , handle(std::move(h))
         , index(index)
     {}
@@ -63,6 +64,7 @@ class test_env {
     std::vector<std::vector<std::exception_ptr>> _exceptions;
     fair_queue::class_id _nr_classes = 0;
     std::vector<request> _inflight;
+    std::vector<fair_queue_entry::clock_type::time_point> _dispatched_deadlines;
 
     static fair_group::config fg_config(unsigned cap) {
         fair_group::config cfg;
@@ -70,9 +72,10 @@ class test_env {
         return cfg;
     }
 
-    static fair_queue::config fq_config() {
+    static fair_queue::config fq_config(bool deadline_dispatch) {
         fair_queue::config cfg;
         cfg.tau = std::chrono::microseconds(50);
+        cfg.deadline_dispatch = deadline_dispatch;
         return cfg;
     }
 
@@ -80,9 +83,9 @@ class test_env {
         do {} while (tick() != 0);
     }
 public:
-    test_env(unsigned capacity)
+    test_env(unsigned capacity, bool deadline_dispatch = false)
         : _fg(fg_config(capacity), 1)
-        , _fq(_fg, fq_config())
+        , _fq(_fg, fq_config(deadline_dispatch))
     {
         // Move _fg._replenished_ts() to far future.
         // This will prevent any `maybe_replenish_capacity` calls (indirectly done by `fair_queue::dispatch_requests()`)
@@ -138,11 +141,12 @@ class test_env {
         return _nr_classes++;
     }
 
-    void do_op(fair_queue::class_id id, unsigned weight) {
+    void do_op(fair_queue::class_id id, unsigned weight, fair_queue_entry::clock_type::time_point deadline = fair_queue_entry::no_deadline) {
         unsigned index = id;
         auto cap = _fq.tokens_capacity(double(weight) / 1'000'000);
-        auto req = std::make_unique<request>(cap, index, [this, index] (request& req) mutable noexcept {
+        auto req = std::make_unique<request>(cap, deadline, index, [this, index] (request& req) mutable noexcept {
             try {
+                _dispatched_deadlines.push_back(req.fqent.deadline());
                 _inflight.push_back(std::move(req));
             } catch (...) {
                 auto eptr = std::current_exception();
@@ -159,6 +163,10 @@ class test_env {
         _fq.update_shares_for_class(id, shares);
     }
 
+    const std::vector<fair_queue_entry::clock_type::time_point>& dispatched_deadlines() const noexcept {
+        return _dispatched_deadlines;
+    }
+
     void reset_results(unsigned index) {
         _results[index] = 0;
     }
@@ -455,3 +463,50 @@ SEASTAR_THREAD_TEST_CASE(test_fair_queue_random_run) {
     auto expected_error = std::max(1, int(round(reqs * 0.05)));
     env.verify(format("random_run ({:d} requests)", reqs), {1, 1}, expected_error);
 }
+
+// Requests of a class are dispatched earliest deadline first, the ones
+// queued without a deadline go after those due sooner than relaxed_deadline.
+SEASTAR_THREAD_TEST_CASE(test_fair_queue_deadline_order) {
+    test_env env(1, true);
+
+    auto a = env.register_priority_class(10);
+
+    auto now = fair_queue_entry::clock_type::now();
+    std::default_random_engine& generator = testing::local_random_engine;
+    std::uniform_int_distribution<unsigned> distribution(1, 50);
+    for (int i = 0; i < 100; ++i) {
+        if (i % 10 == 0) {
+            env.do_op(a, 1);
+        } else {
+            env.do_op(a, 1, now + std::chrono::milliseconds(distribution(generator)));
+        }
+    }
+    yield().get();
+    while (env.dispatched_deadlines().size() < 100) {
+        env.tick();
+    }
+
+    auto& deadlines = env.dispatched_deadlines();
+    BOOST_REQUIRE_EQUAL(deadlines.size(), 100);
+    BOOST_REQUIRE(std::is_sorted(deadlines.begin(), deadlines.end()));
+    BOOST_REQUIRE(deadlines.back() >= now + 100ms);
+}
+
+// Deadlines reorder requests within a class, but don't change the shares.
+SEASTAR_THREAD_TEST_CASE(test_fair_queue_deadline_shares) {
+    test_env env(1, true);
+
+    auto a = env.register_priority_class(10);
+    auto b = env.register_priority_class(20);
+
+    auto now = fair_queue_entry::clock_type::now();
+    for (int i = 0; i < 100; ++i) {
+        // The latest deadline first, every new request goes to the head
+        env.do_op(a, 1, now + std::chrono::milliseconds(100 - i));
+        env.do_op(b, 1);
+    }
+    yield().get();
+    // allow half the requests in
+    env.tick(100);
+    env.verify("deadline_shares", {1, 2});
+}
@@ -29,6 +29,7 @@
 #include <seastar/core/do_with.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/semaphore.hh>
+#include <seastar/core/sleep.hh>
 #include <seastar/testing/random.hh>
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/test_runner.hh>
@@ -539,6 +540,62 @@ SEASTAR_TEST_CASE(test_fstream_slow_start) {
     });
 }
 
+SEASTAR_TEST_CASE(test_fstream_adaptive_read_ahead) {
+    return seastar::async([] {
+        static constexpr size_t file_size = 128 * 1024 * 1024;
+        static constexpr size_t buffer_size = 16 * 1024;
+
+        auto mock_file = make_shared<mock_read_only_file>(file_size);
+        mock_file->set_allowed_read_requests(std::numeric_limits<size_t>::max());
+        std::vector<size_t> read_sizes;
+        mock_file->set_read_size_verifier([&] (size_t length) {
+            read_sizes.push_back(length);
+        });
+
+        file_input_stream_options options{};
+        options.buffer_size = buffer_size;
+        options.read_ahead = 4;
+        options.adaptive_read_ahead = true;
+        auto in = make_file_input_stream(file(mock_file), 0, file_size, options);
+        auto close_in = deferred_close(in);
+
+        auto read_sequentially = [&] {
+            read_sizes.clear();
+            for (unsigned i = 0; i < 32; i++) {
+                BOOST_REQUIRE_GT(in.read().get().size(), 0u);
+            }
+            // Starts as a point read, then requests grow as the stream
+            // turns out to be read sequentially
+            BOOST_REQUIRE_EQUAL(read_sizes.front(), buffer_size);
+            BOOST_REQUIRE(std::is_sorted(read_sizes.begin(), read_sizes.end()));
+            BOOST_REQUIRE_GE(read_sizes.back(), buffer_size * 16);
+        };
+
+        BOOST_TEST_MESSAGE("Reading sequentially");
+        read_sequentially();
+
+        BOOST_TEST_MESSAGE("Skipping");
+        in.skip(8 * 1024 * 1024).get();
+        read_sequentially();
+
+        BOOST_TEST_MESSAGE("Skipping within the data read ahead");
+        in.skip(100).get();
+        read_sizes.clear();
+        for (unsigned i = 0; i < 4; i++) {
+            BOOST_REQUIRE_GT(in.read().get().size(), 0u);
+        }
+        BOOST_REQUIRE(!read_sizes.empty());
+        BOOST_REQUIRE_GE(read_sizes.front(), buffer_size * 16);
+
+        BOOST_TEST_MESSAGE("Stalling");
+        seastar::sleep(std::chrono::milliseconds(200)).get();
+        read_sizes.clear();
+        in.read().get();
+        BOOST_REQUIRE(!read_sizes.empty());
+        BOOST_REQUIRE_EQUAL(read_sizes.back(), buffer_size);
+    });
+}
+
 #ifdef SEASTAR_ENABLE_ALLOC_FAILURE_INJECTION
 
 SEASTAR_TEST_CASE(test_close_error) {
@@ -183,6 +183,105 @@ SEASTAR_TEST_CASE(test_add_del_cookie)
     return make_ready_future<>();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_route_tree_precedence) {
+    routes rts;
+    auto param = new handl();
+    auto exact = new handl();
+    auto later = new handl();
+    auto remainder = new handl();
+    rts.add(GET, url("/api/v1").remainder("rest"), remainder);
+    auto rule = new match_rule(param);
+    rule->add_str("/api/v1/items").add_param("id");
+    rts.add(rule, GET);
+    // Added later, so the parameter rule wins over it
+    auto other = new match_rule(later);
+    other->add_str("/api/v1/items/first");
+    rts.add(other, GET);
+    rts.put(GET, "/api/v1/items/first", exact);
+
+    parameters params;
+    httpd::handler_base* nl = nullptr;
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/api/v1/items/first", params), exact);
+    // The remainder rule was added first
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/api/v1/items/second", params), remainder);
+    BOOST_REQUIRE_EQUAL(params.path("rest"), "/items/second");
+
+    delete rts.del_cookie(0, GET);
+    params.clear();
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/api/v1/items/second", params), param);
+    BOOST_REQUIRE_EQUAL(params.path("id"), "/second");
+    BOOST_REQUIRE(!params.exists("rest"));
+    params.clear();
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/api/v1/items/second/", params), param);
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/api/v1/items/second/x", params), nl);
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/api/v1/itemsx/second", params), nl);
+
+    delete rts.drop(GET, "/api/v1/items/first");
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/api/v1/items/first", params), param);
+    BOOST_REQUIRE_EQUAL(rts.get_handler(POST, "/api/v1/items/first", params), nl);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_route_tree_params) {
+    routes rts;
+    auto h1 = new handl();
+    auto h2 = new handl();
+    path_description path1("/my/path", GET, "path1",
+        {{"param1", path_description::url_component_type::PARAM}
+        ,{"/text", path_description::url_component_type::FIXED_STRING}
+        ,{"param2", path_description::url_component_type::PARAM}}, {});
+    path_description path2("/my/path", GET, "path2",
+        {{"param3", path_description::url_component_type::PARAM}
+        ,{"param4", path_description::url_component_type::PARAM_UNTIL_END_OF_PATH}}, {});
+    path1.set(rts, h1);
+    path2.set(rts, h2);
+
+    parameters params;
+    httpd::handler_base* nl = nullptr;
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/my/path/a/text/b", params), h1);
+    BOOST_REQUIRE_EQUAL(params.get_decoded_param("param1"), "a");
+    BOOST_REQUIRE_EQUAL(params.get_decoded_param("param2"), "b");
+    params.clear();
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/my/path/a/other/b", params), h2);
+    BOOST_REQUIRE_EQUAL(params.get_decoded_param("param3"), "a");
+    BOOST_REQUIRE_EQUAL(params.get_decoded_param("param4"), "other/b");
+    BOOST_REQUIRE(!params.exists("param1"));
+    params.clear();
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/my/path/a", params), h2);
+    BOOST_REQUIRE_EQUAL(params.path("param4"), "");
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/my/path", params), nl);
+
+    path1.unset(rts);
+    params.clear();
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/my/path/a/text/b", params), h2);
+    BOOST_REQUIRE_EQUAL(params.get_decoded_param("param4"), "text/b");
+}
+
+// Rules the tree cannot hold keep their place among the others
+SEASTAR_THREAD_TEST_CASE(test_route_tree_custom_matcher) {
+    struct any_matcher : public matcher {
+        virtual size_t match(const sstring& url, size_t ind, parameters& param) override {
+            return url.length();
+        }
+    };
+    routes rts;
+    auto first = new handl();
+    auto custom = new handl();
+    auto last = new handl();
+    auto rule = new match_rule(first);
+    rule->add_str("/first");
+    rts.add(rule, GET);
+    auto custom_rule = new match_rule(custom);
+    custom_rule->add_str("/custom").add_matcher(new any_matcher());
+    rts.add(custom_rule, GET);
+    rts.add(GET, url("/custom").remainder("path"), last);
+
+    parameters params;
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/first", params), first);
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/custom/a/b", params), custom);
+    delete rts.del_cookie(1, GET);
+    BOOST_REQUIRE_EQUAL(rts.get_handler(GET, "/custom/a/b", params), last);
+}
+
 SEASTAR_TEST_CASE(test_formatter)
 {
     BOOST_REQUIRE_EQUAL(json::formatter::to_json(true), "true");
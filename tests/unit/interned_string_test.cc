@@ -0,0 +1,123 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/core/interned_string.hh>
+#include <fmt/format.h>
+#include <string>
+#include <unordered_set>
+
+using namespace std::literals;
+using namespace seastar;
+
+BOOST_AUTO_TEST_CASE(test_interning_deduplicates) {
+    string_pool pool;
+    auto a = pool.intern("content-type");
+    auto b = pool.intern(sstring("content-type"));
+    auto c = pool.intern("content-length"sv);
+    BOOST_REQUIRE(a == b);
+    BOOST_REQUIRE(a != c);
+    BOOST_REQUIRE_EQUAL(a.data(), b.data());
+    BOOST_REQUIRE_EQUAL(a.hash(), b.hash());
+    BOOST_REQUIRE_EQUAL(a.view(), "content-type"sv);
+    BOOST_REQUIRE_EQUAL(c.str(), sstring("content-length"));
+    BOOST_REQUIRE_EQUAL(pool.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_empty_string) {
+    string_pool pool;
+    auto e = pool.intern("");
+    BOOST_REQUIRE(e == interned_string());
+    BOOST_REQUIRE(e.empty());
+    BOOST_REQUIRE_EQUAL(e.size(), 0);
+    BOOST_REQUIRE_EQUAL(e.view(), ""sv);
+    BOOST_REQUIRE_EQUAL(pool.size(), 0);
+    BOOST_REQUIRE(pool.find("") == interned_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_find) {
+    string_pool pool;
+    BOOST_REQUIRE(!pool.find("missing"));
+    auto a = pool.intern("present");
+    BOOST_REQUIRE(pool.find("present") == a);
+    BOOST_REQUIRE(!pool.find("missing"));
+    BOOST_REQUIRE_EQUAL(pool.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_many_strings) {
+    string_pool pool;
+    std::vector<interned_string> handles;
+    for (int i = 0; i < 100000; i++) {
+        handles.push_back(pool.intern(fmt::format("key:{}", i)));
+    }
+    BOOST_REQUIRE_EQUAL(pool.size(), 100000);
+    for (int i = 0; i < 100000; i++) {
+        auto s = fmt::format("key:{}", i);
+        BOOST_REQUIRE_EQUAL(handles[i].view(), s);
+        BOOST_REQUIRE(pool.intern(s) == handles[i]);
+    }
+    BOOST_REQUIRE_EQUAL(pool.size(), 100000);
+    BOOST_REQUIRE_GT(pool.memory_used(), 100000 * 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_large_strings) {
+    string_pool pool;
+    auto small = pool.intern("small");
+    std::string big(1 << 20, 'x');
+    auto b = pool.intern(big);
+    BOOST_REQUIRE_EQUAL(b.view(), big);
+    BOOST_REQUIRE(pool.intern(big) == b);
+    // Large strings get their own chunk, the current one is still used
+    auto small2 = pool.intern("small2");
+    BOOST_REQUIRE_EQUAL(small.view(), "small"sv);
+    BOOST_REQUIRE_EQUAL(small2.view(), "small2"sv);
+    BOOST_REQUIRE_EQUAL(pool.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_containers_and_ordering) {
+    string_pool pool;
+    std::unordered_set<interned_string> set;
+    set.insert(pool.intern("b"));
+    set.insert(pool.intern("a"));
+    set.insert(pool.intern("b"));
+    BOOST_REQUIRE_EQUAL(set.size(), 2);
+    BOOST_REQUIRE(set.contains(pool.intern("a")));
+    BOOST_REQUIRE(pool.intern("a") < pool.intern("b"));
+    BOOST_REQUIRE(pool.intern("ab") > pool.intern("a"));
+    BOOST_REQUIRE_EQUAL(fmt::format("{}", pool.intern("fmt")), "fmt");
+}
+
+BOOST_AUTO_TEST_CASE(test_clear) {
+    string_pool pool;
+    pool.intern("gone");
+    pool.clear();
+    BOOST_REQUIRE_EQUAL(pool.size(), 0);
+    BOOST_REQUIRE_EQUAL(pool.memory_used(), 0);
+    BOOST_REQUIRE(!pool.find("gone"));
+    BOOST_REQUIRE_EQUAL(pool.intern("back").view(), "back"sv);
+}
+
+BOOST_AUTO_TEST_CASE(test_local_pool) {
+    auto a = intern("shard-local");
+    BOOST_REQUIRE(a == string_pool::local().intern("shard-local"));
+}
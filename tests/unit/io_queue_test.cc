@@ -94,6 +94,18 @@ struct io_queue_for_tests {
     future<size_t> queue_request(internal::priority_class pc, internal::io_direction_and_length dnl, internal::io_request req, io_intent* intent, iovec_keeper iovs) noexcept {
         return queue.queue_request(pc, dnl, std::move(req), intent, std::move(iovs));
     }
+
+    static void feed_capacity_estimate(io_group& g, std::chrono::duration<double> exec_time, uint64_t completions, bool backlogged) {
+        g.update_capacity(exec_time * completions, completions, backlogged);
+    }
+
+    static double capacity_factor(const io_group& g) {
+        return g.capacity_factor();
+    }
+
+    static fair_group::capacity_t replenish_rate(const io_group& g) {
+        return g._fgs.front().token_bucket().rate();
+    }
 };
 
 internal::priority_class get_default_pc() {
@@ -325,6 +337,44 @@ SEASTAR_THREAD_TEST_CASE(test_io_cancellation) {
     when_all_succeed(finished.begin(), finished.end()).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_adaptive_capacity) {
+    io_queue::config cfg{0};
+    cfg.adaptive_capacity = true;
+    // Re-estimate on every update
+    cfg.averaging_decay_ticks = 0;
+    io_group group(cfg, 1);
+    auto goal = group.io_latency_goal();
+    auto nominal_rate = io_queue_for_tests::replenish_rate(group);
+
+    // Requests execute for twice as long as they may, the disk is at half the
+    // configured capacity
+    io_queue_for_tests::feed_capacity_estimate(group, 4 * goal, 10, true);
+    BOOST_REQUIRE_CLOSE(io_queue_for_tests::capacity_factor(group), 0.5, 0.1);
+    BOOST_REQUIRE_CLOSE(double(io_queue_for_tests::replenish_rate(group)), nominal_rate * 0.5, 0.1);
+
+    // Within the goal, but not really fast either
+    io_queue_for_tests::feed_capacity_estimate(group, 1.5 * goal, 10, true);
+    BOOST_REQUIRE_CLOSE(io_queue_for_tests::capacity_factor(group), 0.5, 0.1);
+
+    // Fast, but nobody waits for the disk
+    io_queue_for_tests::feed_capacity_estimate(group, 0.5 * goal, 10, false);
+    BOOST_REQUIRE_CLOSE(io_queue_for_tests::capacity_factor(group), 0.5, 0.1);
+
+    // Fast and requests wait in the queue, probe for more
+    io_queue_for_tests::feed_capacity_estimate(group, 0.5 * goal, 10, true);
+    BOOST_REQUIRE_GT(io_queue_for_tests::capacity_factor(group), 0.5);
+
+    for (int i = 0; i < 100; i++) {
+        io_queue_for_tests::feed_capacity_estimate(group, 100 * goal, 10, true);
+    }
+    BOOST_REQUIRE_CLOSE(io_queue_for_tests::capacity_factor(group), cfg.capacity_factor_min, 0.1);
+
+    for (int i = 0; i < 100; i++) {
+        io_queue_for_tests::feed_capacity_estimate(group, 0.1 * goal, 10, true);
+    }
+    BOOST_REQUIRE_CLOSE(io_queue_for_tests::capacity_factor(group), cfg.capacity_factor_max, 0.1);
+}
+
 SEASTAR_TEST_CASE(test_request_buffer_split) {
     auto ensure = [] (const std::vector<internal::io_request::part>& parts, const internal::io_request& req, int idx, uint64_t pos, size_t size, uintptr_t mem) {
         BOOST_REQUIRE(parts[idx].req.opcode() == req.opcode());
@@ -31,6 +31,7 @@
 #include <seastar/core/io_queue.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/core/internal/estimated_histogram.hh>
+#include <seastar/core/native_histogram.hh>
 #include <seastar/testing/random.hh>
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -389,3 +390,68 @@ SEASTAR_THREAD_TEST_CASE(test_estimated_histogram) {
         BOOST_CHECK_EQUAL(mh.buckets[i].count, 33 + i);
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_native_histogram) {
+    using namespace seastar::metrics;
+    using hist = native_histogram<2>;
+
+    BOOST_CHECK_EQUAL(hist::num_buckets, 248);
+    // Everything up to 4 is in the first bucket, then each power of two
+    // is split into 4 buckets
+    for (uint64_t v : {0, 1, 4}) {
+        BOOST_CHECK_EQUAL(hist::bucket_index(v), 0);
+    }
+    BOOST_CHECK_EQUAL(hist::bucket_index(5), 1);
+    BOOST_CHECK_EQUAL(hist::bucket_index(7), 3);
+    BOOST_CHECK_EQUAL(hist::bucket_index(8), 4);
+    BOOST_CHECK_EQUAL(hist::bucket_index(9), 4);
+    BOOST_CHECK_EQUAL(hist::bucket_index(10), 5);
+    BOOST_CHECK_EQUAL(hist::bucket_index(std::numeric_limits<uint64_t>::max()), hist::num_buckets - 1);
+    for (size_t i = 0; i < hist::num_buckets; i++) {
+        BOOST_CHECK_EQUAL(hist::bucket_index(hist::bucket_upper_bound(i)), i);
+        if (i > 0) {
+            BOOST_CHECK_EQUAL(hist::bucket_index(hist::bucket_lower_bound(i)), i);
+            BOOST_CHECK_EQUAL(hist::bucket_upper_bound(i - 1) + 1, hist::bucket_lower_bound(i));
+        }
+    }
+
+    hist h1;
+    hist h2;
+    for (uint64_t v = 1; v <= 100; v++) {
+        h1.add(v);
+    }
+    h2.add(1000);
+    BOOST_CHECK_EQUAL(h1.count(), 100);
+    BOOST_CHECK_EQUAL(h1.sum(), 5050);
+    BOOST_CHECK_EQUAL(h1.quantile(0), 4);
+    // 50 is in [48, 55], 99 in [96, 111]
+    BOOST_CHECK_EQUAL(h1.quantile(0.5), 55);
+    BOOST_CHECK_EQUAL(h1.quantile(0.99), 111);
+
+    auto m1 = h1.to_metrics_histogram();
+    auto m2 = h2.to_metrics_histogram();
+    BOOST_REQUIRE(m1.native_histogram);
+    BOOST_CHECK_EQUAL(m1.native_histogram->schema, 2);
+    BOOST_CHECK_EQUAL(m1.native_histogram->min_id, 9);
+    BOOST_CHECK_EQUAL(m1.buckets.size(), hist::bucket_index(100) + 1);
+    BOOST_CHECK_EQUAL(m1.buckets.back().count, 100);
+    BOOST_CHECK_EQUAL(m1.buckets.back().upper_bound, 111);
+    BOOST_CHECK_EQUAL(m2.buckets.size(), hist::bucket_index(1000) + 1);
+
+    // Snapshots of different lengths merge as the metrics layer does it
+    // when aggregating shards
+    auto merged = m1 + m2;
+    h1.merge(h2);
+    auto expected = h1.to_metrics_histogram();
+    BOOST_CHECK_EQUAL(merged.sample_count, 101);
+    BOOST_CHECK_EQUAL(merged.sample_sum, 6050);
+    BOOST_REQUIRE_EQUAL(merged.buckets.size(), expected.buckets.size());
+    for (size_t i = 0; i < expected.buckets.size(); i++) {
+        BOOST_CHECK_EQUAL(merged.buckets[i].count, expected.buckets[i].count);
+        BOOST_CHECK_EQUAL(merged.buckets[i].upper_bound, expected.buckets[i].upper_bound);
+    }
+
+    h1.clear();
+    BOOST_CHECK_EQUAL(h1.count(), 0);
+    BOOST_CHECK(h1.to_metrics_histogram().buckets.empty());
+}
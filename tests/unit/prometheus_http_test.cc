@@ -47,6 +47,15 @@ struct test_metrics {
             metrics::make_gauge("int_test", [] { return 10; }, metrics::description{"simple minimal test"}),
             metrics::make_gauge("double_test", [] { return 1234567654321.0; }, metrics::description{"test that a long double is printed fully and not in scientific notation"}),
             metrics::make_counter("counter_test", [] () -> int64_t { return 1234567654321; }, metrics::description{"test with a long counter value"}),
+            metrics::make_gauge("aggregated_test", [] { return 10; }, metrics::description{"test that series are aggregated"}).aggregate({metrics::shard_label}),
+            metrics::make_histogram("histogram_test", metrics::description{"test that a histogram is printed"}, [] {
+                metrics::histogram h;
+                h.sample_count = 3;
+                h.sample_sum = 5;
+                h.buckets.push_back({1, 1.0});
+                h.buckets.push_back({3, 2.0});
+                return h;
+            }),
         });
     }
 };
@@ -81,6 +90,10 @@ future<> test_prometheus_metrics_body() {
             BOOST_REQUIRE_MESSAGE(std::ranges::search(resp_str, R"(seastar_aaaa_int_test{shard="0"} 10.000000)"sv), "Response: " + resp_str);
             BOOST_REQUIRE_MESSAGE(std::ranges::search(resp_str, R"(seastar_aaaa_double_test{shard="0"} 1234567654321.000000)"sv), "Response: " + resp_str);
             BOOST_REQUIRE_MESSAGE(std::ranges::search(resp_str, R"(seastar_aaaa_counter_test{shard="0"} 1234567654321)"sv), "Response: " + resp_str);
+            BOOST_REQUIRE_MESSAGE(std::ranges::search(resp_str, R"(seastar_aaaa_aggregated_test{} 10.000000)"sv), "Response: " + resp_str);
+            BOOST_REQUIRE_MESSAGE(std::ranges::search(resp_str, "seastar_aaaa_histogram_test_sum{shard=\"0\"} 5\n"sv), "Response: " + resp_str);
+            BOOST_REQUIRE_MESSAGE(std::ranges::search(resp_str, R"(seastar_aaaa_histogram_test_bucket{le="1.000000",shard="0"} 1)"sv), "Response: " + resp_str);
+            BOOST_REQUIRE_MESSAGE(std::ranges::search(resp_str, R"(seastar_aaaa_histogram_test_bucket{le="+Inf",shard="0"} 3)"sv), "Response: " + resp_str);
         });
 
         server.do_accepts(0).get();
@@ -25,6 +25,7 @@
 #include <seastar/core/temporary_buffer.hh>
 #include <seastar/http/request.hh>
 #include <seastar/http/request_parser.hh>
+#include <seastar/http/simd_request_parser.hh>
 #include <seastar/testing/test_case.hh>
 #include <tuple>
 #include <utility>
@@ -32,19 +33,21 @@
 
 using namespace seastar;
 
-SEASTAR_TEST_CASE(test_header_parsing) {
-    struct test_set {
-        sstring msg;
-        bool parsable;
-        sstring header_name = "";
-        sstring header_value = "";
-
-        temporary_buffer<char> buf() {
-            return temporary_buffer<char>(msg.c_str(), msg.size());
-        }
-    };
+namespace {
+
+struct test_set {
+    sstring msg;
+    bool parsable;
+    sstring header_name = "";
+    sstring header_value = "";
 
-    std::vector<test_set> tests = {
+    temporary_buffer<char> buf() {
+        return temporary_buffer<char>(msg.c_str(), msg.size());
+    }
+};
+
+std::vector<test_set> header_tests() {
+    return {
         { "GET /test HTTP/1.1\r\nHost: test\r\n\r\n", true, "Host", "test" },
         { "GET /hello HTTP/1.0\r\nHeader: Field\r\n\r\n", true, "Header", "Field" },
         { "GET /hello HTTP/1.0\r\nHeader: \r\n\r\n", true, "Header", "" },
@@ -59,9 +62,13 @@ SEASTAR_TEST_CASE(test_header_parsing) {
         { "GET /hello HTTP/1.0\r\nHeader@: Field\r\n\r\n", false },
         { "GET /hello HTTP/1.0\r\nHeader: fiel\r\nd \r\n\r\n", false }
     };
+}
+
+}
 
+SEASTAR_TEST_CASE(test_header_parsing) {
     http_request_parser parser;
-    for (auto& tset : tests) {
+    for (auto& tset : header_tests()) {
         parser.init();
         BOOST_REQUIRE(parser(tset.buf()).get().has_value());
         BOOST_REQUIRE_NE(parser.failed(), tset.parsable);
@@ -72,3 +79,98 @@ SEASTAR_TEST_CASE(test_header_parsing) {
     }
     return make_ready_future<>();
 }
+
+SEASTAR_TEST_CASE(test_simd_header_parsing) {
+    http_simd_request_parser parser;
+    for (auto& tset : header_tests()) {
+        // Feed the request in two pieces, split at every position, and
+        // check that the bytes following the head are left unconsumed
+        sstring msg = tset.msg + "body";
+        for (size_t split = 1; split < msg.size(); ++split) {
+            parser.init();
+            auto res = parser(temporary_buffer<char>(msg.c_str(), split)).get();
+            if (std::holds_alternative<continue_consuming>(res.get())) {
+                BOOST_REQUIRE_LT(split, tset.msg.size());
+                res = parser(temporary_buffer<char>(msg.c_str() + split, msg.size() - split)).get();
+            }
+            auto& rest = std::get<stop_consuming<char>>(res.get()).get_buffer();
+            BOOST_REQUIRE_NE(parser.failed(), tset.parsable);
+            if (tset.parsable) {
+                auto end = std::max(split, tset.msg.size());
+                BOOST_REQUIRE_EQUAL(std::string_view(rest.get(), rest.size()), std::string_view(msg).substr(tset.msg.size(), end - tset.msg.size()));
+                auto req = parser.get_parsed_request();
+                BOOST_REQUIRE_EQUAL(req->_method, "GET");
+                BOOST_REQUIRE_EQUAL(req->get_header(tset.header_name), tset.header_value);
+            }
+        }
+    }
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_simd_parser_views) {
+    sstring msg = "POST /path?x=1 HTTP/1.1\r\nHost: test\r\nX-A: 1\r\nx-a: 2\r\n\r\n";
+    http_simd_request_parser parser;
+    parser.init();
+    BOOST_REQUIRE(std::holds_alternative<stop_consuming<char>>(parser(temporary_buffer<char>(msg.c_str(), msg.size())).get().get()));
+    BOOST_REQUIRE(!parser.failed());
+    BOOST_REQUIRE_EQUAL(parser.method(), "POST");
+    BOOST_REQUIRE_EQUAL(parser.url(), "/path?x=1");
+    BOOST_REQUIRE_EQUAL(parser.version(), "1.1");
+    BOOST_REQUIRE_EQUAL(parser.headers().size(), 3);
+    BOOST_REQUIRE_EQUAL(parser.get_header("x-A").value_or("none"), "1");
+    BOOST_REQUIRE(!parser.get_header("Content-Length"));
+    BOOST_REQUIRE_EQUAL(parser.get_parsed_request()->get_header("X-A"), "1,2");
+
+    parser.init();
+    BOOST_REQUIRE(std::holds_alternative<stop_consuming<char>>(parser(temporary_buffer<char>()).get().get()));
+    BOOST_REQUIRE(parser.eof());
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(test_simd_parser_head_size_limit) {
+    sstring head = "GET / HTTP/1.1\r\nHost: test\r\n\r\n";
+    http_simd_request_parser parser;
+    auto feed = [&] (const sstring& msg, size_t split) {
+        parser.init();
+        auto res = parser(temporary_buffer<char>(msg.c_str(), split)).get();
+        if (std::holds_alternative<continue_consuming>(res.get())) {
+            res = parser(temporary_buffer<char>(msg.c_str() + split, msg.size() - split)).get();
+        }
+        BOOST_REQUIRE(std::holds_alternative<stop_consuming<char>>(res.get()));
+    };
+
+    // A head of exactly the limit is accepted, one byte more is not,
+    // whether it comes in one buffer or two
+    for (size_t split : {head.size(), size_t(1), head.size() / 2, head.size() - 1}) {
+        parser.set_max_head_size(head.size());
+        feed(head, split);
+        BOOST_REQUIRE(!parser.failed());
+        parser.set_max_head_size(head.size() - 1);
+        feed(head, split);
+        BOOST_REQUIRE(parser.failed());
+        BOOST_REQUIRE(parser.head_too_large());
+    }
+
+    // An unterminated head is rejected once it is past the limit
+    parser.set_max_head_size(http_simd_request_parser::default_max_head_size);
+    parser.init();
+    sstring chunk(4096, 'a');
+    chunk = "GET / HTTP/1.1\r\nX: " + chunk;
+    size_t fed = 0;
+    while (fed <= http_simd_request_parser::default_max_head_size) {
+        auto res = parser(temporary_buffer<char>(chunk.c_str(), chunk.size())).get();
+        fed += chunk.size();
+        if (std::holds_alternative<stop_consuming<char>>(res.get())) {
+            break;
+        }
+    }
+    BOOST_REQUIRE(parser.head_too_large());
+
+    // Malformed heads within the limit are still plain errors
+    parser.init();
+    sstring bad = "GET / HTTP/1.1\r\nHeader Field\r\n\r\n";
+    parser(temporary_buffer<char>(bad.c_str(), bad.size())).get();
+    BOOST_REQUIRE(parser.failed());
+    BOOST_REQUIRE(!parser.head_too_large());
+    return make_ready_future<>();
+}
@@ -27,6 +27,9 @@
 #include <seastar/rpc/lz4_compressor.hh>
 #include <seastar/rpc/lz4_fragmented_compressor.hh>
 #include <seastar/rpc/multi_algo_compressor_factory.hh>
+#ifdef SEASTAR_HAVE_ZSTD
+#include <seastar/rpc/zstd_compressor.hh>
+#endif
 #include <seastar/testing/random.hh>
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -1275,6 +1278,67 @@ SEASTAR_THREAD_TEST_CASE(test_lz4_fragmented_compressor) {
     test_compressor([] { return std::make_unique<rpc::lz4_fragmented_compressor>(); });
 }
 
+#ifdef SEASTAR_HAVE_ZSTD
+
+SEASTAR_THREAD_TEST_CASE(test_zstd_compressor) {
+    test_compressor([] { return std::make_unique<rpc::zstd_compressor>(); });
+}
+
+static std::shared_ptr<const rpc::zstd_compressor::dictionary> make_zstd_dictionary(unsigned seed) {
+    std::vector<temporary_buffer<char>> samples;
+    for (unsigned i = 0; i < 1000; i++) {
+        auto s = fmt::format("{{\"seed\":{},\"id\":{},\"name\":\"user{}\",\"state\":\"{}\"}}",
+                seed, i * 7919 % 1000, i % 13, i % 3 ? "active" : "suspended");
+        samples.emplace_back(s.data(), s.size());
+    }
+    auto data = rpc::zstd_compressor::dictionary::train(samples, 4096);
+    return std::make_shared<const rpc::zstd_compressor::dictionary>(std::string_view(data));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_zstd_dictionary_compressor) {
+    auto dict = make_zstd_dictionary(0);
+    test_compressor([dict] { return std::make_unique<rpc::zstd_compressor>(dict); });
+
+    // Raw content dictionaries have no id of their own
+    auto raw = std::make_shared<const rpc::zstd_compressor::dictionary>(std::string_view("{\"id\":0,\"name\":\"user\",\"state\":\"active\"}"));
+    BOOST_REQUIRE_NE(raw->id(), 0);
+    test_compressor([raw] { return std::make_unique<rpc::zstd_compressor>(raw); });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_zstd_dictionary_negotiation) {
+    auto dict1 = make_zstd_dictionary(1);
+    auto dict2 = make_zstd_dictionary(2);
+    BOOST_REQUIRE_NE(dict1->id(), dict2->id());
+    auto plain = rpc::zstd_compressor::factory();
+    auto with_dict1 = rpc::zstd_compressor::factory(dict1);
+    auto with_dict2 = rpc::zstd_compressor::factory(dict2);
+
+    BOOST_REQUIRE_EQUAL(plain.supported(), "ZSTD");
+    BOOST_REQUIRE_EQUAL(with_dict1.supported(), fmt::format("ZSTD_DICT_{}", dict1->id()));
+
+    // Same dictionary on both sides
+    auto c = with_dict1.negotiate(with_dict1.supported(), true);
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(c->name(), with_dict1.supported());
+    // Peers without a dictionary, or with a different one, don't get it
+    BOOST_REQUIRE(!plain.negotiate(with_dict1.supported(), true));
+    BOOST_REQUIRE(!with_dict2.negotiate(with_dict1.supported(), true));
+    // but a server with a dictionary still serves plain clients
+    c = with_dict1.negotiate(plain.supported(), true);
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(c->name(), "ZSTD");
+
+    // A client with a dictionary falls back to plain zstd when the
+    // server has another one
+    auto client = rpc::multi_algo_compressor_factory({&with_dict1, &plain});
+    auto server = rpc::multi_algo_compressor_factory({&with_dict2, &plain});
+    c = server.negotiate(client.supported(), true);
+    BOOST_REQUIRE(c);
+    BOOST_REQUIRE_EQUAL(c->name(), "ZSTD");
+}
+
+#endif
+
 // Test reproducing issue #671: If timeout is time_point::max(), translating
 // it to relative timeout in the sender and then back in the receiver, when
 // these calculations happen across a millisecond boundary, overflowed the
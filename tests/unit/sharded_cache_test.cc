@@ -0,0 +1,308 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/manual_clock.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/sharded_cache.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/util/later.hh>
+#include <map>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+template <typename Eviction, typename Clock = lowres_clock>
+struct test_entry : public cache_entry<Eviction, Clock> {
+    sstring _key;
+    int value;
+
+    test_entry(sstring key, int value)
+        : cache_entry<Eviction, Clock>(std::hash<sstring>()(key))
+        , _key(std::move(key))
+        , value(value)
+    {}
+    const sstring& key() const {
+        return _key;
+    }
+};
+
+// Owns its entries and records why they left the cache
+template <typename Eviction, typename Clock = lowres_clock>
+struct test_cache {
+    using entry = test_entry<Eviction, Clock>;
+
+    std::map<sstring, cache_removal_cause> removed;
+    local_cache<entry, Eviction> cache;
+
+    explicit test_cache(cache_config cfg = {})
+        : cache(cfg, [this] (entry& e, cache_removal_cause cause) {
+            removed[e.key()] = cause;
+            delete &e;
+        })
+    {}
+
+    bool put(sstring key, int value = 0, size_t charge = 1, typename entry::time_point expiry = entry::never_expires) {
+        auto e = new entry(std::move(key), value);
+        if (!cache.insert(*e, charge, expiry)) {
+            delete e;
+            return false;
+        }
+        return true;
+    }
+    entry* get(const sstring& key) {
+        return cache.find(key, std::hash<sstring>()(key));
+    }
+    bool evicted(const sstring& key) const {
+        auto i = removed.find(key);
+        return i != removed.end() && i->second == cache_removal_cause::evicted;
+    }
+};
+
+SEASTAR_THREAD_TEST_CASE(test_cache_find_insert_erase) {
+    test_cache<no_eviction> c;
+    BOOST_REQUIRE(c.put("a", 1, 10));
+    BOOST_REQUIRE(c.put("b", 2, 20));
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 2);
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 30);
+    BOOST_REQUIRE_EQUAL(c.get("a")->value, 1);
+    BOOST_REQUIRE(!c.get("c"));
+
+    // Inserting an existing key replaces the entry
+    BOOST_REQUIRE(c.put("a", 3, 5));
+    BOOST_REQUIRE(c.removed.at("a") == cache_removal_cause::erased);
+    BOOST_REQUIRE_EQUAL(c.get("a")->value, 3);
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 25);
+
+    c.cache.erase(*c.get("b"));
+    BOOST_REQUIRE(!c.get("b"));
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 1);
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 5);
+
+    auto& st = c.cache.get_stats();
+    BOOST_REQUIRE_EQUAL(st.hits, 3);
+    BOOST_REQUIRE_EQUAL(st.misses, 2);
+    BOOST_REQUIRE_EQUAL(st.inserts, 3);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_large_charges) {
+    // Charges are not truncated to 32 bits
+    constexpr size_t gib = size_t(1) << 30;
+    test_cache<lru_eviction> c({.capacity = 8 * gib});
+    BOOST_REQUIRE(c.put("a", 1, 5 * gib));
+    BOOST_REQUIRE_EQUAL(c.get("a")->charge(), 5 * gib);
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 5 * gib);
+    BOOST_REQUIRE(c.put("b", 2, 4 * gib));
+    BOOST_REQUIRE(c.evicted("a"));
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 4 * gib);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_rehash) {
+    test_cache<no_eviction> c;
+    for (int i = 0; i < 10000; i++) {
+        c.put(to_sstring(i), i);
+    }
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 10000);
+    BOOST_REQUIRE_GE(c.cache.bucket_count(), 10000);
+    for (int i = 0; i < 10000; i++) {
+        BOOST_REQUIRE_EQUAL(c.get(to_sstring(i))->value, i);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_admission) {
+    test_cache<lru_eviction> c({.capacity = 100, .max_entry_charge = 50});
+    BOOST_REQUIRE(c.put("small", 0, 50));
+    BOOST_REQUIRE(!c.put("large", 0, 51));
+    BOOST_REQUIRE(!c.get("large"));
+    BOOST_REQUIRE(c.get("small"));
+    BOOST_REQUIRE_EQUAL(c.cache.get_stats().rejected, 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_lru_eviction) {
+    test_cache<lru_eviction> c({.capacity = 3});
+    c.put("a");
+    c.put("b");
+    c.put("c");
+    c.get("a");
+    c.put("d");
+    BOOST_REQUIRE(c.evicted("b"));
+    BOOST_REQUIRE(c.get("a"));
+    BOOST_REQUIRE(c.get("c"));
+    BOOST_REQUIRE(c.get("d"));
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 3);
+
+    // Charges, not entries, are bounded
+    c.put("e", 0, 2);
+    BOOST_REQUIRE(c.evicted("a"));
+    BOOST_REQUIRE(c.evicted("c"));
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 2);
+    BOOST_REQUIRE_EQUAL(c.cache.get_stats().evicted, 3);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_clock_eviction) {
+    test_cache<clock_eviction> c({.capacity = 3});
+    c.put("a");
+    c.put("b");
+    c.put("c");
+    c.get("a");
+    c.put("d");
+    // "a" got a second chance
+    BOOST_REQUIRE(c.evicted("b"));
+    c.put("e");
+    BOOST_REQUIRE(c.evicted("c"));
+    // "a" went round before "d" was inserted, so it is older than "d"
+    c.put("f");
+    BOOST_REQUIRE(c.evicted("a"));
+    c.put("g");
+    BOOST_REQUIRE(c.evicted("d"));
+}
+
+// When every resident entry was accessed, the policy must still pick one of
+// them, not the entry being inserted
+template <typename Eviction>
+static void test_insert_into_hot_cache() {
+    test_cache<Eviction> c({.capacity = 3});
+    c.put("a");
+    c.put("b");
+    c.put("c");
+    for (int round = 0; round < 2; round++) {
+        BOOST_REQUIRE(c.get("a"));
+        BOOST_REQUIRE(c.get("b"));
+        BOOST_REQUIRE(c.get("c"));
+    }
+    BOOST_REQUIRE(c.put("d"));
+    BOOST_REQUIRE(!c.removed.contains("d"));
+    BOOST_REQUIRE(c.get("d"));
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 3);
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 3);
+    BOOST_REQUIRE_EQUAL(c.cache.get_stats().evicted, 1);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_insert_into_hot_cache_evicts_resident) {
+    test_insert_into_hot_cache<lru_eviction>();
+    test_insert_into_hot_cache<clock_eviction>();
+    test_insert_into_hot_cache<s3fifo_eviction>();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_s3fifo_eviction) {
+    test_cache<s3fifo_eviction> c({.capacity = 100});
+    // A working set accessed repeatedly, then a scan of keys used once
+    for (int i = 0; i < 50; i++) {
+        c.put(format("hot{}", i));
+    }
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 50; i++) {
+            BOOST_REQUIRE(c.get(format("hot{}", i)));
+        }
+    }
+    for (int i = 0; i < 1000; i++) {
+        c.put(format("scan{}", i));
+    }
+    for (int i = 0; i < 50; i++) {
+        BOOST_REQUIRE(c.get(format("hot{}", i)));
+    }
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 100);
+
+    // A key recently evicted from the small queue is remembered by the
+    // ghost, and goes straight to the main queue when it comes back
+    int last_evicted = 999;
+    while (!c.evicted(format("scan{}", last_evicted))) {
+        last_evicted--;
+    }
+    auto key = format("scan{}", last_evicted);
+    c.put(key);
+    for (int i = 1000; i < 1100; i++) {
+        c.put(format("scan{}", i));
+    }
+    BOOST_REQUIRE(c.get(key));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_expiry) {
+    test_cache<lru_eviction, manual_clock> c;
+    c.put("short", 0, 1, manual_clock::now() + 1s);
+    c.put("long", 0, 1, manual_clock::now() + 10s);
+    c.put("forever");
+    BOOST_REQUIRE(c.get("short"));
+
+    manual_clock::advance(2s);
+    yield().get();
+    BOOST_REQUIRE(c.removed.at("short") == cache_removal_cause::expired);
+    BOOST_REQUIRE(!c.get("short"));
+    BOOST_REQUIRE(c.get("long"));
+
+    manual_clock::advance(10s);
+    yield().get();
+    BOOST_REQUIRE(!c.get("long"));
+    BOOST_REQUIRE(c.get("forever"));
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 1);
+    BOOST_REQUIRE_EQUAL(c.cache.get_stats().expired, 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_cache_evict_and_remove) {
+    test_cache<lru_eviction> c;
+    for (int i = 0; i < 10; i++) {
+        c.put(to_sstring(i), i, 10);
+    }
+    BOOST_REQUIRE_EQUAL(c.cache.evict(25), 30);
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 7);
+    BOOST_REQUIRE(c.evicted("0"));
+    BOOST_REQUIRE(c.evicted("2"));
+
+    // remove() unlinks without disposing
+    auto e = c.get("5");
+    c.cache.remove(*e);
+    BOOST_REQUIRE(!c.get("5"));
+    BOOST_REQUIRE(!c.removed.contains("5"));
+    delete e;
+
+    c.cache.set_capacity(30);
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 3);
+    c.cache.clear();
+    BOOST_REQUIRE_EQUAL(c.cache.size(), 0);
+    BOOST_REQUIRE_EQUAL(c.cache.charge(), 0);
+    BOOST_REQUIRE_EQUAL(c.removed.size(), 9);
+}
+
+struct sharded_test_cache : public test_cache<lru_eviction> {
+    future<> stop() {
+        return make_ready_future<>();
+    }
+};
+
+SEASTAR_THREAD_TEST_CASE(test_sharded_cache_routing) {
+    sharded<sharded_test_cache> shards;
+    shards.start().get();
+    sharded_cache<sharded_test_cache> router(shards);
+    for (int i = 0; i < 100; i++) {
+        auto key = to_sstring(i);
+        auto hash = std::hash<sstring>()(key);
+        auto shard = router.invoke_on_owner(hash, [key, i] (sharded_test_cache& c) {
+            c.put(key, i);
+            return this_shard_id();
+        }).get();
+        BOOST_REQUIRE_EQUAL(shard, sharded_cache<sharded_test_cache>::shard_of(hash));
+        BOOST_REQUIRE_LT(shard, smp::count);
+    }
+    auto total = router.map_reduce0([] (sharded_test_cache& c) { return c.cache.size(); }, size_t(0), std::plus<size_t>()).get();
+    BOOST_REQUIRE_EQUAL(total, 100);
+    shards.stop().get();
+}
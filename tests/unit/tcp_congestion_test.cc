@@ -0,0 +1,250 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/net/tcp-congestion.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <fmt/core.h>
+#include <chrono>
+#include <cmath>
+
+#include "tcp_sim.hh"
+
+using namespace seastar;
+using namespace std::chrono_literals;
+using net::tcp_congestion_control;
+using net::tcp_congestion_window;
+using net::packet;
+
+namespace {
+
+constexpr uint32_t mss = 1000;
+
+/*
+ * Acknowledges one window per round trip, as a path of the given bandwidth
+ * and propagation delay does for a sender that always fills its window:
+ * what does not fit the path waits in the queue of its bottleneck.
+ */
+struct fluid_path {
+    double bandwidth;
+    tcp_congestion_control::clock_type::duration rtt;
+    tcp_congestion_control::clock_type::time_point now;
+
+    void round(tcp_congestion_control& cc, tcp_congestion_window& w) {
+        auto window = w.cwnd;
+        auto duration = std::max<tcp_congestion_control::clock_type::duration>(rtt,
+                std::chrono::duration_cast<tcp_congestion_control::clock_type::duration>(std::chrono::duration<double>(window / bandwidth)));
+        auto start = now;
+        auto segments = std::max(window / mss, 1u);
+        for (uint32_t i = 1; i <= segments; i++) {
+            now = start + duration * i / segments;
+            cc.on_ack(w, tcp_congestion_control::ack_sample{
+                .acked = mss,
+                .flight_size = w.cwnd,
+                .rtt = duration,
+                .now = now,
+                .recovery = false,
+            });
+        }
+    }
+};
+
+class fixed_window : public tcp_congestion_control {
+public:
+    virtual std::string_view name() const noexcept override {
+        return "fixed";
+    }
+    virtual void on_ack(tcp_congestion_window& w, const ack_sample& s) override {
+    }
+    virtual uint32_t on_loss(const tcp_congestion_window& w, uint32_t flight_size, clock_type::time_point now) override {
+        return w.cwnd;
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(test_algorithms_by_name) {
+    for (auto name : {"reno", "cubic", "bbr"}) {
+        BOOST_REQUIRE(tcp_congestion_control::find(name));
+        BOOST_REQUIRE_EQUAL(tcp_congestion_control::make(name)->name(), name);
+    }
+    BOOST_REQUIRE_EQUAL(tcp_congestion_control::make_default()->name(), "reno");
+    BOOST_REQUIRE(!tcp_congestion_control::find("vegas"));
+    BOOST_REQUIRE_EXCEPTION(tcp_congestion_control::make("vegas"), std::system_error, [] (const std::system_error& e) {
+        return e.code().value() == ENOENT;
+    });
+
+    tcp_congestion_control::register_algorithm("fixed", [] () -> std::unique_ptr<tcp_congestion_control> {
+        return std::make_unique<fixed_window>();
+    });
+    BOOST_REQUIRE_EQUAL(tcp_congestion_control::make("fixed")->name(), "fixed");
+}
+
+BOOST_AUTO_TEST_CASE(test_reno) {
+    auto cc = tcp_congestion_control::make("reno");
+    tcp_congestion_window w{.cwnd = 10 * mss, .ssthresh = 20 * mss};
+    tcp_congestion_control::clock_type::time_point now;
+    cc->init(w, mss, now);
+    BOOST_REQUIRE_EQUAL(w.cwnd, 10 * mss);
+
+    // Slow start grows by at most a segment per acknowledgement
+    auto ack = [&] (uint32_t acked) {
+        cc->on_ack(w, {.acked = acked, .flight_size = w.cwnd, .rtt = std::nullopt, .now = now, .recovery = false});
+    };
+    ack(1500);
+    BOOST_REQUIRE_EQUAL(w.cwnd, 11 * mss);
+    // Congestion avoidance by a segment per window
+    w.cwnd = 20 * mss;
+    ack(mss);
+    BOOST_REQUIRE_EQUAL(w.cwnd, 20 * mss + mss / 20);
+
+    BOOST_REQUIRE_EQUAL(cc->on_loss(w, 30 * mss, now), 15 * mss);
+    BOOST_REQUIRE_EQUAL(cc->on_loss(w, mss, now), 2 * mss);
+    w.ssthresh = 10 * mss;
+    cc->on_recovery_end(w, 30 * mss, now);
+    BOOST_REQUIRE_EQUAL(w.cwnd, 10 * mss);
+    cc->on_timeout(w, 30 * mss, true, now);
+    BOOST_REQUIRE_EQUAL(w.ssthresh, 15 * mss);
+    BOOST_REQUIRE_EQUAL(w.cwnd, mss);
+    cc->on_timeout(w, 2 * mss, false, now);
+    BOOST_REQUIRE_EQUAL(w.ssthresh, 15 * mss);
+}
+
+BOOST_AUTO_TEST_CASE(test_cubic) {
+    auto cc = tcp_congestion_control::make("cubic");
+    tcp_congestion_window w{.cwnd = 100 * mss, .ssthresh = 50 * mss};
+    fluid_path path{.bandwidth = 1e9, .rtt = 100ms, .now = {}};
+    cc->init(w, mss, path.now);
+
+    // Multiplicative decrease by beta = 0.7
+    w.ssthresh = cc->on_loss(w, w.cwnd, path.now);
+    BOOST_REQUIRE_EQUAL(w.ssthresh, 70 * mss);
+    cc->on_recovery_end(w, w.cwnd, path.now);
+    BOOST_REQUIRE_EQUAL(w.cwnd, 70 * mss);
+
+    // Back to the window of the loss after K = cbrt(30 / 0.4) seconds,
+    // quickly at first
+    auto k = std::chrono::duration<double>(std::cbrt(30 / 0.4));
+    auto start = path.now;
+    path.round(*cc, w);
+    auto first_round = w.cwnd - 70 * mss;
+    while (path.now - start < k / 2) {
+        path.round(*cc, w);
+    }
+    auto half_way = w.cwnd;
+    BOOST_REQUIRE_GT(half_way, 85 * mss);
+    BOOST_REQUIRE_LT(half_way, 100 * mss);
+    while (path.now - start < k) {
+        path.round(*cc, w);
+    }
+    BOOST_REQUIRE_GT(w.cwnd, 95 * mss);
+    BOOST_REQUIRE_LT(w.cwnd, 105 * mss);
+    // Slowly around it
+    auto at_k = w.cwnd;
+    path.round(*cc, w);
+    BOOST_REQUIRE_LT(w.cwnd - at_k, first_round);
+    // Then probing beyond it
+    while (path.now - start < k * 2) {
+        path.round(*cc, w);
+    }
+    BOOST_REQUIRE_GT(w.cwnd, 120 * mss);
+}
+
+BOOST_AUTO_TEST_CASE(test_bbr) {
+    auto cc = tcp_congestion_control::make("bbr");
+    tcp_congestion_window w{.cwnd = 10 * mss, .ssthresh = std::numeric_limits<uint32_t>::max()};
+    // A bandwidth-delay product of 200 segments
+    fluid_path path{.bandwidth = 1e7, .rtt = 20ms, .now = {}};
+    uint32_t bdp = 200 * mss;
+    cc->init(w, mss, path.now);
+
+    // The window settles around the product, whatever it started from
+    for (int i = 0; i < 100; i++) {
+        path.round(*cc, w);
+    }
+    for (int i = 0; i < 16; i++) {
+        path.round(*cc, w);
+        BOOST_REQUIRE_GE(w.cwnd, bdp * 3 / 4);
+        BOOST_REQUIRE_LE(w.cwnd, bdp * 5 / 4 + 3 * mss);
+    }
+
+    // Losses do not shrink it
+    auto cwnd = w.cwnd;
+    w.ssthresh = cc->on_loss(w, w.cwnd, path.now);
+    BOOST_REQUIRE_GE(w.ssthresh, cwnd);
+    cc->on_recovery_end(w, w.cwnd, path.now);
+    BOOST_REQUIRE_GE(w.cwnd, bdp * 3 / 4);
+
+    // A timeout does, for a while
+    cc->on_timeout(w, w.cwnd, true, path.now);
+    BOOST_REQUIRE_EQUAL(w.cwnd, mss);
+    for (int i = 0; i < 10; i++) {
+        path.round(*cc, w);
+    }
+    BOOST_REQUIRE_GE(w.cwnd, bdp * 3 / 4);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_select_algorithm) {
+    tcp_sim::simulation sim({}, {});
+    auto listener = sim.listen();
+    BOOST_REQUIRE_THROW(listener.set_congestion_control("vegas"), std::system_error);
+    listener.set_congestion_control("cubic");
+    auto accepted = listener.accept();
+    auto client = sim.connect();
+    client.connected().get();
+    auto server = accepted.get();
+
+    BOOST_REQUIRE_EQUAL(server.congestion_control(), "cubic");
+    BOOST_REQUIRE_EQUAL(client.congestion_control(), "reno");
+    client.set_congestion_control(tcp_congestion_control::find("bbr"));
+    BOOST_REQUIRE_EQUAL(client.congestion_control(), "bbr");
+
+    // Data still flows after switching
+    client.send(packet(temporary_buffer<char>(100000))).get();
+    size_t received = 0;
+    while (received < 100000) {
+        server.wait_for_data().get();
+        received += server.read().len();
+    }
+    client.close_write();
+    server.close_write();
+    client.wait_input_shutdown().get();
+    server.wait_input_shutdown().get();
+    sim.get_network().wait_idle().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_goodput_over_lossy_long_fat_link) {
+    // 20 Mbit/s with 50ms of round trip time and 0.2% of the data lost,
+    // queueing about two bandwidth-delay products
+    tcp_sim::link data{.rate = 2.5e6, .delay = 25ms, .queue_size = 256 * 1024, .loss = 0.002};
+    tcp_sim::link acks{.rate = 2.5e6, .delay = 25ms, .queue_size = 128 * 1024, .loss = 0};
+    for (auto algorithm : {"reno", "cubic", "bbr"}) {
+        tcp_sim::simulation sim(data, acks);
+        auto r = tcp_sim::transfer(sim, algorithm, 2s);
+        fmt::print("{:>6}: goodput {:.2f} MB/s of {:.2f} MB/s, {} of {} packets lost, {} dropped\n",
+                algorithm, r.goodput / 1e6, data.rate / 1e6, r.link.lost, r.link.packets, r.link.dropped);
+        // The link runs on real timers, how close to its rate each algorithm
+        // gets depends on how fast the host runs the simulation. Only check
+        // what holds on any host.
+        BOOST_REQUIRE_GT(r.goodput, 0);
+        BOOST_REQUIRE_LE(r.goodput, data.rate * 1.1);
+    }
+}
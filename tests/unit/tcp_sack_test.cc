@@ -0,0 +1,134 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/net/tcp.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <fmt/core.h>
+#include <chrono>
+
+#include "tcp_sim.hh"
+
+using namespace seastar;
+using namespace std::chrono_literals;
+using net::tcp_option;
+using net::tcp_hdr;
+using net::make_seq;
+
+BOOST_AUTO_TEST_CASE(test_sack_option) {
+    tcp_option::sack sack;
+    sack.blocks[sack.nr_blocks++] = {make_seq(3000), make_seq(4000)};
+    sack.blocks[sack.nr_blocks++] = {make_seq(0xfffffc00), make_seq(1000)};
+    sack.blocks[sack.nr_blocks++] = {make_seq(5000), make_seq(7000)};
+    BOOST_REQUIRE_EQUAL(sack.len(), 26);
+
+    // Found after other options
+    uint8_t options[40] = {1, 1, 8, 10, 0, 0, 0, 1, 0, 0, 0, 2};
+    sack.write(reinterpret_cast<char*>(options + 12));
+    auto parsed = tcp_option::parse_sack(options, options + 12 + sack.len());
+    BOOST_REQUIRE_EQUAL(parsed.nr_blocks, 3);
+    for (unsigned i = 0; i < 3; i++) {
+        BOOST_REQUIRE_EQUAL(parsed.blocks[i].left, sack.blocks[i].left);
+        BOOST_REQUIRE_EQUAL(parsed.blocks[i].right, sack.blocks[i].right);
+    }
+    // Not past the end of the options
+    BOOST_REQUIRE_EQUAL(tcp_option::parse_sack(options, options + 12 + sack.len() - 1).nr_blocks, 0);
+    BOOST_REQUIRE_EQUAL(tcp_option::parse_sack(options, options + 12).nr_blocks, 0);
+
+    // SACK permitted goes with the SYN, blocks with the acknowledgements
+    tcp_option opt;
+    opt._local_mss = 1460;
+    char hdr[tcp_hdr::len + 40];
+    tcp_hdr syn{};
+    syn.f_syn = true;
+    auto size = opt.get_size(true, false);
+    BOOST_REQUIRE_EQUAL(size, 12);
+    BOOST_REQUIRE_EQUAL(opt.fill(hdr, &syn, size), size);
+    BOOST_REQUIRE_EQUAL(hdr[tcp_hdr::len + 7], 4);
+    BOOST_REQUIRE_EQUAL(hdr[tcp_hdr::len + 8], 2);
+    BOOST_REQUIRE_EQUAL(opt.get_size(true, true), 0);
+
+    tcp_hdr ack{};
+    ack.f_ack = true;
+    BOOST_REQUIRE_EQUAL(opt.get_size(false, true), 0);
+    opt._local_sack = sack;
+    size = opt.get_size(false, true);
+    BOOST_REQUIRE_EQUAL(size, 28);
+    BOOST_REQUIRE_EQUAL(opt.fill(hdr, &ack, size), size);
+    parsed = tcp_option::parse_sack(reinterpret_cast<uint8_t*>(hdr) + tcp_hdr::len, reinterpret_cast<uint8_t*>(hdr) + tcp_hdr::len + size);
+    BOOST_REQUIRE_EQUAL(parsed.nr_blocks, 3);
+    BOOST_REQUIRE_EQUAL(parsed.blocks[1].right, make_seq(1000));
+}
+
+namespace {
+
+// 20 Mbit/s with 50ms of round trip time
+constexpr tcp_sim::link data_link{.rate = 2.5e6, .delay = 25ms, .queue_size = 256 * 1024};
+constexpr tcp_sim::link ack_link{.rate = 2.5e6, .delay = 25ms, .queue_size = 128 * 1024};
+
+void print(std::string_view name, const tcp_sim::transfer_result& r) {
+    fmt::print("{:>12}: goodput {:.2f} MB/s, {} of {} packets lost, {} dropped, {} reordered, {} retransmissions, {} spurious, {} SACK recoveries\n",
+            name, r.goodput / 1e6, r.link.lost, r.link.packets, r.link.dropped, r.link.reordered,
+            r.stats.retransmissions, r.stats.spurious_retransmissions, r.stats.sack_recoveries);
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_retransmissions_over_lossy_link) {
+    // Several losses in most windows, with an algorithm that keeps its
+    // window large through them
+    auto data = data_link;
+    data.loss = 0.01;
+
+    auto run = [&] (bool sack) {
+        tcp_sim::simulation sim(data, ack_link);
+        if (!sack) {
+            sim.get_network().disable_sack();
+        }
+        return tcp_sim::transfer(sim, "bbr", 5s);
+    };
+    auto without_sack = run(false);
+    print("without SACK", without_sack);
+    BOOST_REQUIRE_EQUAL(without_sack.stats.sack_recoveries, 0);
+
+    auto with_sack = run(true);
+    print("with SACK", with_sack);
+    BOOST_REQUIRE_GT(with_sack.stats.sack_recoveries, 0);
+    // Goodput depends on how fast the host runs the simulation, compare
+    // what does not: with the scoreboard, each lost packet is sent again
+    // about once, lost retransmissions being lost packets themselves
+    auto losses = with_sack.link.lost + with_sack.link.dropped;
+    BOOST_REQUIRE_GT(losses, 0);
+    BOOST_REQUIRE_LE(with_sack.stats.retransmissions, losses * 3 / 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_spurious_retransmissions) {
+    // Segments overtaken by enough others to look lost
+    auto data = data_link;
+    data.reorder = 0.005;
+
+    tcp_sim::simulation sim(data, ack_link);
+    auto r = tcp_sim::transfer(sim, "reno", 3s);
+    print("reordering", r);
+    BOOST_REQUIRE_GT(r.stats.retransmissions, 0);
+    BOOST_REQUIRE_GT(r.stats.spurious_retransmissions, 0);
+    BOOST_REQUIRE_LE(r.stats.spurious_retransmissions, r.stats.retransmissions);
+}
@@ -0,0 +1,353 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <seastar/core/future.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/net/api.hh>
+#include <seastar/net/ip.hh>
+#include <seastar/net/tcp.hh>
+#include <seastar/net/toeplitz.hh>
+
+namespace seastar {
+
+namespace tcp_sim {
+
+using namespace std::chrono_literals;
+using clock_type = steady_clock_type;
+using net::packet;
+
+// One direction of the path: a bottleneck that queues packets and drops
+// them once its queue is full, then the propagation delay
+struct link {
+    // Bottleneck rate, in bytes per second
+    double rate = 2.5e6;
+    // One way propagation delay
+    clock_type::duration delay = 25ms;
+    // Bytes the bottleneck queues
+    size_t queue_size = 128 * 1024;
+    // Probability of a packet being lost, before the bottleneck
+    double loss = 0;
+    // Probability of a packet being held back after the bottleneck, and
+    // for how long, so that the ones after it overtake it
+    double reorder = 0;
+    clock_type::duration reorder_delay = 5ms;
+};
+
+struct link_stats {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    // Lost at random
+    uint64_t lost = 0;
+    // Dropped by the bottleneck
+    uint64_t dropped = 0;
+    // Overtaken by the ones after them
+    uint64_t reordered = 0;
+};
+
+class network;
+
+// Lets tcp run over a network instead of an ipv4 instance
+struct traits {
+    using address_type = net::ipv4_address;
+    using inet_type = network;
+    using l4packet = net::ipv4_traits::l4packet;
+    using packet_provider_type = net::ipv4_traits::packet_provider_type;
+    static void tcp_pseudo_header_checksum(net::checksummer& csum, net::ipv4_address src, net::ipv4_address dst, uint16_t len) {
+        net::ipv4_traits::tcp_pseudo_header_checksum(csum, src, dst, len);
+    }
+    static constexpr uint8_t ip_hdr_len_min = net::ipv4_traits::ip_hdr_len_min;
+};
+
+/*
+ * A host talking to itself over a path made of two links, one for the
+ * packets the server sends and one for those it receives: both ends of the
+ * connections of a single tcp instance, so that its metrics are only
+ * registered once, told apart by the server port.
+ *
+ * The packets tcp has to send are collected every 100us, which is when
+ * they enter the links.
+ */
+class network {
+public:
+    // What tcp uses of the network interface
+    class interface {
+        net::hw_features _hw;
+        net::ipv4_address _address;
+    public:
+        explicit interface(net::ipv4_address address) : _address(address) {
+            _hw.rx_csum_offload = true;
+            _hw.tx_csum_l4_offload = true;
+        }
+        const net::hw_features& hw_features() const {
+            return _hw;
+        }
+        net::ipv4_address host_address() const {
+            return _address;
+        }
+        interface* netif() {
+            return this;
+        }
+        unsigned hash2cpu(uint32_t) {
+            return this_shard_id();
+        }
+        rss_key_type rss_key() const {
+            return default_rsskey_40bytes;
+        }
+    };
+    interface _inet;
+private:
+    struct in_flight {
+        clock_type::time_point arrival;
+        packet p;
+    };
+    struct pipe {
+        link params;
+        clock_type::time_point busy_until;
+        std::deque<in_flight> packets;
+        timer<> deliver;
+        link_stats stats;
+    };
+    uint16_t _server_port;
+    std::function<void (packet)> _receive;
+    traits::packet_provider_type _provider;
+    // From the server, to the server
+    std::array<pipe, 2> _pipes;
+    timer<> _poll;
+    std::mt19937 _rng{1};
+    bool _sack = true;
+    std::optional<promise<>> _idle;
+private:
+    // Replaces the SACK permitted option of a SYN segment with NOPs
+    static void remove_sack_permitted(packet& p) {
+        auto h = net::tcp_hdr::read(p.get_header(0, net::tcp_hdr::len));
+        if (!h.f_syn) {
+            return;
+        }
+        auto th = p.get_header(0, h.data_offset * 4);
+        for (auto opt = th + net::tcp_hdr::len; opt < th + h.data_offset * 4 - 1; ) {
+            auto kind = net::tcp_option::option_kind(*opt);
+            if (kind == net::tcp_option::option_kind::eol) {
+                break;
+            } else if (kind == net::tcp_option::option_kind::nop) {
+                opt++;
+            } else if (kind == net::tcp_option::option_kind::sack_permitted) {
+                opt[0] = opt[1] = uint8_t(net::tcp_option::option_kind::nop);
+                break;
+            } else {
+                opt += std::max(uint8_t(opt[1]), uint8_t(2));
+            }
+        }
+    }
+    void send(packet p) {
+        if (!_sack) {
+            remove_sack_permitted(p);
+        }
+        auto th = p.get_header(0, net::tcp_hdr::len);
+        auto& d = _pipes[net::tcp_hdr::read(th).src_port != _server_port];
+        auto now = clock_type::now();
+        d.stats.packets++;
+        if (std::bernoulli_distribution(d.params.loss)(_rng)) {
+            d.stats.lost++;
+            return;
+        }
+        auto busy = std::max(d.busy_until, now);
+        auto queued = std::chrono::duration<double>(busy - now).count() * d.params.rate;
+        if (queued + p.len() > d.params.queue_size) {
+            d.stats.dropped++;
+            return;
+        }
+        d.busy_until = busy + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(p.len() / d.params.rate));
+        d.stats.bytes += p.len();
+        auto arrival = d.busy_until + d.params.delay;
+        if (std::bernoulli_distribution(d.params.reorder)(_rng)) {
+            d.stats.reordered++;
+            arrival += d.params.reorder_delay;
+        }
+        auto pos = std::upper_bound(d.packets.begin(), d.packets.end(), arrival, [] (clock_type::time_point t, const in_flight& x) {
+            return t < x.arrival;
+        });
+        d.packets.insert(pos, in_flight{arrival, std::move(p)});
+        d.deliver.rearm(d.packets.front().arrival);
+    }
+    void deliver(pipe& d) {
+        auto now = clock_type::now();
+        while (!d.packets.empty() && d.packets.front().arrival <= now) {
+            auto p = std::move(d.packets.front().p);
+            d.packets.pop_front();
+            _receive(std::move(p));
+        }
+        if (!d.packets.empty()) {
+            d.deliver.arm(d.packets.front().arrival);
+        }
+    }
+public:
+    network(net::ipv4_address address, uint16_t server_port, link from_server, link to_server, std::function<void (packet)> receive)
+        : _inet(address)
+        , _server_port(server_port)
+        , _receive(std::move(receive)) {
+        _pipes[0].params = from_server;
+        _pipes[1].params = to_server;
+        for (auto& d : _pipes) {
+            d.deliver.set_callback([this, &d] { deliver(d); });
+        }
+        _poll.set_callback([this] {
+            while (_provider) {
+                auto l4p = _provider();
+                if (!l4p) {
+                    break;
+                }
+                send(std::move(l4p->p));
+            }
+            if (_idle && std::ranges::all_of(_pipes, [] (const pipe& d) { return d.packets.empty(); })) {
+                _idle->set_value();
+                _idle.reset();
+            }
+        });
+        _poll.arm_periodic(100us);
+    }
+    void register_packet_provider(traits::packet_provider_type func) {
+        _provider = std::move(func);
+    }
+    future<net::ethernet_address> get_l2_dst_address(net::ipv4_address) {
+        return make_ready_future<net::ethernet_address>();
+    }
+    // Changes the probability of packets being lost, in both directions
+    void set_loss(double loss) noexcept {
+        for (auto& d : _pipes) {
+            d.params.loss = loss;
+        }
+    }
+    // Removes the SACK permitted option from SYN segments, as some
+    // middleboxes do, so that connections go without selective
+    // acknowledgements
+    void disable_sack() noexcept {
+        _sack = false;
+    }
+    // Resolves once tcp has nothing more to send and no packet is on its
+    // way in either direction, e.g. once closing connections are gone
+    future<> wait_idle() {
+        _idle.emplace();
+        return _idle->get_future();
+    }
+    const link_stats& from_server() const noexcept {
+        return _pipes[0].stats;
+    }
+    const link_stats& to_server() const noexcept {
+        return _pipes[1].stats;
+    }
+};
+
+using tcp = net::tcp<traits>;
+
+// A tcp instance on a network
+class simulation {
+    net::ipv4_address _address;
+    uint16_t _port;
+    network _network;
+    tcp _tcp;
+public:
+    simulation(link from_server, link to_server, uint16_t server_port = 10000)
+        : _address(0x0a000001)
+        , _port(server_port)
+        , _network(_address, server_port, from_server, to_server, [this] (packet p) {
+            _tcp.received(std::move(p), _address, _address);
+        })
+        , _tcp(_network) {
+    }
+    tcp& get_tcp() noexcept {
+        return _tcp;
+    }
+    tcp::listener listen() {
+        return _tcp.listen(_port);
+    }
+    tcp::connection connect() {
+        return _tcp.connect(make_ipv4_address(uint32_t(_address.ip), _port));
+    }
+    network& get_network() noexcept {
+        return _network;
+    }
+};
+
+struct transfer_result {
+    double goodput;
+    link_stats link;
+    tcp::stats stats;
+};
+
+/*
+ * Sends data from the server for a while and returns the rate it reached
+ * the client at. The path is lossless while connections close, so that
+ * they are gone before the simulation. Runs in a thread.
+ */
+inline transfer_result transfer(simulation& sim, std::string_view algorithm, std::chrono::seconds duration) {
+    auto listener = sim.listen();
+    listener.set_congestion_control(algorithm);
+    auto accepted = listener.accept();
+    auto client = sim.connect();
+    client.connected().get();
+    auto server = accepted.get();
+
+    size_t received = 0;
+    auto reader = seastar::async([&] {
+        while (true) {
+            client.wait_for_data().get();
+            auto p = client.read();
+            if (!p.len()) {
+                break;
+            }
+            received += p.len();
+        }
+    });
+
+    temporary_buffer<char> chunk(64 * 1024);
+    std::fill_n(chunk.get_write(), chunk.size(), 'x');
+    auto start = clock_type::now();
+    while (clock_type::now() - start < duration) {
+        server.send(packet(chunk.share())).get();
+    }
+    auto goodput = received / std::chrono::duration<double>(clock_type::now() - start).count();
+    auto link = sim.get_network().from_server();
+    auto stats = sim.get_tcp().get_stats();
+
+    sim.get_network().set_loss(0);
+    server.close_write();
+    reader.get();
+    client.close_write();
+    server.wait_input_shutdown().get();
+    sim.get_network().wait_idle().get();
+    return transfer_result{goodput, link, stats};
+}
+
+}
+
+}
@@ -0,0 +1,150 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/core/timer-wheel.hh>
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace seastar;
+
+namespace {
+
+struct test_timer {
+    using clock = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+    using duration = clock::duration;
+
+    boost::intrusive::list_member_hook<> link;
+    time_point timeout;
+    bool _expired = false;
+    bool armed = false;
+
+    time_point get_timeout() const noexcept { return timeout; }
+    void cancel() noexcept {}
+};
+
+using wheel_t = timer_wheel<test_timer, &test_timer::link>;
+
+test_timer::time_point at(int64_t ts) {
+    return test_timer::time_point(test_timer::duration(ts));
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel_expires_in_order) {
+    wheel_t w;
+    std::vector<test_timer> timers(4);
+    int64_t timeouts[] = { 5, 70, 4100, int64_t(1) << 40 };
+    for (size_t i = 0; i < timers.size(); ++i) {
+        timers[i].timeout = at(timeouts[i]);
+        w.insert(timers[i]);
+    }
+    BOOST_REQUIRE_EQUAL(w.size(), 4u);
+    BOOST_REQUIRE(w.get_next_timeout() == at(5));
+
+    for (size_t i = 0; i < timers.size(); ++i) {
+        BOOST_REQUIRE(w.expire(at(timeouts[i] - 1)).empty());
+        auto exp = w.expire(at(timeouts[i]));
+        BOOST_REQUIRE_EQUAL(exp.size(), 1u);
+        BOOST_REQUIRE_EQUAL(&exp.front(), &timers[i]);
+        exp.clear();
+        if (i + 1 < timers.size()) {
+            BOOST_REQUIRE(w.get_next_timeout() == at(timeouts[i + 1]));
+        }
+    }
+    BOOST_REQUIRE(w.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel_overdue_and_remove) {
+    wheel_t w;
+    test_timer past, future;
+    w.expire(at(1000));
+    past.timeout = at(10);
+    future.timeout = at(5000);
+    BOOST_REQUIRE(w.insert(past));
+    w.insert(future);
+    BOOST_REQUIRE(w.get_next_timeout() == at(1000));
+    w.remove(future);
+    BOOST_REQUIRE_EQUAL(w.size(), 1u);
+    auto exp = w.expire(at(1000));
+    BOOST_REQUIRE_EQUAL(exp.size(), 1u);
+    BOOST_REQUIRE_EQUAL(&exp.front(), &past);
+    exp.clear();
+    BOOST_REQUIRE(w.empty());
+}
+
+// Random arm/cancel/advance sequences checked against a brute-force model
+BOOST_AUTO_TEST_CASE(test_timer_wheel_random) {
+    std::mt19937_64 rng(1234);
+    std::vector<test_timer> timers(1000);
+    wheel_t w;
+    int64_t now = 1000;
+    w.expire(at(now));
+    for (int step = 0; step < 200000; ++step) {
+        auto& t = timers[rng() % timers.size()];
+        switch (rng() % 3) {
+        case 0:
+            if (!t.armed) {
+                int64_t delta = rng() % 4 ? int64_t(rng() % 5000) : int64_t(rng() % (int64_t(1) << 40));
+                t.timeout = at(now + delta - 10);
+                w.insert(t);
+                t.armed = true;
+            }
+            break;
+        case 1:
+            if (t.armed) {
+                w.remove(t);
+                t.armed = false;
+            }
+            break;
+        case 2: {
+            now += rng() % 50 ? int64_t(rng() % 3000) : int64_t(rng() % (int64_t(1) << 41));
+            auto exp = w.expire(at(now));
+            std::set<const test_timer*> expired;
+            for (auto& e : exp) {
+                BOOST_REQUIRE(e.get_timeout() <= at(now));
+                expired.insert(&e);
+            }
+            exp.clear();
+            size_t armed = 0;
+            auto min_timeout = at(std::numeric_limits<int64_t>::max());
+            for (auto& x : timers) {
+                if (x.armed && x.get_timeout() <= at(now)) {
+                    BOOST_REQUIRE(expired.contains(&x));
+                    x.armed = false;
+                } else if (x.armed) {
+                    ++armed;
+                    min_timeout = std::min(min_timeout, x.get_timeout());
+                }
+            }
+            BOOST_REQUIRE_EQUAL(w.size(), armed);
+            BOOST_REQUIRE(!armed || w.get_next_timeout() <= min_timeout);
+            break;
+        }
+        }
+    }
+    w.clear();
+}
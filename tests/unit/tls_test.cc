@@ -36,6 +36,7 @@
 #include <seastar/util/std-compat.hh>
 #include <seastar/util/process.hh>
 #include <seastar/net/tls.hh>
+#include <seastar/net/tls_resumption.hh>
 #include <seastar/net/dns.hh>
 #include <seastar/net/inet_address.hh>
 #include <seastar/testing/test_case.hh>
@@ -49,6 +50,8 @@
 
 #include <gnutls/gnutls.h>
 
+#include <netinet/tcp.h>
+
 #if 0
 
 static void enable_gnutls_logging() {
@@ -1554,6 +1557,100 @@ SEASTAR_THREAD_TEST_CASE(test_skip_wait_for_eof) {
     }
 }
 
+// The kernel refuses the "tls" upper layer protocol on a socket that is not
+// connected, but only once it found the module
+static bool kernel_has_tls_module() {
+    auto fd = file_desc::socket(AF_INET, SOCK_STREAM, 0);
+    auto r = ::setsockopt(fd.get(), SOL_TCP, TCP_ULP, "tls", sizeof("tls"));
+    return r == 0 || (errno != ENOENT && errno != ENOPROTOOPT);
+}
+
+static void do_test_kernel_offload(sstring priority) {
+    tls::credentials_builder b;
+
+    b.set_x509_key_file(certfile("test.crt"), certfile("test.key"), tls::x509_crt_format::PEM).get();
+    b.set_x509_trust_file(certfile("catest.pem"), tls::x509_crt_format::PEM).get();
+    b.set_priority_string(priority);
+    b.set_enable_kernel_offload(true);
+
+    auto creds = b.build_certificate_credentials();
+    auto serv = b.build_server_credentials();
+
+    ::listen_options opts;
+    opts.reuse_address = true;
+    opts.set_fixed_cpu(this_shard_id());
+
+    auto addr = ::make_ipv4_address({0x7f000001, 4712});
+    auto server = tls::listen(serv, addr, opts);
+
+    auto sa = server.accept();
+    auto c = tls::connect(creds, addr).get();
+    auto s = sa.get();
+
+    // Whether the kernel has the "tls" module or not, data has to flow,
+    // in records of any size, and close_notify has to end the stream
+    auto msg = uninitialized_string(256 * 1024);
+    for (size_t i = 0; i < msg.size(); i++) {
+        msg[i] = 'a' + i % 26;
+    }
+    auto in = s.connection.input();
+    auto out = c.output();
+    auto sout = s.connection.output();
+    auto cin = c.input();
+
+    auto fin = in.read_exactly(msg.size());
+    out.write(msg).get();
+    out.flush().get();
+    auto buf = fin.get();
+    BOOST_REQUIRE(std::string_view(buf.get(), buf.size()) == msg);
+
+    auto cfin = cin.read_exactly(msg.size());
+    sout.write(msg).get();
+    sout.flush().get();
+    buf = cfin.get();
+    BOOST_REQUIRE(std::string_view(buf.get(), buf.size()) == msg);
+
+    auto client = tls::get_kernel_offload(c).get();
+    auto srv = tls::get_kernel_offload(s.connection).get();
+    BOOST_TEST_MESSAGE(fmt::format("{}: client tx {} rx {}, server tx {} rx {}", priority, client.tx, client.rx, srv.tx, srv.rx));
+    // A TLS 1.3 client has session tickets to read after the handshake
+    auto tls13 = priority.find("TLS1.3") != sstring::npos;
+    if (tls13) {
+        BOOST_REQUIRE(!client.rx);
+    }
+    if (kernel_has_tls_module()) {
+        // Whether the server can take receive depends on the client's data
+        // arriving with its last handshake record or not. A TLS 1.2 client
+        // gets nothing after the handshake until it sent its data.
+        BOOST_REQUIRE(client.tx);
+        BOOST_REQUIRE(srv.tx);
+        if (!tls13) {
+            BOOST_REQUIRE(client.rx);
+        }
+    } else {
+        BOOST_TEST_MESSAGE("kernel has no tls module, sessions stay in gnutls");
+    }
+
+    out.close().get();
+    BOOST_REQUIRE(in.read().get().empty());
+    sout.close().get();
+    BOOST_REQUIRE(cin.read().get().empty());
+    in.close().get();
+    cin.close().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_kernel_offload_tls12) {
+    do_test_kernel_offload("SECURE128:-VERS-TLS-ALL:+VERS-TLS1.2:-CIPHER-ALL:+AES-128-GCM");
+}
+
+SEASTAR_THREAD_TEST_CASE(test_kernel_offload_tls13) {
+    do_test_kernel_offload("SECURE128:+SECURE192:-VERS-TLS-ALL:+VERS-TLS1.3");
+}
+
+SEASTAR_THREAD_TEST_CASE(test_kernel_offload_tls13_chacha) {
+    do_test_kernel_offload("SECURE128:-VERS-TLS-ALL:+VERS-TLS1.3:-CIPHER-ALL:+CHACHA20-POLY1305");
+}
+
 static void do_test_tls13_session_tickets(bool reset_server) {
     tls::credentials_builder b;
 
@@ -1674,6 +1771,103 @@ SEASTAR_THREAD_TEST_CASE(test_tls13_session_tickets_retain_session_key) {
     do_test_tls13_session_tickets(true);
 }
 
+// Connects to the server, exchanges data both ways, which brings the client
+// a TLS 1.3 session ticket, and returns whether the session was resumed
+static bool connect_and_exchange(server_socket& server, shared_ptr<tls::certificate_credentials> creds, socket_address addr) {
+    auto sa = server.accept();
+    auto c = tls::connect(creds, addr).get();
+    auto s = sa.get();
+
+    auto in = s.connection.input();
+    auto out = s.connection.output();
+    auto cin = c.input();
+    auto cout = c.output();
+
+    cout.write("nils").get();
+    cout.flush().get();
+    in.read().get();
+    out.write("banan").get();
+    out.flush().get();
+    cin.read().get();
+
+    auto resumed = tls::check_session_is_resumed(c).get();
+
+    cout.close().get();
+    out.close().get();
+    in.close().get();
+    cin.close().get();
+    return resumed;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_client_session_cache) {
+    tls::credentials_builder b;
+
+    b.set_x509_key_file(certfile("test.crt"), certfile("test.key"), tls::x509_crt_format::PEM).get();
+    b.set_x509_trust_file(certfile("catest.pem"), tls::x509_crt_format::PEM).get();
+    b.set_session_resume_mode(tls::session_resume_mode::TLS13_SESSION_TICKET);
+    b.set_priority_string("SECURE128:+SECURE192:-VERS-TLS-ALL:+VERS-TLS1.3");
+
+    auto creds = b.build_certificate_credentials();
+    auto cache = make_shared<tls::client_session_cache>();
+    creds->set_session_cache(cache);
+    auto serv = b.build_server_credentials();
+
+    ::listen_options opts;
+    opts.reuse_address = true;
+    opts.set_fixed_cpu(this_shard_id());
+
+    auto addr = ::make_ipv4_address({0x7f000001, 4712});
+    auto server = tls::listen(serv, addr, opts);
+
+    BOOST_REQUIRE(!connect_and_exchange(server, creds, addr));
+    BOOST_REQUIRE_EQUAL(cache->size(), 1);
+    BOOST_REQUIRE(connect_and_exchange(server, creds, addr));
+    BOOST_REQUIRE(connect_and_exchange(server, creds, addr));
+    BOOST_REQUIRE_EQUAL(cache->get_stats().misses, 1);
+    BOOST_REQUIRE_EQUAL(cache->get_stats().hits, 2);
+
+    // A session the server does not know is not resumed, and is replaced
+    cache->put(format("{}", addr), tls::session_data(64, 0));
+    BOOST_REQUIRE(!connect_and_exchange(server, creds, addr));
+    BOOST_REQUIRE(connect_and_exchange(server, creds, addr));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_session_ticket_key_rotation) {
+    tls::credentials_builder b;
+
+    b.set_x509_key_file(certfile("test.crt"), certfile("test.key"), tls::x509_crt_format::PEM).get();
+    b.set_x509_trust_file(certfile("catest.pem"), tls::x509_crt_format::PEM).get();
+    b.set_priority_string("SECURE128:+SECURE192:-VERS-TLS-ALL:+VERS-TLS1.3");
+
+    sharded<tls::session_ticket_key_rotation> rotation;
+    rotation.start(std::chrono::hours(24), tls::session_ticket_key_rotation::generate_key()).get();
+    auto stop_rotation = defer([&rotation] () noexcept { rotation.stop().get(); });
+
+    auto creds = b.build_certificate_credentials();
+    creds->set_session_cache(make_shared<tls::client_session_cache>());
+    auto serv = b.build_server_credentials();
+    rotation.local().add(serv);
+
+    ::listen_options opts;
+    opts.reuse_address = true;
+    opts.set_fixed_cpu(this_shard_id());
+
+    auto addr = ::make_ipv4_address({0x7f000001, 4712});
+    auto server = tls::listen(serv, addr, opts);
+
+    BOOST_REQUIRE(!connect_and_exchange(server, creds, addr));
+    BOOST_REQUIRE(connect_and_exchange(server, creds, addr));
+
+    // Tickets of the previous key no longer resume
+    rotation.local().rotate().get();
+    BOOST_REQUIRE(!connect_and_exchange(server, creds, addr));
+    BOOST_REQUIRE(connect_and_exchange(server, creds, addr));
+
+    // Reloading the credentials keeps the rotated key
+    b.rebuild(*serv);
+    BOOST_REQUIRE(connect_and_exchange(server, creds, addr));
+}
+
 SEASTAR_THREAD_TEST_CASE(test_tls13_session_tickets_invalidated_by_reload) {
     tls::credentials_builder b;
     tmpdir tmp;
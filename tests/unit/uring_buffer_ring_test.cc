@@ -0,0 +1,208 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Runs with a provided buffer ring of 4 buffers of 4096 bytes, of which a
+// socket may hold 2 (see CMakeLists.txt). The ring is only set up by the
+// io_uring backend on Linux 6.0 or later; elsewhere sockets read into
+// private buffers and the tests only check the data.
+
+#include <seastar/core/reactor.hh>
+#include <seastar/core/internal/buffer_allocator.hh>
+#include <seastar/core/internal/pollable_fd.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/net/api.hh>
+
+#include <vector>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+static constexpr size_t ring_buffer_size = 4096;
+static constexpr unsigned socket_share = 2;
+
+class test_buffer_allocator final : public internal::buffer_allocator {
+public:
+    virtual temporary_buffer<char> allocate_buffer() override {
+        return temporary_buffer<char>(ring_buffer_size);
+    }
+};
+
+static test_buffer_allocator allocator;
+
+struct socket_pair {
+    pollable_fd client;
+    pollable_fd server;
+};
+
+static socket_pair make_socket_pair(pollable_fd& listener) {
+    auto addr = listener.get_file_desc().get_address();
+    auto client = engine().make_pollable_fd(addr, 0);
+    auto accepted = listener.accept();
+    engine().posix_connect(client, addr, ipv4_addr()).get();
+    return socket_pair{std::move(client), std::get<0>(accepted.get())};
+}
+
+static pollable_fd make_listener() {
+    return engine().posix_listen(ipv4_addr("127.0.0.1", 0), listen_options{.reuse_address = true});
+}
+
+static char pattern(size_t i, char seed) {
+    return char(i * 7 + seed);
+}
+
+static void send(pollable_fd& fd, size_t len, char seed) {
+    std::vector<char> out(len);
+    for (size_t i = 0; i < len; i++) {
+        out[i] = pattern(i, seed);
+    }
+    fd.write_all(out.data(), out.size()).get();
+}
+
+// Receives len bytes and returns the buffers they came in, which keeps the
+// ring buffers among them out of the ring
+static std::vector<temporary_buffer<char>> receive(pollable_fd& fd, size_t len, char seed) {
+    std::vector<temporary_buffer<char>> bufs;
+    size_t pos = 0;
+    while (pos < len) {
+        auto buf = fd.recv_some(&allocator).get();
+        BOOST_REQUIRE(!buf.empty());
+        BOOST_REQUIRE_LE(pos + buf.size(), len);
+        for (size_t i = 0; i < buf.size(); i++) {
+            BOOST_REQUIRE_EQUAL(buf[i], pattern(pos + i, seed));
+        }
+        pos += buf.size();
+        bufs.push_back(std::move(buf));
+    }
+    return bufs;
+}
+
+// Exchanges some data over a fresh socket and tells whether it was read
+// from the ring
+static bool buffer_ring_in_use(socket_pair& s) {
+    auto recvs = engine().get_io_stats().uring_buffer_ring_recvs;
+    send(s.client, 100, 0);
+    receive(s.server, 100, 0);
+    if (engine().get_io_stats().uring_buffer_ring_recvs == recvs) {
+        BOOST_TEST_MESSAGE("io_uring provided buffer ring not in use, skipping");
+        return false;
+    }
+    return true;
+}
+
+// Sends and receives chunks, holding on to everything received, until the
+// socket holds its share of the ring
+static std::vector<temporary_buffer<char>> fill_share(socket_pair& s) {
+    std::vector<temporary_buffer<char>> held;
+    auto start = engine().get_io_stats().uring_buffer_ring_recvs;
+    for (char seed = 0; engine().get_io_stats().uring_buffer_ring_recvs - start < socket_share; seed++) {
+        send(s.client, ring_buffer_size, seed);
+        for (auto& buf : receive(s.server, ring_buffer_size, seed)) {
+            held.push_back(std::move(buf));
+        }
+    }
+    return held;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_recv_through_buffer_ring) {
+    auto listener = make_listener();
+    auto s = make_socket_pair(listener);
+    if (!buffer_ring_in_use(s)) {
+        return;
+    }
+
+    // Data arriving while nobody reads is queued, in order, larger writes
+    // span several ring buffers
+    send(s.client, 3 * ring_buffer_size, 2);
+    send(s.client, 10, 3);
+    receive(s.server, 3 * ring_buffer_size, 2);
+    receive(s.server, 10, 3);
+
+    s.client.shutdown(SHUT_WR);
+    BOOST_REQUIRE(s.server.recv_some(&allocator).get().empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_buffer_ring_socket_share) {
+    auto listener = make_listener();
+    auto s = make_socket_pair(listener);
+    if (!buffer_ring_in_use(s)) {
+        return;
+    }
+    auto held = fill_share(s);
+    // Holding its share, the socket stops receiving until it is read from,
+    // the data stays in the socket buffer
+    auto stats = engine().get_io_stats();
+    send(s.client, 4 * ring_buffer_size, 9);
+    sleep(50ms).get();
+    BOOST_REQUIRE_EQUAL(engine().get_io_stats().uring_buffer_ring_recvs, stats.uring_buffer_ring_recvs);
+    BOOST_REQUIRE_EQUAL(engine().get_io_stats().uring_buffer_ring_copies, stats.uring_buffer_ring_copies);
+    receive(s.server, 4 * ring_buffer_size, 9);
+
+    // Reads then go to private buffers and the ring keeps the buffers for
+    // the other sockets
+    stats = engine().get_io_stats();
+    send(s.client, 4 * ring_buffer_size, 10);
+    receive(s.server, 4 * ring_buffer_size, 10);
+    BOOST_REQUIRE_EQUAL(engine().get_io_stats().uring_buffer_ring_recvs, stats.uring_buffer_ring_recvs);
+    BOOST_REQUIRE_GT(engine().get_io_stats().uring_buffer_ring_copies, stats.uring_buffer_ring_copies);
+
+    auto other = make_socket_pair(listener);
+    send(other.client, 100, 11);
+    receive(other.server, 100, 11);
+    BOOST_REQUIRE_GT(engine().get_io_stats().uring_buffer_ring_recvs, stats.uring_buffer_ring_recvs);
+
+    // Once the buffers are released, the socket reads from the ring again
+    held.clear();
+    stats = engine().get_io_stats();
+    send(s.client, 100, 12);
+    receive(s.server, 100, 12);
+    BOOST_REQUIRE_GT(engine().get_io_stats().uring_buffer_ring_recvs, stats.uring_buffer_ring_recvs);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_buffer_ring_exhausted) {
+    auto listener = make_listener();
+    // Two sockets holding their share take all 4 buffers of the ring
+    auto a = make_socket_pair(listener);
+    if (!buffer_ring_in_use(a)) {
+        return;
+    }
+    auto held_a = fill_share(a);
+    auto b = make_socket_pair(listener);
+    auto held_b = fill_share(b);
+
+    // A third socket finds the ring empty and falls back to a private buffer
+    auto c = make_socket_pair(listener);
+    auto stats = engine().get_io_stats();
+    send(c.client, 100, 20);
+    receive(c.server, 100, 20);
+    BOOST_REQUIRE_GT(engine().get_io_stats().uring_buffer_ring_exhausted, stats.uring_buffer_ring_exhausted);
+    BOOST_REQUIRE_EQUAL(engine().get_io_stats().uring_buffer_ring_recvs, stats.uring_buffer_ring_recvs);
+
+    // The next read re-arms the multishot receive, which takes buffers from
+    // the ring again once they are back
+    held_a.clear();
+    held_b.clear();
+    stats = engine().get_io_stats();
+    send(c.client, 100, 21);
+    receive(c.server, 100, 21);
+    BOOST_REQUIRE_GT(engine().get_io_stats().uring_buffer_ring_recvs, stats.uring_buffer_ring_recvs);
+}
@@ -0,0 +1,192 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Runs with a fixed-file table of 2 slots and a registered buffer arena of
+// 1MB (see CMakeLists.txt). Both are only set up by the io_uring backend;
+// elsewhere the files are read and written the usual way and the tests
+// only check the data.
+
+#include <seastar/core/file.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/tmp_file.hh>
+
+#include <vector>
+
+using namespace seastar;
+
+static constexpr size_t arena_size = 1 << 20;
+static constexpr size_t block_size = 4096;
+
+static file open_test_file(tmp_dir& t, sstring name, file_open_options options) {
+    return open_file_dma((t.get_path() / name.c_str()).native(), open_flags::rw | open_flags::create, options).get();
+}
+
+static void fill(temporary_buffer<char>& buf, char seed) {
+    for (size_t i = 0; i < buf.size(); i++) {
+        buf.get_write()[i] = char(i * 7 + seed);
+    }
+}
+
+static void check(const char* p, size_t len, char seed) {
+    for (size_t i = 0; i < len; i++) {
+        BOOST_REQUIRE_EQUAL(p[i], char(i * 7 + seed));
+    }
+}
+
+// Writes a block through buf, reads it back into buf and checks it
+static void write_and_read(file& f, temporary_buffer<char>& buf, char seed) {
+    fill(buf, seed);
+    BOOST_REQUIRE_EQUAL(f.dma_write(0, buf.get(), buf.size()).get(), buf.size());
+    std::fill_n(buf.get_write(), buf.size(), 0);
+    BOOST_REQUIRE_EQUAL(f.dma_read(0, buf.get_write(), buf.size()).get(), buf.size());
+    check(buf.get(), buf.size(), seed);
+}
+
+static uint64_t fixed_file_requests() {
+    return engine().get_io_stats().uring_fixed_file_requests;
+}
+
+static uint64_t fixed_buffer_requests() {
+    return engine().get_io_stats().uring_fixed_buffer_requests;
+}
+
+// Does I/O on f through a buffer from allocate_dma_buffer() and tells
+// whether it was submitted on the registered buffer arena
+static bool arena_in_use(file& f) {
+    auto buf = allocate_dma_buffer(block_size, f.memory_dma_alignment());
+    auto before = fixed_buffer_requests();
+    write_and_read(f, buf, 0);
+    if (fixed_buffer_requests() == before) {
+        BOOST_TEST_MESSAGE("io_uring registered buffer arena not in use, skipping");
+        return false;
+    }
+    return true;
+}
+
+// Does I/O on f and tells whether it went through the fixed-file table
+static bool uses_fixed_file(file& f, char seed) {
+    auto buf = temporary_buffer<char>::aligned(f.memory_dma_alignment(), block_size);
+    auto before = fixed_file_requests();
+    write_and_read(f, buf, seed);
+    f.flush().get();
+    return fixed_file_requests() > before;
+}
+
+SEASTAR_TEST_CASE(test_fixed_file_table) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        file_open_options options;
+        options.fixed_file = true;
+        std::vector<file> files;
+        files.push_back(open_test_file(t, "0", options));
+        if (!uses_fixed_file(files[0], 0)) {
+            BOOST_TEST_MESSAGE("io_uring fixed-file table not in use, skipping");
+            files[0].close().get();
+            return;
+        }
+        files.push_back(open_test_file(t, "1", options));
+        BOOST_REQUIRE(uses_fixed_file(files[1], 1));
+
+        // The table is full, the next file uses its plain descriptor
+        files.push_back(open_test_file(t, "2", options));
+        BOOST_REQUIRE(!uses_fixed_file(files[2], 2));
+
+        // Files not asking for a slot don't get one
+        auto plain = open_test_file(t, "plain", file_open_options{});
+        BOOST_REQUIRE(!uses_fixed_file(plain, 3));
+        plain.close().get();
+
+        // Closing a registered file frees its slot for the next one
+        files[0].close().get();
+        files[0] = open_test_file(t, "3", options);
+        BOOST_REQUIRE(uses_fixed_file(files[0], 4));
+
+        for (auto& f : files) {
+            f.close().get();
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_fixed_buffer_arena) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        auto f = open_test_file(t, "0", file_open_options{});
+        if (!arena_in_use(f)) {
+            f.close().get();
+            return;
+        }
+        auto alignment = f.memory_dma_alignment();
+        auto buf = allocate_dma_buffer(block_size, alignment);
+        auto before = fixed_buffer_requests();
+        write_and_read(f, buf, 0);
+        // One write and one read
+        BOOST_REQUIRE_EQUAL(fixed_buffer_requests() - before, 2);
+
+        // Buffers from elsewhere are not registered
+        auto plain = temporary_buffer<char>::aligned(alignment, block_size);
+        before = fixed_buffer_requests();
+        write_and_read(f, plain, 1);
+        BOOST_REQUIRE_EQUAL(fixed_buffer_requests(), before);
+
+        // Once the arena is exhausted, buffers are allocated the usual way
+        std::vector<temporary_buffer<char>> held;
+        held.push_back(std::move(buf));
+        while (held.size() < arena_size / block_size) {
+            held.push_back(allocate_dma_buffer(block_size, alignment));
+        }
+        auto overflow = allocate_dma_buffer(block_size, alignment);
+        before = fixed_buffer_requests();
+        write_and_read(f, overflow, 2);
+        BOOST_REQUIRE_EQUAL(fixed_buffer_requests(), before);
+
+        // Freed buffers go back to the arena
+        held.erase(held.begin());
+        buf = allocate_dma_buffer(block_size, alignment);
+        before = fixed_buffer_requests();
+        write_and_read(f, buf, 3);
+        BOOST_REQUIRE_GT(fixed_buffer_requests(), before);
+
+        f.close().get();
+    });
+}
+
+SEASTAR_TEST_CASE(test_fixed_buffers_read_bulk) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        file_open_options options;
+        options.fixed_buffers = true;
+        auto f = open_test_file(t, "0", options);
+        bool in_use = arena_in_use(f);
+        auto buf = temporary_buffer<char>::aligned(f.memory_dma_alignment(), 4 * block_size);
+        fill(buf, 5);
+        f.dma_write(0, buf.get(), buf.size()).get();
+
+        // Files opened with fixed_buffers read into the arena
+        auto before = fixed_buffer_requests();
+        auto bulk = f.dma_read_bulk<char>(0, buf.size()).get();
+        BOOST_REQUIRE_EQUAL(bulk.size(), buf.size());
+        check(bulk.get(), bulk.size(), 5);
+        if (in_use) {
+            BOOST_REQUIRE_GT(fixed_buffer_requests(), before);
+        }
+        f.close().get();
+    });
+}